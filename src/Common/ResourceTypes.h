@@ -0,0 +1,36 @@
+#ifndef RESOURCE_TYPES_H
+#define RESOURCE_TYPES_H
+
+/**
+ * @brief Resource types of the TResourceManager, used for the memory accounting and budgets,
+ * 		  and the ids the TResourceManager gives to every resource path.
+ * 
+ */
+
+enum RESOURCETYPE {
+	NONE_RESOURCE		=-1,
+	TEXTURE_RESOURCE	= 0,
+	MESH_RESOURCE		= 1,
+	SHADER_RESOURCE		= 2,
+	MATERIAL_RESOURCE	= 3,
+	RESOURCE_TYPES		= 4		// Numero de tipos
+};
+
+typedef unsigned int TResourceId;			// Ruta ya tratada de un recurso, se busca sin copiar ni tratar la ruta otra vez
+static const TResourceId NO_RESOURCE_ID = 0;	// Id que no apunta a ninguna ruta
+
+// Recursos del motor que estan en la carpeta de assets
+enum DEFAULTRESOURCE {
+	DEFAULT_TEXTURE		= 0,	// textures/default_texture.png
+	DEFAULT_BUMP		= 1,	// textures/default_bump.png
+	DEFAULT_PARTICLE	= 2,	// textures/default_particle.png
+	DEFAULT_MESH		= 3,	// models/cube.obj
+	DEFAULT_SPHERE		= 4,	// models/sphere.obj
+	DEFAULT_DOME		= 5,	// models/dome.obj
+	DEFAULT_INVISIBLE	= 6,	// textures/invisible_texture.png
+	DEFAULT_FONT		= 7,	// textures/default_font.png
+	DEFAULT_SKYDOME		= 8,	// textures/default_skydome.jpg
+	DEFAULT_RESOURCES	= 9		// Numero de recursos por defecto
+};
+
+#endif
\ No newline at end of file
@@ -21,7 +21,93 @@ enum SHADERTYPE {
 	FISHEYE_SHADER 			= 10,
 	BARREL_SHADER 			= 11,
 	SHADOW_SHADER			= 12,
-	TWODTEXT_SHADER			= 13
+	TWODTEXT_SHADER			= 13,
+	INSTANCED_SHADER		= 14
 };
 
+/**
+ * @brief Uniforms TOE sends to the shaders. Their locations are cached in each Program.
+ * 
+ */
+
+enum UNIFORMTYPE {
+	MVP_UNIFORM					= 0,
+	MODEL_UNIFORM				= 1,
+	VIEW_UNIFORM				= 2,
+	MODELVIEW_UNIFORM			= 3,
+	PROJECTION_UNIFORM			= 4,
+	NORMAL_UNIFORM				= 5,
+	DEPTHMVP_UNIFORM			= 6,
+	MROT_UNIFORM				= 7,
+	FRAMETIME_UNIFORM			= 8,
+	TEXTURESCALE_UNIFORM		= 9,
+	UVMAP_UNIFORM				= 10,
+	SPECULARMAP_UNIFORM			= 11,
+	BUMPMAP_UNIFORM				= 12,
+	MASK_UNIFORM				= 13,
+	SHININESS_UNIFORM			= 14,
+	DIFFUSE_UNIFORM				= 15,
+	SPECULAR_UNIFORM			= 16,
+	AMBIENT_UNIFORM				= 17,
+	LINECOLOR_UNIFORM			= 18,
+	AMBIENTLIGHT_UNIFORM		= 19,
+	NLIGHTS_UNIFORM				= 20,
+	NSHADOWLIGHTS_UNIFORM		= 21,
+	UNIFORM_COUNT				= 22
+};
+
+/**
+ * @brief Fields of each light in the Light[] uniform array.
+ * 
+ */
+
+enum LIGHTUNIFORMTYPE {
+	LIGHT_POSITION				= 0,
+	LIGHT_DIFFUSE				= 1,
+	LIGHT_SPECULAR				= 2,
+	LIGHT_ATTENUATION			= 3,
+	LIGHT_DIRECTIONAL			= 4,
+	LIGHT_DIRECTION				= 5,
+	LIGHT_SHADOWLIGHT			= 6,
+	LIGHT_SHADOWMAP				= 7,
+	LIGHT_UNIFORM_COUNT			= 8
+};
+
+/**
+ * @brief Vertex attributes TOE sends to the shaders.
+ * 
+ */
+
+enum ATTRIBTYPE {
+	VERTEXPOSITION_ATTRIB		= 0,
+	VERTEXNORMAL_ATTRIB			= 1,
+	TEXTURECOORDS_ATTRIB		= 2,
+	MASKCOORDS_ATTRIB			= 3,
+	PARTICLECENTER_ATTRIB		= 4,
+	PARTICLECOLOR_ATTRIB		= 5,
+	PARTICLEEXTRA_ATTRIB		= 6,
+	SHADOWPOSITION_ATTRIB		= 7,
+	POSITION2D_ATTRIB			= 8,
+	COLOR2D_ATTRIB				= 9,
+	OVERCOLOR_ATTRIB			= 10,
+	ATTRIB_COUNT				= 11
+};
+
+/**
+ * @brief Fixed attribute locations of the mesh vertex layout. Every program binds them before linking
+ * 		  so the same VAO of a mesh can be drawn with any shader.
+ * 
+ */
+
+enum MESHATTRIBLOCATION {
+	MESH_POSITION_LOCATION		= 0,
+	MESH_NORMAL_LOCATION		= 1,
+	MESH_UV_LOCATION			= 2,
+	MESH_TANGENT_LOCATION		= 3,
+	MESH_INSTANCE_LOCATION		= 4		// mat4 por instancia, ocupa las localizaciones 4 a 7
+};
+
+#define MAX_SHADER_LIGHTS		12	// Size of the Light[] array in the shaders
+#define MAX_SHADER_SHADOWS		20	// Size of the DepthBiasMVPArray[] array in the shaders
+
 #endif
\ No newline at end of file
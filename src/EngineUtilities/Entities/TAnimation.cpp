@@ -24,12 +24,12 @@ void TAnimation::SetPaths(std::string ID, int frames, const std::vector<std::str
     m_anims[ID].meshes.clear();	
 	// add all paths to the animation vector
     for (int i = 0; i < frames; i++){
-    	TResourceMesh* mesh = TResourceManager::GetInstance()->GetResourceMesh(paths[i]);
-        m_anims[ID].meshes.push_back(mesh);
+        m_anims[ID].meshes.push_back(TResourceManager::GetInstance()->GetResourceMesh(paths[i]));
 	}
 	
 	// Change actual mesh to the actual animation first frame
 	m_mesh = m_anims[ID].meshes[0];
+	m_boundsRevision++;
 }
 
 void TAnimation::UpdateAnimation(float deltatime){
@@ -61,6 +61,7 @@ void TAnimation::UpdateAnimation(float deltatime){
 			nextFrame = nextFrame % m_anims[m_queue.back()].meshes.size();
 			// Update animation mesh to correpondent
 			m_mesh = m_anims[m_queue.back()].meshes[nextFrame];
+			m_boundsRevision++;
 			m_actualFrame = nextFrame;
 		}
 	}
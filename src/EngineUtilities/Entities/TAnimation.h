@@ -12,7 +12,7 @@
 struct AnimData{
 	int frames;								// frames - Maximo de frames de la animacion
 	int fps;								// fps - Velocidad de la animacion
-	std::vector <TResourceMesh*> meshes;	// meshess - Todos los recursos de cada frame de la animacion
+	std::vector <TResourceHandle<TResourceMesh>> meshes;	// meshess - Todos los recursos de cada frame de la animacion
 
 	/**
 	 * @brief	- Constructor del struct AnimData donde inicializamos sus variables a 0 
@@ -113,9 +113,9 @@ public:
 	void SetBBVisibility(bool visible);
 
 protected:
-    TResourceMesh* 		m_mesh;
-	TResourceTexture* 	m_texture;
-	TResourceMaterial* 	m_material;
+    TResourceHandle<TResourceMesh> 		m_mesh;
+	TResourceHandle<TResourceTexture> 	m_texture;
+	TResourceHandle<TResourceMaterial> 	m_material;
 	bool m_visibleBB;
 	bool m_drawingShadows;
 
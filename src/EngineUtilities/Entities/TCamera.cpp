@@ -129,4 +129,9 @@ glm::mat4 TCamera::CalculateOrthogonalMatrix(){
 
 void TCamera::BeginDraw(){}
 
-void TCamera::EndDraw(){}
\ No newline at end of file
+void TCamera::EndDraw(){}
+
+bool TCamera::GetWorldBounds(const glm::mat4& model, glm::vec3* min, glm::vec3* max){
+	TransformBounds(model, glm::vec3(0.0f), glm::vec3(0.0f), min, max);
+	return true;
+}
\ No newline at end of file
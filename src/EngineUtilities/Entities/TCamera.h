@@ -171,6 +171,11 @@ public:
 	 */
 	void EndDraw();
 
+	/**
+	 * @brief	- La camara no pinta nada, su caja es solo su posicion
+	 */
+	virtual bool GetWorldBounds(const glm::mat4& model, glm::vec3* min, glm::vec3* max) override;
+
 private:
 	bool m_perspective;				// m_perspective - Si es perspetiva o ortogonal
 
@@ -1,17 +1,18 @@
 #include "TDome.h"
 #include <GL/glew.h>
 #include "../TOcularEngine/VideoDriver.h"
+#include "../TRenderQueue.h"
 
 // Get dome model (sphere)
-std::string getModel(){
-	return VideoDriver::GetInstance()->GetAssetsPath() + "/models/dome.obj";
+TResourceId getModel(){
+	return TResourceManager::GetInstance()->GetDefaultId(DEFAULT_DOME);
 }
 
 // String validation when calling father constructor
-std::string checkText(std::string path){
-	std::string toRet = path;
-	if(path.compare("")==0) toRet = VideoDriver::GetInstance()->GetAssetsPath() + "/textures/default_skydome.jpg";
-	return toRet;
+TResourceId checkText(std::string path){
+	TResourceManager* manager = TResourceManager::GetInstance();
+	if(path.compare("")==0) return manager->GetDefaultId(DEFAULT_SKYDOME);
+	return manager->GetResourceId(path);
 }
 
 // Constructor
@@ -30,18 +31,24 @@ TDome::~TDome(){}
 
 void TDome::BeginDraw(){
 	if(!m_drawingShadows){
-		// Bind and send the data to the VERTEX SHADER
-		glDepthMask(GL_FALSE);
-		SendShaderData();
-		
-		// Bind and draw elements depending of how many vbos
-		GLuint elementsBuffer = m_mesh->GetElementBuffer();
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, elementsBuffer);
-		glDrawElements(GL_TRIANGLES, m_mesh->GetElementSize(), GL_UNSIGNED_INT, 0);
-		glDepthMask(GL_TRUE);
+		// The dome goes in the background layer so it's drawn before every other entity
+		unsigned int textureId = 0;
+		if(m_texture != nullptr) textureId = m_texture->GetTextureId();
+		unsigned long long key = TRenderQueue::MakeKey(BACKGROUND_LAYER, m_program, nullptr, TRenderQueue::MakeTextureSet(textureId), m_mesh->GetElementBuffer());
+		TRenderQueue::GetInstance()->Push(this, key);
 	}
 }
 
+void TDome::DrawQueued(){
+	// Bind and send the data to the VERTEX SHADER
+	glDepthMask(GL_FALSE);
+	SendShaderData();
+	
+	// Draw the elements, the element buffer is already bound in the VAO
+	glDrawElements(GL_TRIANGLES, m_mesh->GetElementSize(), GL_UNSIGNED_INT, 0);
+	glDepthMask(GL_TRUE);
+}
+
 void TDome::EndDraw(){
 	m_drawingShadows = false;
 }
@@ -51,33 +58,21 @@ void TDome::DrawShadow(){
 	m_drawingShadows = true;
 }
 
+bool TDome::GetWorldBounds(const glm::mat4& model, glm::vec3* min, glm::vec3* max){
+	return false;
+}
+
 void TDome::SendShaderData(){
 	Program* myProgram = VideoDriver::GetInstance()->SetShaderProgram(m_program);
 
-    // -------------------------------------------------------- ENVIAMOS LOS VERTICES
-    // BIND VERTEX
-    GLuint vertexBuffer = m_mesh->GetVertexBuffer();
-	glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
-
-	// SEND THE VERTEX
-	GLint posAttrib = glGetAttribLocation(myProgram->GetProgramID(), "VertexPosition");
-	glVertexAttribPointer(posAttrib,3, GL_FLOAT, GL_FALSE, 0*sizeof(float), 0);
-	glEnableVertexAttribArray(posAttrib);
-
-	// -------------------------------------------------------- ENVIAMOS LAS UV
-	// BIND THE UV
-    GLuint uvBuffer = m_mesh->GetUvBuffer();
-	glBindBuffer(GL_ARRAY_BUFFER, uvBuffer);
-
-	// SEND THE UV
-	GLuint uvAttrib = glGetAttribLocation(myProgram->GetProgramID(), "TextureCoords");
-	glVertexAttribPointer(uvAttrib, 2, GL_FLOAT, GL_FALSE, 0*sizeof(float), 0);
-	glEnableVertexAttribArray(uvAttrib);
+    // -------------------------------------------------------- ENLAZAMOS EL MESH
+	// BIND THE MESH VAO (VERTEX AND UV)
+	TRenderQueue::GetInstance()->BindMesh(m_mesh);
 
 	// -------------------------------------------------------- ENVIAMOS LAS MATRICES
 	// SEND THE MODELVIEWPROJECTION MATRIX
-	glm::mat4 mvpMatrix = ProjMatrix * ViewMatrix * m_stack.top();
-	GLint mvpLocation = glGetUniformLocation(myProgram->GetProgramID(), "MVP");
+	glm::mat4 mvpMatrix = ProjMatrix * ViewMatrix * ModelMatrix;
+	GLint mvpLocation = myProgram->GetUniformLocation(MVP_UNIFORM);
 	glUniformMatrix4fv(mvpLocation, 1, GL_FALSE, &mvpMatrix[0][0]);
 
 	// -------------------------------------------------------- ENVIAMOS LA TEXTURA
@@ -86,7 +81,7 @@ void TDome::SendShaderData(){
 	else if(m_mesh != nullptr) currentTexture = m_mesh->GetTexture();
 
 	if(currentTexture != nullptr){
-		GLuint TextureID = glGetUniformLocation(myProgram->GetProgramID(), "uvMap");
+		GLuint TextureID = myProgram->GetUniformLocation(UVMAP_UNIFORM);
 		glUniform1i(TextureID, 0); 
 
 		glActiveTexture(GL_TEXTURE0);
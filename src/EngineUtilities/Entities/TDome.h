@@ -24,10 +24,15 @@ public:
 	~TDome();
 
 	/**
-	 * @brief	- Empezamos a pintar el dome con el ZBuffer desactivado 
+	 * @brief	- Mandamos el dome a la cola de pintado en la capa de fondo
 	 */
 	virtual void BeginDraw() override;
 
+	/**
+	 * @brief	- Pintamos el dome, lo llama la cola de pintado
+	 */
+	virtual void DrawQueued() override;
+
 	/**
 	 * @brief	- Acabamos de pintar el dome 
 	 */
@@ -38,6 +43,11 @@ public:
 	 */
 	virtual void DrawShadow() override;
 
+	/**
+	 * @brief	- El dome rodea a la camara, no tiene caja para que no lo descarte el frustum
+	 */
+	virtual bool GetWorldBounds(const glm::mat4& model, glm::vec3* min, glm::vec3* max) override;
+
 private:
 	/**
 	 * @brief Send to shader all vertex and texture
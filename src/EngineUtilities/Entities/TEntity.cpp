@@ -1,25 +1,34 @@
 #include "./TEntity.h"
+#include <glm/common.hpp>
 
 TEntity::~TEntity(){}
 
-std::stack<glm::mat4> TEntity::InitializeStack(){
-    static std::stack<glm::mat4> aux;   // 
-    aux.push(glm::mat4(1.0f));          //
-    return aux;                         // Creamos la pila con la matriz identidad en ella y la devolvemos
-}
-
-std::stack<glm::mat4> TEntity::m_stack = TEntity::InitializeStack();
-
 unsigned int TEntity::currentFrame = 1;
 
 void TEntity::SetProgram(SHADERTYPE program){
     m_program = program;
 }
 
+bool TEntity::IsTransform(){
+    return false;
+}
+
+void TEntity::SetOwnerNode(TNode* node){
+    m_ownerNode = node;
+}
+
+TNode* TEntity::GetOwnerNode(){
+    return m_ownerNode;
+}
+
 // Initialize static variables
+glm::mat4 TEntity::ModelMatrix = glm::mat4(1.0f);
 glm::mat4 TEntity::ViewMatrix;
 glm::mat4 TEntity::ProjMatrix;
 bool TEntity::m_checkClipping = false;
+bool TEntity::m_clippingChecked = false;
+bool TEntity::m_checkOcclusion = false;
+TOcclusionBuffer* TEntity::m_occlusionBuffer = nullptr;
 float TEntity::m_clippingLimits[4] = {+1.0f, -1.0f, +1.0f, -1.0f};  // Limites por defecto de la pantalla
 glm::mat4 TEntity::DepthWVP;
 
@@ -35,17 +44,58 @@ void TEntity::SetViewMatrixPtr(glm::mat4 view){
 }
 
 bool TEntity::CheckClipping(){
-	glm::mat4 mvpMatrix = ProjMatrix * ViewMatrix * m_stack.top(); //
+	glm::mat4 mvpMatrix = ProjMatrix * ViewMatrix * ModelMatrix;      //
 	glm::vec4 point = mvpMatrix * glm::vec4(0,0,0,1);              // 
 	return CheckClippingPoint(point);                              // Comparamos el clipping con el centro del objeto
 }
 
+bool TEntity::GetWorldBounds(const glm::mat4& model, glm::vec3* min, glm::vec3* max){
+	return false;
+}
+
+void TEntity::TransformBounds(const glm::mat4& model, glm::vec3 center, glm::vec3 halfSize, glm::vec3* min, glm::vec3* max){
+	// Centro transformado mas la extension proyectada en cada eje con los valores absolutos de la matriz
+	glm::vec3 worldCenter = glm::vec3(model * glm::vec4(center, 1.0f));
+
+	glm::vec3 extent(0.0f);
+	for(int i=0; i<3; i++){
+		extent += glm::abs(glm::vec3(model[i])) * halfSize[i];
+	}
+
+	*min = worldCenter - extent;
+	*max = worldCenter + extent;
+}
+
+bool TEntity::IsOccluder(){
+	return false;
+}
+
+void TEntity::DrawOccluder(TOcclusionBuffer* buffer, const glm::mat4& model){}
+
+unsigned int TEntity::GetBoundsRevision(){
+	return m_boundsRevision;
+}
+
 bool TEntity::CheckClippingPoint(glm::vec4 Pclip){
 	return abs(Pclip.x) < Pclip.w && abs(Pclip.y) < Pclip.w && 0 < Pclip.z && Pclip.z < Pclip.w;
 }
 
 void TEntity::DrawShadow(){}
 
+void TEntity::DrawQueued(){}
+
+bool TEntity::CanInstanceWith(TEntity* other){
+    return false;
+}
+
+void TEntity::DrawInstanced(std::vector<glm::mat4>* models){
+    int size = models->size();
+    for(int i=0; i<size; i++){
+        ModelMatrix = models->at(i);
+        DrawQueued();
+    }
+}
+
 void TEntity::CheckClippingAreas(glm::vec4 point, int* upDown, int* leftRight, int* nearFar){
    float valueX = point.x / abs(point.w);                   //
    float valueY = point.y / abs(point.w);                   //
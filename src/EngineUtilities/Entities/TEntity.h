@@ -9,8 +9,11 @@
 
 #include <ShaderTypes.h>
 #include "../Resources/Program.h"
-#include <stack>
 #include <glm/mat4x4.hpp>
+#include <vector>
+
+class TNode;
+class TOcclusionBuffer;
 
 class TEntity{
 public:
@@ -35,6 +38,29 @@ public:
 	 */
 	virtual void DrawShadow();
 
+	/**
+	 * @brief	- Pinta la entidad con la matriz ModelMatrix actual, lo llama la TRenderQueue
+	 * 				al vaciarse. Por defecto las entidades no pintan nada
+	 */
+	virtual void DrawQueued();
+
+	/**
+	 * @brief	- Indica si la entidad se puede pintar en la misma llamada instanciada que otra
+	 * 				Por defecto las entidades no se instancian
+	 *
+	 * @param 	- other - Entidad con la que se quiere agrupar
+	 * @return 	- bool - Comparten mesh, programa, texturas y material
+	 */
+	virtual bool CanInstanceWith(TEntity* other);
+
+	/**
+	 * @brief	- Pinta la entidad una vez por cada matriz mundo, lo llama la TRenderQueue al agrupar
+	 * 				entidades iguales. Por defecto pinta cada matriz con DrawQueued
+	 *
+	 * @param 	- models - Matrices mundo de cada instancia
+	 */
+	virtual void DrawInstanced(std::vector<glm::mat4>* models);
+
 	/**
 	 * @brief	- Metodo que compprueba si un objeto esta dentro de la pantalla
 	 * 				por defecto solo compara con el centro
@@ -43,6 +69,71 @@ public:
 	 */
 	virtual bool CheckClipping();
 
+	/**
+	 * @brief	- Calcula la caja alineada con los ejes que ocupa la entidad en coordenadas mundo
+	 * 				Por defecto las entidades no tienen caja y se pintan siempre
+	 *
+	 * @param 	- model - Matriz mundo de la entidad
+	 * @param 	- min - Esquina minima de la caja
+	 * @param 	- max - Esquina maxima de la caja
+	 * @return 	- bool - La entidad tiene caja
+	 */
+	virtual bool GetWorldBounds(const glm::mat4& model, glm::vec3* min, glm::vec3* max);
+
+	/**
+	 * @brief	- Transforma una caja local a la caja alineada con los ejes que la contiene en coordenadas mundo
+	 *
+	 * @param 	- model - Matriz mundo
+	 * @param 	- center - Centro de la caja local
+	 * @param 	- halfSize - Mitad del tamanyo de la caja local
+	 * @param 	- min - Esquina minima de la caja mundo
+	 * @param 	- max - Esquina maxima de la caja mundo
+	 */
+	static void TransformBounds(const glm::mat4& model, glm::vec3 center, glm::vec3 halfSize, glm::vec3* min, glm::vec3* max);
+
+	/**
+	 * @brief	- Indica si la entidad se rasteriza en el buffer de oclusion para tapar a las demas
+	 * 				Por defecto las entidades no son oclusores
+	 */
+	virtual bool IsOccluder();
+
+	/**
+	 * @brief	- Rasteriza la entidad en el buffer de oclusion, por defecto no hace nada
+	 * 				Solo se rasteriza una vez por frame aunque la vean varios portales
+	 *
+	 * @param 	- buffer - Buffer de oclusion del frame
+	 * @param 	- model - Matriz mundo de la entidad
+	 */
+	virtual void DrawOccluder(TOcclusionBuffer* buffer, const glm::mat4& model);
+
+	/**
+	 * @brief	- Devuelve la revision de la caja local, cambia cuando la entidad cambia de tamanyo
+	 *
+	 * @return 	- unsigned int - Revision de la caja
+	 */
+	virtual unsigned int GetBoundsRevision();
+
+	/**
+	 * @brief	- Indica si la entidad es una transformacion, por defecto las entidades no lo son
+	 * 
+	 * @return 	- bool - La entidad es un TTransform
+	 */
+	virtual bool IsTransform();
+
+	/**
+	 * @brief	- Guarda el nodo del arbol que contiene la entidad
+	 * 
+	 * @param 	- node - Nodo al que pertenece la entidad
+	 */
+	void SetOwnerNode(TNode* node);
+
+	/**
+	 * @brief	- Devuelve el nodo del arbol que contiene la entidad
+	 * 
+	 * @return 	- TNode* - Nodo al que pertenece la entidad
+	 */
+	TNode* GetOwnerNode();
+
 	/**
 	 * @brief	- Cambia el shader con el que se va a pintar la entidad 
 	 * 
@@ -62,18 +153,14 @@ public:
 	 */
 	static void ResetClippingVariables();
 
-	/**
-	 * @brief	- Inicializa la matriz de la pila a la identidad 
-	 *
-	 * @return 	- std::stack<glm::mat4> - Pila de matrices con la que empezar
-	 */
-	static std::stack<glm::mat4> InitializeStack();
-
-	static std::stack<glm::mat4> m_stack;	// m_stack - Pila de transformaciones de las entidades
 	static bool m_checkClipping;			// m_checkClipping - Booleano para activar o desactivar la comprobacion del clipping
+	static bool m_clippingChecked;			// m_clippingChecked - El recorrido ya ha descartado las cajas fuera del frustum
+	static bool m_checkOcclusion;			// m_checkOcclusion - Descartar las entidades tapadas por los oclusores (necesita el clipping)
+	static TOcclusionBuffer* m_occlusionBuffer;	// m_occlusionBuffer - Buffer de oclusion de la camara principal
 	static float m_clippingLimits[4];		// m_clippingLimits[] - Los cuatros limites de la pantalla para comparar el clipping
 											// 0 (+X) / 1 (-X) / 2 (+Y) / 3 (-Y)
 	
+	static glm::mat4 ModelMatrix;			// ModelMatrix - Matriz mundo de la entidad que se esta pintando, la pone el recorrido del arbol
 	static glm::mat4 ViewMatrix;			// ViewMatrix - Matriz view a utilizar por las entidades
 	static glm::mat4 ProjMatrix;			// ProjMatrix - Matriz projection a utilizar por las entidades
 	static glm::mat4 DepthWVP;				// DepthWVP - Matriz view desde la luz hasta las entidades
@@ -84,6 +171,9 @@ public:
     SHADERTYPE m_program = NONE_SHADER;		// m_program - Shader que va a utilizar la entidad
 
 protected:
+	TNode* m_ownerNode = nullptr;			// m_ownerNode - Nodo del arbol que contiene la entidad
+	unsigned int m_boundsRevision = 0;		// m_boundsRevision - Se incrementa al cambiar la caja local de la entidad
+
 	/**
 	 * @brief	- Comprueba si un punto se encuentra dentro de la pantalla 
 	 * 
@@ -70,6 +70,11 @@ void TLight::DrawShadow(){
 	m_drawingShadows = true;
 }
 
+bool TLight::GetWorldBounds(const glm::mat4& model, glm::vec3* min, glm::vec3* max){
+	TransformBounds(model, glm::vec3(0.0f), glm::vec3(0.5f), min, max);
+	return true;
+}
+
 void TLight::DrawBB(){
 	// Pintamos el bounding box
 	Program* myProgram = VideoDriver::GetInstance()->SetShaderProgram(BB_SHADER);
@@ -105,16 +110,16 @@ void TLight::DrawBB(){
 	//glm::mat4 transform = glm::translate(glm::mat4(1.0f), m_mesh->GetCenter()) * glm::scale(glm::mat4(1), m_mesh->GetSize());
 
 	// Apply object's transformation matrix 
-	glm::mat4 m = ProjMatrix * ViewMatrix * m_stack.top();
-	GLuint uniform_m = glGetUniformLocation(myProgram->GetProgramID(), "MVP");
+	glm::mat4 m = ProjMatrix * ViewMatrix * ModelMatrix;
+	GLuint uniform_m = myProgram->GetUniformLocation(MVP_UNIFORM);
 	glUniformMatrix4fv(uniform_m, 1, GL_FALSE, &m[0][0]);
 
 	// Send light color
-	GLuint linecolor = glGetUniformLocation(myProgram->GetProgramID(), "LineColor");
+	GLuint linecolor = myProgram->GetUniformLocation(LINECOLOR_UNIFORM);
 	glUniform3f(linecolor, 0.7f, 0.7f, 0.0f);
 
 	// Send each vertex data
-	GLuint attribute_v_coord = glGetAttribLocation(myProgram->GetProgramID(), "VertexPosition");	
+	GLuint attribute_v_coord = myProgram->GetAttribLocation(VERTEXPOSITION_ATTRIB);	
 	glBindBuffer(GL_ARRAY_BUFFER, vbo_vertices);
 	glEnableVertexAttribArray(attribute_v_coord);
 
@@ -112,6 +112,11 @@ public:
 	 * @brief	- Cambia la variable de pintar sombras de la luz 
 	 */
 	virtual void DrawShadow() override;
+
+	/**
+	 * @brief	- Caja del cubo unidad que se pinta como bounding box de la luz
+	 */
+	virtual bool GetWorldBounds(const glm::mat4& model, glm::vec3* min, glm::vec3* max) override;
 	
 	/**
 	 * @brief	- Pinta el bounding box que forma la luz 
@@ -1,6 +1,9 @@
 #include "TMesh.h"
 
 #include "./../../TOcularEngine/VideoDriver.h"
+#include "./../TRenderQueue.h"
+#include "./../TFrustum.h"
+#include "./../TOcclusionBuffer.h"
 #include <glm/gtc/type_ptr.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <GL/glew.h>
@@ -16,56 +19,175 @@ TMesh::TMesh(std::string meshPath, std::string texturePath){
 	m_textureScaleX = 1.0f;				//
 	m_textureScaleY = 1.0f;				// Por defecto las texturas no estan escaladas
 	m_frameDrawed = 0;					// Ultimo frame en el que se pintado el mesh
+	m_frameOccluded = 0;				// Ultimo frame en el que se ha rasterizado como oclusor
+	m_occluder = false;					// Por defecto no tapa a otros objetos
+	m_meshRevision = 0;					// Revision del recurso mesh
 
 	LoadMesh(meshPath);					// Cargamos el mesh
 	ChangeTexture(texturePath);			// Cargamos la textura
 	m_program = STANDARD_SHADER;		// Programa estandar con el que va a pintarse
 }
 
+TMesh::TMesh(TResourceId meshId, TResourceId textureId){
+	m_mesh = nullptr;					// 
+	m_texture = nullptr;				//
+	m_specularMap = nullptr;			//
+	m_bumpMap = nullptr;				//
+	m_material = nullptr;				// Recursos del TMesh inicializados a nullptr
+	m_visibleBB = false;				// Por defecto no se pinta la bounding box
+	m_drawingShadows = false;			// Valor por defecto de pintar las sombras
+	m_textureScaleX = 1.0f;				//
+	m_textureScaleY = 1.0f;				// Por defecto las texturas no estan escaladas
+	m_frameDrawed = 0;					// Ultimo frame en el que se pintado el mesh
+	m_frameOccluded = 0;				// Ultimo frame en el que se ha rasterizado como oclusor
+	m_occluder = false;					// Por defecto no tapa a otros objetos
+	m_meshRevision = 0;					// Revision del recurso mesh
+
+	LoadMesh(meshId);					// Cargamos el mesh
+	ChangeTexture(textureId);			// Cargamos la textura
+	m_program = STANDARD_SHADER;		// Programa estandar con el que va a pintarse
+}
+
 TMesh::~TMesh(){}
 
 void TMesh::LoadMesh(std::string meshPath){
 	// En el caso de pasar un string vacio cargamos un cubo como mesh
-	if(meshPath.compare("")==0) meshPath = VideoDriver::GetInstance()->GetAssetsPath() + "/models/cube.obj";
-	m_mesh = TResourceManager::GetInstance()->GetResourceMesh(meshPath);
+	TResourceManager* manager = TResourceManager::GetInstance();
+	LoadMesh(meshPath.compare("")==0 ? manager->GetDefaultId(DEFAULT_MESH) : manager->GetResourceId(meshPath));
+}
+
+void TMesh::LoadMesh(TResourceId meshId){
+	TResourceManager* manager = TResourceManager::GetInstance();
+	if(manager->GetAsyncLoading()) m_mesh = manager->GetResourceMeshAsync(meshId);	// Se pinta el cubo mientras se carga
+	else m_mesh = manager->GetResourceMesh(meshId);
+	m_boundsRevision++;
 }
 
 void TMesh::ChangeTexture(std::string texturePath){
-	if(texturePath.compare("")!=0) m_texture = TResourceManager::GetInstance()->GetResourceTexture(texturePath);
-	else m_texture = nullptr;
+	if(texturePath.compare("")==0) m_texture = nullptr;
+	else ChangeTexture(TResourceManager::GetInstance()->GetResourceId(texturePath));
+}
+
+void TMesh::ChangeTexture(TResourceId textureId){
+	// En segundo plano la que se mostraba hasta ahora hace de provisional
+	TResourceManager* manager = TResourceManager::GetInstance();
+	if(manager->GetAsyncLoading()) m_texture = manager->GetResourceTextureAsync(textureId, nullptr, GetCurrentTexture());
+	else m_texture = manager->GetResourceTexture(textureId);
 }
 
 void TMesh::ChangeBumpMap(std::string texturePath){
-	if(texturePath.compare("")!=0) m_bumpMap = TResourceManager::GetInstance()->GetResourceTexture(texturePath);
-	else m_bumpMap = nullptr;
+	TResourceManager* manager = TResourceManager::GetInstance();
+	if(texturePath.compare("")==0) m_bumpMap = nullptr;
+	else if(manager->GetAsyncLoading()) m_bumpMap = manager->GetResourceTextureAsync(texturePath, nullptr, GetCurrentBumpMap());
+	else m_bumpMap = manager->GetResourceTexture(texturePath);
 }
 
 void TMesh::ChangeSpecularMap(std::string texturePath){
-	if(texturePath.compare("")!=0) m_specularMap = TResourceManager::GetInstance()->GetResourceTexture(texturePath);
-	else m_specularMap = nullptr;
+	TResourceManager* manager = TResourceManager::GetInstance();
+	if(texturePath.compare("")==0) m_specularMap = nullptr;
+	else if(manager->GetAsyncLoading()) m_specularMap = manager->GetResourceTextureAsync(texturePath, nullptr, GetCurrentSpecularMap());
+	else m_specularMap = manager->GetResourceTexture(texturePath);
+}
+
+unsigned int TMesh::GetBoundsRevision(){
+	// Al subirse un mesh que se cargaba en segundo plano cambia de cubo a su caja real
+	if(m_mesh != nullptr && m_mesh->GetRevision() != m_meshRevision){
+		m_meshRevision = m_mesh->GetRevision();
+		m_boundsRevision++;
+	}
+	return m_boundsRevision;
 }
 
 void TMesh::SetBBVisibility(bool visible){
 	m_visibleBB = visible;
 }
 
+void TMesh::SetOccluder(bool occluder){
+	m_occluder = occluder;
+}
+
 void TMesh::BeginDraw(){
 	if(m_mesh != nullptr && !m_drawingShadows && CheckClipping()){	// Comprobamos que haya mesh, que no vayan a pintarse las sombras y que el objeto este dentro de la pantalla
 		unsigned int currentFrame = TEntity::currentFrame;			// Cargamos el frame en el que se ha pintado el mesh
 		if(currentFrame != m_frameDrawed){							//  
 			m_frameDrawed = currentFrame;							// En el caso de que sea diferente al del mesh lo actualizamos y pintamos
 
-			SendShaderData();										// Enviamos la informacion a los shaders
-			
-			GLuint elementsBuffer = m_mesh->GetElementBuffer();		// Cargamos y pintamos los elementos del mesh
-			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, elementsBuffer);
-			glDrawElements(GL_TRIANGLES, m_mesh->GetElementSize(), GL_UNSIGNED_INT, 0);
-
-			if(m_visibleBB) DrawBoundingBox();						// En el caso de que sea necesario pintamos el bounding box
+			TRenderQueue::GetInstance()->Push(this, GetSortKey(), true);	// Lo mandamos a la cola para pintarlo agrupado por estado
 		}
 	}
 }
 
+void TMesh::DrawQueued(){
+	SendShaderData(m_program);										// Enviamos la informacion a los shaders
+	glDrawElements(GL_TRIANGLES, m_mesh->GetElementSize(), GL_UNSIGNED_INT, 0);
+
+	if(m_visibleBB){
+		TRenderQueue::GetInstance()->ResetState();					// El bounding box enlaza sus propios buffers en el VAO por defecto
+		DrawBoundingBox();											// En el caso de que sea necesario pintamos el bounding box
+	}
+}
+
+bool TMesh::CanInstanceWith(TEntity* other){
+	TMesh* mesh = dynamic_cast<TMesh*>(other);
+	if(mesh == nullptr) return false;
+
+	// Solo el programa estandar tiene version instanciada y el bounding box se pinta por separado
+	if(m_program != STANDARD_SHADER || mesh->m_program != STANDARD_SHADER) return false;
+	if(m_visibleBB || mesh->m_visibleBB) return false;
+
+	// Todo lo que no sea la matriz mundo tiene que ser igual para compartir la llamada
+	return m_mesh == mesh->m_mesh
+		&& GetCurrentTexture() == mesh->GetCurrentTexture()
+		&& GetCurrentSpecularMap() == mesh->GetCurrentSpecularMap()
+		&& GetCurrentBumpMap() == mesh->GetCurrentBumpMap()
+		&& GetCurrentMaterial() == mesh->GetCurrentMaterial()
+		&& m_textureScaleX == mesh->m_textureScaleX
+		&& m_textureScaleY == mesh->m_textureScaleY;
+}
+
+void TMesh::DrawInstanced(std::vector<glm::mat4>* models){
+	TRenderQueue* queue = TRenderQueue::GetInstance();
+
+	SendShaderData(INSTANCED_SHADER);								// Enviamos todo menos las matrices del objeto
+	queue->BindInstances(models);									// Las matrices mundo van en el buffer de instancias
+	glDrawElementsInstanced(GL_TRIANGLES, m_mesh->GetElementSize(), GL_UNSIGNED_INT, 0, models->size());
+	queue->UnbindInstances();
+}
+
+TResourceTexture* TMesh::GetCurrentTexture(){
+	if(m_texture != nullptr) return m_texture;
+	return m_mesh->GetTexture();
+}
+
+TResourceTexture* TMesh::GetCurrentSpecularMap(){
+	if(m_specularMap != nullptr) return m_specularMap;
+	return m_mesh->GetSpecularMap();
+}
+
+TResourceTexture* TMesh::GetCurrentBumpMap(){
+	if(m_bumpMap != nullptr) return m_bumpMap;
+	return m_mesh->GetBumpMap();
+}
+
+TResourceMaterial* TMesh::GetCurrentMaterial(){
+	if(m_material != nullptr) return m_material;
+	return m_mesh->GetMaterial();
+}
+
+unsigned long long TMesh::GetSortKey(){
+	TResourceTexture* texture = GetCurrentTexture();
+	TResourceTexture* specularMap = GetCurrentSpecularMap();
+	TResourceTexture* bumpMap = GetCurrentBumpMap();
+	TResourceMaterial* material = GetCurrentMaterial();
+
+	unsigned int textures = TRenderQueue::MakeTextureSet(
+		texture != nullptr ? texture->GetTextureId() : 0,
+		specularMap != nullptr ? specularMap->GetTextureId() : 0,
+		bumpMap != nullptr ? bumpMap->GetTextureId() : 0);
+
+	return TRenderQueue::MakeKey(OPAQUE_LAYER, m_program, material, textures, m_mesh->GetElementBuffer());
+}
+
 void TMesh::EndDraw(){
 	m_drawingShadows = false;	
 }
@@ -75,153 +197,109 @@ void TMesh::DrawShadow(){
 	// Nos guardamos un puntero al programa para pintar sombras y enviamos las variables
 	Program* myProgram = VideoDriver::GetInstance()->SetShaderProgram(SHADOW_SHADER);
 
-	/// SEND THE VERTEX (1-Bind, 2-VertexAttribPointer)
-    GLuint vertexBuffer = m_mesh->GetVertexBuffer();
-	glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);									// Bind vertex buffer
-	
-	GLint posAttrib = glGetAttribLocation(myProgram->GetProgramID(), "Position");	// Get atrib location
-	glEnableVertexAttribArray(posAttrib);											// Enable pass
-	glVertexAttribPointer(posAttrib,3, GL_FLOAT, GL_FALSE, 0, (void*)0);  			// Pour buffer data to shader
+	/// BIND THE MESH VAO (Position shares location with VertexPosition)
+	TRenderQueue::GetInstance()->BindMesh(m_mesh);
 
 	/// SEND DEPTHMVP UNIFORM (UniformMatrix4)
-	glm::mat4 depthMVP = TEntity::DepthWVP * m_stack.top();
-	GLuint dMVPID = glGetUniformLocation(myProgram->GetProgramID(), "DepthMVP");	// Get uniform location
+	glm::mat4 depthMVP = TEntity::DepthWVP * ModelMatrix;
+	GLuint dMVPID = myProgram->GetUniformLocation(DEPTHMVP_UNIFORM);	// Get uniform location
 	glUniformMatrix4fv(dMVPID, 1, GL_FALSE, &depthMVP[0][0]);						// Send uniform
 
-	// Bind and draw elements depending
-	GLuint elementsBuffer = m_mesh->GetElementBuffer();
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, elementsBuffer);							// Bind elements buffer
+	// Draw the elements, the element buffer is already bound in the VAO
 	glDrawElements(GL_TRIANGLES, m_mesh->GetElementSize(), GL_UNSIGNED_INT, 0);		// Draw the elements (triangles)
 }
 
-void TMesh::SendShaderData(){
-	Program* myProgram = VideoDriver::GetInstance()->SetShaderProgram(m_program);
+void TMesh::SendShaderData(SHADERTYPE program){
+	Program* myProgram = VideoDriver::GetInstance()->SetShaderProgram(program);
+	TRenderQueue* queue = TRenderQueue::GetInstance();
 
 	// -------------------------------------------------------- ENVIAMOS EL TIME
 	float time = VideoDriver::GetInstance()->GetTime();
-	GLint timeLocation = glGetUniformLocation(myProgram->GetProgramID(), "frameTime");
+	GLint timeLocation = myProgram->GetUniformLocation(FRAMETIME_UNIFORM);
 	glUniform1f(timeLocation, time/1000); // EN SEGUNDOS
 
-    // -------------------------------------------------------- ENVIAMOS LOS VERTICES
-    // BIND VERTEX
-    GLuint vertexBuffer = m_mesh->GetVertexBuffer();
-	glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
-
-	// SEND VERTEX
-	GLint posAttrib = glGetAttribLocation(myProgram->GetProgramID(), "VertexPosition");
-	glEnableVertexAttribArray(posAttrib);
-	glVertexAttribPointer(posAttrib,3, GL_FLOAT, GL_FALSE, 0*sizeof(float), 0);
-
-	// -------------------------------------------------------- ENVIAMOS LAS UV
-	// BIND UV
-    GLuint uvBuffer = m_mesh->GetUvBuffer();
-	glBindBuffer(GL_ARRAY_BUFFER, uvBuffer);
-
-	// SEND UV
-	GLuint uvAttrib = glGetAttribLocation(myProgram->GetProgramID(), "TextureCoords");
-	glEnableVertexAttribArray(uvAttrib);
-	glVertexAttribPointer(uvAttrib, 2, GL_FLOAT, GL_FALSE, 0*sizeof(float), 0);
+	// -------------------------------------------------------- ENLAZAMOS EL MESH
+	// El VAO del mesh ya tiene los vertices, uvs, normales y elementos, solo se enlaza si cambia
+	queue->BindMesh(m_mesh);
 
 	// SEND UV SCALE
 	const glm::vec2 scaleA(m_textureScaleX,m_textureScaleY);
-	GLint uvScale = glGetUniformLocation(myProgram->GetProgramID(), "TextureScale");
+	GLint uvScale = myProgram->GetUniformLocation(TEXTURESCALE_UNIFORM);
 	glUniform2fv(uvScale,1,&scaleA[0]);
 
-	// -------------------------------------------------------- ENVIAMOS LAS NORMALS
-	// BIND NORMALS
-    GLuint normalBuffer = m_mesh->GetNormalBuffer();
-	glBindBuffer(GL_ARRAY_BUFFER, normalBuffer);
-
-	// SEND NORMALS
-	GLuint normAttrib = glGetAttribLocation(myProgram->GetProgramID(), "VertexNormal");
-	glEnableVertexAttribArray(normAttrib);
-	glVertexAttribPointer(normAttrib, 3, GL_FLOAT, GL_FALSE, 0*sizeof(float), 0);
-
 	// -------------------------------------------------------- ENVIAMOS LAS MATRICES
 	// SEND MODEL MATRIX
-	glm::mat4 model =  m_stack.top();
-	GLint mLocation = glGetUniformLocation(myProgram->GetProgramID(), "ModelMatrix");
+	glm::mat4 model =  ModelMatrix;
+	GLint mLocation = myProgram->GetUniformLocation(MODEL_UNIFORM);
 	glUniformMatrix4fv(mLocation, 1, GL_FALSE, &model[0][0]);
 
 	// SEND NORMAL MATRIX (ROTAMOS LAS NORMALES)
-	glm::mat3 normalMatrix = m_stack.top();
+	glm::mat3 normalMatrix = ModelMatrix;
 	normalMatrix = glm::transpose(glm::inverse(normalMatrix));
-	GLint normalMLocation = glGetUniformLocation(myProgram->GetProgramID(), "NormalMatrix");
+	GLint normalMLocation = myProgram->GetUniformLocation(NORMAL_UNIFORM);
 	glUniformMatrix3fv(normalMLocation, 1, GL_FALSE, &normalMatrix[0][0]);
 
 	// SEND VIEW MATRIX
-	GLint vLocation = glGetUniformLocation(myProgram->GetProgramID(), "ViewMatrix");
+	GLint vLocation = myProgram->GetUniformLocation(VIEW_UNIFORM);
 	glUniformMatrix4fv(vLocation, 1, GL_FALSE, &ViewMatrix[0][0]);
 
 	// SEND MODELVIEW MATRIX
-	glm::mat4 modelView = ViewMatrix * m_stack.top();
-	GLint mvLocation = glGetUniformLocation(myProgram->GetProgramID(), "ModelViewMatrix");
+	glm::mat4 modelView = ViewMatrix * ModelMatrix;
+	GLint mvLocation = myProgram->GetUniformLocation(MODELVIEW_UNIFORM);
 	glUniformMatrix4fv(mvLocation, 1, GL_FALSE, &modelView[0][0]);
 
 	// SEND PROJECTION MATRIX
 	glm::mat4 pMatrix = ProjMatrix;
-	GLint pLocation = glGetUniformLocation(myProgram->GetProgramID(), "ProjectionMatrix");
+	GLint pLocation = myProgram->GetUniformLocation(PROJECTION_UNIFORM);
 	glUniformMatrix4fv(pLocation, 1, GL_FALSE, &pMatrix[0][0]);
 
 	// SEND MODELVIEWPROJECTION MATRIX
 	glm::mat4 mvpMatrix = ProjMatrix * modelView;
-	GLint mvpLocation = glGetUniformLocation(myProgram->GetProgramID(), "MVP");
+	GLint mvpLocation = myProgram->GetUniformLocation(MVP_UNIFORM);
 	glUniformMatrix4fv(mvpLocation, 1, GL_FALSE, &mvpMatrix[0][0]);
 
 	// -------------------------------------------------------- ENVIAMOS LA TEXTURA
-	TResourceTexture* currentTexture = nullptr;
-	if(m_texture != nullptr) currentTexture = m_texture;
-	else if(m_mesh != nullptr) currentTexture = m_mesh->GetTexture();
+	TResourceTexture* currentTexture = GetCurrentTexture();
 
 	if(currentTexture != nullptr){
-		GLuint TextureID = glGetUniformLocation(myProgram->GetProgramID(), "uvMap");
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, currentTexture->GetTextureId());
+		GLuint TextureID = myProgram->GetUniformLocation(UVMAP_UNIFORM);
+		queue->BindTexture(0, currentTexture->GetTextureId());
 		glUniform1i(TextureID, 0); 
 	}
 
 	// -------------------------------------------------------- ENVIAMOS EL SPECULAR MAP
-	currentTexture = nullptr;
-	if(m_specularMap != nullptr) currentTexture = m_specularMap;
-	else if(m_mesh != nullptr) currentTexture = m_mesh->GetSpecularMap();
+	currentTexture = GetCurrentSpecularMap();
 
 	if(currentTexture != nullptr){
-		GLuint TextureID = glGetUniformLocation(myProgram->GetProgramID(), "specularMap");
-
-		glActiveTexture(GL_TEXTURE2);
-		glBindTexture(GL_TEXTURE_2D, currentTexture->GetTextureId());
+		GLuint TextureID = myProgram->GetUniformLocation(SPECULARMAP_UNIFORM);
+		queue->BindTexture(2, currentTexture->GetTextureId());
 		glUniform1i(TextureID, 2); 
 	}
 
 	// -------------------------------------------------------- ENVIAMOS EL BUMP MAP
-	currentTexture = nullptr;
-	if(m_bumpMap != nullptr) currentTexture = m_bumpMap;
-	else if(m_mesh != nullptr) currentTexture = m_mesh->GetBumpMap();
+	currentTexture = GetCurrentBumpMap();
 
 	if(currentTexture != nullptr){
-		GLuint TextureID = glGetUniformLocation(myProgram->GetProgramID(), "bumpMap");
-
-		glActiveTexture(GL_TEXTURE3);
-		glBindTexture(GL_TEXTURE_2D, currentTexture->GetTextureId());
+		GLuint TextureID = myProgram->GetUniformLocation(BUMPMAP_UNIFORM);
+		queue->BindTexture(3, currentTexture->GetTextureId());
 		glUniform1i(TextureID, 3); 
 	}
 
 	// -------------------------------------------------------- ENVIAMOS EL MATERIAL
-	TResourceMaterial* currentMaterial = nullptr;
-	if(m_material != nullptr) currentMaterial = m_material;
-	if(currentMaterial == nullptr) currentMaterial = m_mesh->GetMaterial();
+	TResourceMaterial* currentMaterial = GetCurrentMaterial();
 
-	if(currentMaterial != nullptr){
-		GLuint shininess = glGetUniformLocation(myProgram->GetProgramID(), "Material.Shininess");
+	// Los uniforms del material se quedan en el programa, solo los enviamos si cambian
+	if(currentMaterial != nullptr && queue->UseMaterial(program, currentMaterial)){
+		GLuint shininess = myProgram->GetUniformLocation(SHININESS_UNIFORM);
 		glUniform1f(shininess, currentMaterial->GetShininess());
 
-		GLuint diffuse = glGetUniformLocation(myProgram->GetProgramID(), "Material.Diffuse");
+		GLuint diffuse = myProgram->GetUniformLocation(DIFFUSE_UNIFORM);
 		glUniform3fv(diffuse, 1, &currentMaterial->GetColorDifuse()[0]);
 
-		GLuint specular = glGetUniformLocation(myProgram->GetProgramID(), "Material.Specular");
+		GLuint specular = myProgram->GetUniformLocation(SPECULAR_UNIFORM);
 		glUniform3fv(specular, 1, &currentMaterial->GetColorSpecular()[0]);
 
-		GLuint ambient = glGetUniformLocation(myProgram->GetProgramID(), "Material.Ambient");
+		GLuint ambient = myProgram->GetUniformLocation(AMBIENT_UNIFORM);
 		glUniform3fv(ambient, 1, &currentMaterial->GetColorAmbient()[0]);
 	}
 
@@ -261,16 +339,16 @@ void TMesh::DrawBoundingBox() {
 	glm::mat4 transform = glm::translate(glm::mat4(1.0f), m_mesh->GetCenter()) * glm::scale(glm::mat4(1), m_mesh->GetSize());
 
 	// Apply object's transformation matrix 
-	glm::mat4 m = ProjMatrix * ViewMatrix * m_stack.top() * transform;
-	GLuint uniform_m = glGetUniformLocation(myProgram->GetProgramID(), "MVP");
+	glm::mat4 m = ProjMatrix * ViewMatrix * ModelMatrix * transform;
+	GLuint uniform_m = myProgram->GetUniformLocation(MVP_UNIFORM);
 	glUniformMatrix4fv(uniform_m, 1, GL_FALSE, &m[0][0]);
 
 	// Send light color
-	GLuint linecolor = glGetUniformLocation(myProgram->GetProgramID(), "LineColor");
+	GLuint linecolor = myProgram->GetUniformLocation(LINECOLOR_UNIFORM);
 	glUniform3fv(linecolor, 1, glm::value_ptr(glm::vec3(0.3f, 0.7f, 1.0f)));
 
 	// Send each vertex data
-	GLuint attribute_v_coord = glGetAttribLocation(myProgram->GetProgramID(), "VertexPosition");	
+	GLuint attribute_v_coord = myProgram->GetAttribLocation(VERTEXPOSITION_ATTRIB);	
 	glBindBuffer(GL_ARRAY_BUFFER, vbo_vertices);
 	glEnableVertexAttribArray(attribute_v_coord);
 
@@ -301,97 +379,33 @@ void TMesh::SetTextureScale(float valueX, float valueY){
 	m_textureScaleY = valueY;
 }
 
-int TMesh::Sign(int v){
-	if(v>=0) return 1;
-	else return -1;
-}
-
 // http://www.lighthouse3d.com/tutorials/view-frustum-culling/geometric-approach-testing-boxes-ii/
-// Posible mejora para el clipping
 bool TMesh::CheckClipping(){
-	if(!m_checkClipping) return true;
-
-	bool output = true;
-	glm::vec3 center = m_mesh->GetCenter();		//
-	glm::vec3 size = m_mesh->GetSize();			// Cargamos el centro y el tamanyo del mesh
-
-	glm::mat4 mvpMatrix = ProjMatrix * ViewMatrix * m_stack.top();	// Calculamos la matriz MVP
-	// Comprobamos el cliping con los 8 puntos 
-
-	int upDown, leftRight, nearFar;
-	upDown = leftRight = nearFar  = 0;
-
-	for(int i=-1; i<=0; i++){
-		// +X -X
-		for(int j=-1; j<=0; j++){
-			// +Y -Y
-			for(int k=-1; k<=0; k++){
-				// +Z -Z
-				// Funcion que comprueba si los ocho lados del bounding box estan fuera de la pantalla
-				glm::vec3 point = center + glm::vec3(size.x/2.0f * Sign(i), size.y/2.0f * Sign(j), size.z/2.0f * Sign(k));
-				glm::vec4 mvpPoint = mvpMatrix * glm::vec4(point.x, point.y, point.z, 1.0f);
-
-				CheckClippingAreas(mvpPoint, &upDown, &leftRight, &nearFar);
-			}
-		}
-	}
+	if(!m_checkClipping || m_clippingChecked) return true;
 
-	// Comprobacion clipping
-	int sides = 8;
-	// En el caso de que alguna de las variables valga 8 o -8 significa que se sale por un lado
-	if(upDown == sides || upDown == -sides || leftRight == sides || leftRight == -sides || nearFar == sides){
-		output = false;
-	}
+	// Caja mundo del mesh contra los seis planos del frustum (limitado por los portales)
+	glm::vec3 min, max;
+	GetWorldBounds(ModelMatrix, &min, &max);
 
-	return output;
+	TFrustum frustum;
+	frustum.Update(ProjMatrix * ViewMatrix, m_clippingLimits);
+	return frustum.TestBox(min, max);
 }
 
-bool TMesh::CheckOcclusion(){
-	bool output = true;
-	glm::vec3 center = m_mesh->GetCenter();
-	glm::vec3 size = m_mesh->GetSize();
-
-	glm::mat4 mvpMatrix = ProjMatrix * ViewMatrix * m_stack.top();
-
-	TOEvector2di sizeWindow = VideoDriver::GetInstance()->GetWindowResolution();
-	int width = sizeWindow.X;
-	int height = sizeWindow.Y;
-
-	int raster, visible;
-	raster = visible = 0;
-
-	for(int i=-1; i<=0; i++){
-		// +X -X
-		for(int j=-1; j<=0; j++){
-			// +Y -Y
-			for(int k=-1; k<=0; k++){
-				// +Z -Z
-				glm::vec3 point = center + glm::vec3(size.x/2.0f * Sign(i), size.y/2.0f * Sign(j), size.z/2.0f * Sign(k));
-				glm::vec4 mvpPoint = mvpMatrix * glm::vec4(point.x, point.y, point.z, 1.0f);
-
-				glm::vec3 pixelRead(mvpPoint.x, mvpPoint.y, mvpPoint.z);
-				pixelRead = pixelRead / mvpPoint.w;
-				pixelRead.x = ((pixelRead.x + 1)/2) * width;
-				pixelRead.y = ((pixelRead.y + 1)/2) * height;
-				pixelRead.z = (pixelRead.z+1)/2;
-
-				float depthBuff = 0.0f;
-				glReadPixels(static_cast<GLint>(pixelRead.x), static_cast<GLint>(pixelRead.y), 1, 1, GL_DEPTH_COMPONENT, GL_FLOAT, &depthBuff);
-
-				if(pixelRead.x >= 0.0f && pixelRead.x <= width && pixelRead.y >= 0.0f && pixelRead.y <= height && mvpPoint.z > 0){
-				
-					if(depthBuff < pixelRead.z) raster++;
-				}else{
-					visible++;
-				}
-			}
-		}
-	}
+bool TMesh::GetWorldBounds(const glm::mat4& model, glm::vec3* min, glm::vec3* max){
+	if(m_mesh == nullptr) return false;
+	TransformBounds(model, m_mesh->GetCenter(), m_mesh->GetSize() / 2.0f, min, max);
+	return true;
+}
 
-	int sides = 8;
-	if(raster!=0 && raster == sides - visible){
-		output = false;
-	}
+bool TMesh::IsOccluder(){
+	return m_occluder && m_mesh != nullptr;
+}
+
+void TMesh::DrawOccluder(TOcclusionBuffer* buffer, const glm::mat4& model){
+	// El buffer se limpia una vez por frame, si otro portal ya lo ha rasterizado no se repite
+	if(m_frameOccluded == TEntity::currentFrame) return;
+	m_frameOccluded = TEntity::currentFrame;
 
-	return output;
+	buffer->RasterizeMesh(model, m_mesh->GetPositions(), m_mesh->GetIndices());
 }
\ No newline at end of file
@@ -23,6 +23,14 @@ public:
 	 * @param 	- texturePath - ruta a la textura que va a utilizar
 	 */
 	TMesh(std::string meshPath = "", std::string texturePath = "");
+
+	/**
+	 * @brief	- Constructor del mesh a partir de los ids de las rutas (p.e. los de TResourceManager::GetDefaultId)
+	 *
+	 * @param	- meshId - id de la ruta al mesh que va a mostrar
+	 * @param 	- textureId - id de la ruta a la textura que va a utilizar
+	 */
+	TMesh(TResourceId meshId, TResourceId textureId);
 	
 	/**
 	 * @brief	- Destructor virtual del mesh, las variables dinamicas que tiene el mesh
@@ -31,10 +39,28 @@ public:
 	virtual ~TMesh();
 
 	/**
-	 * @brief	- Metodo en el que se pinta el mesh enviando todos los datos a los shaders
+	 * @brief	- Metodo en el que se manda el mesh a la cola de pintado si es visible
 	 */
 	virtual void BeginDraw() override;
 
+	/**
+	 * @brief	- Pinta el mesh enviando todos los datos a los shaders, lo llama la cola de pintado
+	 */
+	virtual void DrawQueued() override;
+
+	/**
+	 * @brief	- Indica si el otro mesh puede pintarse en la misma llamada instanciada
+	 * 				Solo se instancian los meshes con el programa estandar y sin bounding box visible
+	 */
+	virtual bool CanInstanceWith(TEntity* other) override;
+
+	/**
+	 * @brief	- Pinta todas las instancias con una sola llamada a glDrawElementsInstanced
+	 *
+	 * @param 	- models - Matrices mundo de cada instancia
+	 */
+	virtual void DrawInstanced(std::vector<glm::mat4>* models) override;
+
 	/**
 	 * @brief	- Metodo de dejar de acabar de pintar el mesh, en este metodo se resetean las variables necesarias 
 	 */
@@ -47,18 +73,30 @@ public:
 
 	/**
 	 * @brief	- Cambia el mesh que se pinta
+	 * 				Con la carga en segundo plano activa se pinta el cubo hasta que se carga
 	 * 
 	 * @param	- meshPath - Ruta al mesh
 	 */
 	void LoadMesh(std::string meshPath = "");
 
+	/**
+	 * @brief	- Cambia el mesh que se pinta a partir del id de su ruta (p.e. los de TResourceManager::GetDefaultId)
+	 */
+	void LoadMesh(TResourceId meshId);
+
 	/**
 	 * @brief 	- Cambia la textura que utiliza el mesh
+	 * 				Con la carga en segundo plano activa se sigue mostrando la anterior hasta que se carga
 	 * 
 	 * @param 	- texturePath - Ruta a la textura
 	 */
 	void ChangeTexture(std::string texturePath = "");
 
+	/**
+	 * @brief 	- Cambia la textura que utiliza el mesh a partir del id de su ruta
+	 */
+	void ChangeTexture(TResourceId textureId);
+
 	/**
 	 * @brief 	- Cambia el mapa de especulares que utiliza el mesh
 	 * 
@@ -80,6 +118,14 @@ public:
 	 */
 	void SetBBVisibility(bool visible);
 
+	/**
+	 * @brief 	- Marca el mesh como oclusor, sus triangulos se rasterizan en la CPU para descartar
+	 * 				los objetos que tapa. Pensado para paredes y meshes estaticos grandes
+	 * 
+	 * @param 	- occluder - El mesh tapa a otros objetos
+	 */
+	void SetOccluder(bool occluder);
+
 	/**
 	 * @brief	- Cambia el escalado de la textura  
 	 * 
@@ -88,16 +134,24 @@ public:
 	 */
 	void SetTextureScale(float valueX, float valueY);
 
+	/**
+	 * @brief	- Devuelve la revision de la caja local, tambien cambia cuando acaba de cargarse el mesh en segundo plano
+	 */
+	virtual unsigned int GetBoundsRevision() override;
+
 protected:
 
 	unsigned int 		m_frameDrawed;	// m_frameDrawed - Ultimo frame en el que se ha pintado
-	TResourceMesh* 		m_mesh;			// m_mesh - Recurso de mesh a pintar
-	TResourceTexture* 	m_texture;		// m_texture - Recurso textura a utilizar
-	TResourceTexture*	m_specularMap;	// m_specularMap - Mapa de especulares a utilizar
-	TResourceTexture*	m_bumpMap;		// m_bumpMap - Mapa de normales a utilizar
-	TResourceMaterial* 	m_material;		// m_material - Material del mesh
+	unsigned int 		m_frameOccluded;	// m_frameOccluded - Ultimo frame en el que se ha rasterizado en el buffer de oclusion
+	TResourceHandle<TResourceMesh> 		m_mesh;			// m_mesh - Recurso de mesh a pintar
+	TResourceHandle<TResourceTexture> 	m_texture;		// m_texture - Recurso textura a utilizar
+	TResourceHandle<TResourceTexture>	m_specularMap;	// m_specularMap - Mapa de especulares a utilizar
+	TResourceHandle<TResourceTexture>	m_bumpMap;		// m_bumpMap - Mapa de normales a utilizar
+	TResourceHandle<TResourceMaterial> 	m_material;		// m_material - Material del mesh
+	unsigned int		m_meshRevision;	// m_meshRevision - Revision del recurso mesh con la que se calculo la caja
 
 	bool m_visibleBB;
+	bool m_occluder;		// m_occluder - El mesh se rasteriza en el buffer de oclusion
 	bool m_drawingShadows;
 
 	float m_textureScaleX;
@@ -106,8 +160,25 @@ protected:
 	/**
 	 * @brief	- Envia a los shaders toda la informacion necesaria 
 	 * 
+	 * @param 	- program - Programa al que se envia la informacion
 	*/
-	void SendShaderData();
+	void SendShaderData(SHADERTYPE program);
+
+	/**
+	 * @brief	- Devuelven los recursos con los que se pinta, los del mesh si no se han cambiado
+	 */
+	TResourceTexture* GetCurrentTexture();
+	TResourceTexture* GetCurrentSpecularMap();
+	TResourceTexture* GetCurrentBumpMap();
+	TResourceMaterial* GetCurrentMaterial();
+
+	/**
+	 * @brief	- Calcula la clave con la que se ordena el mesh en la cola de pintado
+	 * 				a partir de su programa, material, texturas, buffers y profundidad
+	 * 
+	 * @return 	- unsigned long long - Clave de ordenacion
+	 */
+	unsigned long long GetSortKey();
 
 	/**
 	 * @brief	- Dibuja el bounding box del mesh 
@@ -116,31 +187,28 @@ protected:
 	void DrawBoundingBox();	
 
 	/**
-	 * @brief	- Comprueba si los 8 puntos del bounding box del objeo se encuentran dentro de la pantalla
+	 * @brief	- Comprueba la caja mundo del mesh contra los planos del frustum
 	 *				para sabe si puede dejar de pintarse o no   
 	 * 
 	 * @return 	- bool - True: Se encuentra dentro de la pantall
 	 * @return 	- bool - False: Esta fuera de la pantalla 
 	 */
 	virtual	bool CheckClipping() override;
+
+	/**
+	 * @brief	- Transforma el bounding box del mesh a una caja en coordenadas mundo
+	 */
+	virtual bool GetWorldBounds(const glm::mat4& model, glm::vec3* min, glm::vec3* max) override;
 	
 	/**
-	 * @brief 	- Comprueba si un objeto esta ocluido por otro para poder dejar de pintarlo
-	 * 
-	 * @return 	- bool - True: El objeto es visible
-	 * @return 	- bool - False: El objeto esta ocluido
+	 * @brief	- Indica si el mesh esta marcado como oclusor
 	 */
-	virtual	bool CheckOcclusion();
+	virtual bool IsOccluder() override;
 
-private:
 	/**
-	 * @brief	- Devuelve el signo del valor pasado por parametros 
-	 * 				Los valores mayores o igual a 0 devolveran un 1, mientras que los demas un -1
-	 * 
-	 * @param 	- value - Valor del que sacar el signo
-	 * @return 	- int - Signo del valor
+	 * @brief	- Rasteriza los triangulos del mesh en el buffer de oclusion
 	 */
-	int Sign(int value);
+	virtual void DrawOccluder(TOcclusionBuffer* buffer, const glm::mat4& model) override;
 };
 
 #endif
\ No newline at end of file
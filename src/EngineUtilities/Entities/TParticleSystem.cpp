@@ -1,11 +1,19 @@
 #include "./TParticleSystem.h"
 #include "../TOcularEngine/VideoDriver.h"
 #include "./../TResourceManager.h"
+#include "./../TRenderQueue.h"
+#include "./../TJobPool.h"
+#include "./../TParticlePool.h"
+#include "./../TStreamBuffer.h"
+#include "./../TOcularEngine/Elements/Particles/BatchParticleManager.h"
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <glm/gtx/norm.hpp>
 #include <GL/glew.h>
 #include <algorithm>
+#include <limits>
+#include <cstring>
+#include <functional>
 
 // Mesh que van a compartir todas las particulas
 static const GLfloat g_vertex_buffer_data[] = {
@@ -17,55 +25,50 @@ static const GLfloat g_vertex_buffer_data[] = {
 
 TParticleSystem::~TParticleSystem(){
 	delete m_manager;					// Eliminamos el manager del sistema de particulas
+	TParticlePool::GetInstance()->Free(m_memory, m_memorySize);	// Devolvemos la memoria de las particulas
 
 	glBindBuffer(GL_ARRAY_BUFFER, 0);   //
-    glDeleteBuffers(1, &m_vbo);			//
-    									//
-    glBindBuffer(GL_ARRAY_BUFFER, 0);   //
-    glDeleteBuffers(1, &m_pbo);			//
-    									//
-    glBindBuffer(GL_ARRAY_BUFFER, 0);   //
-    glDeleteBuffers(1, &m_cbo);			//
-    									//
-    glBindBuffer(GL_ARRAY_BUFFER, 0);   //
-    glDeleteBuffers(1, &m_ebo);			// Vaciamos y eliminamos los buffers
-}
-
-TParticleSystem::TParticleSystem(std::string path){
+    glDeleteBuffers(1, &m_vbo);			// Vaciamos y eliminamos el buffer del mesh
+}
+
+TParticleSystem::TParticleSystem(std::string path, int capacity){
 	// Inicializamos las variables
 	m_drawingShadows = false;
 	m_newParticlesPerSecond = 100;
 	m_particleAcumulation = 0;
 
 	//Inicializamos el manager de particulas y las particulas
-	m_manager = new ParticleManager();
+	m_manager = new BatchParticleManager();
+	m_particleCount = 0;
+	m_capacity = capacity;
+	if(m_capacity < 0) m_capacity = 0;
+	m_fullPolicy = PARTICLE_RECYCLE;
+	m_deltaTime = 0.0f;
+
+	// No se coge memoria hasta que se crean las primeras particulas
+	m_allocated = 0;
+	m_memory = nullptr;
+	m_memorySize = 0;
+	m_particlesColorData = nullptr;
+	m_particlePositionData = nullptr;
+	m_particlesExtra = nullptr;
+	m_dead = nullptr;
 
 	// Cargamos en el vertex buffer el mesh que vamos a utilizar
 	glGenBuffers(1, &m_vbo);
 	glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
 	glBufferData(GL_ARRAY_BUFFER, sizeof(g_vertex_buffer_data), g_vertex_buffer_data, GL_STATIC_DRAW);
 
-	// Preparamos el buffer que se utilizara para las posiciones de las particulas
-	// Inicializamos el buffer vacio, se rellenara a cada frame con las nuevas posiciones
-	glGenBuffers(1, &m_pbo);
-	glBindBuffer(GL_ARRAY_BUFFER, m_pbo);
-	glBufferData(GL_ARRAY_BUFFER, m_maxParticles * 3 * sizeof(GLfloat), NULL, GL_STREAM_DRAW);
-
-	// Preparamos el buffer que se utiizara para los colores de las particulas
-	// Inicializamos el buffer vacio, se rellenara a cada frame con las nuevas posiciones
-	glGenBuffers(1, &m_cbo);
-	glBindBuffer(GL_ARRAY_BUFFER, m_cbo);
-	glBufferData(GL_ARRAY_BUFFER, m_maxParticles * 3 * sizeof(GLubyte), NULL, GL_STREAM_DRAW);
-
-	// Preparamos el buffer que se utilizara para los extras de las particulas
-	// Inicializamos el buffer vacio, se rellenara a cada frame con las nuevas posiciones
-	glGenBuffers(1, &m_ebo);
-	glBindBuffer(GL_ARRAY_BUFFER, m_ebo);
-	glBufferData(GL_ARRAY_BUFFER, m_maxParticles * 2 * sizeof(GLfloat), NULL, GL_STREAM_DRAW);
+	// Las posiciones, colores y extras de las particulas se escriben cada frame en el TStreamBuffer
+	m_positionOffset = 0;
+	m_colorOffset = 0;
+	m_extraOffset = 0;
+	m_streamRevision = 0;
+	m_streamDirty = true;
 
 	m_program = PARTICLE_SHADER;
-	m_particleCount = 0;
-	m_lastUsedParticle = 0;
+	m_boundsMin = glm::vec3(0.0f);
+	m_boundsMax = glm::vec3(0.0f);
 
 	// Cargamos la textura
 	SetTexture(path);
@@ -80,18 +83,50 @@ int TParticleSystem::GetNewPerSecond(){
 	return m_newParticlesPerSecond;
 }
 
+void TParticleSystem::SetFullPolicy(PARTICLEFULLPOLICY policy){
+	m_fullPolicy = policy;
+}
+
+PARTICLEFULLPOLICY TParticleSystem::GetFullPolicy(){
+	return m_fullPolicy;
+}
+
+int TParticleSystem::GetParticleCount(){
+	return m_particleCount;
+}
+
+int TParticleSystem::GetCapacity(){
+	return m_capacity;
+}
+
 void TParticleSystem::BeginDraw(){
 	if(!m_drawingShadows){
-		SendShaderData();	// Enviamos la informacion al shader y pintamos las particulas
-		glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, m_particleCount);
-		ResetShaderData();	// Reseteamos las variables del shader
+		// Las particulas se pintan con transparencia, de detras hacia delante
+		unsigned int textureId = 0;
+		if(m_texture != nullptr) textureId = m_texture->GetTextureId();
+		unsigned long long key = TRenderQueue::MakeKey(TRANSPARENT_LAYER, m_program, nullptr, TRenderQueue::MakeTextureSet(textureId), m_vbo);
+		TRenderQueue::GetInstance()->Push(this, key);
 	}
 }
 
+void TParticleSystem::DrawQueued(){
+	UploadParticles();	// Subimos las particulas del ultimo update si no estan ya en el buffer de este frame
+	SendShaderData();	// Enviamos la informacion al shader y pintamos las particulas
+	glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, m_particleCount);
+	ResetShaderData();	// Reseteamos las variables del shader
+}
+
 void TParticleSystem::DrawShadow(){
 	m_drawingShadows = true;
 }
 
+bool TParticleSystem::GetWorldBounds(const glm::mat4& model, glm::vec3* min, glm::vec3* max){
+	glm::vec3 position(model[3][0], model[3][1], model[3][2]);
+	*min = position + m_boundsMin;
+	*max = position + m_boundsMax;
+	return true;
+}
+
 void TParticleSystem::EndDraw(){
 	m_drawingShadows = false;	
 }
@@ -102,15 +137,15 @@ void TParticleSystem::ResetShaderData(){
 	GLuint idProgram = myProgram->GetProgramID();
 
 	// Enviamos los centros de las particulas
-	GLint indexAttrib = glGetAttribLocation(idProgram, "ParticleCenter");
+	GLint indexAttrib = myProgram->GetAttribLocation(PARTICLECENTER_ATTRIB);
 	glVertexAttribDivisor(indexAttrib, 0);
 
 	// Enviamos los colores de las particulas
-	indexAttrib = glGetAttribLocation(idProgram, "ParticleColor");
+	indexAttrib = myProgram->GetAttribLocation(PARTICLECOLOR_ATTRIB);
 	glVertexAttribDivisor(indexAttrib, 0);
 
 	// Enviamos las variables extra de las particulas
-	indexAttrib = glGetAttribLocation(idProgram, "ParticleExtra");
+	indexAttrib = myProgram->GetAttribLocation(PARTICLEEXTRA_ATTRIB);
 	glVertexAttribDivisor(indexAttrib, 0);
 }
 
@@ -122,7 +157,7 @@ void TParticleSystem::SendShaderData(){
 		// Calculamos la matriz MVP
 
 		// PRIMERO DE TODO QUITAMOS LA ROTACION DE LA MATRIZ DE LA PILA
-		glm::mat4 m_matrix = m_stack.top();
+		glm::mat4 m_matrix = ModelMatrix;
 
 		glm::mat4 translation(1.0f);
 		translation[3][0] = m_matrix[3][0];
@@ -133,7 +168,7 @@ void TParticleSystem::SendShaderData(){
 		glm::mat4 mvpMatrix = ProjMatrix * modelView;
 
 		// SEND THE MATRIX
-		GLint indexAttrib = glGetUniformLocation(idProgram, "MVP");
+		GLint indexAttrib = myProgram->GetUniformLocation(MVP_UNIFORM);
 		glUniformMatrix4fv(indexAttrib, 1, GL_FALSE, &mvpMatrix[0][0]);
 
 		glm::mat3 m_view = ViewMatrix;
@@ -146,12 +181,12 @@ void TParticleSystem::SendShaderData(){
 		rotation[3] = glm::vec4(0,0,0,1);
 
 
-		indexAttrib = glGetUniformLocation(idProgram, "MRot");
+		indexAttrib = myProgram->GetUniformLocation(MROT_UNIFORM);
 		glUniformMatrix4fv(indexAttrib, 1, GL_FALSE, &rotation[0][0]);
 
 	// Enviamos los vertex basicos
 		// Le decimos al shader que el atributo solamente se va a pasar una vez
-		indexAttrib = glGetAttribLocation(idProgram, "VertexPosition");
+		indexAttrib = myProgram->GetAttribLocation(VERTEXPOSITION_ATTRIB);
 
 		glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
 		glVertexAttribPointer(indexAttrib, 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
@@ -161,36 +196,34 @@ void TParticleSystem::SendShaderData(){
 
 	// Enviamos el centro de las particulas
 		// Le decimos al shader que el atributo se le va a pasar una vez por particula
-		indexAttrib = glGetAttribLocation(idProgram, "ParticleCenter");
+		indexAttrib = myProgram->GetAttribLocation(PARTICLECENTER_ATTRIB);
 
-		glBindBuffer(GL_ARRAY_BUFFER, m_pbo);
-		glVertexAttribPointer(indexAttrib, 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
+		glBindBuffer(GL_ARRAY_BUFFER, TStreamBuffer::GetInstance()->GetBuffer());
+		glVertexAttribPointer(indexAttrib, 3, GL_FLOAT, GL_FALSE, 0, (void*)m_positionOffset);
 
 		glVertexAttribDivisor(indexAttrib, 1);
 		glEnableVertexAttribArray(indexAttrib);
 
 	// Enviamos el color de las particulas
 		// Le decimos al shader que el atributo se le va a pasar una vez por particula
-		indexAttrib = glGetAttribLocation(idProgram, "ParticleColor");
+		indexAttrib = myProgram->GetAttribLocation(PARTICLECOLOR_ATTRIB);
 
-		glBindBuffer(GL_ARRAY_BUFFER, m_cbo);
-		glVertexAttribPointer(indexAttrib, 3, GL_UNSIGNED_BYTE, GL_TRUE, 0, (void*)0);
+		glVertexAttribPointer(indexAttrib, 3, GL_UNSIGNED_BYTE, GL_TRUE, 0, (void*)m_colorOffset);
 
 		glVertexAttribDivisor(indexAttrib, 1);
 		glEnableVertexAttribArray(indexAttrib);
 
 	// Enviamos los extras de las particulas
 		// Le decimos al shader que el atributo se le va a pasar una vez por particula
-		indexAttrib = glGetAttribLocation(idProgram, "ParticleExtra");
+		indexAttrib = myProgram->GetAttribLocation(PARTICLEEXTRA_ATTRIB);
 
-		glBindBuffer(GL_ARRAY_BUFFER, m_ebo);
-		glVertexAttribPointer(indexAttrib, 2, GL_FLOAT, GL_FALSE, 0, (void*)0);
+		glVertexAttribPointer(indexAttrib, 2, GL_FLOAT, GL_FALSE, 0, (void*)m_extraOffset);
 
 		glVertexAttribDivisor(indexAttrib, 1);
 		glEnableVertexAttribArray(indexAttrib);
 
 	if(m_texture != nullptr){
-		GLuint TextureID = glGetUniformLocation(idProgram, "uvMap");
+		GLuint TextureID = myProgram->GetUniformLocation(UVMAP_UNIFORM);
 		glUniform1i(TextureID, 0);
 
 		glActiveTexture(GL_TEXTURE0);
@@ -200,115 +233,308 @@ void TParticleSystem::SendShaderData(){
 
 void TParticleSystem::AddNewParticles(float deltaTime){
 	// Calculamos el numero de nuevas particulas a generar
+	// Lo que sobra de una particula se guarda para el siguiente frame
 	float newParticle = m_newParticlesPerSecond * deltaTime;
 	newParticle += m_particleAcumulation;
-	
-	// Vamos generando una a una las particulas hasta que nos quede un valor menor de 0
-	// Este valor se guardara para el siguiente frame
-	while(newParticle >= 1){
-		int pos = FindUnusedParticle();						// Busca en que posicion anyadir la nueva particula
-		m_manager->InitParticle(m_particleContainer[pos]);	// Inicializamos esta particula
-		newParticle--;
+	int count = (int)newParticle;
+	m_particleAcumulation = newParticle - count;
+	if(count <= 0) return;
+
+	// Si no caben aplicamos la politica del sistema
+	if(m_particleCount + count > m_capacity){
+		if(m_fullPolicy == PARTICLE_GROW){
+			int capacity = std::max(m_capacity, 1);
+			while(capacity < m_particleCount + count) capacity *= 2;
+			SetCapacity(capacity);
+		}
+		else if(m_fullPolicy == PARTICLE_RECYCLE){
+			count = std::min(count, m_capacity);
+			RecycleParticles(m_particleCount + count - m_capacity);
+		}
+		else count = m_capacity - m_particleCount;
 	}
 
-	m_particleAcumulation = newParticle;	
+	// Las nuevas van detras de las vivas, se inicializan todas de golpe
+	if(count <= 0) return;
+	Reserve(m_particleCount + count);
+	m_manager->InitParticles(&m_particles, m_particleCount, count);
+	m_particleCount += count;
+}
+
+void TParticleSystem::RecycleParticles(int count){
+	if(count <= 0) return;
+
+	// Ordenamos solo lo justo para separar las que menos vida tienen (en caso de empate la de menor posicion)
+	const float* life = m_particles.life;
+	int* order = m_dead;
+	for(int i=0; i<m_particleCount; i++) order[i] = i;
+	std::nth_element(order, order + (count - 1), order + m_particleCount, [life](int a, int b){
+		if(life[a] != life[b]) return life[a] < life[b];
+		return a < b;
+	});
+
+	// Se quitan de mayor a menor para que mover la ultima no afecte a las que faltan
+	std::sort(order, order + count, std::greater<int>());
+	RemoveParticles(order, count);
+}
+
+void TParticleSystem::RemoveParticles(const int* dead, int count){
+	for(int i=0; i<count; i++){
+		m_particleCount--;
+		if(dead[i] != m_particleCount) m_particles.Move(m_particleCount, dead[i]);
+		m_particles.life[m_particleCount] = -1.0f;
+	}
+}
+
+void TParticleSystem::SetCapacity(int capacity){
+	if(capacity < 0) capacity = 0;
+	m_capacity = capacity;
+
+	// Las que no caben se quitan y la memoria que sobra vuelve al pool
+	if(m_particleCount > capacity) m_particleCount = capacity;
+	if(m_allocated > capacity) Allocate(capacity);
+}
+
+void TParticleSystem::Reserve(int count){
+	if(count <= m_allocated) return;
+
+	// Se dobla para que crecer cueste poco repartido entre frames, sin pasar de la capacidad
+	int allocated = m_allocated;
+	if(allocated < m_minAllocated) allocated = m_minAllocated;
+	while(allocated < count) allocated *= 2;
+	if(allocated > m_capacity) allocated = m_capacity;
+	Allocate(allocated);
+}
+
+void TParticleSystem::Allocate(int count){
+	TParticlePool* pool = TParticlePool::GetInstance();
+	unsigned char* oldMemory = m_memory;
+	unsigned long long oldSize = m_memorySize;
+	TParticleArray oldParticles = m_particles;
+
+	// Un solo bloque: las particulas, los arrays de subida y las muertas de cada trozo
+	unsigned long long particleBytes = TParticleArray::GetBytes(count);
+	unsigned long long positionBytes = count * 3 * sizeof(float);
+	unsigned long long extraBytes = count * 2 * sizeof(float);
+	unsigned long long colorBytes = count * 3 * sizeof(unsigned char);
+	unsigned long long deadBytes = count * sizeof(int);
+	m_memory = nullptr;
+	m_memorySize = 0;
+	if(count > 0) m_memory = pool->Allocate(particleBytes + positionBytes + extraBytes + deadBytes + colorBytes, &m_memorySize);
+
+	unsigned char* memory = m_memory;
+	m_particles.Place(memory, count);
+	if(memory != nullptr) memory += particleBytes;
+	m_particlePositionData = (float*)memory;
+	if(memory != nullptr) memory += positionBytes;
+	m_particlesExtra = (float*)memory;
+	if(memory != nullptr) memory += extraBytes;
+	m_dead = (int*)memory;
+	if(memory != nullptr) memory += deadBytes;
+	m_particlesColorData = memory;
+
+	// Las vivas pasan al bloque nuevo y el resto empiezan muertas
+	m_particles.Copy(oldParticles, m_particleCount);
+	m_particles.Clear(m_particleCount, count - m_particleCount);
+	m_allocated = count;
+	pool->Free(oldMemory, oldSize);
 }
 
 void TParticleSystem::Update(float deltaTime){
-	// Anyadimos las particulas nuevas
-	AddNewParticles(deltaTime);
+	int chunks = BeginUpdate(deltaTime);
+	if(IsThreadSafe()) TJobPool::GetInstance()->Run(chunks, [this](int chunk){ UpdateChunk(chunk); });
+	else for(int i=0; i<chunks; i++) UpdateChunk(i);
+	EndUpdate();
+}
 
-	m_particleCount = 0;
-	// Actualizamos las particulas
-	for(int i=0; i<m_maxParticles; i++){
+bool TParticleSystem::IsThreadSafe(){
+	return m_manager->IsThreadSafe();
+}
 
-	    Particle& p = m_particleContainer[i]; // shortcut
+int TParticleSystem::BeginUpdate(float deltaTime){
+	// Anyadimos las particulas nuevas
+	AddNewParticles(deltaTime);
+	m_deltaTime = deltaTime;
 
-	    // COmprobamos que la particula este viva
-	    if(p.life > 0.0f){
+	// Solo se actualizan las vivas, que estan al principio
+	m_chunks.resize((m_particleCount + m_chunkSize - 1) / m_chunkSize);
+	return m_chunks.size();
+}
 
-	        // Decrementamos su nivel de vida
-	        p.life -= deltaTime;
-	        if (p.life > 0.0f){
+void TParticleSystem::UpdateChunk(int chunk){
+	int first = chunk * m_chunkSize;
+	int count = m_particleCount - first;
+	if(count > m_chunkSize) count = m_chunkSize;
 
-	        	// Enviamos la particula al manager para que este la actualice
-	        	m_manager->UpdateParticle(p, deltaTime);
+	// Decrementamos la vida de todas, las que llegan a 0 se quitan en EndUpdate
+	float* life = m_particles.life + first;
+	for(int i=0; i<count; i++) life[i] -= m_deltaTime;
 
-	            // Rellenamos los arrays de posicion, color y variables extras
-	            m_particlePositionData[3*m_particleCount+0] = p.pos.X + p.translation.X;
-	            m_particlePositionData[3*m_particleCount+1] = p.pos.Y + p.translation.Y;
-	            m_particlePositionData[3*m_particleCount+2] = p.pos.Z + p.translation.Z;
-	            
-	            m_particlesColorData[3*m_particleCount+0] = p.r;
-	            m_particlesColorData[3*m_particleCount+1] = p.g;
-	            m_particlesColorData[3*m_particleCount+2] = p.b;
+	// El manager actualiza todas las particulas del trozo de golpe
+	m_manager->UpdateParticles(&m_particles, first, count, m_deltaTime);
 
-	            m_particlesExtra[2*m_particleCount+0] = p.size;
-	            m_particlesExtra[2*m_particleCount+1] = p.rotation;
+	// Rellenamos los arrays de posicion, color y variables extras con las vivas
+	PackParticles(chunk);
+}
 
-	            m_particleCount++;
+void TParticleSystem::EndUpdate(){
+	// Juntamos las vivas de cada trozo al principio de los arrays, siempre en el mismo orden
+	float* positions = m_particlePositionData;
+	unsigned char* colors = m_particlesColorData;
+	float* extras = m_particlesExtra;
+	int count = 0;
+	glm::vec3 boundsMin(std::numeric_limits<float>::max());
+	glm::vec3 boundsMax(-std::numeric_limits<float>::max());
+
+	int size = m_chunks.size();
+	for(int i=0; i<size; i++){
+		const TParticleChunk& chunk = m_chunks[i];
+		if(chunk.count == 0) continue;
+
+		int first = i * m_chunkSize;
+		if(first != count){
+			memmove(positions + 3*count, positions + 3*first, chunk.count * 3 * sizeof(float));
+			memmove(colors + 3*count, colors + 3*first, chunk.count * 3 * sizeof(unsigned char));
+			memmove(extras + 2*count, extras + 2*first, chunk.count * 2 * sizeof(float));
+		}
+		count += chunk.count;
+		boundsMin = glm::min(boundsMin, chunk.min);
+		boundsMax = glm::max(boundsMax, chunk.max);
+	}
 
-	        }
-	    }
+	// Quitamos las muertas de mayor a menor, cada trozo tiene las suyas ordenadas de menor a mayor
+	for(int i=size-1; i>=0; i--){
+		const TParticleChunk& chunk = m_chunks[i];
+		for(int j=chunk.dead-1; j>=0; j--) RemoveParticles(&m_dead[i * m_chunkSize + j], 1);
 	}
 
-	// Una vez los arrays estan llenos utilizamos sus valores para rellenar los buffers
-	glBindBuffer(GL_ARRAY_BUFFER, m_pbo);
-	glBufferData(GL_ARRAY_BUFFER, m_maxParticles * 3 * sizeof(GLfloat), NULL, GL_STREAM_DRAW); // Buffer orphaning, a common way to improve streaming perf. See above link for details.
-	glBufferSubData(GL_ARRAY_BUFFER, 0, m_particleCount * sizeof(GLfloat) * 3, m_particlePositionData);
+	// Guardamos la caja de las particulas vivas para el frustum culling
+	if(m_particleCount > 0){
+		m_boundsMin = boundsMin;
+		m_boundsMax = boundsMax;
+	}
+	else{
+		m_boundsMin = glm::vec3(0.0f);
+		m_boundsMax = glm::vec3(0.0f);
+	}
+	m_boundsRevision++;
 
-	glBindBuffer(GL_ARRAY_BUFFER, m_cbo);
-	glBufferData(GL_ARRAY_BUFFER, m_maxParticles * 3 * sizeof(GLubyte), NULL, GL_STREAM_DRAW); // Buffer orphaning, a common way to improve streaming perf. See above link for details.
-	glBufferSubData(GL_ARRAY_BUFFER, 0, m_particleCount * sizeof(GLubyte) * 3, m_particlesColorData);
+	// Los arrays cambian, se suben otra vez al pintar
+	m_streamDirty = true;
+}
 
-	glBindBuffer(GL_ARRAY_BUFFER, m_ebo);
-	glBufferData(GL_ARRAY_BUFFER, m_maxParticles * 2 * sizeof(GLfloat), NULL, GL_STREAM_DRAW);
-	glBufferSubData(GL_ARRAY_BUFFER, 0, m_particleCount * sizeof(GLfloat) * 2, m_particlesExtra);
+void TParticleSystem::UploadParticles(){
+	TStreamBuffer* stream = TStreamBuffer::GetInstance();
+	if(!m_streamDirty && m_streamRevision == stream->GetRevision()) return;
+
+	// Solo las vivas, que estan juntas al principio de los arrays
+	// Las tres partes van en un solo Map para que esten en la misma vuelta del buffer
+	GLsizeiptr positionBytes = m_particleCount * 3 * sizeof(GLfloat);
+	GLsizeiptr extraBytes = m_particleCount * 2 * sizeof(GLfloat);
+	GLsizeiptr colorBytes = m_particleCount * 3 * sizeof(GLubyte);
+	GLintptr offset = 0;
+	unsigned char* memory = (unsigned char*)stream->Map(positionBytes + extraBytes + colorBytes, &offset);
+	if(m_particleCount > 0){
+		memcpy(memory, m_particlePositionData, positionBytes);
+		memcpy(memory + positionBytes, m_particlesExtra, extraBytes);
+		memcpy(memory + positionBytes + extraBytes, m_particlesColorData, colorBytes);
+	}
+	stream->Unmap();
 
+	m_positionOffset = offset;
+	m_extraOffset = offset + positionBytes;
+	m_colorOffset = offset + positionBytes + extraBytes;
+	m_streamRevision = stream->GetRevision();
+	m_streamDirty = false;
 }
 
-int TParticleSystem::FindUnusedParticle(){
-	// Para hacerlo mas eficiento empezamos a buscar desde la ultima particula actualizada
-	for(int i=m_lastUsedParticle; i<m_maxParticles; i++){
-		if(m_particleContainer[i].life < 0.0f){
-			m_lastUsedParticle = i;
-			return i;
-		}
+void TParticleSystem::PackParticles(int chunk){
+	int first = chunk * m_chunkSize;
+	int last = first + m_chunkSize;
+	if(last > m_particleCount) last = m_particleCount;
+
+	const float* posX = m_particles.posX;
+	const float* posY = m_particles.posY;
+	const float* posZ = m_particles.posZ;
+	const float* translationX = m_particles.translationX;
+	const float* translationY = m_particles.translationY;
+	const float* translationZ = m_particles.translationZ;
+	const unsigned char* r = m_particles.r;
+	const unsigned char* g = m_particles.g;
+	const unsigned char* b = m_particles.b;
+	const float* size = m_particles.size;
+	const float* rotation = m_particles.rotation;
+	const float* life = m_particles.life;
+	float* positions = m_particlePositionData;
+	unsigned char* colors = m_particlesColorData;
+	float* extras = m_particlesExtra;
+	int* dead = m_dead;
+
+	// Cada particula se escribe en la siguiente posicion libre del trozo y solo se avanza si esta viva
+	// Las que mueren se apuntan igual en m_dead. Como count <= i nunca se sale de la parte del trozo
+	int count = first;
+	int deadCount = first;
+	for(int i=first; i<last; i++){
+		positions[3*count+0] = posX[i] + translationX[i];
+		positions[3*count+1] = posY[i] + translationY[i];
+		positions[3*count+2] = posZ[i] + translationZ[i];
+
+		colors[3*count+0] = r[i];
+		colors[3*count+1] = g[i];
+		colors[3*count+2] = b[i];
+
+		extras[2*count+0] = size[i];
+		extras[2*count+1] = rotation[i];
+
+		dead[deadCount] = i;
+
+		bool alive = life[i] > 0.0f;
+		count += alive;
+		deadCount += !alive;
 	}
 
-	// En el caso de llegar hasta el final y no encontrar ninguna, probamos desde el inicio hasta el ultimo pillado
-	for(int i=0; i<m_lastUsedParticle; i++){
-		if(m_particleContainer[i].life < 0.0f){
-			m_lastUsedParticle = i;
-			return i;
-		}
+	// Caja de las particulas vivas del trozo, el quad puede girar asi que usamos su tamanyo entero
+	float minX = std::numeric_limits<float>::max(), minY = minX, minZ = minX;
+	float maxX = -minX, maxY = -minX, maxZ = -minX;
+	for(int i=first; i<count; i++){
+		float extent = extras[2*i];
+		minX = std::min(minX, positions[3*i+0] - extent);
+		minY = std::min(minY, positions[3*i+1] - extent);
+		minZ = std::min(minZ, positions[3*i+2] - extent);
+		maxX = std::max(maxX, positions[3*i+0] + extent);
+		maxY = std::max(maxY, positions[3*i+1] + extent);
+		maxZ = std::max(maxZ, positions[3*i+2] + extent);
 	}
 
-	// En el caso de no haber encontrado ninguna particula sobreescribimos la primera
-	return 0;
+	TParticleChunk& result = m_chunks[chunk];
+	result.count = count - first;
+	result.dead = deadCount - first;
+	result.min = glm::vec3(minX, minY, minZ);
+	result.max = glm::vec3(maxX, maxY, maxZ);
 }
 
 void TParticleSystem::SetTranslate(glm::vec3 position){
 	// Actualizamos la posicion de todas las particulas en funcion del nuevo centro
 	// De esta forma no se teletransportan al llamar al metodo
-	for(int i=0; i<m_maxParticles; i++){
-		m_particleContainer[i].translation.X += position.x;
-		m_particleContainer[i].translation.Y += position.y;
-		m_particleContainer[i].translation.Z += position.z;
+	for(int i=0; i<m_particleCount; i++){
+		m_particles.translationX[i] += position.x;
+		m_particles.translationY[i] += position.y;
+		m_particles.translationZ[i] += position.z;
 	}
 }
 
 void TParticleSystem::Translate(glm::vec3 position){
-	for(int i=0; i<m_maxParticles; i++){
-		m_particleContainer[i].translation.X -= position.x;
-		m_particleContainer[i].translation.Y -= position.y;
-		m_particleContainer[i].translation.Z -= position.z;
+	for(int i=0; i<m_particleCount; i++){
+		m_particles.translationX[i] -= position.x;
+		m_particles.translationY[i] -= position.y;
+		m_particles.translationZ[i] -= position.z;
 	}
 }
 
 void TParticleSystem::SetTexture(std::string path){
-	if(path.compare("") == 0) m_texture = TResourceManager::GetInstance()->GetResourceTexture(VideoDriver::GetInstance()->GetAssetsPath() + "/textures/default_particle.png");
-	else m_texture = TResourceManager::GetInstance()->GetResourceTexture(path);
+	TResourceManager* manager = TResourceManager::GetInstance();
+	if(path.compare("") == 0) m_texture = manager->GetResourceTexture(manager->GetDefaultId(DEFAULT_PARTICLE));
+	else m_texture = manager->GetResourceTexture(path);
 }
 
 void TParticleSystem::SetManager(ParticleManager* manager){
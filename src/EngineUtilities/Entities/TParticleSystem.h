@@ -11,14 +11,21 @@
 #include "./TEntity.h"
 #include "./../Resources/TResourceTexture.h"
 #include "./../TOcularEngine/Elements/Particles/ParticleManager.h"
+#include <cstddef>
+
+typedef ptrdiff_t GLintptr;
 
 class TParticleSystem: public TEntity{
 public:
 	/**
 	 * @brief	- Constructor del sistema de particulas
 	 * 				en este se inicializan y rellenan los buffers
+	 * 				La memoria de las particulas se coge del TParticlePool segun se van creando
+	 * 
+	 * @param 	- path - Ruta de la textura, la de por defecto si esta vacia
+	 * @param 	- capacity - Numero maximo de particulas vivas a la vez
 	 */
-	TParticleSystem(std::string path = "");
+	TParticleSystem(std::string path = "", int capacity = 10000);
 	
 	/**
 	 * @brief	- Destructor del sistema de particulas donde eliminamos el manager
@@ -27,10 +34,15 @@ public:
 	~TParticleSystem();
 
 	/**
-	 * @brief	- Empezamos a pintar las particulas 
+	 * @brief	- Empezamos a pintar las particulas mandandolas a la cola de pintado
 	 */
 	virtual void BeginDraw() override;
 
+	/**
+	 * @brief	- Pintamos las particulas, lo llama la cola de pintado
+	 */
+	virtual void DrawQueued() override;
+
 	/**
 	 * @brief	- Acabamos de pintar las particulas reseteando las variables 
 	 */
@@ -42,13 +54,49 @@ public:
 	 */
 	virtual void DrawShadow() override;
 
+	/**
+	 * @brief	- Caja de las particulas vivas calculada en el ultimo Update
+	 * 				Las particulas solo se desplazan con la posicion de la matriz mundo
+	 */
+	virtual bool GetWorldBounds(const glm::mat4& model, glm::vec3* min, glm::vec3* max) override;
+
 	/**
 	 * @brief	- Update de las particulas en las que se actualizan sus valores segun el manager que tenga
+	 * 				Hace BeginUpdate, los trozos en el TJobPool y EndUpdate
 	 * 
 	 * @param 	- deltaTime - DeltaTime para poder actualizar sus valores en funcion del tiempo de ejecucion 
 	 */
 	void Update(float deltaTime);
 
+	/**
+	 * @brief	- Primera parte del update, en el hilo principal: crea las particulas nuevas
+	 * 				Se hace en serie para que rand() de lo mismo con cualquier numero de hilos
+	 * 
+	 * @param 	- deltaTime - DeltaTime del frame
+	 * @return 	- int - Numero de trozos a actualizar con UpdateChunk
+	 */
+	int BeginUpdate(float deltaTime);
+
+	/**
+	 * @brief	- Actualiza un trozo de m_chunkSize particulas y copia sus vivas a los arrays de subida
+	 * 				Los trozos se pueden actualizar a la vez desde varios hilos solo si IsThreadSafe
+	 * 
+	 * @param 	- chunk - Trozo a actualizar
+	 */
+	void UpdateChunk(int chunk);
+
+	/**
+	 * @brief	- Devuelve si los trozos se pueden actualizar en los hilos del TJobPool
+	 * 				Los managers que actualizan de una en una (ParticleManager::IsThreadSafe) van en serie en el hilo principal
+	 */
+	bool IsThreadSafe();
+
+	/**
+	 * @brief	- Ultima parte del update, en el hilo principal: junta los trozos en los arrays de subida
+	 * 				Se suben al TStreamBuffer al pintarlas
+	 */
+	void EndUpdate();
+
 	/**
 	 * @brief	- Cargamos la textura que pintan las particulas 
 	 * 
@@ -91,6 +139,36 @@ public:
 	 */
 	int GetNewPerSecond();
 
+	/**
+	 * @brief	- Cambiamos lo que se hace al crear particulas con el sistema lleno
+	 * 
+	 * @param 	- policy - PARTICLE_DROP, PARTICLE_RECYCLE o PARTICLE_GROW
+	 */
+	void SetFullPolicy(PARTICLEFULLPOLICY policy);
+
+	/**
+	 * @brief 	- Devuelve lo que se hace al crear particulas con el sistema lleno
+	 */
+	PARTICLEFULLPOLICY GetFullPolicy();
+
+	/**
+	 * @brief 	- Devuelve el numero de particulas vivas
+	 */
+	int GetParticleCount();
+
+	/**
+	 * @brief 	- Devuelve el numero de particulas que caben sin crecer
+	 */
+	int GetCapacity();
+
+	/**
+	 * @brief 	- Cambia el numero de particulas que caben
+	 * 				Si hay mas vivas se quitan las ultimas y si sobra memoria se devuelve al pool
+	 * 
+	 * @param 	- capacity - Nuevo numero de particulas
+	 */
+	void SetCapacity(int capacity);
+
 private:
 	/**
 	 * @brief	- Enviamos la informacion al shader 
@@ -103,38 +181,95 @@ private:
 	void ResetShaderData();
 
 	/**
-	 * @brief 	- Buscamos en el array de particulas una que no se este usando
-	 * 
-	 * @return 	- int - posicion en el array de la particula
+	 * @brief	- Copia los arrays de subida al TStreamBuffer si no estan ya en este frame
 	 */
-	int FindUnusedParticle();
+	void UploadParticles();
 
 	/**
-	 * @brief 	- Anyadimos una nueva particula
+	 * @brief 	- Anyadimos las particulas nuevas al final de las vivas
+	 * 				Si no caben se aplica m_fullPolicy
 	 * 
 	 * @param 	- deltaTime - valor del deltaTime
 	 */
 	void AddNewParticles(float deltaTime);
 
+	/**
+	 * @brief 	- Quita las particulas a las que menos vida les queda para hacer sitio a las nuevas
+	 * 
+	 * @param 	- count - Numero de particulas a quitar
+	 */
+	void RecycleParticles(int count);
+
+	/**
+	 * @brief 	- Quita particulas moviendo la ultima viva a su hueco
+	 * 
+	 * @param 	- dead - Particulas a quitar, de mayor a menor
+	 * @param 	- count - Numero de particulas a quitar
+	 */
+	void RemoveParticles(const int* dead, int count);
+
+	/**
+	 * @brief 	- Se asegura de que haya memoria para un numero de particulas, doblando la que hay
+	 * 
+	 * @param 	- count - Particulas que tienen que caber
+	 */
+	void Reserve(int count);
+
+	/**
+	 * @brief 	- Mueve las particulas vivas a un bloque del pool con sitio para count
+	 * 
+	 * @param 	- count - Particulas que caben en el bloque nuevo
+	 */
+	void Allocate(int count);
+
+	/**
+	 * @brief	- Copia las particulas vivas de un trozo seguidas al principio de su parte de los arrays de subida
+	 * 				y calcula su caja. Se escribe siempre y solo se avanza si la particula esta viva, sin saltos por particula
+	 * 
+	 * @param 	- chunk - Trozo a copiar
+	 */
+	void PackParticles(int chunk);
+
+	/**
+	 * @brief 	- Particulas vivas de un trozo despues de UpdateChunk
+	 */
+	struct TParticleChunk{
+		int			count;		// count - Particulas vivas del trozo
+		int			dead;		// dead - Particulas que han muerto en el trozo, sus posiciones estan en m_dead
+		glm::vec3	min;		// min - Esquina minima de sus particulas vivas
+		glm::vec3	max;		// max - Esquina maxima de sus particulas vivas
+	};
+
 	ParticleManager*	m_manager;					// m_manager - Manager de las particulas que se encarga de updatearlas y inicializarlas
-	TResourceTexture*	m_texture;					// m_texture - Textura que utilizan las particulas
+	TResourceHandle<TResourceTexture>	m_texture;	// m_texture - Textura que utilizan las particulas
 
-	int 				m_particleCount;			// m_particleCount - Numero de particulas activas en el momento
-	static const int 	m_maxParticles = 10000;		// m_maxParticles - Numero maximo de particulas
+	int 				m_particleCount;			// m_particleCount - Numero de particulas activas en el momento, siempre al principio de m_particles
+	int 				m_capacity;					// m_capacity - Numero de particulas que caben, a partir de aqui se aplica m_fullPolicy
+	int 				m_allocated;				// m_allocated - Numero de particulas que caben en la memoria cogida, como mucho m_capacity
+	PARTICLEFULLPOLICY	m_fullPolicy;				// m_fullPolicy - Que se hace al crear particulas con el sistema lleno
+	glm::vec3			m_boundsMin;				// m_boundsMin - Esquina minima de las particulas vivas
+	glm::vec3			m_boundsMax;				// m_boundsMax - Esquina maxima de las particulas vivas
+	static const int 	m_minAllocated = 64;		// m_minAllocated - Particulas del primer bloque que se coge del pool
+	static const int 	m_chunkSize = 2048;			// m_chunkSize - Particulas de cada trozo del update, fijo para que el resultado no dependa de los hilos
+	std::vector<TParticleChunk>	m_chunks;			// m_chunks - Resultado de cada trozo del update
+	float				m_deltaTime;				// m_deltaTime - DeltaTime del update en curso
 	int					m_newParticlesPerSecond;	// m_newParticlesPerSecond - Numero de particulas que se crean cada segundo
 	float				m_particleAcumulation;		// m_particleAcumulation - Numero de particulas a crear desde el ultimo frame
 	
 	GLuint 				m_vbo;	// m_vbo - Vertex buffer del mesh basico
-	GLuint				m_pbo; 	// m_pbo - Buffer con las posiciones de las particulas
-	GLuint				m_ebo;	// m_ebo - Buffer con los extras de las particulas
-	GLuint				m_cbo;	// m_cbo - Buffer con los colores de las particular
-
-	int 				m_lastUsedParticle; 	// m_lastUsedParticle - Numero de la ultima particula que se actualizo
+	GLintptr			m_positionOffset;	// m_positionOffset - Posicion de las posiciones de las particulas en el TStreamBuffer
+	GLintptr			m_colorOffset;		// m_colorOffset - Posicion de los colores de las particulas en el TStreamBuffer
+	GLintptr			m_extraOffset;		// m_extraOffset - Posicion de los extras de las particulas en el TStreamBuffer
+	unsigned int		m_streamRevision;	// m_streamRevision - Revision del TStreamBuffer con la que se subieron
+	bool				m_streamDirty;		// m_streamDirty - Ha habido un update desde la ultima subida
 
-	Particle 			m_particleContainer		[m_maxParticles*1];		// m_particleContainer - Array con todas las particulas
-	unsigned char 		m_particlesColorData	[m_maxParticles*3];		// m_particlesColorData - Array con todos los colores de las particulas
-	float				m_particlePositionData	[m_maxParticles*3];		// m_particlePositionData - Array con las posiciones de las particulas
-	float 				m_particlesExtra		[m_maxParticles*2];		// m_particlesExtra - Array con el tamanyo y la rotacion de las particulas
+	unsigned char*		m_memory;					// m_memory - Bloque del TParticlePool con las particulas y los arrays de subida
+	unsigned long long	m_memorySize;				// m_memorySize - Tamanyo del bloque, para devolverlo al pool
+	TParticleArray		m_particles;				// m_particles - Todas las particulas, un array por campo, las vivas al principio
+	unsigned char*		m_particlesColorData;		// m_particlesColorData - Array con todos los colores de las particulas
+	float*				m_particlePositionData;		// m_particlePositionData - Array con las posiciones de las particulas
+	float*				m_particlesExtra;			// m_particlesExtra - Array con el tamanyo y la rotacion de las particulas
+	int*				m_dead;						// m_dead - Particulas muertas en el update, cada trozo en su parte
 
 	bool 				m_drawingShadows;		// m_drawingShadows - Variable para saber si pintar las sombras
 };
@@ -1,9 +1,11 @@
 #include "TText.h"
 #include "../TOcularEngine/VideoDriver.h"
 #include "./../TResourceManager.h"
+#include "./../TRenderQueue.h"
 
 #include <GL/glew.h>
 #include <glm/gtc/type_ptr.hpp>
+#include <cmath>
 
 TText::TText(std::string text, float charSize, std::string texture){
 	m_drawingShadows = false;
@@ -25,8 +27,9 @@ TText::TText(std::string text, float charSize, std::string texture){
 	ChangeText(text);
 
 	// Ponemos la textura del texto
-	if(texture.compare("")==0) texture = VideoDriver::GetInstance()->GetAssetsPath() + "/textures/default_font.png";
-	m_texture = TResourceManager::GetInstance()->GetResourceTexture(texture); 
+	TResourceManager* manager = TResourceManager::GetInstance();
+	if(texture.compare("")==0) m_texture = manager->GetResourceTexture(manager->GetDefaultId(DEFAULT_FONT));
+	else m_texture = manager->GetResourceTexture(texture);
 
 	// Nos guardamos el programa a utilizar
 	m_program = TEXT_SHADER;
@@ -47,12 +50,29 @@ void TText::DrawShadow(){
 
 void TText::BeginDraw(){
 	if(!m_drawingShadows){
-		// Bind and send the data to the VERTEX SHADER
-		SendShaderData();
-		glDrawArrays(GL_TRIANGLES, 0, m_size);
+		// El texto se pinta con transparencia, de detras hacia delante
+		unsigned long long key = TRenderQueue::MakeKey(TRANSPARENT_LAYER, m_program, nullptr, TRenderQueue::MakeTextureSet(m_texture->GetTextureId()), m_vbo);
+		TRenderQueue::GetInstance()->Push(this, key);
 	}
 }
 
+void TText::DrawQueued(){
+	// Bind and send the data to the VERTEX SHADER
+	SendShaderData();
+	glDrawArrays(GL_TRIANGLES, 0, m_size);
+}
+
+bool TText::GetWorldBounds(const glm::mat4& model, glm::vec3* min, glm::vec3* max){
+	// El billboard solo conserva la posicion de la matriz mundo, el texto va de -ancho/2 a ancho/2 y de -SIZE a 0
+	float halfWidth = m_charSize * m_text.length() / 2.0f;
+	float radius = std::sqrt(halfWidth * halfWidth + m_charSize * m_charSize);
+
+	glm::vec3 position(model[3][0], model[3][1], model[3][2]);
+	*min = position - glm::vec3(radius);
+	*max = position + glm::vec3(radius);
+	return true;
+}
+
 void TText::EndDraw(){
 	m_drawingShadows = false;
 }
@@ -79,7 +99,7 @@ void TText::SendShaderData(){
 		// Calculamos la matriz MVP
 
 		// PRIMERO DE TODO QUITAMOS LA ROTACION DE LA MATRIZ DE LA PILA
-		glm::mat4 m_matrix = m_stack.top();
+		glm::mat4 m_matrix = ModelMatrix;
 
 		// SEGUIDAMENTE COGEMOS LA ROTACION DE LA CAMARA Y LA INVERTIMOS
 		// DE ESTA FORMA CONSEGUIMOS QUE SIEMPRE MIRE A LA CAMARA
@@ -94,7 +114,7 @@ void TText::SendShaderData(){
 		glm::mat4 mvpMatrix = ProjMatrix * modelView;
 
 		// SEND THE MATRIX
-		GLint mvpLocation = glGetUniformLocation(myProgram->GetProgramID(), "MVP");
+		GLint mvpLocation = myProgram->GetUniformLocation(MVP_UNIFORM);
 		glUniformMatrix4fv(mvpLocation, 1, GL_FALSE, &mvpMatrix[0][0]);
 
 	// Enviamos los vertices del texto
@@ -102,7 +122,7 @@ void TText::SendShaderData(){
 		glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
 
 		// SEND THE VERTEX
-		GLint posAttrib = glGetAttribLocation(myProgram->GetProgramID(), "VertexPosition");
+		GLint posAttrib = myProgram->GetAttribLocation(VERTEXPOSITION_ATTRIB);
 		glVertexAttribPointer(posAttrib,3, GL_FLOAT, GL_FALSE, 0*sizeof(float), 0);
 		glEnableVertexAttribArray(posAttrib);
 
@@ -111,12 +131,12 @@ void TText::SendShaderData(){
 		glBindBuffer(GL_ARRAY_BUFFER, m_uvbo);
 
 		// SEND THE UV
-		GLuint uvAttrib = glGetAttribLocation(myProgram->GetProgramID(), "TextureCoords");
+		GLuint uvAttrib = myProgram->GetAttribLocation(TEXTURECOORDS_ATTRIB);
 		glVertexAttribPointer(uvAttrib, 2, GL_FLOAT, GL_FALSE, 0*sizeof(float), 0);
 		glEnableVertexAttribArray(uvAttrib);
 
 	// Enviamos la textura del texto
-		GLuint TextureID = glGetUniformLocation(myProgram->GetProgramID(), "uvMap");
+		GLuint TextureID = myProgram->GetUniformLocation(UVMAP_UNIFORM);
 		glUniform1i(TextureID, 0);
 
 		glActiveTexture(GL_TEXTURE0);
@@ -174,6 +194,7 @@ void TText::LoadText(std::string text){
 	}
 
 	m_size = textVertex.size();
+	m_boundsRevision++;
 
 	// Una vez ya almacenados todos los vertices y uv cargamos los vectores
 	glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
@@ -28,10 +28,15 @@ public:
 	~TText();
 
 	/**
-	 * @brief 	- Enviamos la informacion al shader y pintamos el texto
+	 * @brief 	- Mandamos el texto a la cola de pintado
 	 */
 	virtual void BeginDraw() override;
 
+	/**
+	 * @brief 	- Enviamos la informacion al shader y pintamos el texto, lo llama la cola de pintado
+	 */
+	virtual void DrawQueued() override;
+
 	/**
 	 * @brief 	- Reseteamos las variables requeridas
 	 */
@@ -42,6 +47,11 @@ public:
 	 */
 	virtual void DrawShadow() override;
 
+	/**
+	 * @brief	- El texto siempre mira a la camara, su caja es la esfera que lo contiene en cualquier orientacion
+	 */
+	virtual bool GetWorldBounds(const glm::mat4& model, glm::vec3* min, glm::vec3* max) override;
+
 	/**
 	 * @brief	- Cambia la cadena de texto que se pinta
 	 * 
@@ -69,7 +79,7 @@ private:
 	 */
 	void SendShaderData();
 
-	TResourceTexture* 	m_texture;	// m_texture - Imagen con todas las letras de la tipografia
+	TResourceHandle<TResourceTexture> 	m_texture;	// m_texture - Imagen con todas las letras de la tipografia
 	std::string 		m_text;		// m_text - Texto de la entidad
 	float 				m_charSize;	// m_charSize - Tamanyo de los caracteres
 
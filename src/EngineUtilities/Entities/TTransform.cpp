@@ -1,4 +1,5 @@
 #include "./TTransform.h"
+#include "./../TNode.h"
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtx/quaternion.hpp>
 #include <iostream>
@@ -12,28 +13,34 @@ TTransform::~TTransform(){}
 
 void TTransform::Identity(){
 	m_matrix = glm::mat4(1.0f);
+	Invalidate();
 }
 
 
 #include <glm/gtx/string_cast.hpp>
 void TTransform::Load(glm::mat4 matrix){
 	m_matrix = matrix;
+	Invalidate();
 }
 
 void TTransform::Transpose(){
 	m_matrix = glm::transpose(m_matrix);
+	Invalidate();
 }
 
 void TTransform::Inverse(){
 	m_matrix = glm::inverse(m_matrix);
+	Invalidate();
 }
 
 void TTransform::Translate(float X, float Y, float Z){
 	m_matrix = glm::translate(m_matrix, glm::vec3(X,Y,Z));
+	Invalidate();
 }
 
 void TTransform::Rotate(float X, float Y, float Z, float W){
 	m_matrix = glm::rotate(m_matrix, glm::radians(W), glm::vec3(X,Y,Z));
+	Invalidate();
 }
 
 void TTransform::Rotate(float X, float Y, float Z){
@@ -50,23 +57,22 @@ void TTransform::Rotate(float X, float Y, float Z){
 
  	// Multiplicamos la matriz actual por las dos rotaciones nuevas
  	m_matrix = final1 * m_matrix * final2;
+	Invalidate();
 
 }
 
 void TTransform::Scale(float X, float Y, float Z){
 	m_matrix = glm::scale(m_matrix, glm::vec3(X,Y,Z));
+	Invalidate();
 }
 
 void TTransform::BeginDraw(){
-	// Apilar la multiplicacion de la matriz de la transformacion y la matriz actual
-	m_stack.push(m_matrix * m_stack.top());
-	//PrintMatrix(m_stack.top());
+	// Ponemos como matriz actual la matriz mundo cacheada en el nodo
+	if(m_ownerNode != nullptr) ModelMatrix = m_ownerNode->GetWorldMatrix();
+	else ModelMatrix = m_matrix;
 }
 
-void TTransform::EndDraw(){
-	// Desapilar matriz y ponerla como actual
-	m_stack.pop();
-}
+void TTransform::EndDraw(){}
 
 void TTransform::PrintMatrix(glm::mat4 mat){
 	for(int i= 0; i<4; i++){
@@ -90,3 +96,12 @@ void TTransform::PrintMatrix(){
 glm::mat4 TTransform::GetTransform(){
 	return m_matrix;
 }
+
+bool TTransform::IsTransform(){
+	return true;
+}
+
+void TTransform::Invalidate(){
+	// Avisamos al nodo de que su matriz mundo (y la de sus hijos) ya no es valida
+	if(m_ownerNode != nullptr) m_ownerNode->SetDirty();
+}
@@ -85,13 +85,13 @@ public:
 
 	/**
 	 * @brief	- Empezamos a pintar la transformacion
-	 * 				Apilamos una nueva transformacion en la pila 
+	 * 				Cargamos la matriz mundo del nodo como matriz actual de las entidades
 	 */
 	void 	BeginDraw();					
 
 	/**
 	 * @brief	- Acabamos de pintar la transformacion
-	 * 				Desapilamos una transformacion de la pila 
+	 * 				Al no haber pila de matrices no hay nada que deshacer
 	 */		
 	void 	EndDraw();	
 
@@ -114,8 +114,20 @@ public:
 	 */
 	glm::mat4 GetTransform();
 
+	/**
+	 * @brief	- Indica que la entidad es una transformacion
+	 * 
+	 * @return 	- bool - Siempre true
+	 */
+	bool IsTransform() override;
+
 private:
 	glm::mat4 m_matrix;		// m_matix - Matriz de transformacion de 4x4
+
+	/**
+	 * @brief	- Marca como sucia la matriz mundo cacheada del nodo y de sus descendientes
+	 */
+	void Invalidate();
 };
 
 #endif
\ No newline at end of file
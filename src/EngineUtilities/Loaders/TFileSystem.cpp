@@ -0,0 +1,157 @@
+#include "TFileSystem.h"
+#include "./../TPathTable.h"
+
+#include <iostream>
+#include <cstring>
+#include <sys/stat.h>
+
+// ============================================================================================================================================
+//
+// TVirtualFile
+//
+// ============================================================================================================================================
+
+TVirtualFile::TVirtualFile(){
+	m_data = nullptr;
+	m_size = 0;
+	m_packed = false;
+}
+
+TVirtualFile::~TVirtualFile(){
+	Close();
+}
+
+bool TVirtualFile::Open(const std::string& path){
+	Close();
+
+	const unsigned char* pack = nullptr;
+	const TPackEntry* entry = TFileSystem::GetInstance()->FindPacked(path, &pack);
+	if(entry != nullptr){
+		const unsigned char* stored = pack + entry->offset;
+		if(entry->compression == TPackFile::PACK_STORED) m_data = stored;
+		else{
+			// Comprimido, se descomprime entero en el buffer del fichero
+			m_buffer.resize(entry->rawSize);
+			if(!TPackFile::DecompressLZ4(stored, entry->size, m_buffer.data(), entry->rawSize)){
+				std::cout<<"Entrada del pack corrupta: "<<path<<std::endl;
+				m_buffer.clear();
+				return false;
+			}
+			m_data = m_buffer.data();
+		}
+		m_size = entry->rawSize;
+		m_packed = true;
+		return true;
+	}
+
+	// No esta en ningun pack, se mapea del disco
+	if(!m_file.Open(path)) return false;
+	m_data = m_file.GetData();
+	m_size = m_file.GetSize();
+	return true;
+}
+
+void TVirtualFile::Close(){
+	m_file.Close();
+	std::vector<unsigned char>().swap(m_buffer);
+	m_data = nullptr;
+	m_size = 0;
+	m_packed = false;
+}
+
+const unsigned char* TVirtualFile::GetData(){
+	return m_data;
+}
+
+size_t TVirtualFile::GetSize(){
+	return m_size;
+}
+
+bool TVirtualFile::GetPacked(){
+	return m_packed;
+}
+
+// ============================================================================================================================================
+//
+// TFileSystem
+//
+// ============================================================================================================================================
+
+TFileSystem* TFileSystem::GetInstance(){
+	static TFileSystem instance;
+	return &instance;
+}
+
+TFileSystem::TFileSystem(){
+}
+
+TFileSystem::~TFileSystem(){
+	int size = m_packs.size();
+	for(int i=0; i<size; i++) delete m_packs[i].file;
+	m_packs.clear();
+}
+
+bool TFileSystem::MountPack(std::string packPath, std::string root){
+	TMappedFile* file = new TMappedFile();
+	if(!file->Open(packPath) || !TPackFile::Validate(file->GetData(), file->GetSize(), packPath)){
+		delete file;
+		return false;
+	}
+
+	TMountedPack pack;
+	pack.file = file;
+	TPathTable::Normalize(root, &pack.root);
+	if(!pack.root.empty()) pack.root += "/";
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_packs.push_back(pack);
+	return true;
+}
+
+const TPackEntry* TFileSystem::FindPacked(const std::string& path, const unsigned char** data){
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if(m_packs.empty()) return nullptr;
+
+	// Las rutas del pack son relativas a su carpeta de assets
+	std::string name;
+	TPathTable::Normalize(path, &name);
+
+	for(int i=m_packs.size()-1; i>=0; i--){
+		const std::string& root = m_packs[i].root;
+		if(name.length() <= root.length() || name.compare(0, root.length(), root) != 0) continue;
+
+		const unsigned char* pack = m_packs[i].file->GetData();
+		const TPackEntry* entry = TPackFile::Find(pack, name.data() + root.length(), name.length() - root.length());
+		if(entry != nullptr){
+			*data = pack;
+			return entry;
+		}
+	}
+	return nullptr;
+}
+
+bool TFileSystem::Exists(const std::string& path){
+	const unsigned char* data = nullptr;
+	if(FindPacked(path, &data) != nullptr) return true;
+	struct stat info;
+	return stat(path.c_str(), &info) == 0;
+}
+
+bool TFileSystem::ReadText(const std::string& path, std::string* text){
+	TVirtualFile file;
+	if(!file.Open(path)) return false;
+	// Como un ifstream en modo texto: los finales de linea \r\n se quedan en \n
+	const char* data = (const char*)file.GetData();
+	size_t size = file.GetSize();
+	text->clear();
+	text->reserve(size);
+	for(size_t i=0; i<size; i++){
+		if(data[i] != '\r' || i + 1 >= size || data[i+1] != '\n') text->push_back(data[i]);
+	}
+	return true;
+}
+
+int TFileSystem::GetPackCount(){
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_packs.size();
+}
\ No newline at end of file
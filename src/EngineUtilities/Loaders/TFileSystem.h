@@ -0,0 +1,139 @@
+#ifndef TFILESYSTEM_H
+#define TFILESYSTEM_H
+
+/**
+ * @brief Virtual file system of the loaders: files are searched in the mounted asset packs first
+ * 		  and read from disk when no pack has them.
+ *
+ * @file TFileSystem.h
+ */
+
+#include "TMappedFile.h"
+#include "TPackFile.h"
+
+#include <string>
+#include <vector>
+#include <mutex>
+
+/**
+ * @brief 	- Fichero abierto a traves del TFileSystem, de un pack o del disco
+ * 				Los datos siguen siendo validos hasta cerrarlo
+ */
+class TVirtualFile{
+public:
+	/**
+	 * @brief	- Constructor del fichero, no abre nada hasta llamar a Open
+	 */
+	TVirtualFile();
+
+	/**
+	 * @brief	- Destructor, cierra el fichero si sigue abierto
+	 */
+	~TVirtualFile();
+
+	/**
+	 * @brief	- Abre el fichero del pack que lo tenga o, si no esta en ninguno, lo mapea del disco
+	 *
+	 * @param 	- path - Ruta del fichero (la misma que en disco)
+	 * @return 	- bool - Se ha podido abrir
+	 */
+	bool Open(const std::string& path);
+
+	/**
+	 * @brief	- Cierra el fichero y libera lo descomprimido
+	 */
+	void Close();
+
+	/**
+	 * @brief	- Devuelve el principio del fichero en memoria (nullptr si no esta abierto)
+	 */
+	const unsigned char* GetData();
+
+	/**
+	 * @brief	- Devuelve el tamanyo del fichero en bytes
+	 */
+	size_t GetSize();
+
+	/**
+	 * @brief	- Devuelve si se ha leido de un pack
+	 */
+	bool GetPacked();
+
+private:
+	TMappedFile					m_file;		// m_file - Fichero del disco mapeado
+	std::vector<unsigned char>	m_buffer;	// m_buffer - Entrada descomprimida de un pack
+	const unsigned char*		m_data;		// m_data - Contenido (en el pack, en m_buffer o en m_file)
+	size_t						m_size;		// m_size - Tamanyo del contenido
+	bool						m_packed;	// m_packed - Se ha leido de un pack
+
+	// No se puede copiar, m_data puede apuntar a su propio buffer
+	TVirtualFile(const TVirtualFile&) = delete;
+	TVirtualFile& operator=(const TVirtualFile&) = delete;
+};
+
+class TFileSystem{
+public:
+	/**
+	 * @brief	- Devuelve la instancia del sistema de ficheros
+	 */
+	static TFileSystem* GetInstance();
+
+	/**
+	 * @brief	- Destructor, deshace el mapeo de los packs
+	 */
+	~TFileSystem();
+
+	/**
+	 * @brief	- Monta un pack, se abre una vez y se queda mapeado hasta cerrar el motor
+	 * 				Los montados despues tienen preferencia (parches)
+	 *
+	 * @param 	- packPath - Ruta del pack
+	 * @param 	- root - Carpeta de la que se construyo el pack (la carpeta de assets)
+	 * @return 	- bool - Se ha abierto y es valido
+	 */
+	bool MountPack(std::string packPath, std::string root);
+
+	/**
+	 * @brief	- Busca un fichero en los packs montados
+	 *
+	 * @param 	- path - Ruta del fichero
+	 * @param 	- data - Contenido del pack donde esta
+	 * @return 	- TPackEntry - Entrada del fichero, nullptr si no esta en ningun pack
+	 */
+	const TPackEntry* FindPacked(const std::string& path, const unsigned char** data);
+
+	/**
+	 * @brief	- Devuelve si el fichero esta en un pack o en disco
+	 */
+	bool Exists(const std::string& path);
+
+	/**
+	 * @brief	- Lee un fichero de texto entero (shaders, materiales), con los finales de linea en \n
+	 *
+	 * @param 	- path - Ruta del fichero
+	 * @param 	- text - Contenido del fichero
+	 * @return 	- bool - Se ha podido leer
+	 */
+	bool ReadText(const std::string& path, std::string* text);
+
+	/**
+	 * @brief	- Devuelve el numero de packs montados
+	 */
+	int GetPackCount();
+
+private:
+	/**
+	 * @brief 	- Pack montado
+	 */
+	struct TMountedPack{
+		TMappedFile*	file;		// file - Pack mapeado
+		std::string		root;		// root - Carpeta de assets ya tratada, con '/' al final si no esta vacia
+	};
+
+	TFileSystem();
+
+	std::vector<TMountedPack>	m_packs;	// m_packs - Packs montados, del primero al ultimo
+	std::mutex					m_mutex;	// m_mutex - Los hilos del cargador buscan mientras se monta otro
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,100 @@
+#include "TMappedFile.h"
+
+#ifdef _WIN32
+	#include <windows.h>
+#else
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+TMappedFile::TMappedFile(){
+	m_data = nullptr;
+	m_size = 0;
+#ifdef _WIN32
+	m_file = INVALID_HANDLE_VALUE;
+	m_mapping = nullptr;
+#else
+	m_file = -1;
+#endif
+}
+
+TMappedFile::~TMappedFile(){
+	Close();
+}
+
+bool TMappedFile::Open(std::string path){
+	Close();
+
+#ifdef _WIN32
+	m_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if(m_file == INVALID_HANDLE_VALUE) return false;
+
+	LARGE_INTEGER size;
+	if(!GetFileSizeEx(m_file, &size) || size.QuadPart == 0){
+		Close();
+		return false;
+	}
+	m_size = (size_t)size.QuadPart;
+
+	m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if(m_mapping == nullptr){
+		Close();
+		return false;
+	}
+
+	m_data = (const unsigned char*)MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+	if(m_data == nullptr){
+		Close();
+		return false;
+	}
+#else
+	m_file = open(path.c_str(), O_RDONLY);
+	if(m_file < 0) return false;
+
+	struct stat info;
+	if(fstat(m_file, &info) != 0 || info.st_size <= 0){
+		Close();
+		return false;
+	}
+	m_size = (size_t)info.st_size;
+
+	void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, m_file, 0);
+	if(data == MAP_FAILED){
+		Close();
+		return false;
+	}
+	m_data = (const unsigned char*)data;
+
+	// Se va a leer entero, pedimos al sistema que adelante la lectura
+	madvise(data, m_size, MADV_WILLNEED);
+#endif
+
+	return true;
+}
+
+void TMappedFile::Close(){
+#ifdef _WIN32
+	if(m_data != nullptr) UnmapViewOfFile(m_data);
+	if(m_mapping != nullptr) CloseHandle(m_mapping);
+	if(m_file != INVALID_HANDLE_VALUE) CloseHandle(m_file);
+	m_mapping = nullptr;
+	m_file = INVALID_HANDLE_VALUE;
+#else
+	if(m_data != nullptr) munmap((void*)m_data, m_size);
+	if(m_file >= 0) close(m_file);
+	m_file = -1;
+#endif
+
+	m_data = nullptr;
+	m_size = 0;
+}
+
+const unsigned char* TMappedFile::GetData(){
+	return m_data;
+}
+
+size_t TMappedFile::GetSize(){
+	return m_size;
+}
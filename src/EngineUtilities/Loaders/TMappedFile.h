@@ -0,0 +1,64 @@
+#ifndef TMAPPEDFILE_H
+#define TMAPPEDFILE_H
+
+/**
+ * @brief Read-only memory mapped file.
+ * 
+ * @file TMappedFile.h
+ */
+
+#include <string>
+#include <cstddef>
+
+class TMappedFile{
+public:
+	/**
+	 * @brief	- Constructor del fichero mapeado, no abre nada hasta llamar a Open
+	 */
+	TMappedFile();
+
+	/**
+	 * @brief	- Destructor, deshace el mapeo si sigue abierto
+	 */
+	~TMappedFile();
+
+	/**
+	 * @brief	- Mapea el fichero entero en memoria de solo lectura
+	 * 
+	 * @param 	- path - Ruta al fichero
+	 * @return 	- bool - Se ha podido abrir y mapear
+	 */
+	bool Open(std::string path);
+
+	/**
+	 * @brief	- Deshace el mapeo y cierra el fichero
+	 */
+	void Close();
+
+	/**
+	 * @brief	- Devuelve el principio del fichero en memoria (nullptr si no esta abierto)
+	 */
+	const unsigned char* GetData();
+
+	/**
+	 * @brief	- Devuelve el tamanyo del fichero en bytes
+	 */
+	size_t GetSize();
+
+private:
+	const unsigned char*	m_data;		// m_data - Paginas mapeadas del fichero
+	size_t					m_size;		// m_size - Tamanyo del fichero
+
+#ifdef _WIN32
+	void*					m_file;		// m_file - HANDLE del fichero
+	void*					m_mapping;	// m_mapping - HANDLE del mapeo
+#else
+	int						m_file;		// m_file - Descriptor del fichero
+#endif
+
+	// No se puede copiar, el mapeo solo se deshace una vez
+	TMappedFile(const TMappedFile&) = delete;
+	TMappedFile& operator=(const TMappedFile&) = delete;
+};
+
+#endif
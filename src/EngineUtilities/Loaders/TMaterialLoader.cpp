@@ -1,13 +1,15 @@
 #include "TMaterialLoader.h"
 #include "./../TResourceManager.h"
 #include "./../Resources/TResourceMaterial.h"
+#include "TMeshFile.h"
+#include "TFileSystem.h"
 
 #include <assimp/cimport.h>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
 
 #include <iostream>
-#include <fstream>
+#include <sstream>
 #include <string.h>
 #include <stdio.h>
 
@@ -50,8 +52,7 @@ bool TMaterialLoader::LoadMaterial(std::string name, std::string path, TResource
 	bool output = false;
 
 	// Comprobamos que el nombre pasado no este ya en nuestra base de datos
-	TResourceMaterial* recMaterial = nullptr;
-	recMaterial = TResourceManager::GetInstance()->GetResourceMaterial(name);
+	TResourceHandle<TResourceMaterial> recMaterial = TResourceManager::GetInstance()->GetResourceMaterial(name);
 
 	// En el caso de haberlo encontrado y este cargado damos el metodo por finalizado
 	if(recMaterial->GetLoaded()){output = true;}
@@ -60,11 +61,13 @@ bool TMaterialLoader::LoadMaterial(std::string name, std::string path, TResource
 		// del path de .obj a .mtl
 		path = TreatPath(path);
 
-		std::ifstream readFile;
-		readFile.open(path, std::ifstream::out);
+		// Se lee entero del pack o del disco y se recorre en memoria
+		std::string content;
+		bool opened = TFileSystem::GetInstance()->ReadText(path, &content);
+		std::istringstream readFile(content);
 
 		// Miramos si el archivo se ha abierto correctamente
-		if(readFile.is_open()){
+		if(opened){
 			std::string line;
 
 			std::string token;
@@ -137,7 +140,6 @@ bool TMaterialLoader::LoadMaterial(std::string name, std::string path, TResource
 		}else{
 			//std::cout<<"No se ha encontrado el material: "<<name<<std::endl;
 		}
-		readFile.close();
 	}
 	
 	mesh->AddMaterial(recMaterial);
@@ -145,7 +147,7 @@ bool TMaterialLoader::LoadMaterial(std::string name, std::string path, TResource
 }
 
 bool TMaterialLoader::LoadMaterial(std::string name, TResourceMesh* mesh, const aiMaterial* material){
-	TResourceMaterial* recMaterial = TResourceManager::GetInstance()->GetResourceMaterial(name);
+	TResourceHandle<TResourceMaterial> recMaterial = TResourceManager::GetInstance()->GetResourceMaterial(name);
 
 	// Cargamos el material en el caso de que no haya sido cargado antes
 	if(!recMaterial->GetLoaded() && material != nullptr){
@@ -214,4 +216,26 @@ bool TMaterialLoader::LoadMaterial(std::string name, TResourceMesh* mesh, const
 	mesh->AddMaterial(recMaterial);
 
 	return true;
+}
+
+bool TMaterialLoader::LoadMaterial(std::string name, TResourceMesh* mesh, const TMeshFileMaterial* material){
+	TResourceHandle<TResourceMaterial> recMaterial = TResourceManager::GetInstance()->GetResourceMaterial(name);
+
+	// Cargamos el material en el caso de que no haya sido cargado antes
+	if(!recMaterial->GetLoaded()){
+		if(material != nullptr){
+			recMaterial->SetColorAmbient(glm::vec3(material->ambient[0], material->ambient[1], material->ambient[2]));
+			recMaterial->SetColorDifuse(glm::vec3(material->diffuse[0], material->diffuse[1], material->diffuse[2]));
+			recMaterial->SetColorSpecular(glm::vec3(material->specular[0], material->specular[1], material->specular[2]));
+			recMaterial->SetColorEmmisive(glm::vec3(material->emissive[0], material->emissive[1], material->emissive[2]));
+			recMaterial->SetShininess(material->shininess);
+		}
+
+		// Damos el material como cargado, sin valores se queda con los de por defecto
+		recMaterial->LoadFile();
+	}
+	// Le anyadimos el mateial al mesh
+	mesh->AddMaterial(recMaterial);
+
+	return material != nullptr;
 }
\ No newline at end of file
@@ -10,6 +10,7 @@
 #include "./../Resources/TResourceMesh.h"
 #include <string>
 class aiMaterial;
+struct TMeshFileMaterial;
 
 class TMaterialLoader{
 public:
@@ -32,6 +33,16 @@ public:
 	 * @return 	- bool - Se ha cargado correctamente el material
 	 */
 	static bool LoadMaterial(std::string name, TResourceMesh* mesh, const aiMaterial* material);
+
+	/**
+	 * @brief	- Cargamos el material a partir de los valores ya resueltos de un mesh cocinado, sin leer el .mtl
+	 * 
+	 * @param 	- name - Nombre del material 
+	 * @param 	- mesh - Recurso del mesh que necesita el material 
+	 * @param 	- material - Valores guardados en el fichero, si es nullptr el material se queda con los valores por defecto
+	 * @return 	- bool - Se ha cargado correctamente el material
+	 */
+	static bool LoadMaterial(std::string name, TResourceMesh* mesh, const TMeshFileMaterial* material);
 private:
 	/**
 	 * @brief	- Leemos los primero tres floats del string pasado por parametros 
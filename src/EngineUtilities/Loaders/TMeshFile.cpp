@@ -0,0 +1,290 @@
+#include "TMeshFile.h"
+
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <algorithm>
+#include <glm/common.hpp>
+
+/*
+	FORMATO TOEM (version 2, la 1 no tiene materialOffset ni seccion de material)
+	TMeshFileHeader				- Cabecera con magic, version, numero de elementos y offsets de las secciones
+	VERTICES (alineado a 16)	- vertexCount * vertexStride bytes, posicion / normal / uv / tangente (opcional)
+	ELEMENTOS (alineado a 16)	- indexCount * UINT
+	RUTAS (alineado a 16)		- stringCount * (UINT longitud + CHARS), textura / normal map / specular map / material
+	MATERIAL (alineado a 16)	- TMeshFileMaterial, solo si materialOffset no es 0
+*/
+
+// La cabecera y el material se leen directamente de las paginas mapeadas, su tamanyo no puede depender del compilador
+static_assert(sizeof(TMeshFileHeader) == 96, "TMeshFileHeader tiene que ocupar 96 bytes sin relleno");
+static_assert(sizeof(TMeshFileMaterial) == 64, "TMeshFileMaterial tiene que ocupar 64 bytes sin relleno");
+
+static unsigned long long AlignMeshOffset(unsigned long long offset){
+	unsigned long long alignment = TMeshFile::MESHFILE_ALIGNMENT;
+	return (offset + alignment - 1) / alignment * alignment;
+}
+
+bool TMeshFile::IsMeshFile(const unsigned char* data, unsigned long long size){
+	return size >= sizeof(TMeshFileHeader::magic) && memcmp(data, "TOEM", 4) == 0;
+}
+
+bool TMeshFile::Validate(const unsigned char* data, unsigned long long size, std::string path, TMeshFileHeader* header){
+	const char* error = nullptr;
+	memset(header, 0, sizeof(TMeshFileHeader));
+
+	// Version y tamanyo de cabecera estan en el mismo sitio en todas las versiones
+	unsigned int version = 0, headerSize = 0;
+	if(size >= 3 * sizeof(unsigned int)){
+		memcpy(&version, data + 4, sizeof(unsigned int));
+		memcpy(&headerSize, data + 8, sizeof(unsigned int));
+	}
+	unsigned int expectedHeader = version == 1 ? MESHFILE_V1_HEADER : (unsigned int)sizeof(TMeshFileHeader);
+
+	if(!IsMeshFile(data, size)) error = "no es un fichero TOEM";
+	else if(version < MESHFILE_MIN_VERSION || version > MESHFILE_VERSION) error = "version no soportada";
+	else if(headerSize != expectedHeader) error = "tamanyo de cabecera incorrecto";
+	else if(size < headerSize) error = "cabecera incompleta";
+	else{
+		memcpy(header, data, headerSize);
+
+		unsigned int expectedStride = (header->flags & MESHFILE_TANGENTS) ? 11 * sizeof(float) : 8 * sizeof(float);
+
+		// Las multiplicaciones se hacen en 64 bits, con 32 bits de cuenta no pueden desbordar
+		unsigned long long vertexBytes = (unsigned long long)header->vertexCount * header->vertexStride;
+		unsigned long long indexBytes = (unsigned long long)header->indexCount * sizeof(unsigned int);
+
+		if(header->fileSize != size) error = "el tamanyo no coincide con el de la cabecera";
+		else if(header->vertexStride != expectedStride) error = "tamanyo de vertice incorrecto";
+		else if(header->vertexCount == 0 || header->indexCount == 0 || header->indexCount % 3 != 0) error = "numero de vertices o elementos incorrecto";
+		else if(header->vertexOffset % MESHFILE_ALIGNMENT != 0 || header->indexOffset % MESHFILE_ALIGNMENT != 0 || header->materialOffset % MESHFILE_ALIGNMENT != 0) error = "secciones sin alinear";
+		else if(header->vertexOffset < headerSize || header->vertexOffset > size || vertexBytes > size - header->vertexOffset) error = "seccion de vertices fuera del fichero";
+		else if(header->indexOffset < headerSize || header->indexOffset > size || indexBytes > size - header->indexOffset) error = "seccion de elementos fuera del fichero";
+		else if(header->stringOffset < headerSize || header->stringOffset > size) error = "seccion de rutas fuera del fichero";
+		else if(header->materialOffset != 0 && (header->materialOffset < headerSize || header->materialOffset > size || sizeof(TMeshFileMaterial) > size - header->materialOffset)) error = "seccion de material fuera del fichero";
+		else if(!CheckIndices((const unsigned int*)(data + header->indexOffset), header->indexCount, header->vertexCount)) error = "elemento fuera de rango";
+	}
+
+	if(error != nullptr){
+		std::cout<<"Mesh corrupto ("<<error<<"): "<<path<<std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+bool TMeshFile::ReadStrings(const unsigned char* data, unsigned long long size, const TMeshFileHeader* header, std::string paths[4]){
+	unsigned long long offset = header->stringOffset;
+	for(unsigned int i=0; i<header->stringCount; i++){
+		unsigned int length = 0;
+		if(size - offset < sizeof(unsigned int)) return false;
+		memcpy(&length, data + offset, sizeof(unsigned int));
+		offset += sizeof(unsigned int);
+
+		if(length > size - offset) return false;
+		if(i < 4) paths[i].assign((const char*)(data + offset), length);
+		offset += length;
+	}
+	return true;
+}
+
+const TMeshFileMaterial* TMeshFile::GetMaterial(const unsigned char* data, const TMeshFileHeader* header){
+	if(header->materialOffset == 0) return nullptr;
+	return (const TMeshFileMaterial*)(data + header->materialOffset);
+}
+
+bool TMeshFile::CheckIndices(const unsigned int* index, unsigned long long indexCount, unsigned long long vertexCount){
+	unsigned int maxIndex = 0;
+	for(unsigned long long i=0; i<indexCount; i++) maxIndex = std::max(maxIndex, index[i]);
+	return indexCount == 0 || maxIndex < vertexCount;
+}
+
+bool TMeshFile::InterleaveVertices(std::vector<glm::vec3>* vertex, std::vector<glm::vec2>* uv, std::vector<glm::vec3>* normal, std::vector<glm::vec3>* tangent, std::vector<float>* data){
+	// Formato de cada vertice: posicion (3) / normal (3) / uv (2) / tangente (3, opcional)
+	bool hasTangents = tangent != nullptr && !tangent->empty() && tangent->size() == vertex->size();
+	int floatsPerVertex = hasTangents ? 11 : 8;
+	int size = vertex->size();
+	int normalCount = normal->size();
+	int uvCount = uv->size();
+
+	data->resize(size * floatsPerVertex);
+	for(int i=0; i<size; i++){
+		float* current = &(*data)[i * floatsPerVertex];
+		glm::vec3 position = vertex->at(i);
+		glm::vec3 currentNormal = i < normalCount ? normal->at(i) : glm::vec3(0,0,0);
+		glm::vec2 currentUv = i < uvCount ? uv->at(i) : glm::vec2(0,0);
+
+		current[0] = position.x; 		current[1] = position.y; 		current[2] = position.z;
+		current[3] = currentNormal.x; 	current[4] = currentNormal.y; 	current[5] = currentNormal.z;
+		current[6] = currentUv.x; 		current[7] = currentUv.y;
+
+		if(hasTangents){
+			glm::vec3 currentTangent = tangent->at(i);
+			current[8] = currentTangent.x; 	current[9] = currentTangent.y; 	current[10] = currentTangent.z;
+		}
+	}
+
+	return hasTangents;
+}
+
+bool TMeshFile::Save(std::string path, TMeshData* mesh){
+	if(mesh->vertex.empty() || mesh->index.empty() || mesh->index.size() % 3 != 0) return false;
+
+	std::vector<float> data;
+	bool hasTangents = InterleaveVertices(&mesh->vertex, &mesh->uv, &mesh->normal, &mesh->tangent, &data);
+
+	TMeshFileHeader header;
+	memset(&header, 0, sizeof(TMeshFileHeader));
+	memcpy(header.magic, "TOEM", 4);
+	header.version = MESHFILE_VERSION;
+	header.headerSize = sizeof(TMeshFileHeader);
+	header.flags = hasTangents ? MESHFILE_TANGENTS : 0;
+	header.vertexCount = mesh->vertex.size();
+	header.vertexStride = (hasTangents ? 11 : 8) * sizeof(float);
+	header.indexCount = mesh->index.size();
+	header.stringCount = 4;
+
+	header.vertexOffset = AlignMeshOffset(sizeof(TMeshFileHeader));
+	header.indexOffset = AlignMeshOffset(header.vertexOffset + data.size() * sizeof(float));
+	header.stringOffset = AlignMeshOffset(header.indexOffset + mesh->index.size() * sizeof(unsigned int));
+
+	unsigned long long end = header.stringOffset;
+	for(int i=0; i<4; i++) end += sizeof(unsigned int) + mesh->paths[i].size();
+	if(mesh->hasMaterial){
+		header.materialOffset = AlignMeshOffset(end);
+		end = header.materialOffset + sizeof(TMeshFileMaterial);
+	}
+	header.fileSize = end;
+
+	for(int i=0; i<3; i++){
+		header.center[i] = mesh->center[i];
+		header.size[i] = mesh->size[i];
+	}
+
+	std::ofstream file(path, std::ios::binary);
+	if(!file.is_open()){
+		std::cout<<"Error al escribir el archivo: "<<path<<std::endl;
+		return false;
+	}
+
+	// Cada seccion se escribe de golpe, el relleno de alineacion son ceros
+	char padding[MESHFILE_ALIGNMENT] = {0};
+	unsigned long long written = sizeof(TMeshFileHeader);
+	file.write(reinterpret_cast<char*>(&header), sizeof(TMeshFileHeader));
+
+	file.write(padding, header.vertexOffset - written);
+	file.write(reinterpret_cast<char*>(data.data()), data.size() * sizeof(float));
+	written = header.vertexOffset + data.size() * sizeof(float);
+
+	file.write(padding, header.indexOffset - written);
+	file.write(reinterpret_cast<char*>(mesh->index.data()), mesh->index.size() * sizeof(unsigned int));
+	written = header.indexOffset + mesh->index.size() * sizeof(unsigned int);
+
+	file.write(padding, header.stringOffset - written);
+	written = header.stringOffset;
+	for(int i=0; i<4; i++){
+		unsigned int length = mesh->paths[i].size();
+		file.write(reinterpret_cast<char*>(&length), sizeof(unsigned int));
+		file.write(mesh->paths[i].data(), length);
+		written += sizeof(unsigned int) + length;
+	}
+
+	if(mesh->hasMaterial){
+		TMeshFileMaterial material = mesh->material;
+		memset(material.reserved, 0, sizeof(material.reserved));
+		file.write(padding, header.materialOffset - written);
+		file.write(reinterpret_cast<char*>(&material), sizeof(TMeshFileMaterial));
+	}
+
+	bool output = file.good();
+	file.close();
+	return output;
+}
+
+/*
+	FORMATO ANTIGUO (sin cabecera)
+	1º  SIZE 	- 3 FLOATS, SIZE
+	2º  CENTER	- 3 FLOATS, CENTER
+	3º  INT 	- SIZE DE VERTICES (3*SIZE = TOTAL FLOATS)
+	4º  FLOAT 	- VERTICES
+	5º  INT  	- SIZE DE UVS (2*SIZE = TOTAL FLOATS)
+	6º  FLOAT 	- UVS
+	7º  INT 	- SIZE DE NORMALES (3*SIZE = TOTAL FLOATS)
+	8º  FLOAT 	- NORMALES
+	9º  INT 	- SIZE DE ELEMENTOS
+	10º UINT	- ELEMENTOS
+	11º INT		- SIZE DEL STRING DE TEXTURA
+	12º CHAR	- CADA CHAR DEL STRING
+	13º INT		- SIZE DEL STRING DEL NORMAL MAP
+	14º CHAR	- CADA CHAR DEL STRING
+	15º INT 	- SIZE DEL STRING DEL SPECULAR MAP
+	16º CHAR	- CADA CHAR DEL STRING
+	17º INT		- SIZE DEL STRING DE MATERIAL
+	18º CHAR	- CADA CHAR DEL STRING
+*/
+
+template<typename T>
+static bool ReadLegacyArray(const unsigned char* data, unsigned long long fileSize, unsigned long long* position, std::vector<T>* output){
+	// Cada array lleva su numero de elementos delante, se copia entero de una vez
+	int size = 0;
+	if(fileSize - *position < sizeof(int)) return false;
+	memcpy(&size, data + *position, sizeof(int));
+	*position += sizeof(int);
+	if(size < 0 || (unsigned long long)size * sizeof(T) > fileSize - *position) return false;
+
+	output->resize(size);
+	if(size > 0) memcpy(output->data(), data + *position, size * sizeof(T));
+	*position += size * sizeof(T);
+	return true;
+}
+
+static bool ReadLegacyString(const unsigned char* data, unsigned long long fileSize, unsigned long long* position, std::string* output){
+	std::vector<char> chars;
+	if(!ReadLegacyArray(data, fileSize, position, &chars)) return false;
+	output->assign(chars.begin(), chars.end());
+	return true;
+}
+
+bool TMeshFile::LoadLegacy(const unsigned char* data, unsigned long long size, std::string path, TMeshData* mesh){
+	// -------------------------------------------------------------- 1º y 2º
+	glm::vec3 bounds[2];
+	unsigned long long position = sizeof(bounds);
+	bool read = size >= sizeof(bounds);
+	if(read) memcpy(bounds, data, sizeof(bounds));
+
+	// -------------------------------------------------------------- 3º a 18º
+	read = read && ReadLegacyArray(data, size, &position, &mesh->vertex);
+	read = read && ReadLegacyArray(data, size, &position, &mesh->uv);
+	read = read && ReadLegacyArray(data, size, &position, &mesh->normal);
+	read = read && ReadLegacyArray(data, size, &position, &mesh->index);
+	for(int i=0; i<4 && read; i++) read = ReadLegacyString(data, size, &position, &mesh->paths[i]);
+
+	if(!read){
+		std::cout<<"Mesh corrupto: "<<path<<std::endl;
+		return false;
+	}
+
+	if(!CheckIndices(mesh->index.data(), mesh->index.size(), mesh->vertex.size())){
+		std::cout<<"Mesh corrupto (elemento fuera de rango): "<<path<<std::endl;
+		return false;
+	}
+
+	mesh->size = bounds[0];
+	mesh->center = bounds[1];
+	mesh->hasMaterial = false;
+	return true;
+}
+
+std::string TMeshFile::GetCookedPath(std::string path){
+	std::size_t dot = path.find_last_of('.');
+	std::size_t slash = path.find_last_of("/\\");
+	if(dot != std::string::npos && (slash == std::string::npos || dot > slash)) path.erase(dot);
+	return path + ".toem";
+}
+
+std::string TMeshFile::ResolvePath(std::string meshPath, std::string path){
+	if(path.empty() || path[0] == '/' || path[0] == '\\' || path.find(':') != std::string::npos) return path;
+
+	std::size_t slash = meshPath.find_last_of("/\\");
+	if(slash == std::string::npos) return path;
+	return meshPath.substr(0, slash + 1) + path;
+}
\ No newline at end of file
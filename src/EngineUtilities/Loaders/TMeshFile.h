@@ -0,0 +1,157 @@
+#ifndef TMESHFILE_H
+#define TMESHFILE_H
+
+/**
+ * @brief Binary mesh format (TOEM) shared by the engine loader and the offline asset cooker. No OpenGL.
+ *
+ * @file TMeshFile.h
+ */
+
+#include <glm/vec3.hpp>
+#include <glm/vec2.hpp>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 	- Cabecera del formato binario de meshes, todos los campos en little endian
+ * 				Detras van las secciones de vertices intercalados, elementos, rutas y material, alineadas a 16 bytes
+ * 				Las rutas son textura, normal map, specular map y material, cada una con su longitud (uint32) delante
+ * 				La version 1 acaba en size (88 bytes), la 2 anyade materialOffset
+ */
+struct TMeshFileHeader{
+	char				magic[4];		// magic - Siempre "TOEM"
+	unsigned int		version;		// version - Version del formato
+	unsigned int		headerSize;		// headerSize - Tamanyo de la cabecera en bytes
+	unsigned int		flags;			// flags - MESHFILE_TANGENTS si los vertices llevan tangente
+	unsigned int		vertexCount;	// vertexCount - Numero de vertices
+	unsigned int		vertexStride;	// vertexStride - Bytes por vertice (32, o 44 con tangentes)
+	unsigned int		indexCount;		// indexCount - Numero de elementos, multiplo de 3
+	unsigned int		stringCount;	// stringCount - Numero de rutas
+	unsigned long long	vertexOffset;	// vertexOffset - Inicio de los vertices desde el principio del fichero
+	unsigned long long	indexOffset;	// indexOffset - Inicio de los elementos
+	unsigned long long	stringOffset;	// stringOffset - Inicio de las rutas
+	unsigned long long	fileSize;		// fileSize - Tamanyo total del fichero
+	float				center[3];		// center - Centro del bounding box
+	float				size[3];		// size - Tamanyo del bounding box
+	unsigned long long	materialOffset;	// materialOffset - Inicio del material ya resuelto (0 si no lleva, version 2)
+};
+
+/**
+ * @brief 	- Valores del material resueltos al cocinar, evitan leer el .mtl al arrancar
+ */
+struct TMeshFileMaterial{
+	float				ambient[3];		// ambient - Color ambiente (Ka)
+	float				diffuse[3];		// diffuse - Color difuso (Kd)
+	float				specular[3];	// specular - Color especular (Ks)
+	float				emissive[3];	// emissive - Color emisivo (Ke)
+	float				shininess;		// shininess - Brillo (Ns)
+	float				reserved[3];	// reserved - Relleno a 64 bytes, siempre 0
+};
+
+/**
+ * @brief 	- Mesh ya preparado en CPU, lo que se escribe o se lee de un fichero sin pasar por la grafica
+ */
+struct TMeshData{
+	std::vector<glm::vec3>		vertex;			// vertex - Posiciones de los vertices
+	std::vector<glm::vec2>		uv;				// uv - Uvs de los vertices
+	std::vector<glm::vec3>		normal;			// normal - Normales de los vertices
+	std::vector<glm::vec3>		tangent;		// tangent - Tangentes de los vertices (puede estar vacio)
+	std::vector<unsigned int>	index;			// index - Elementos, tres por triangulo
+	glm::vec3					center;			// center - Centro del bounding box
+	glm::vec3					size;			// size - Tamanyo del bounding box
+	std::string					paths[4];		// paths - Textura, normal map, specular map y nombre del material
+	bool						hasMaterial;	// hasMaterial - Se ha resuelto el material y se guarda en el fichero
+	TMeshFileMaterial			material;		// material - Valores del material resuelto
+};
+
+class TMeshFile{
+public:
+	/**
+	 * @brief	- Comprueba que la cabecera y los tamanyos de todas las secciones caben en el fichero
+	 * 				La cabecera se copia para poder leer las versiones con cabecera mas corta
+	 *
+	 * @param 	- data - Contenido del fichero
+	 * @param 	- size - Tamanyo del fichero
+	 * @param 	- path - Ruta del fichero para los mensajes de error
+	 * @param 	- header - Cabecera leida, los campos que no tiene la version del fichero quedan a 0
+	 * @return 	- bool - El fichero es valido
+	 */
+	static bool Validate(const unsigned char* data, unsigned long long size, std::string path, TMeshFileHeader* header);
+
+	/**
+	 * @brief	- Lee las rutas de un fichero ya validado
+	 *
+	 * @param 	- paths - Textura, normal map, specular map y material
+	 * @return 	- bool - Las rutas caben en el fichero
+	 */
+	static bool ReadStrings(const unsigned char* data, unsigned long long size, const TMeshFileHeader* header, std::string paths[4]);
+
+	/**
+	 * @brief	- Devuelve el material resuelto de un fichero ya validado, nullptr si no lleva
+	 */
+	static const TMeshFileMaterial* GetMaterial(const unsigned char* data, const TMeshFileHeader* header);
+
+	/**
+	 * @brief	- Guarda un mesh en el formato binario TOEM (version actual)
+	 * 				Las rutas se escriben tal cual, las de las texturas tienen que ser relativas a la carpeta del fichero
+	 *
+	 * @param 	- path - Ruta del fichero a escribir
+	 * @param 	- mesh - Mesh ya indexado con su bounding box
+	 * @return 	- bool - Se ha escrito correctamente
+	 */
+	static bool Save(std::string path, TMeshData* mesh);
+
+	/**
+	 * @brief	- Lee el formato binario antiguo, sin cabecera
+	 *
+	 * @param 	- data - Contenido del fichero
+	 * @param 	- size - Tamanyo del fichero
+	 * @param 	- path - Ruta del fichero para los mensajes de error
+	 * @param 	- mesh - Mesh en el que se guardan los vectores, el bounding box y las rutas
+	 * @return 	- bool - Se ha leido correctamente
+	 */
+	static bool LoadLegacy(const unsigned char* data, unsigned long long size, std::string path, TMeshData* mesh);
+
+	/**
+	 * @brief	- Comprueba que todos los elementos apuntan a un vertice existente
+	 * 				Un elemento fuera de rango haria leer a la grafica fuera del buffer
+	 *
+	 * @param 	- index - Elementos del mesh
+	 * @param 	- indexCount - Numero de elementos
+	 * @param 	- vertexCount - Numero de vertices
+	 * @return 	- bool - Todos los elementos estan en rango
+	 */
+	static bool CheckIndices(const unsigned int* index, unsigned long long indexCount, unsigned long long vertexCount);
+
+	/**
+	 * @brief	- Intercala los vertices en el formato del VAO: posicion / normal / uv / tangente (opcional)
+	 *
+	 * @param 	- data - Vector en el que se escriben los floats intercalados
+	 * @return 	- bool - Se han incluido las tangentes
+	 */
+	static bool InterleaveVertices(std::vector<glm::vec3>* vertex, std::vector<glm::vec2>* uv, std::vector<glm::vec3>* normal, std::vector<glm::vec3>* tangent, std::vector<float>* data);
+
+	/**
+	 * @brief	- Devuelve la ruta del fichero cocinado de un mesh (cube.obj -> cube.toem)
+	 */
+	static std::string GetCookedPath(std::string path);
+
+	/**
+	 * @brief	- Resuelve una ruta guardada en un fichero de version 2, relativa a la carpeta del mesh
+	 * 				Las rutas absolutas y las vacias se devuelven igual
+	 */
+	static std::string ResolvePath(std::string meshPath, std::string path);
+
+	/**
+	 * @brief	- Comprueba si el fichero empieza por el magic de TOEM
+	 */
+	static bool IsMeshFile(const unsigned char* data, unsigned long long size);
+
+	static const unsigned int MESHFILE_VERSION = 2;			// MESHFILE_VERSION - Version del formato que se escribe
+	static const unsigned int MESHFILE_MIN_VERSION = 1;		// MESHFILE_MIN_VERSION - Version mas antigua que se sabe leer
+	static const unsigned int MESHFILE_V1_HEADER = 88;		// MESHFILE_V1_HEADER - Tamanyo de la cabecera de la version 1
+	static const unsigned int MESHFILE_TANGENTS = 1;		// MESHFILE_TANGENTS - Flag de los vertices con tangente
+	static const unsigned int MESHFILE_ALIGNMENT = 16;		// MESHFILE_ALIGNMENT - Alineacion de las secciones
+};
+
+#endif
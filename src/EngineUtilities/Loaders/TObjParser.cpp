@@ -0,0 +1,682 @@
+#include "TObjParser.h"
+#include "TFileSystem.h"
+
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <thread>
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+
+// VBO = VERTEX BUFFER OBJECT
+static unsigned int HashPackedVertex(const PackedVertex* packed){
+	// Hash de los 8 floats tal cual (igual que el memcmp de antes, 0.0 y -0.0 son vertices distintos)
+	unsigned int words[8];
+	memcpy(words, packed, sizeof(words));
+	unsigned int hash = 2166136261u;
+	for(int i=0; i<8; i++){
+		hash ^= words[i];
+		hash *= 16777619u;
+		hash ^= hash >> 15;
+	}
+	return hash;
+}
+
+void TObjParser::IndexVBO(std::vector<glm::vec3>* vertexVec, std::vector<glm::vec2>* uvVec, std::vector<glm::vec3>* normalVec, std::vector<unsigned int>* indexVec, std::string name){
+	static_assert(sizeof(PackedVertex) == 8 * sizeof(float), "PackedVertex no puede tener relleno, se compara byte a byte");
+
+	// Tabla hash con direccionamiento abierto, guarda el vertice de salida de cada paquete distinto
+	int size = vertexVec->size();
+	unsigned int capacity = 16;
+	while(capacity < (unsigned int)size * 2) capacity <<= 1;
+	unsigned int mask = capacity - 1;
+	std::vector<int> table(capacity, -1);
+
+	// Los vertices unicos se compactan en los mismos vectores, el de salida nunca va por delante del de entrada
+	indexVec->clear();
+	indexVec->reserve(size);
+	int unique = 0;
+	for(int i=0; i<size; i++){
+		PackedVertex packed = {(*vertexVec)[i], (*uvVec)[i], (*normalVec)[i]};
+		unsigned int slot = HashPackedVertex(&packed) & mask;
+
+		while(table[slot] != -1){
+			int candidate = table[slot];
+			PackedVertex other = {(*vertexVec)[candidate], (*uvVec)[candidate], (*normalVec)[candidate]};
+			if(memcmp(&packed, &other, sizeof(PackedVertex)) == 0) break;
+			slot = (slot + 1) & mask;
+		}
+
+		if(table[slot] != -1){
+			indexVec->push_back(table[slot]);
+		}
+		else{
+			(*vertexVec)[unique] = packed.position;
+			(*uvVec)[unique] = packed.uv;
+			(*normalVec)[unique] = packed.normal;
+			table[slot] = unique;
+			indexVec->push_back(unique);
+			unique++;
+		}
+	}
+
+	vertexVec->resize(unique);
+	uvVec->resize(unique);
+	normalVec->resize(unique);
+
+	OptimizeMesh(vertexVec, uvVec, normalVec, indexVec, name);
+}
+
+// ============================================================================================================================================
+//
+// CACHE DE VERTICES
+//
+// ============================================================================================================================================
+
+/*
+	Orden de triangulos de Tom Forsyth (Linear-Speed Vertex Cache Optimisation): cada vertice tiene una puntuacion
+	segun su posicion en una cache LRU simulada y los triangulos que le quedan, y se anyade siempre el triangulo
+	con mas puntuacion de entre los que tocan la cache
+*/
+
+static const int FORSYTH_CACHE_SIZE = 32;			// FORSYTH_CACHE_SIZE - Tamanyo de la cache LRU simulada
+static const float FORSYTH_DECAY_POWER = 1.5f;		// FORSYTH_DECAY_POWER - Caida de la puntuacion con la posicion en cache
+static const float FORSYTH_LAST_TRIANGLE = 0.75f;	// FORSYTH_LAST_TRIANGLE - Puntuacion de los vertices del ultimo triangulo
+static const float FORSYTH_VALENCE_SCALE = 2.0f;	// FORSYTH_VALENCE_SCALE - Bonus de los vertices con pocos triangulos
+static const float FORSYTH_VALENCE_POWER = 0.5f;	// FORSYTH_VALENCE_POWER - Caida del bonus con los triangulos restantes
+
+static float ForsythScore(int cachePosition, int remaining){
+	if(remaining == 0) return -1.0f;
+
+	float score = 0.0f;
+	if(cachePosition < 0) score = 0.0f;
+	else if(cachePosition < 3) score = FORSYTH_LAST_TRIANGLE;
+	else score = std::pow(1.0f - (cachePosition - 3) * (1.0f / (FORSYTH_CACHE_SIZE - 3)), FORSYTH_DECAY_POWER);
+
+	return score + FORSYTH_VALENCE_SCALE * std::pow((float)remaining, -FORSYTH_VALENCE_POWER);
+}
+
+float TObjParser::ComputeACMR(std::vector<unsigned int>* indexVec, int vertexCount, int cacheSize){
+	// Cache FIFO como la de post-transformacion de la grafica, fallos por triangulo
+	int indexCount = indexVec->size();
+	if(indexCount < 3) return 0.0f;
+
+	std::vector<int> stamp(vertexCount, -cacheSize - 1);
+	int misses = 0;
+	for(int i=0; i<indexCount; i++){
+		unsigned int vertex = (*indexVec)[i];
+		if(misses - stamp[vertex] > cacheSize){
+			stamp[vertex] = misses;
+			misses++;
+		}
+	}
+	return (float)misses / (indexCount / 3);
+}
+
+void TObjParser::OptimizeVertexCache(std::vector<unsigned int>* indexVec, int vertexCount){
+	int triangleCount = indexVec->size() / 3;
+	if(triangleCount < 2) return;
+	const unsigned int* indices = indexVec->data();
+
+	// Triangulos de cada vertice en un solo vector (offset + cuenta)
+	std::vector<int> remaining(vertexCount, 0), offsets(vertexCount + 1, 0);
+	for(int i=0; i<triangleCount * 3; i++) remaining[indices[i]]++;
+	for(int v=0; v<vertexCount; v++) offsets[v + 1] = offsets[v] + remaining[v];
+
+	std::vector<int> adjacency(triangleCount * 3), fill(offsets.begin(), offsets.end() - 1);
+	for(int t=0; t<triangleCount; t++){
+		for(int k=0; k<3; k++) adjacency[fill[indices[t * 3 + k]]++] = t;
+	}
+
+	std::vector<int> cachePosition(vertexCount, -1);
+	std::vector<float> vertexScore(vertexCount), triangleScore(triangleCount, 0.0f);
+	std::vector<char> added(triangleCount, 0);
+	for(int v=0; v<vertexCount; v++) vertexScore[v] = ForsythScore(-1, remaining[v]);
+	for(int t=0; t<triangleCount; t++){
+		for(int k=0; k<3; k++) triangleScore[t] += vertexScore[indices[t * 3 + k]];
+	}
+
+	std::vector<unsigned int> output;
+	output.reserve(triangleCount * 3);
+	int cache[FORSYTH_CACHE_SIZE + 3], cacheSize = 0, newCache[FORSYTH_CACHE_SIZE + 3];
+	int cursor = 0;
+	int best = 0;
+
+	for(int count=0; count<triangleCount; count++){
+		// Si ningun triangulo de la cache sirve cogemos el siguiente sin anyadir
+		if(best < 0){
+			while(added[cursor]) cursor++;
+			best = cursor;
+		}
+
+		added[best] = 1;
+		const unsigned int* triangle = indices + best * 3;
+		for(int k=0; k<3; k++){
+			unsigned int v = triangle[k];
+			output.push_back(v);
+
+			// Quitamos el triangulo de los pendientes del vertice
+			int begin = offsets[v], end = begin + remaining[v];
+			for(int a=begin; a<end; a++){
+				if(adjacency[a] == best){
+					adjacency[a] = adjacency[end - 1];
+					break;
+				}
+			}
+			remaining[v]--;
+		}
+
+		// Los vertices del triangulo pasan al principio de la cache, el resto se desplaza
+		int newSize = 0;
+		for(int k=0; k<3; k++) newCache[newSize++] = triangle[k];
+		for(int c=0; c<cacheSize; c++){
+			int v = cache[c];
+			if(v != (int)triangle[0] && v != (int)triangle[1] && v != (int)triangle[2]) newCache[newSize++] = v;
+		}
+		for(int c=FORSYTH_CACHE_SIZE; c<newSize; c++) cachePosition[newCache[c]] = -1;
+		cacheSize = std::min(newSize, FORSYTH_CACHE_SIZE);
+		for(int c=0; c<cacheSize; c++){
+			cache[c] = newCache[c];
+			cachePosition[cache[c]] = c;
+		}
+
+		// Recalculamos las puntuaciones de los vertices de la cache (y los que acaban de salir) y sus triangulos
+		best = -1;
+		float bestScore = -1.0f;
+		for(int c=0; c<newSize; c++){
+			int v = newCache[c];
+			float score = ForsythScore(cachePosition[v], remaining[v]);
+			float delta = score - vertexScore[v];
+			vertexScore[v] = score;
+
+			int begin = offsets[v], end = begin + remaining[v];
+			for(int a=begin; a<end; a++){
+				int t = adjacency[a];
+				triangleScore[t] += delta;
+				if(c < cacheSize && triangleScore[t] > bestScore){
+					bestScore = triangleScore[t];
+					best = t;
+				}
+			}
+		}
+	}
+
+	indexVec->swap(output);
+}
+
+void TObjParser::OptimizeVertexFetch(std::vector<glm::vec3>* vertexVec, std::vector<glm::vec2>* uvVec, std::vector<glm::vec3>* normalVec, std::vector<unsigned int>* indexVec){
+	// Los vertices se ordenan por su primer uso en los elementos, la grafica los lee casi en orden
+	int vertexCount = vertexVec->size();
+	std::vector<int> remap(vertexCount, -1);
+	std::vector<glm::vec3> vertex, normal;
+	std::vector<glm::vec2> uv;
+	vertex.reserve(vertexCount);
+	uv.reserve(vertexCount);
+	normal.reserve(vertexCount);
+
+	int indexCount = indexVec->size();
+	for(int i=0; i<indexCount; i++){
+		unsigned int old = (*indexVec)[i];
+		if(remap[old] == -1){
+			remap[old] = vertex.size();
+			vertex.push_back((*vertexVec)[old]);
+			uv.push_back((*uvVec)[old]);
+			normal.push_back((*normalVec)[old]);
+		}
+		(*indexVec)[i] = remap[old];
+	}
+
+	vertexVec->swap(vertex);
+	uvVec->swap(uv);
+	normalVec->swap(normal);
+}
+
+void TObjParser::OptimizeMesh(std::vector<glm::vec3>* vertexVec, std::vector<glm::vec2>* uvVec, std::vector<glm::vec3>* normalVec, std::vector<unsigned int>* indexVec, std::string name){
+	int vertexCount = vertexVec->size();
+	if(indexVec->size() < 6) return;
+
+	float before = ComputeACMR(indexVec, vertexCount);
+	OptimizeVertexCache(indexVec, vertexCount);
+	OptimizeVertexFetch(vertexVec, uvVec, normalVec, indexVec);
+	float after = ComputeACMR(indexVec, vertexVec->size());
+
+	// Se monta la linea entera antes de escribirla, el cocinador optimiza varios meshes a la vez
+	std::stringstream line;
+	line<<std::fixed<<std::setprecision(3)<<"ACMR "<<name<<": "<<before<<" -> "<<after<<" ("<<indexVec->size() / 3<<" triangulos)\n";
+	std::cout<<line.str()<<std::flush;
+}
+
+bool TObjParser::ComputeBoundingBox(std::vector<glm::vec3>* vertexVec, glm::vec3* center, glm::vec3* size){
+	if(vertexVec->empty()) return false;
+
+	// Miramos cuales son los vertices mas alejados en cada eje
+	glm::vec3 min = vertexVec->at(0), max = vertexVec->at(0);
+	int count = vertexVec->size();
+	for(int i=0; i<count; i++){
+		min = glm::min(min, vertexVec->at(i));
+		max = glm::max(max, vertexVec->at(i));
+	}
+
+	// A partir de estos valores calculamos el tamanyo y el centro del bounding box
+	*size = max - min;
+	*center = (min + max) / 2.0f;
+	return true;
+}
+
+// ============================================================================================================================================
+//
+// OBJ
+//
+// ============================================================================================================================================
+
+/*
+	El obj se mapea en memoria y se parte en trozos que empiezan en un salto de linea, cada hilo lee uno
+	Los indices negativos (relativos) de un trozo no se pueden resolver hasta saber cuantos vertices tienen los anteriores,
+	se guardan respecto al principio del trozo y se resuelven al juntarlos
+*/
+
+static const unsigned char OBJ_RELATIVE = 1;		// OBJ_RELATIVE - Bit del indice relativo al trozo (por componente)
+static const unsigned char OBJ_MISSING = 8;			// OBJ_MISSING - Bit del indice que no viene en la cara (por componente)
+
+struct TObjCorner{
+	int				index[3];		// index - Posicion, uv y normal (base 0)
+	unsigned char	flags;			// flags - OBJ_RELATIVE << componente y OBJ_MISSING << componente
+};
+
+struct TObjChunk{
+	const char*					begin;			// begin - Primer caracter del trozo
+	const char*					end;			// end - Final del trozo (justo despues de un salto de linea)
+	std::vector<glm::vec3>		vertex;			// vertex - Posiciones del trozo
+	std::vector<glm::vec2>		uv;				// uv - Uvs del trozo
+	std::vector<glm::vec3>		normal;			// normal - Normales del trozo
+	std::vector<TObjCorner>		corners;		// corners - Tres esquinas por triangulo
+	std::string					materialLib;	// materialLib - Primer mtllib del trozo
+	std::string					materialName;	// materialName - Primer usemtl del trozo
+	const char*					error;			// error - Motivo por el que no se ha podido leer, nullptr si todo bien
+};
+
+static inline bool IsObjSpace(char c){
+	return c == ' ' || c == '\t';
+}
+
+static inline bool IsObjDigit(char c){
+	return c >= '0' && c <= '9';
+}
+
+static const char* SkipObjSpaces(const char* c, const char* end){
+	while(c < end && IsObjSpace(*c)) c++;
+	return c;
+}
+
+static const char* NextObjLine(const char* c, const char* end){
+	while(c < end && *c != '\n') c++;
+	return c < end ? c + 1 : end;
+}
+
+static const char* ParseObjFloat(const char* c, const char* end, float* output, bool* ok){
+	// Potencias exactas en double, con 19 cifras de mantisa el redondeo a float es correcto en la practica
+	static const double powers[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+	c = SkipObjSpaces(c, end);
+	bool negative = false;
+	if(c < end && (*c == '-' || *c == '+')) negative = *c++ == '-';
+
+	unsigned long long mantissa = 0;
+	int digits = 0, exponent = 0;
+	const char* start = c;
+	for(; c < end && IsObjDigit(*c); c++){
+		if(digits < 19){ mantissa = mantissa * 10 + (*c - '0'); if(mantissa != 0) digits++; }
+		else exponent++;
+	}
+	if(c < end && *c == '.'){
+		for(c++; c < end && IsObjDigit(*c); c++){
+			if(digits < 19){ mantissa = mantissa * 10 + (*c - '0'); exponent--; if(mantissa != 0) digits++; }
+		}
+	}
+	if(c == start || (c == start + 1 && *start == '.')){
+		*ok = false;
+		return c;
+	}
+	if(c < end && (*c == 'e' || *c == 'E')){
+		const char* exponentStart = c++;
+		bool negativeExponent = false;
+		if(c < end && (*c == '-' || *c == '+')) negativeExponent = *c++ == '-';
+		if(c < end && IsObjDigit(*c)){
+			int value = 0;
+			for(; c < end && IsObjDigit(*c); c++) if(value < 10000) value = value * 10 + (*c - '0');
+			exponent += negativeExponent ? -value : value;
+		}
+		else c = exponentStart;
+	}
+
+	double value = (double)mantissa;
+	if(exponent < 0) value = exponent >= -22 ? value / powers[-exponent] : value * std::pow(10.0, exponent);
+	else if(exponent > 0) value = exponent <= 22 ? value * powers[exponent] : value * std::pow(10.0, exponent);
+
+	*output = (float)(negative ? -value : value);
+	return c;
+}
+
+static const char* ParseObjInt(const char* c, const char* end, int* output, bool* ok){
+	bool negative = false;
+	if(c < end && (*c == '-' || *c == '+')) negative = *c++ == '-';
+	if(c >= end || !IsObjDigit(*c)){
+		*ok = false;
+		return c;
+	}
+
+	long long value = 0;
+	for(; c < end && IsObjDigit(*c); c++) if(value < 0x7FFFFFFF) value = value * 10 + (*c - '0');
+	if(value > 0x7FFFFFFF) value = 0x7FFFFFFF;
+	*output = negative ? -(int)value : (int)value;
+	return c;
+}
+
+static std::string ReadObjName(const char* c, const char* end){
+	// El resto de la linea sin espacios a los lados, los nombres pueden tener espacios
+	c = SkipObjSpaces(c, end);
+	const char* last = c;
+	while(last < end && *last != '\n' && *last != '\r') last++;
+	while(last > c && IsObjSpace(*(last - 1))) last--;
+	return std::string(c, last - c);
+}
+
+static void ParseObjChunk(TObjChunk* chunk){
+	const char* c = chunk->begin;
+	const char* end = chunk->end;
+	std::vector<TObjCorner> face;
+	chunk->error = nullptr;
+
+	while(c < end && chunk->error == nullptr){
+		const char* line = SkipObjSpaces(c, end);
+		const char* next = NextObjLine(line, end);
+		bool ok = true;
+
+		if(line + 1 < end && line[0] == 'v' && IsObjSpace(line[1])){
+			glm::vec3 vertex;
+			const char* p = ParseObjFloat(line + 1, end, &vertex.x, &ok);
+			p = ParseObjFloat(p, end, &vertex.y, &ok);
+			ParseObjFloat(p, end, &vertex.z, &ok);
+			chunk->vertex.push_back(vertex);
+		}
+		else if(line + 2 < end && line[0] == 'v' && line[1] == 't' && IsObjSpace(line[2])){
+			// La v es opcional en el formato
+			glm::vec2 uv(0, 0);
+			const char* p = SkipObjSpaces(ParseObjFloat(line + 2, end, &uv.x, &ok), end);
+			if(p < end && *p != '\n' && *p != '\r') ParseObjFloat(p, end, &uv.y, &ok);
+			uv.y = 1.0f - uv.y;
+			chunk->uv.push_back(uv);
+		}
+		else if(line + 2 < end && line[0] == 'v' && line[1] == 'n' && IsObjSpace(line[2])){
+			glm::vec3 normal;
+			const char* p = ParseObjFloat(line + 2, end, &normal.x, &ok);
+			p = ParseObjFloat(p, end, &normal.y, &ok);
+			ParseObjFloat(p, end, &normal.z, &ok);
+			chunk->normal.push_back(normal);
+		}
+		else if(line + 1 < end && line[0] == 'f' && IsObjSpace(line[1])){
+			// Cada esquina es v, v/vt, v//vn o v/vt/vn, con indices positivos (base 1) o negativos (desde el final)
+			int counts[3] = {(int)chunk->vertex.size(), (int)chunk->uv.size(), (int)chunk->normal.size()};
+			face.clear();
+			const char* p = SkipObjSpaces(line + 1, end);
+			while(ok && p < end && *p != '\n' && *p != '\r' && *p != '#'){
+				TObjCorner corner;
+				corner.flags = 0;
+				for(int i=0; i<3 && ok; i++){
+					bool present = i == 0 || (p < end && *p == '/');
+					if(i > 0 && present) p++;
+					if(i > 0 && present && (p >= end || *p == '/' || IsObjSpace(*p) || *p == '\n' || *p == '\r')) present = false;
+
+					int value = 0;
+					if(present) p = ParseObjInt(p, end, &value, &ok);
+					if(!present || value == 0){
+						if(i == 0) ok = false;
+						corner.flags |= OBJ_MISSING << i;
+						corner.index[i] = 0;
+					}
+					else if(value < 0){
+						corner.flags |= OBJ_RELATIVE << i;
+						corner.index[i] = counts[i] + value;
+					}
+					else corner.index[i] = value - 1;
+				}
+				face.push_back(corner);
+				p = SkipObjSpaces(p, end);
+			}
+			if(!ok) chunk->error = "cara mal formada";
+
+			// Los poligonos se triangulan en abanico desde la primera esquina
+			int cornerCount = face.size();
+			for(int i=1; ok && i + 1 < cornerCount; i++){
+				chunk->corners.push_back(face[0]);
+				chunk->corners.push_back(face[i]);
+				chunk->corners.push_back(face[i + 1]);
+			}
+		}
+		else if(next - line > 7 && strncmp(line, "mtllib", 6) == 0 && IsObjSpace(line[6])){
+			if(chunk->materialLib.empty()) chunk->materialLib = ReadObjName(line + 6, end);
+		}
+		else if(next - line > 7 && strncmp(line, "usemtl", 6) == 0 && IsObjSpace(line[6])){
+			if(chunk->materialName.empty()) chunk->materialName = ReadObjName(line + 6, end);
+		}
+
+		if(!ok && chunk->error == nullptr) chunk->error = "numero mal formado";
+		c = next;
+	}
+}
+
+static void ClearObjOutput(std::vector<glm::vec3>* vertexVec, std::vector<glm::vec2>* uvVec, std::vector<glm::vec3>* normalVec, std::vector<unsigned int>* indexVec){
+	vertexVec->clear();
+	uvVec->clear();
+	normalVec->clear();
+	indexVec->clear();
+}
+
+bool TObjParser::ParseObj(std::string path, std::vector<glm::vec3>* vertexVec, std::vector<glm::vec2>* uvVec, std::vector<glm::vec3>* normalVec, std::vector<unsigned int>* indexVec, std::string* materialLib, std::string* materialName){
+	// Si falla cualquier trozo no se devuelve nada a medias
+	ClearObjOutput(vertexVec, uvVec, normalVec, indexVec);
+
+	TVirtualFile file;
+	if(!file.Open(path)){
+		std::cout<<"Impossible to open the file !\n";
+		return false;
+	}
+	const char* data = (const char*)file.GetData();
+	unsigned long long size = file.GetSize();
+
+	// Un trozo por hilo, pero sin trozos demasiado pequenyos para que no cueste mas crear los hilos que leer
+	unsigned long long chunkCount = std::max(1u, std::thread::hardware_concurrency());
+	chunkCount = std::max(1ull, std::min(chunkCount, size / m_minChunkSize));
+
+	std::vector<TObjChunk> chunks(chunkCount);
+	const char* begin = data;
+	for(unsigned long long i=0; i<chunkCount; i++){
+		const char* end = i + 1 == chunkCount ? data + size : NextObjLine(data + size * (i + 1) / chunkCount, data + size);
+		chunks[i].begin = begin;
+		chunks[i].end = std::max(begin, end);
+		begin = chunks[i].end;
+	}
+
+	std::vector<std::thread> threads;
+	for(unsigned long long i=1; i<chunkCount; i++) threads.push_back(std::thread(ParseObjChunk, &chunks[i]));
+	ParseObjChunk(&chunks[0]);
+	for(unsigned int i=0; i<threads.size(); i++) threads[i].join();
+
+	// Juntamos los trozos, cada uno empieza donde acaba el anterior
+	std::vector<glm::vec3> positions, normals;
+	std::vector<glm::vec2> uvs;
+	std::vector<int> bases(chunkCount * 3);
+	unsigned long long totals[4] = {0, 0, 0, 0};
+	for(unsigned long long i=0; i<chunkCount; i++){
+		if(chunks[i].error != nullptr){
+			std::cout<<"File can't be read by our simple parser ("<<chunks[i].error<<"): "<<path<<std::endl;
+			return false;
+		}
+		bases[i * 3] = totals[0];
+		bases[i * 3 + 1] = totals[1];
+		bases[i * 3 + 2] = totals[2];
+		totals[0] += chunks[i].vertex.size();
+		totals[1] += chunks[i].uv.size();
+		totals[2] += chunks[i].normal.size();
+		totals[3] += chunks[i].corners.size();
+
+		if(materialLib != nullptr && materialLib->empty()) *materialLib = chunks[i].materialLib;
+		if(materialName != nullptr && materialName->empty()) *materialName = chunks[i].materialName;
+	}
+	if(totals[3] == 0 || totals[0] >= 0x7FFFFFFF || totals[3] >= 0x7FFFFFFF){
+		std::cout<<"File can't be read by our simple parser (sin triangulos): "<<path<<std::endl;
+		return false;
+	}
+
+	positions.reserve(totals[0]);
+	uvs.reserve(totals[1]);
+	normals.reserve(totals[2]);
+	for(unsigned long long i=0; i<chunkCount; i++){
+		positions.insert(positions.end(), chunks[i].vertex.begin(), chunks[i].vertex.end());
+		uvs.insert(uvs.end(), chunks[i].uv.begin(), chunks[i].uv.end());
+		normals.insert(normals.end(), chunks[i].normal.begin(), chunks[i].normal.end());
+		std::vector<glm::vec3>().swap(chunks[i].vertex);
+		std::vector<glm::vec2>().swap(chunks[i].uv);
+		std::vector<glm::vec3>().swap(chunks[i].normal);
+	}
+
+	// Las esquinas con la misma posicion, uv y normal son el mismo vertice. Cada posicion guarda la lista de
+	// combinaciones uv/normal que ya han salido, casi siempre tiene una o dos. Las esquinas sin normal usan la
+	// del triangulo y no se comparten entre caras
+	std::vector<int> firstVariant(totals[0], -1);
+	std::vector<int> nextVariant;
+	std::vector<int> variantKeys;
+	nextVariant.reserve(totals[0]);
+	variantKeys.reserve(totals[0] * 2);
+	int limits[3] = {(int)totals[0], (int)totals[1], (int)totals[2]};
+
+	vertexVec->reserve(totals[0]);
+	uvVec->reserve(totals[0]);
+	normalVec->reserve(totals[0]);
+	indexVec->reserve(totals[3]);
+
+	int triangle = 0;
+	for(unsigned long long i=0; i<chunkCount; i++){
+		std::vector<TObjCorner>& corners = chunks[i].corners;
+		int cornerCount = corners.size();
+		for(int j=0; j<cornerCount; j += 3, triangle++){
+			int resolved[3][3];
+			for(int k=0; k<3; k++){
+				for(int c=0; c<3; c++){
+					const TObjCorner& corner = corners[j + k];
+					if(corner.flags & (OBJ_MISSING << c)){
+						resolved[k][c] = c == 2 ? -2 - triangle : -1;
+						continue;
+					}
+					int index = corner.index[c] + ((corner.flags & (OBJ_RELATIVE << c)) ? bases[i * 3 + c] : 0);
+					if(index < 0 || index >= limits[c]){
+						std::cout<<"Indice fuera de rango en el obj: "<<path<<std::endl;
+						ClearObjOutput(vertexVec, uvVec, normalVec, indexVec);
+						return false;
+					}
+					resolved[k][c] = index;
+				}
+			}
+
+			// Basta con que le falte la normal a una esquina para necesitar la del triangulo
+			glm::vec3 faceNormal(0, 1, 0);
+			if(resolved[0][2] < 0 || resolved[1][2] < 0 || resolved[2][2] < 0){
+				glm::vec3 p0 = positions[resolved[0][0]], p1 = positions[resolved[1][0]], p2 = positions[resolved[2][0]];
+				glm::vec3 cross = glm::cross(p1 - p0, p2 - p0);
+				float length = glm::length(cross);
+				if(length > 0.0f) faceNormal = cross / length;
+			}
+
+			for(int k=0; k<3; k++){
+				int position = resolved[k][0];
+				int variant = firstVariant[position];
+				while(variant != -1 && (variantKeys[variant * 2] != resolved[k][1] || variantKeys[variant * 2 + 1] != resolved[k][2])){
+					variant = nextVariant[variant];
+				}
+
+				// El numero de combinacion es directamente el indice del vertice de salida
+				if(variant == -1){
+					variant = nextVariant.size();
+					nextVariant.push_back(firstVariant[position]);
+					variantKeys.push_back(resolved[k][1]);
+					variantKeys.push_back(resolved[k][2]);
+					firstVariant[position] = variant;
+
+					vertexVec->push_back(positions[position]);
+					uvVec->push_back(resolved[k][1] >= 0 ? uvs[resolved[k][1]] : glm::vec2(0, 0));
+					normalVec->push_back(resolved[k][2] >= 0 ? normals[resolved[k][2]] : faceNormal);
+				}
+				indexVec->push_back(variant);
+			}
+		}
+	}
+
+	return true;
+}
+
+bool TObjParser::ParseMaterial(std::string path, std::string* name, TMeshFileMaterial* material, std::string textures[3]){
+	std::string content;
+	if(!TFileSystem::GetInstance()->ReadText(path, &content)) return false;
+	std::istringstream readFile(content);
+
+	// Leemos todos los materiales del fichero y al final nos quedamos con el que se busca
+	struct TParsedMaterial{
+		std::string			name;
+		TMeshFileMaterial	values;
+		std::string			textures[3];
+	};
+	std::vector<TParsedMaterial> materials;
+
+	std::string line;
+	while(std::getline(readFile, line)){
+		std::istringstream stream(line);
+		std::string token;
+		if(!(stream >> token) || token[0] == '#') continue;
+
+		if(token.compare("newmtl") == 0){
+			// Valores por defecto de TResourceMaterial
+			TParsedMaterial parsed;
+			stream >> parsed.name;
+			for(int i=0; i<3; i++){
+				parsed.values.ambient[i] = parsed.values.diffuse[i] = parsed.values.specular[i] = parsed.values.emissive[i] = 1.0f;
+				parsed.values.reserved[i] = 0.0f;
+			}
+			parsed.values.shininess = 1.0f;
+			materials.push_back(parsed);
+			continue;
+		}
+		if(materials.empty()) continue;
+
+		TParsedMaterial& current = materials.back();
+		float* color = nullptr;
+		if(token.compare("Ns") == 0) stream >> current.values.shininess;
+		else if(token.compare("Ka") == 0) color = current.values.ambient;
+		else if(token.compare("Kd") == 0) color = current.values.diffuse;
+		else if(token.compare("Ks") == 0) color = current.values.specular;
+		else if(token.compare("Ke") == 0) color = current.values.emissive;
+		else if(token.compare("map_Kd") == 0) stream >> current.textures[0];
+		else if(token.compare("map_Bump") == 0 || token.compare("map_bump") == 0 || token.compare("bump") == 0) stream >> current.textures[1];
+		else if(token.compare("map_Ks") == 0) stream >> current.textures[2];
+
+		if(color != nullptr) stream >> color[0] >> color[1] >> color[2];
+	}
+
+	if(materials.empty()) return false;
+
+	int chosen = 0;
+	int count = materials.size();
+	for(int i=0; i<count; i++){
+		if(materials[i].name == *name){
+			chosen = i;
+			break;
+		}
+	}
+
+	*name = materials[chosen].name;
+	*material = materials[chosen].values;
+	for(int i=0; i<3; i++) textures[i] = materials[chosen].textures[i];
+	return true;
+}
\ No newline at end of file
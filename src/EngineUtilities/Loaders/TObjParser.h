@@ -0,0 +1,110 @@
+#ifndef TOBJPARSER_H
+#define TOBJPARSER_H
+
+/**
+ * @brief Text OBJ / MTL parsing and vertex indexing without OpenGL, used by the loader and the offline asset cooker.
+ *
+ * @file TObjParser.h
+ */
+
+#include "TMeshFile.h"
+#include <glm/vec3.hpp>
+#include <glm/vec2.hpp>
+
+#include <string>
+#include <vector>
+
+/**
+ * @brief 	- Struct que se utiliza para saber el numero de elemtos que componen el objeto
+ * 				a traves de la posicion, uv, y normal de cada vertice (clave de la tabla hash de IndexVBO)
+ */
+struct PackedVertex{
+	glm::vec3 position;
+	glm::vec2 uv;
+	glm::vec3 normal;
+};
+
+class TObjParser{
+public:
+	/**
+	 * @brief	- Leemos un obj de texto ya indexado: las esquinas con los mismos indices v/vt/vn comparten vertice
+	 * 				El fichero se mapea en memoria y los ficheros grandes se leen en trozos, uno por hilo
+	 * 				Acepta poligonos (se triangulan en abanico), indices negativos y caras sin uv o sin normal
+	 * 				(uv 0,0 y la normal del triangulo)
+	 *
+	 * @param 	- path - Ruta del obj
+	 * @param 	- vertex - Vertices del mesh
+	 * @param 	- uv - Uvs del mesh
+	 * @param 	- normal - Normales del mesh
+	 * @param 	- index - Elementos del mesh, tres por triangulo
+	 * @param 	- materialLib - Devuelve el fichero de mtllib, opcional
+	 * @param 	- materialName - Devuelve el primer usemtl, opcional
+	 * @return	- bool - Se ha leido el obj correctamente
+	 */
+	static bool ParseObj(std::string path, std::vector<glm::vec3>* vertex, std::vector<glm::vec2>* uv, std::vector<glm::vec3>* normal, std::vector<unsigned int>* index, std::string* materialLib = nullptr, std::string* materialName = nullptr);
+
+	/**
+	 * @brief	- Leemos un material de un mtl. Si no hay ninguno con ese nombre se coge el primero del fichero,
+	 * 				igual que hace el cargador de materiales al cargar todo el fichero
+	 *
+	 * @param 	- path - Ruta del mtl
+	 * @param 	- name - Nombre del material, se sustituye por el encontrado
+	 * @param 	- material - Valores del material (los que no aparecen se quedan con los de TResourceMaterial)
+	 * @param 	- textures - Rutas de map_Kd, map_Bump y map_Ks tal y como aparecen en el fichero
+	 * @return 	- bool - Se ha encontrado el material
+	 */
+	static bool ParseMaterial(std::string path, std::string* name, TMeshFileMaterial* material, std::string textures[3]);
+
+	/**
+	 * @brief	- Indexamos los vertices para conseguir los elementos del objeto y los optimizamos con OptimizeMesh
+	 * 				Los vertices iguales (byte a byte) se buscan en una tabla hash y se compactan en los mismos vectores
+	 *
+	 * @param 	- vertex - Vertices del mesh
+	 * @param 	- uvs - Uvs del mesh
+	 * @param 	- normals - Normales del mesh
+	 * @param 	- index - Elementos del mesh
+	 * @param 	- name - Nombre del mesh para el mensaje del ACMR
+	 */
+	static void IndexVBO(std::vector<glm::vec3>* vertex, std::vector<glm::vec2>* uv, std::vector<glm::vec3>* normal, std::vector<unsigned int>* index, std::string name = "");
+
+	/**
+	 * @brief	- Reordena los triangulos para la cache de post-transformacion y despues los vertices en orden de uso
+	 * 				Escribe por consola el ACMR (fallos de cache por triangulo) de antes y de despues
+	 *
+	 * @param 	- name - Nombre del mesh para el mensaje
+	 */
+	static void OptimizeMesh(std::vector<glm::vec3>* vertex, std::vector<glm::vec2>* uv, std::vector<glm::vec3>* normal, std::vector<unsigned int>* index, std::string name = "");
+
+	/**
+	 * @brief	- Reordena los triangulos con el algoritmo de Forsyth para reutilizar vertices de la cache
+	 *
+	 * @param 	- index - Elementos del mesh
+	 * @param 	- vertexCount - Numero de vertices
+	 */
+	static void OptimizeVertexCache(std::vector<unsigned int>* index, int vertexCount);
+
+	/**
+	 * @brief	- Reordena los vertices por su primer uso en los elementos, quita los que no se usan
+	 */
+	static void OptimizeVertexFetch(std::vector<glm::vec3>* vertex, std::vector<glm::vec2>* uv, std::vector<glm::vec3>* normal, std::vector<unsigned int>* index);
+
+	/**
+	 * @brief	- Calcula los fallos de cache por triangulo con una cache FIFO
+	 *
+	 * @param 	- cacheSize - Entradas de la cache simulada
+	 * @return 	- float - ACMR, entre 0.5 (ideal) y 3
+	 */
+	static float ComputeACMR(std::vector<unsigned int>* index, int vertexCount, int cacheSize = 16);
+
+	/**
+	 * @brief	- Calculamos el centro y el tamanyo del bounding box de los vertices
+	 *
+	 * @return 	- bool - Habia vertices para calcularlo
+	 */
+	static bool ComputeBoundingBox(std::vector<glm::vec3>* vertex, glm::vec3* center, glm::vec3* size);
+
+private:
+	static const unsigned long long m_minChunkSize = 4 << 20;	// m_minChunkSize - Bytes minimos de obj por hilo
+};
+
+#endif
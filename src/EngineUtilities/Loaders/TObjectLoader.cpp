@@ -1,100 +1,27 @@
 #include "TObjectLoader.h"
 #include "TMaterialLoader.h"
+#include "TFileSystem.h"
+#include "TObjParser.h"
 #include "./../TResourceManager.h"
 
 //Headers to load models
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
+#include <assimp/IOSystem.hpp>
+#include <assimp/IOStream.hpp>
 
 #include <GL/glew.h>
 #include <iostream>
-#include <fstream>
-#include <stdio.h>
-
-// VBO = VERTEX BUFFER OBJECT
-bool PackedVertex::operator<(const PackedVertex that) const{
-	return memcmp((void*)this, (void*)&that, sizeof(PackedVertex))>0;
-};
-
-bool TObjectLoader::GetSimilarVertexIndex_fast(PackedVertex* packed, std::map<PackedVertex,unsigned int>* VertexToOutIndex, unsigned int* result){
-	// Buscamos a ver si existe un packete igual al actual
-	std::map<PackedVertex,unsigned int>::iterator it = VertexToOutIndex->find(*packed);
-	bool output = false;
-	if ( it == VertexToOutIndex->end() ){
-		output = false;
-	}else{
-		// En el caso de haberlo encontrado nos guardamos el elemento en la variable result
-		*result = it->second;
-		output = true;
-	}
-	// Devolvemos el resultado de la busqueda
-	return output;
-}
-
-void TObjectLoader::IndexVBO(TResourceMesh* mesh, std::vector<glm::vec3>* vertexVec, std::vector<glm::vec2>* uvVec, std::vector<glm::vec3>* normalVec, std::vector<unsigned int>* indexVec){
-	std::map<PackedVertex, unsigned int> VertexToOutIndex;
-	std::vector<glm::vec3> temp_vertices, temp_normals;
-	std::vector<glm::vec2> temp_uvs;
-
-	// Copio los vectores que han pasado en otros temporales
-	temp_vertices.insert	(temp_vertices.begin(), 	vertexVec->begin(), 	vertexVec->end());
-	temp_uvs.insert			(temp_uvs.begin(), 			uvVec->begin(), 		uvVec->end());
-	temp_normals.insert		(temp_normals.begin(), 		normalVec->begin(), 	normalVec->end());
-
-	// Una vez copiados los valores, procedo a vaciar los pasados por parametros
-	vertexVec->clear();
-	uvVec->clear();
-	normalVec->clear();
-	indexVec->clear();
-	// For each input vertex
-	int size = temp_vertices.size();
-	for ( unsigned int i=0; i<size; i++ ){
-
-		PackedVertex packed = {temp_vertices[i], temp_uvs[i], temp_normals[i]};
-	
-			// Try to find a similar vertex in out_XXXX
-		unsigned int index;
-		bool found = GetSimilarVertexIndex_fast(&packed, &VertexToOutIndex, &index);
-
-		if (found){ // A similar vertex is already in the VBO, use it instead !
-			indexVec->push_back(index);
-		}else{ // If not, it needs to be added in the output data.
-			vertexVec->push_back(temp_vertices[i]);
-			uvVec->push_back(temp_uvs[i]);			
-			normalVec->push_back(temp_normals[i]);
-			unsigned int newindex = (unsigned int)vertexVec->size() - 1;
-			indexVec->push_back(newindex);
-			VertexToOutIndex[packed] = newindex;
-		}
-	}
-}
+#include <algorithm>
+#include <cstring>
 
 bool TObjectLoader::LoadBoundingBox(TResourceMesh* mesh, std::vector<glm::vec3>* vertexVec){
-	float min_x, max_x, min_y, max_y, min_z, max_z; 
-
-	// Ponemos como valores iniciales de los minimos y maximos el primer verices
-	min_x = max_x = vertexVec->at(0).x;	
-	min_y = max_y = vertexVec->at(0).y;
-	min_z = max_z = vertexVec->at(0).z;
-	
-	// Miramos cuales son los vertices mas alejados en cada eje
-	int size = vertexVec->size();
-	for (int i = 0; i < size; i++) {
-		if (vertexVec->at(i).x < min_x) min_x = vertexVec->at(i).x;
-		if (vertexVec->at(i).x > max_x) max_x = vertexVec->at(i).x;
-		if (vertexVec->at(i).y < min_y) min_y = vertexVec->at(i).y;
-		if (vertexVec->at(i).y > max_y) max_y = vertexVec->at(i).y;
-		if (vertexVec->at(i).z < min_z) min_z = vertexVec->at(i).z;
-		if (vertexVec->at(i).z > max_z) max_z = vertexVec->at(i).z;
-	}
-
-	// A partir de estos valores calculamos el tamanyo y el centro del bounding box
-	glm::vec3 sizeV = glm::vec3(max_x-min_x, max_y-min_y, max_z-min_z);
-	glm::vec3 center = glm::vec3((min_x+max_x)/2.0f, (min_y+max_y)/2.0f, (min_z+max_z)/2.0f);
+	glm::vec3 center, size;
+	if(!TObjParser::ComputeBoundingBox(vertexVec, &center, &size)) return false;
 
 	// Se los pasamos al recurso mesh
-	mesh->SetSize(sizeV);
+	mesh->SetSize(size);
 	mesh->SetCenter(center);
 
 	return true;
@@ -113,7 +40,7 @@ bool TObjectLoader::LoadObj(TResourceMesh* mesh, int option){
 			loaded = LoadObjFromFileAssimp(mesh, &vertex, &uv, &normal);
 			break;
 		case 1:
-			loaded = LoadObjFromFileCustom(mesh, &vertex, &uv, &normal);
+			loaded = LoadObjFromFileCustom(mesh, &vertex, &uv, &normal, &index);
 			break;
 		default:
 			std::cout<<"La opcion a la que intenta acceder no existe. Opcion: "<<option<<std::endl;
@@ -124,29 +51,15 @@ bool TObjectLoader::LoadObj(TResourceMesh* mesh, int option){
 	}
 
 
-	IndexVBO(mesh, &vertex, &uv, &normal, &index);
-
-	// Cargamos el buffer de vertices
-	GLuint currentBuffer = mesh->GetVertexBuffer();
-	glBindBuffer(GL_ARRAY_BUFFER, currentBuffer);
-	glBufferData(GL_ARRAY_BUFFER, vertex.size()*sizeof(glm::vec3), &vertex[0], GL_STATIC_DRAW);
-	//glBufferStorage(GL_ARRAY_BUFFER, vertex.size()*sizeof(glm::vec3), &vertex[0], GL_STATIC_DRAW);
+	// El cargador personalizado ya devuelve los vertices indexados, solo falta optimizarlos
+	if(index.empty()) TObjParser::IndexVBO(&vertex, &uv, &normal, &index, mesh->GetName());
+	else TObjParser::OptimizeMesh(&vertex, &uv, &normal, &index, mesh->GetName());
 
-	// Cargamos el buffer de uvs
-	currentBuffer = mesh->GetUvBuffer();
-	glBindBuffer(GL_ARRAY_BUFFER, currentBuffer);
-	glBufferData(GL_ARRAY_BUFFER, uv.size()*sizeof(glm::vec2), &uv[0], GL_STATIC_DRAW);
-	
-	// Cargamos el buffer de normales
-	currentBuffer = mesh->GetNormalBuffer();
-	glBindBuffer(GL_ARRAY_BUFFER, currentBuffer);
-	glBufferData(GL_ARRAY_BUFFER, normal.size()*sizeof(glm::vec3), &normal[0], GL_STATIC_DRAW);
+	// Subimos los vertices intercalados y los elementos al VAO del mesh
+	mesh->SetVertexData(&vertex, &uv, &normal, &index);
 
-	// Cargamos el buffer de elementos
-	currentBuffer = mesh->GetElementBuffer();
-	mesh->SetElementSize(index.size());
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, currentBuffer);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, index.size()*sizeof(unsigned int), &index[0], GL_STATIC_DRAW);
+	// El obj de texto no se puede volver a leer como binario, los oclusores necesitan ya la copia en CPU
+	mesh->SetCpuData(&vertex, &index);
 
 	LoadBoundingBox(mesh, &vertex);
 
@@ -159,182 +72,140 @@ bool TObjectLoader::LoadObj(TResourceMesh* mesh, int option){
 //
 // ============================================================================================================================================
 
-/*
-	1º  SIZE 	- 3 FLOATS, SIZE
-	2º  CENTER	- 3 FLOATS, CENTER
-	3º  INT 	- SIZE DE VERTICES (3*SIZE = TOTAL FLOATS)
-	4º  FLOAT 	- VERTICES
-	5º  INT  	- SIZE DE UVS (2*SIZE = TOTAL FLOATS)
-	6º  FLOAT 	- UVS
-	7º  INT 	- SIZE DE NORMALES (3*SIZE = TOTAL FLOATS)
-	8º  FLOAT 	- NORMALES	
-	9º  INT 	- SIZE DE ELEMENTOS
-	10º UINT	- ELEMENTOS
-	11º INT		- SIZE DEL STRING DE TEXTURA
-	12º CHAR	- CADA CHAR DEL STRING
-	13º INT		- SIZE DEL STRING DEL NORMAL MAP
-	14º CHAR	- CADA CHAR DEL STRING
-	15º INT 	- SIZE DEL STRING DEL SPECULAR MAP
-	16º CHAR	- CADA CHAR DEL STRING
-	17º INT		- SIZE DEL STRING DE MATERIAL
-	18º CHAR	- CADA CHAR DEL STRING
-*/
+// El formato TOEM y el formato antiguo se leen y se escriben en TMeshFile, aqui solo se pasan al recurso
+
+std::string TObjectLoader::OpenMeshFile(std::string objPath, TVirtualFile* file){
+	// La version cocinada tiene preferencia, con ella no se lee ningun fichero de texto
+	std::string cookedPath = TMeshFile::GetCookedPath(objPath);
+	if(cookedPath != objPath && file->Open(cookedPath)) return cookedPath;
+	if(file->Open(objPath)) return objPath;
+	return "";
+}
 
 bool TObjectLoader::LoadObjBinary(TResourceMesh* mesh){
+	TMeshLoadData data;
+	if(!ReadObjBinary(mesh->GetName(), &data)) return false;
+	return UploadObjBinary(mesh, &data);
+}
+
+bool TObjectLoader::ReadObjBinary(std::string objPath, TMeshLoadData* data){
+	data->mapped = false;
+
+	std::string path = OpenMeshFile(objPath, &data->file);
+	if(path.empty()){
+		std::cout<<"Error al abrir el archivo: "<<objPath<<std::endl;
+		return false;
+	}
+
+	// Sin magic es un fichero del formato antiguo, se lee entero desde lo ya abierto
+	if(!TMeshFile::IsMeshFile(data->file.GetData(), data->file.GetSize())){
+		bool read = TMeshFile::LoadLegacy(data->file.GetData(), data->file.GetSize(), path, &data->legacy);
+		data->file.Close();
+		if(!read) return false;
+		for(int i=0; i<4; i++) data->paths[i] = data->legacy.paths[i];
+		return true;
+	}
 
-	bool output = false;
+	if(!TMeshFile::Validate(data->file.GetData(), data->file.GetSize(), path, &data->header)) return false;
+	data->mapped = true;
 
+	// Leemos las rutas, cada una con su longitud delante
+	if(!TMeshFile::ReadStrings(data->file.GetData(), data->file.GetSize(), &data->header, data->paths)){
+		std::cout<<"Mesh corrupto (rutas incompletas): "<<objPath<<std::endl;
+		return false;
+	}
+
+	// Desde la version 2 las texturas son relativas a la carpeta del mesh
+	if(data->header.version >= 2){
+		for(int i=0; i<3; i++) data->paths[i] = TMeshFile::ResolvePath(objPath, data->paths[i]);
+	}
+	return true;
+}
+
+bool TObjectLoader::UploadObjBinary(TResourceMesh* mesh, TMeshLoadData* data, bool async){
 	std::string objPath = mesh->GetName();
 
-	std::ifstream objFile;
-	objFile.open(objPath, std::ios::binary);
-
-	if(objFile.is_open()){
-
-
-		std::vector<glm::vec3> vertex;
-		std::vector<glm::vec2> uv;
-		std::vector<glm::vec3> normal;
-		std::vector<unsigned int> index;
-
-		// -------------------------------------------------------------- 1º
-		glm::vec3 vecRead;
-		objFile.read(reinterpret_cast<char*>(&vecRead.x), sizeof(float));  
-		objFile.read(reinterpret_cast<char*>(&vecRead.y), sizeof(float));
-		objFile.read(reinterpret_cast<char*>(&vecRead.z), sizeof(float));
-		mesh->SetSize(vecRead);
-
-		// -------------------------------------------------------------- 2º
-		objFile.read(reinterpret_cast<char*>(&vecRead.x), sizeof(float));  
-		objFile.read(reinterpret_cast<char*>(&vecRead.y), sizeof(float));
-		objFile.read(reinterpret_cast<char*>(&vecRead.z), sizeof(float));
-		mesh->SetCenter(vecRead);
-		// -------------------------------------------------------------- 3º
-		int size;
-		objFile.read(reinterpret_cast<char*>(&size), sizeof(int));
-		// -------------------------------------------------------------- 4º
-			// vertices
-		for(int i=0; i<size; i++){
-			objFile.read(reinterpret_cast<char*>(&vecRead.x), sizeof(float));  
-			objFile.read(reinterpret_cast<char*>(&vecRead.y), sizeof(float));
-			objFile.read(reinterpret_cast<char*>(&vecRead.z), sizeof(float));
-			vertex.push_back(vecRead);
-		}
-		// -------------------------------------------------------------- 5º
-		objFile.read(reinterpret_cast<char*>(&size), sizeof(int));
-		// -------------------------------------------------------------- 6º
-			// uvs
-			glm::vec2 vecRead2;
-		for(int i=0; i<size; i++){
-			objFile.read(reinterpret_cast<char*>(&vecRead2.x), sizeof(float));  
-			objFile.read(reinterpret_cast<char*>(&vecRead2.y), sizeof(float));
-			uv.push_back(vecRead2);
-		}
-		// -------------------------------------------------------------- 7º
-		objFile.read(reinterpret_cast<char*>(&size), sizeof(int));
-		// -------------------------------------------------------------- 8º
-			//normales
-		for(int i=0; i<size; i++){
-			objFile.read(reinterpret_cast<char*>(&vecRead.x), sizeof(float));  
-			objFile.read(reinterpret_cast<char*>(&vecRead.y), sizeof(float));
-			objFile.read(reinterpret_cast<char*>(&vecRead.z), sizeof(float));
-			normal.push_back(vecRead);
-		}
-		// -------------------------------------------------------------- 9º
-		objFile.read(reinterpret_cast<char*>(&size), sizeof(int));
-		// -------------------------------------------------------------- 10º
-			// elementos
-		unsigned int element;
-		for(int i=0; i<size; i++){
-			objFile.read(reinterpret_cast<char*>(&element), sizeof(unsigned int));  
-			index.push_back(element);
-		}
-		// -------------------------------------------------------------- 11º
-		objFile.read(reinterpret_cast<char*>(&size), sizeof(int));
-		// -------------------------------------------------------------- 12º
-			// path textura
-		std::string path;
-		char currentChar;
-		for(int i=0; i<size; i++){
-			objFile.read(reinterpret_cast<char*>(&currentChar), sizeof(char));
-			path.push_back(currentChar);
-		}
-		if(size>0){
-			TResourceTexture* texture = TResourceManager::GetInstance()->GetResourceTexture(path);
-			if(texture != nullptr){
-				mesh->AddTexture(texture);
-			}
-		}
-		// -------------------------------------------------------------- 13º
-		objFile.read(reinterpret_cast<char*>(&size), sizeof(int));
-		// -------------------------------------------------------------- 14º
-			// path normal_map
-		path.clear();
-		for(int i=0; i<size; i++){
-			objFile.read(reinterpret_cast<char*>(&currentChar), sizeof(char));
-			path.push_back(currentChar);
-		}
-		if(size>0){
-			TResourceTexture* texture = TResourceManager::GetInstance()->GetResourceTexture(path);
-			if(texture != nullptr){
-				mesh->AddBumpMap(texture);
-			}
-		}
-		// -------------------------------------------------------------- 15º
-		objFile.read(reinterpret_cast<char*>(&size), sizeof(int));
-		// -------------------------------------------------------------- 16º
-			// path specular_map
-		path.clear();
-		for(int i=0; i<size; i++){
-			objFile.read(reinterpret_cast<char*>(&currentChar), sizeof(char));
-			path.push_back(currentChar);
-		}
-		if(size>0){
-			TResourceTexture* texture = TResourceManager::GetInstance()->GetResourceTexture(path);
-			if(texture != nullptr){
-				mesh->AddSpecularMap(texture);
-			}
-		}
-		// -------------------------------------------------------------- 17º
-		objFile.read(reinterpret_cast<char*>(&size), sizeof(int));
-		// -------------------------------------------------------------- 18º
-			// path material
-		path.clear();
-		for(int i=0; i<size; i++){
-			objFile.read(reinterpret_cast<char*>(&currentChar), sizeof(char));
-			path.push_back(currentChar);
-		}
-		TMaterialLoader::LoadMaterial(path, objPath, mesh);
-
-		// -------------------------------------------------------------- RELLENAR BUFFERS
-		// Cargamos el buffer de vertices
-		GLuint currentBuffer = mesh->GetVertexBuffer();
-		glBindBuffer(GL_ARRAY_BUFFER, currentBuffer);
-		glBufferData(GL_ARRAY_BUFFER, vertex.size()*sizeof(glm::vec3), &vertex[0], GL_STATIC_DRAW);
-
-		// Cargamos el buffer de uvs
-		currentBuffer = mesh->GetUvBuffer();
-		glBindBuffer(GL_ARRAY_BUFFER, currentBuffer);
-		glBufferData(GL_ARRAY_BUFFER, uv.size()*sizeof(glm::vec2), &uv[0], GL_STATIC_DRAW);
-		
-		// Cargamos el buffer de normales
-		currentBuffer = mesh->GetNormalBuffer();
-		glBindBuffer(GL_ARRAY_BUFFER, currentBuffer);
-		glBufferData(GL_ARRAY_BUFFER, normal.size()*sizeof(glm::vec3), &normal[0], GL_STATIC_DRAW);
-
-		// Cargamos el buffer de elementos
-		currentBuffer = mesh->GetElementBuffer();
-		mesh->SetElementSize(index.size());
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, currentBuffer);
-		glBufferData(GL_ELEMENT_ARRAY_BUFFER, index.size()*sizeof(unsigned int), &index[0], GL_STATIC_DRAW);
-
-		output = true;
-	}else{
-		std::cout<<"Error al abrir el archivo: "<<objPath<<std::endl;
+	// Los datos del formato antiguo no pasan por Validate, antes de tocar el mesh se comprueban los elementos
+	TMeshData* legacy = &data->legacy;
+	if(!data->mapped && !TMeshFile::CheckIndices(legacy->index.data(), legacy->index.size(), legacy->vertex.size())){
+		std::cout<<"Mesh corrupto (elemento fuera de rango): "<<objPath<<std::endl;
+		return false;
+	}
+
+	if(data->mapped){
+		const TMeshFileHeader* header = &data->header;
+		mesh->SetSize(glm::vec3(header->size[0], header->size[1], header->size[2]));
+		mesh->SetCenter(glm::vec3(header->center[0], header->center[1], header->center[2]));
+	}
+	else{
+		mesh->SetSize(data->legacy.size);
+		mesh->SetCenter(data->legacy.center);
 	}
 
-	objFile.close();
-	return output;
+	// En segundo plano cada textura muestra la que tenga el mesh (la de por defecto) hasta que se sube
+	TResourceManager* manager = TResourceManager::GetInstance();
+	for(int i=0; i<3; i++){
+		if(data->paths[i].empty()) continue;
+
+		TResourceTexture* current = i == 0 ? mesh->GetTexture() : i == 1 ? mesh->GetBumpMap() : mesh->GetSpecularMap();
+		TResourceHandle<TResourceTexture> texture;
+		if(async) texture = manager->GetResourceTextureAsync(data->paths[i], nullptr, current);
+		else texture = manager->GetResourceTexture(data->paths[i]);
+		if(texture == nullptr) continue;
+
+		if(i == 0) mesh->AddTexture(texture);
+		else if(i == 1) mesh->AddBumpMap(texture);
+		else mesh->AddSpecularMap(texture);
+	}
+
+	if(data->mapped){
+		const unsigned char* file = data->file.GetData();
+		const TMeshFileHeader* header = &data->header;
+
+		// Los ficheros cocinados llevan el material resuelto, los de la version 1 todavia leen el .mtl
+		if(header->version >= 2) TMaterialLoader::LoadMaterial(data->paths[3], mesh, TMeshFile::GetMaterial(file, header));
+		else TMaterialLoader::LoadMaterial(data->paths[3], objPath, mesh);
+
+		// Los vertices y los elementos van a la grafica directamente desde las paginas mapeadas
+		mesh->SetInterleavedData(file + header->vertexOffset, header->vertexCount, (header->flags & TMeshFile::MESHFILE_TANGENTS) != 0, (const unsigned int*)(file + header->indexOffset), header->indexCount);
+		data->file.Close();
+	}
+	else{
+		TMaterialLoader::LoadMaterial(data->paths[3], objPath, mesh);
+
+		// Subimos los vertices intercalados y los elementos al VAO del mesh
+		mesh->SetVertexData(&data->legacy.vertex, &data->legacy.uv, &data->legacy.normal, &data->legacy.index);
+	}
+	return true;
+}
+
+bool TObjectLoader::LoadGeometryBinary(TResourceMesh* mesh, std::vector<glm::vec3>* positions, std::vector<unsigned int>* indices){
+	TVirtualFile file;
+	std::string path = OpenMeshFile(mesh->GetName(), &file);
+	if(path.empty()) return false;
+
+	// Del formato antiguo se lee todo y nos quedamos solo con las posiciones y los elementos
+	if(!TMeshFile::IsMeshFile(file.GetData(), file.GetSize())){
+		TMeshData legacy;
+		if(!TMeshFile::LoadLegacy(file.GetData(), file.GetSize(), path, &legacy)) return false;
+		positions->swap(legacy.vertex);
+		indices->swap(legacy.index);
+		return true;
+	}
+
+	TMeshFileHeader header;
+	if(!TMeshFile::Validate(file.GetData(), file.GetSize(), path, &header)) return false;
+
+	// La posicion son los tres primeros floats de cada vertice
+	const unsigned char* vertex = file.GetData() + header.vertexOffset;
+	positions->resize(header.vertexCount);
+	for(unsigned int i=0; i<header.vertexCount; i++){
+		memcpy(&(*positions)[i], vertex + (unsigned long long)i * header.vertexStride, sizeof(glm::vec3));
+	}
+
+	const unsigned int* index = (const unsigned int*)(file.GetData() + header.indexOffset);
+	indices->assign(index, index + header.indexCount);
+	return true;
 }
 
 // ============================================================================================================================================
@@ -343,6 +214,61 @@ bool TObjectLoader::LoadObjBinary(TResourceMesh* mesh){
 //
 // ============================================================================================================================================
 
+// Assimp lee el obj y su mtl a traves del TFileSystem, asi tambien los encuentra dentro de los packs
+class TAssimpStream: public Assimp::IOStream{
+public:
+	TAssimpStream(){ m_position = 0; }
+
+	bool Open(const char* path){ return m_file.Open(path); }
+
+	size_t Read(void* buffer, size_t size, size_t count) override{
+		if(size == 0) return 0;
+		size_t available = (m_file.GetSize() - m_position) / size;
+		count = std::min(count, available);
+		memcpy(buffer, m_file.GetData() + m_position, size * count);
+		m_position += size * count;
+		return count;
+	}
+
+	size_t Write(const void* buffer, size_t size, size_t count) override{ return 0; }
+
+	aiReturn Seek(size_t offset, aiOrigin origin) override{
+		size_t position = offset;
+		if(origin == aiOrigin_CUR) position = m_position + offset;
+		else if(origin == aiOrigin_END) position = m_file.GetSize() - offset;
+		if(position > m_file.GetSize()) return aiReturn_FAILURE;
+		m_position = position;
+		return aiReturn_SUCCESS;
+	}
+
+	size_t Tell() const override{ return m_position; }
+	size_t FileSize() const override{ return const_cast<TVirtualFile*>(&m_file)->GetSize(); }
+	void Flush() override{}
+
+private:
+	TVirtualFile	m_file;			// m_file - Fichero del pack o del disco
+	size_t			m_position;		// m_position - Posicion de lectura
+};
+
+class TAssimpFileSystem: public Assimp::IOSystem{
+public:
+	bool Exists(const char* path) const override{ return TFileSystem::GetInstance()->Exists(path); }
+	char getOsSeparator() const override{ return '/'; }
+
+	Assimp::IOStream* Open(const char* path, const char* mode) override{
+		// Solo lectura
+		if(strchr(mode, 'w') != nullptr || strchr(mode, 'a') != nullptr) return nullptr;
+		TAssimpStream* stream = new TAssimpStream();
+		if(!stream->Open(path)){
+			delete stream;
+			return nullptr;
+		}
+		return stream;
+	}
+
+	void Close(Assimp::IOStream* stream) override{ delete stream; }
+};
+
 bool TObjectLoader::LoadObjAssimp(TResourceMesh* mesh){
 	return LoadObj(mesh, 0);
 }
@@ -350,16 +276,14 @@ bool TObjectLoader::LoadObjAssimp(TResourceMesh* mesh){
 bool TObjectLoader::LoadObjFromFileAssimp(TResourceMesh* mesh, std::vector<glm::vec3>* vertexVec, std::vector<glm::vec2>* uvVec, std::vector<glm::vec3>* normalVec){
 
 	std::string path = mesh->GetName();
-	
-	std::ifstream file(path);									// |
-	if(!file.fail()) file.close();								// |
-	else{														// |
+	if(!TFileSystem::GetInstance()->Exists(path)){				// |
 		std::cout<<"File not found " + path<<std::endl;			// |
-		return false;											// | Comprobacion de que exista
+		return false;											// | Comprobacion de que exista (sin abrirlo)
 	}
 
 	const struct aiScene* scene = nullptr;
 	Assimp::Importer importer;
+	importer.SetIOHandler(new TAssimpFileSystem());				// El importer se encarga de eliminarlo
 	scene = importer.ReadFile(path.c_str(),  aiProcessPreset_TargetRealtime_Fast | aiProcess_ConvertToLeftHanded);
 	
 	if(!scene){													// |
@@ -409,7 +333,7 @@ bool TObjectLoader::LoadObjFromFileAssimp(TResourceMesh* mesh, std::vector<glm::
 						//std::string finalPath = auxPath + "/textures/" + file;
 						std::string finalPath = auxPath + "/" + file;
 						
-						TResourceTexture* texture = TResourceManager::GetInstance()->GetResourceTexture(finalPath);
+						TResourceHandle<TResourceTexture> texture = TResourceManager::GetInstance()->GetResourceTexture(finalPath);
 						if(texture != nullptr){
 							// Anyadimos la textura al recurso
 							mesh->AddTexture(texture);
@@ -432,98 +356,7 @@ bool TObjectLoader::LoadObjCustom(TResourceMesh* mesh){
 	return LoadObj(mesh, 1);
 }
 
-bool TObjectLoader::LoadObjFromFileCustom(TResourceMesh* mesh, std::vector<glm::vec3>* vertexVec, std::vector<glm::vec2>* uvVec, std::vector<glm::vec3>* normalVec){
-	// Creamos algunas variables temporales para cargar el obj
-	std::vector< unsigned int > vertexIndices, uvIndices, normalIndices;
-	std::vector< glm::vec3 > temp_vertices;
-	std::vector< glm::vec2 > temp_uvs;
-	std::vector< glm::vec3 > temp_normals;
-
-	// Intentamos leer el archivo, en el caso de que no existiera volvemos
-	std::string path = mesh->GetName();
-	FILE * file = std::fopen(path.c_str(),"r");
-	if( file == nullptr ){
-   		std::cout<<"Impossible to open the file !\n";
-		return false;
-	}
-
-	// Bucle de lectura del archivo, saldremos del bucle a partir de un break
-	while(true){
-
-		char lineHeader[128];							// Suponemos que la linea no ocupa mas de 128
-		int res = fscanf(file, "%s", lineHeader);	 	// Lee la primera palabra de la línea
-		if (res == EOF){ 	// EOF = End Of File, es decir, el final del archivo. Se finaliza el ciclo.
-			break; 
-		}
-		else{				// Analizar el lineHeader
-			// Miramos si se trada de un vertice
-			if (strcmp(lineHeader, "v") == 0){
-				glm::vec3 vertex;
-				fscanf(file, "%f %f %f\n", &vertex.x, &vertex.y, &vertex.z );
-				temp_vertices.push_back(vertex);
-			}
-			// Miramos si se trata de un uv
-			else if ( strcmp( lineHeader, "vt" ) == 0 ){
-				glm::vec2 uv;
-				fscanf(file, "%f %f\n", &uv.x, &uv.y );
-				uv.y = 1.0f - uv.y;
-				temp_uvs.push_back(uv);
-			}
-			// Miramos si se trata de una normal
-			else if ( strcmp( lineHeader, "vn" ) == 0 ){
-				glm::vec3 normal;
-				fscanf(file, "%f %f %f\n", &normal.x, &normal.y, &normal.z );
-				temp_normals.push_back(normal);
-			}
-			// Miramos si se trata de un triangulo
-			else if ( strcmp( lineHeader, "f" ) == 0 ){
-				std::string vertex1, vertex2, vertex3;
-				unsigned int vertexIndex[3], uvIndex[3], normalIndex[3];
-				int matches = fscanf(file, "%d/%d/%d %d/%d/%d %d/%d/%d\n", &vertexIndex[0], &uvIndex[0], &normalIndex[0], &vertexIndex[1], &uvIndex[1], &normalIndex[1], &vertexIndex[2], &uvIndex[2], &normalIndex[2] );
-				if (matches != 9){
-					std::cout<<"File can't be read by our simple parser : ( Try exporting with other options\n";
-					return false;
-				}
-				//
-				vertexIndices.push_back(vertexIndex[0]);
-				vertexIndices.push_back(vertexIndex[1]);
-				vertexIndices.push_back(vertexIndex[2]);
-
-				uvIndices.push_back(uvIndex[0]);
-				uvIndices.push_back(uvIndex[1]);
-				uvIndices.push_back(uvIndex[2]);
-
-				normalIndices.push_back(normalIndex[0]);
-				normalIndices.push_back(normalIndex[1]);
-				normalIndices.push_back(normalIndex[2]);
-			}
-		}
-	}
-	// Una vez ya leido todo el documento y almacenado los valores en datos temporales, procedemos a analizarla
-	// Analizamos los vertices
-	int size = vertexIndices.size();
-	for(int i=0; i<size; i++){
-		// Nos guardamos el indice del vertice
-		int vertexIndex = vertexIndices[i];
-		// Tenemos que poner el -1 porque los obj empiezan por 1
-		glm::vec3 vertex = temp_vertices[vertexIndex-1];
-		vertexVec->push_back(vertex);
-	}
-	// Analizamos los UV
-	size = uvIndices.size();
-	for(int i=0; i<size; i++){
-		// Nos guardamos el indice del uv
-		int uvIndex = uvIndices[i];
-		glm::vec2 uv = temp_uvs[uvIndex-1];
-		uvVec->push_back(uv);
-	}
-	// Analizamos las normales
-	size = normalIndices.size();
-	for(int i=0; i<size; i++){
-		// Nos guardamos el indice de la normal
-		int normalIndex = normalIndices[i];
-		glm::vec3 normal = temp_normals[normalIndex-1];
-		normalVec->push_back(normal);
-	}
-	return true;
+bool TObjectLoader::LoadObjFromFileCustom(TResourceMesh* mesh, std::vector<glm::vec3>* vertexVec, std::vector<glm::vec2>* uvVec, std::vector<glm::vec3>* normalVec, std::vector<unsigned int>* indexVec){
+	// La lectura del texto no necesita la grafica, la compartimos con el cocinado de assets
+	return TObjParser::ParseObj(mesh->GetName(), vertexVec, uvVec, normalVec, indexVec);
 }
\ No newline at end of file
@@ -8,21 +8,22 @@
  */
 
 #include "./../Resources/TResourceMesh.h"
+#include "TMeshFile.h"
+#include "TFileSystem.h"
 #include <glm/vec3.hpp>
 #include <glm/vec2.hpp>
 
 #include <vector>
-#include <map>
 
 /**
- * @brief 	- Struct que se utiliza para saber el numero de elemtos que componen el objeto
- * 				a traves de la posicion, uv, y normal de cada vertice
+ * @brief 	- Mesh leido del disco que todavia no se ha subido a la grafica
  */
-struct PackedVertex{
-	glm::vec3 position;
-	glm::vec2 uv;
-	glm::vec3 normal;
-	bool operator<(const PackedVertex that) const;
+struct TMeshLoadData{
+	TVirtualFile	file;		// file - Fichero TOEM (del pack o mapeado), los vertices se suben desde su memoria
+	TMeshFileHeader	header;		// header - Cabecera del fichero TOEM
+	bool			mapped;		// mapped - Es un fichero TOEM, si no el mesh esta en legacy
+	TMeshData		legacy;		// legacy - Mesh leido del formato antiguo
+	std::string		paths[4];	// paths - Texturas (difusa, normales, especular) y material ya resueltos
 };
 
 class TObjectLoader{
@@ -45,12 +46,46 @@ public:
 
 	/**
 	 * @brief	- Cargamos el obj con el cargador binario
+	 * 				Si existe la version cocinada (.toem) se usa esa en lugar del obj
+	 * 				Los ficheros con cabecera TOEM se mapean en memoria y los vertices se suben a la grafica
+	 * 				directamente desde las paginas del fichero, el resto se leen con el formato antiguo
 	 * 
 	 * @param 	- mesh - Recurso mesh a cargar 
 	 * @return 	- bool - El obj se ha cargado correctamente
 	 */
 	static bool LoadObjBinary(TResourceMesh* mesh);
 
+	/**
+	 * @brief	- Primera parte de LoadObjBinary: abre y valida el fichero sin usar OpenGL ni el TResourceManager,
+	 * 				se puede llamar desde los hilos del cargador asincrono
+	 * 
+	 * @param 	- name - Ruta del mesh
+	 * @param 	- data - Fichero mapeado o mesh leido
+	 * @return 	- bool - Se ha leido correctamente
+	 */
+	static bool ReadObjBinary(std::string name, TMeshLoadData* data);
+
+	/**
+	 * @brief	- Segunda parte de LoadObjBinary: sube el mesh leido a la grafica y le asigna texturas y material
+	 * 				Siempre en el hilo principal
+	 * 
+	 * @param 	- mesh - Recurso mesh a cargar
+	 * @param 	- data - Datos leidos con ReadObjBinary, el fichero se cierra al acabar
+	 * @param 	- async - Las texturas del mesh tambien se cargan en segundo plano
+	 * @return 	- bool - Se ha subido correctamente
+	 */
+	static bool UploadObjBinary(TResourceMesh* mesh, TMeshLoadData* data, bool async = false);
+
+	/**
+	 * @brief	- Lee solo las posiciones y los elementos de un fichero TOEM o del formato antiguo, para las copias en CPU del mesh
+	 * 
+	 * @param 	- mesh - Recurso mesh del que leer el fichero
+	 * @param 	- positions - Posiciones de los vertices
+	 * @param 	- indices - Elementos del mesh
+	 * @return 	- bool - Se ha leido correctamente
+	 */
+	static bool LoadGeometryBinary(TResourceMesh* mesh, std::vector<glm::vec3>* positions, std::vector<unsigned int>* indices);
+
 	/**
 	 * @brief 	- Llamamos al cargador de obj pasando el metodo que queremos utilizar
 	 * 
@@ -61,6 +96,15 @@ public:
 	 */
 	static bool LoadObj(TResourceMesh* mesh, int option);
 private:
+	/**
+	 * @brief	- Abre el fichero cocinado del mesh si existe, si no el propio mesh
+	 * 
+	 * @param 	- name - Ruta del mesh
+	 * @param 	- file - Fichero en el que se mapea
+	 * @return 	- std::string - Ruta del fichero abierto, vacia si no se ha podido abrir
+	 */
+	static std::string OpenMeshFile(std::string name, TVirtualFile* file);
+
 	/**
 	 * @brief	- Cargamos la Bounding Box del mesh 
 	 * 
@@ -72,16 +116,17 @@ private:
 	static bool LoadBoundingBox(TResourceMesh* mesh, std::vector<glm::vec3>* vertex);
 	
 	/**
-	 * @brief	- Cargamos el obj utilizando el cargado personalizado 
+	 * @brief	- Cargamos el obj utilizando el cargado personalizado, ya sale indexado
 	 * 
 	 * @param 	- mesh - Recurso mesh a cargar 
 	 * @param 	- vertex - Vertices del mesh
 	 * @param 	- uv - Uvs del mesh
 	 * @param 	- normal - Normales del mesh
+	 * @param 	- index - Elementos del mesh
 	 * 
 	 * @return	- bool - Se ha cargado el obj correctamente 
 	 */
-	static bool LoadObjFromFileCustom(TResourceMesh* mesh, std::vector<glm::vec3>* vertex, std::vector<glm::vec2>* uv, std::vector<glm::vec3>* normal);
+	static bool LoadObjFromFileCustom(TResourceMesh* mesh, std::vector<glm::vec3>* vertex, std::vector<glm::vec2>* uv, std::vector<glm::vec3>* normal, std::vector<unsigned int>* index);
 	
 	/**
 	 * @brief	- Cargamos el obj utilizando el cargador de assimp 
@@ -94,27 +139,6 @@ private:
 	 * @return 	- bool - Se ha cargado el obj correctamente
 	 */
 	static bool LoadObjFromFileAssimp(TResourceMesh* mesh, std::vector<glm::vec3>* vertex, std::vector<glm::vec2>* uv, std::vector<glm::vec3>* normal);
-	
-	/**
-	 * @brief	- Indexamos los vertices para conseguir los elementos del objeto 
-	 * 
-	 * @param 	- mesh - Recurso mesh a indexar 
-	 * @param 	- vertex - Vertices del mesh
-	 * @param 	- uvs - Uvs del mesh
-	 * @param 	- normals - Normales del mesh
-	 * @param 	- index - Elementos del mesh
-	 */
-	static void IndexVBO(TResourceMesh* mesh, std::vector<glm::vec3>* vertex, std::vector<glm::vec2>* uv, std::vector<glm::vec3>* normal, std::vector<unsigned int>* index);
-	
-	/**
-	 * @brief	- Miramos si existe un paquete de vertices parecido para calcular los elementos 
-	 * 
-	 * @param 	- packed - Paquete a comprobar
-	 * @param 	- VertexToOutIndex - Mapa de paquetes
-	 * @param 	- int - Elemento igual
-	 * @return 	- bool - existe un paquete igual
-	 */
-	static bool GetSimilarVertexIndex_fast(PackedVertex* packed, std::map<PackedVertex,unsigned int>* VertexToOutIndex, unsigned int* result);
 };
 
 #endif
\ No newline at end of file
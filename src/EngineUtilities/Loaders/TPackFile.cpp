@@ -0,0 +1,282 @@
+#include "TPackFile.h"
+
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <algorithm>
+
+/*
+	FORMATO TOEP (version 1)
+	CABECERA					- TPackHeader (56 bytes)
+	ENTRADAS					- entryCount TPackEntry (40 bytes), ordenadas por ruta (memcmp y despues longitud)
+	RUTAS						- Todas las rutas seguidas, sin '\0'
+	DATOS						- El contenido de cada entrada, alineado a PACK_ALIGNMENT, tal cual o en un bloque LZ4
+*/
+
+static_assert(sizeof(TPackHeader) == 56, "TPackHeader tiene que ocupar 56 bytes sin relleno");
+static_assert(sizeof(TPackEntry) == 40, "TPackEntry tiene que ocupar 40 bytes sin relleno");
+
+static int CompareNames(const char* a, unsigned int aLength, const char* b, unsigned int bLength){
+	int compare = memcmp(a, b, std::min(aLength, bLength));
+	if(compare != 0) return compare;
+	if(aLength == bLength) return 0;
+	return aLength < bLength ? -1 : 1;
+}
+
+bool TPackFile::Validate(const unsigned char* data, unsigned long long size, std::string path){
+	const char* error = nullptr;
+	TPackHeader header;
+
+	if(size < sizeof(TPackHeader)) error = "cabecera incompleta";
+	else{
+		memcpy(&header, data, sizeof(TPackHeader));
+		if(memcmp(header.magic, "TOEP", 4) != 0) error = "no es un pack TOEP";
+		else if(header.version != PACK_VERSION) error = "version no soportada";
+		else if(header.headerSize != sizeof(TPackHeader) || header.entrySize != sizeof(TPackEntry)) error = "tamanyo de cabecera incorrecto";
+		else if(header.fileSize != size) error = "tamanyo del fichero incorrecto";
+		else if(header.entryOffset % 8 != 0 || header.entryOffset > size || (unsigned long long)header.entryCount * sizeof(TPackEntry) > size - header.entryOffset) error = "entradas fuera del fichero";
+		else if(header.nameOffset > size || header.nameSize > size - header.nameOffset) error = "rutas fuera del fichero";
+	}
+
+	const TPackEntry* entries = error == nullptr ? (const TPackEntry*)(data + header.entryOffset) : nullptr;
+	const char* names = error == nullptr ? (const char*)(data + header.nameOffset) : nullptr;
+	for(unsigned int i=0; error == nullptr && i<header.entryCount; i++){
+		const TPackEntry* entry = &entries[i];
+		if((unsigned long long)entry->nameOffset + entry->nameLength > header.nameSize) error = "ruta fuera del fichero";
+		else if(entry->offset > size || entry->size > size - entry->offset) error = "datos fuera del fichero";
+		else if(entry->compression == PACK_STORED && entry->size != entry->rawSize) error = "tamanyo de entrada incorrecto";
+		else if(entry->compression != PACK_STORED && entry->compression != PACK_LZ4) error = "compresion no soportada";
+		else if(i > 0 && CompareNames(names + entries[i-1].nameOffset, entries[i-1].nameLength, names + entry->nameOffset, entry->nameLength) >= 0) error = "entradas desordenadas";
+	}
+
+	if(error != nullptr){
+		std::cout<<"Pack corrupto ("<<error<<"): "<<path<<std::endl;
+		return false;
+	}
+	return true;
+}
+
+const TPackEntry* TPackFile::Find(const unsigned char* data, const char* name, unsigned int length){
+	const TPackHeader* header = (const TPackHeader*)data;
+	const TPackEntry* entries = (const TPackEntry*)(data + header->entryOffset);
+	const char* names = (const char*)(data + header->nameOffset);
+
+	// Busqueda binaria sobre las entradas ordenadas
+	unsigned int first = 0;
+	unsigned int last = header->entryCount;
+	while(first < last){
+		unsigned int middle = first + (last - first) / 2;
+		const TPackEntry* entry = &entries[middle];
+		int compare = CompareNames(names + entry->nameOffset, entry->nameLength, name, length);
+		if(compare == 0) return entry;
+		if(compare < 0) first = middle + 1;
+		else last = middle;
+	}
+	return nullptr;
+}
+
+const char* TPackFile::GetName(const unsigned char* data, const TPackEntry* entry){
+	const TPackHeader* header = (const TPackHeader*)data;
+	return (const char*)(data + header->nameOffset + entry->nameOffset);
+}
+
+static unsigned long long Align(unsigned long long value, unsigned long long alignment){
+	return (value + alignment - 1) / alignment * alignment;
+}
+
+bool TPackFile::Save(std::string path, std::vector<TPackSource> sources, bool lz4){
+	std::sort(sources.begin(), sources.end(), [](const TPackSource& a, const TPackSource& b){
+		return CompareNames(a.name.data(), a.name.length(), b.name.data(), b.name.length()) < 0;
+	});
+
+	TPackHeader header;
+	memset(&header, 0, sizeof(TPackHeader));
+	memcpy(header.magic, "TOEP", 4);
+	header.version = PACK_VERSION;
+	header.headerSize = sizeof(TPackHeader);
+	header.entryCount = sources.size();
+	header.entrySize = sizeof(TPackEntry);
+	header.alignment = PACK_ALIGNMENT;
+	header.entryOffset = sizeof(TPackHeader);
+	header.nameOffset = header.entryOffset + (unsigned long long)header.entryCount * sizeof(TPackEntry);
+
+	std::string names;
+	std::vector<TPackEntry> entries(sources.size());
+	for(unsigned int i=0; i<sources.size(); i++){
+		if(i > 0 && sources[i].name == sources[i-1].name){
+			std::cout<<"Ruta repetida en el pack: "<<sources[i].name<<std::endl;
+			return false;
+		}
+		memset(&entries[i], 0, sizeof(TPackEntry));
+		entries[i].nameOffset = names.length();
+		entries[i].nameLength = sources[i].name.length();
+		names += sources[i].name;
+	}
+	header.nameSize = names.length();
+
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	if(!file.is_open()){
+		std::cout<<"No se puede escribir el pack: "<<path<<std::endl;
+		return false;
+	}
+
+	// Primero los datos, las entradas se rellenan al ir escribiendolos y se vuelven a escribir al final
+	unsigned long long offset = Align(header.nameOffset + header.nameSize, PACK_ALIGNMENT);
+	file.seekp(offset);
+	std::vector<unsigned char> content, compressed;
+	for(unsigned int i=0; i<sources.size(); i++){
+		std::ifstream input(sources[i].path, std::ios::binary | std::ios::ate);
+		if(!input.is_open()){
+			std::cout<<"No se puede leer: "<<sources[i].path<<std::endl;
+			return false;
+		}
+		content.resize((size_t)input.tellg());
+		input.seekg(0);
+		input.read((char*)content.data(), content.size());
+		if(!input.good() && !content.empty()) return false;
+
+		const std::vector<unsigned char>* stored = &content;
+		entries[i].compression = PACK_STORED;
+		if(lz4 && !content.empty()){
+			CompressLZ4(content.data(), content.size(), &compressed);
+			if(compressed.size() * 10 <= content.size() * 9){
+				stored = &compressed;
+				entries[i].compression = PACK_LZ4;
+			}
+		}
+
+		unsigned long long aligned = Align(offset, PACK_ALIGNMENT);
+		for(; offset < aligned; offset++) file.put(0);
+		entries[i].offset = offset;
+		entries[i].size = stored->size();
+		entries[i].rawSize = content.size();
+		file.write((const char*)stored->data(), stored->size());
+		offset += stored->size();
+	}
+	header.fileSize = offset;
+
+	file.seekp(0);
+	file.write((const char*)&header, sizeof(TPackHeader));
+	if(!entries.empty()) file.write((const char*)entries.data(), entries.size() * sizeof(TPackEntry));
+	file.write(names.data(), names.length());
+	file.close();
+	return file.good();
+}
+
+// ============================================================================================================================================
+//
+// LZ4 (formato de bloque, compatible con LZ4_compress_default / LZ4_decompress_safe)
+//
+// ============================================================================================================================================
+
+#define LZ4_MINMATCH		4		// Coincidencia minima
+#define LZ4_LASTLITERALS	5		// Los ultimos 5 bytes siempre van como literales
+#define LZ4_MFLIMIT			12		// La ultima coincidencia empieza al menos 12 bytes antes del final
+#define LZ4_MAXOFFSET		65535	// Distancia maxima de una coincidencia
+#define LZ4_HASHBITS		12		// Tabla de 4096 posiciones
+
+static unsigned int ReadU32(const unsigned char* data){
+	unsigned int value;
+	memcpy(&value, data, sizeof(unsigned int));
+	return value;
+}
+
+static void WriteLength(std::vector<unsigned char>* output, unsigned long long length){
+	// Lo que no cabe en los 4 bits del token va en bytes de 255 y un ultimo menor
+	for(; length >= 255; length -= 255) output->push_back(255);
+	output->push_back((unsigned char)length);
+}
+
+static void WriteSequence(std::vector<unsigned char>* output, const unsigned char* literals, unsigned long long literalCount, unsigned int offset, unsigned long long matchLength){
+	unsigned long long match = matchLength >= LZ4_MINMATCH ? matchLength - LZ4_MINMATCH : 0;
+	unsigned char token = (unsigned char)(std::min(literalCount, 15ull) << 4);
+	if(offset != 0) token |= (unsigned char)std::min(match, 15ull);
+	output->push_back(token);
+	if(literalCount >= 15) WriteLength(output, literalCount - 15);
+	output->insert(output->end(), literals, literals + literalCount);
+
+	// La ultima secuencia solo lleva literales
+	if(offset == 0) return;
+	output->push_back(offset & 0xFF);
+	output->push_back((offset >> 8) & 0xFF);
+	if(match >= 15) WriteLength(output, match - 15);
+}
+
+void TPackFile::CompressLZ4(const unsigned char* input, unsigned long long size, std::vector<unsigned char>* output){
+	output->clear();
+	output->reserve(size + size / 255 + 16);
+
+	std::vector<long long> table(1 << LZ4_HASHBITS, -1);
+	unsigned long long anchor = 0;
+	unsigned long long position = 0;
+
+	// Busqueda voraz: cada posicion mira la ultima con sus mismos 4 bytes
+	while(size > LZ4_MFLIMIT && position + LZ4_MFLIMIT < size){
+		unsigned int sequence = ReadU32(input + position);
+		unsigned int hash = (sequence * 2654435761u) >> (32 - LZ4_HASHBITS);
+		long long candidate = table[hash];
+		table[hash] = position;
+
+		if(candidate < 0 || position - candidate > LZ4_MAXOFFSET || ReadU32(input + candidate) != sequence){
+			position++;
+			continue;
+		}
+
+		unsigned long long length = LZ4_MINMATCH;
+		while(position + length < size - LZ4_LASTLITERALS && input[candidate + length] == input[position + length]) length++;
+
+		WriteSequence(output, input + anchor, position - anchor, position - candidate, length);
+		position += length;
+		anchor = position;
+	}
+
+	WriteSequence(output, input + anchor, size - anchor, 0, 0);
+}
+
+static bool ReadLength(const unsigned char** input, const unsigned char* end, unsigned long long* length){
+	unsigned char value;
+	do{
+		if(*input >= end) return false;
+		value = *(*input)++;
+		*length += value;
+	} while(value == 255);
+	return true;
+}
+
+bool TPackFile::DecompressLZ4(const unsigned char* input, unsigned long long size, unsigned char* output, unsigned long long outputSize){
+	const unsigned char* in = input;
+	const unsigned char* inEnd = input + size;
+	unsigned char* out = output;
+	unsigned char* outEnd = output + outputSize;
+
+	while(in < inEnd){
+		unsigned char token = *in++;
+
+		unsigned long long literals = token >> 4;
+		if(literals == 15 && !ReadLength(&in, inEnd, &literals)) return false;
+		if(literals > (unsigned long long)(inEnd - in) || literals > (unsigned long long)(outEnd - out)) return false;
+		memcpy(out, in, literals);
+		in += literals;
+		out += literals;
+
+		// La ultima secuencia acaba con los literales
+		if(in == inEnd) break;
+
+		if(inEnd - in < 2) return false;
+		unsigned int offset = in[0] | (in[1] << 8);
+		in += 2;
+		if(offset == 0 || offset > (unsigned long long)(out - output)) return false;
+
+		unsigned long long length = token & 15;
+		if(length == 15 && !ReadLength(&in, inEnd, &length)) return false;
+		length += LZ4_MINMATCH;
+		if(length > (unsigned long long)(outEnd - out)) return false;
+
+		// Se copia byte a byte, la coincidencia se puede solapar con lo que se esta escribiendo
+		const unsigned char* match = out - offset;
+		for(unsigned long long i=0; i<length; i++) out[i] = match[i];
+		out += length;
+	}
+
+	return out == outEnd;
+}
\ No newline at end of file
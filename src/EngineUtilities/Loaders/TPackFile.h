@@ -0,0 +1,107 @@
+#ifndef TPACKFILE_H
+#define TPACKFILE_H
+
+/**
+ * @brief Asset pack archive (TOEP): every file of an asset folder in a single file with a sorted index,
+ * 		  aligned blobs and optional LZ4 per entry. Shared by the engine file system and the offline asset cooker. No OpenGL.
+ *
+ * @file TPackFile.h
+ */
+
+#include <string>
+#include <vector>
+
+/**
+ * @brief 	- Cabecera del pack, todos los campos en little endian
+ * 				Detras van las entradas ordenadas por ruta, las rutas (sin '\0') y los datos de cada entrada alineados
+ */
+struct TPackHeader{
+	char				magic[4];		// magic - Siempre "TOEP"
+	unsigned int		version;		// version - Version del formato
+	unsigned int		headerSize;		// headerSize - Tamanyo de la cabecera en bytes
+	unsigned int		entryCount;		// entryCount - Numero de ficheros
+	unsigned int		entrySize;		// entrySize - Tamanyo de cada entrada en bytes
+	unsigned int		alignment;		// alignment - Alineacion de los datos de cada entrada
+	unsigned long long	entryOffset;	// entryOffset - Inicio de las entradas desde el principio del fichero
+	unsigned long long	nameOffset;		// nameOffset - Inicio de las rutas
+	unsigned long long	nameSize;		// nameSize - Bytes de todas las rutas
+	unsigned long long	fileSize;		// fileSize - Tamanyo total del fichero
+};
+
+/**
+ * @brief 	- Entrada del indice de un fichero del pack
+ */
+struct TPackEntry{
+	unsigned int		nameOffset;		// nameOffset - Inicio de la ruta desde nameOffset de la cabecera
+	unsigned int		nameLength;		// nameLength - Longitud de la ruta, relativa a la carpeta de assets y con '/'
+	unsigned long long	offset;			// offset - Inicio de los datos desde el principio del fichero
+	unsigned long long	size;			// size - Bytes guardados (comprimidos si lleva LZ4)
+	unsigned long long	rawSize;		// rawSize - Bytes del fichero original
+	unsigned int		compression;	// compression - PACK_STORED o PACK_LZ4
+	unsigned int		reserved;		// reserved - Siempre 0
+};
+
+/**
+ * @brief 	- Fichero a guardar en el pack
+ */
+struct TPackSource{
+	std::string			name;			// name - Ruta dentro del pack
+	std::string			path;			// path - Ruta del fichero en disco
+};
+
+class TPackFile{
+public:
+	/**
+	 * @brief	- Comprueba la cabecera, que las entradas esten ordenadas y que todas sus rutas y datos caben en el fichero
+	 *
+	 * @param 	- data - Contenido del fichero
+	 * @param 	- size - Tamanyo del fichero
+	 * @param 	- path - Ruta del fichero para los mensajes de error
+	 * @return 	- bool - El fichero es valido, las entradas se pueden usar sin volver a comprobarlas
+	 */
+	static bool Validate(const unsigned char* data, unsigned long long size, std::string path);
+
+	/**
+	 * @brief	- Busca una entrada por su ruta (busqueda binaria, sin reservar memoria)
+	 *
+	 * @param 	- data - Contenido del pack ya validado
+	 * @param 	- name - Ruta dentro del pack
+	 * @param 	- length - Longitud de la ruta
+	 * @return 	- TPackEntry - Entrada del fichero, nullptr si no esta
+	 */
+	static const TPackEntry* Find(const unsigned char* data, const char* name, unsigned int length);
+
+	/**
+	 * @brief	- Devuelve la ruta de una entrada (no acaba en '\0', su longitud es nameLength)
+	 */
+	static const char* GetName(const unsigned char* data, const TPackEntry* entry);
+
+	/**
+	 * @brief	- Escribe un pack con los ficheros pasados, ordenados por ruta
+	 *
+	 * @param 	- path - Ruta del pack a escribir
+	 * @param 	- sources - Ficheros a guardar
+	 * @param 	- lz4 - Comprime con LZ4 las entradas que ocupan al menos un 10% menos
+	 * @return 	- bool - Se ha escrito correctamente
+	 */
+	static bool Save(std::string path, std::vector<TPackSource> sources, bool lz4);
+
+	/**
+	 * @brief	- Comprime un bloque en formato de bloque LZ4
+	 */
+	static void CompressLZ4(const unsigned char* input, unsigned long long size, std::vector<unsigned char>* output);
+
+	/**
+	 * @brief	- Descomprime un bloque LZ4 comprobando que no se sale de la entrada ni de la salida
+	 *
+	 * @return 	- bool - El bloque es valido y ocupa exactamente outputSize
+	 */
+	static bool DecompressLZ4(const unsigned char* input, unsigned long long size, unsigned char* output, unsigned long long outputSize);
+
+	static const unsigned int PACK_VERSION = 1;			// PACK_VERSION - Version que escribe el cocinador
+	static const unsigned int PACK_ALIGNMENT = 16;		// PACK_ALIGNMENT - Los TOEM y DDS se leen directamente del pack
+	static const unsigned int PACK_STORED = 0;			// PACK_STORED - Entrada sin comprimir
+	static const unsigned int PACK_LZ4 = 1;				// PACK_LZ4 - Entrada en un bloque LZ4
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,173 @@
+#include "TTextureFile.h"
+
+extern "C" {
+#include <SOIL2/image_DXT.h>
+}
+#include <SOIL2/image_helper.h>
+
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+#include <cctype>
+
+/*
+	FORMATO DDS (solo lo que escribe el cocinador)
+	MAGIC + DDS_header			- "DDS " y 124 bytes de cabecera con ancho, alto, numero de mipmaps y FourCC DXT1/DXT5
+	NIVELES						- Bloques de 4x4 de cada mipmap, del mas grande al de 1x1, uno detras de otro
+*/
+
+static_assert(sizeof(DDS_header) == 128, "DDS_header tiene que ocupar 128 bytes sin relleno");
+
+static unsigned int MakeFourCC(char a, char b, char c, char d){
+	return (unsigned int)a | ((unsigned int)b << 8) | ((unsigned int)c << 16) | ((unsigned int)d << 24);
+}
+
+bool TTextureFile::Validate(const unsigned char* data, unsigned long long size, std::string path, int* format, std::vector<TTextureFileLevel>* levels){
+	const char* error = nullptr;
+	DDS_header header;
+	memset(&header, 0, sizeof(DDS_header));
+	levels->clear();
+
+	if(size < TEXTURE_HEADER_SIZE) error = "cabecera incompleta";
+	else{
+		memcpy(&header, data, sizeof(DDS_header));
+		unsigned int fourCC = header.sPixelFormat.dwFourCC;
+
+		if(header.dwMagic != MakeFourCC('D', 'D', 'S', ' ') || header.dwSize != 124) error = "no es un fichero DDS";
+		else if(!(header.sPixelFormat.dwFlags & DDPF_FOURCC)) error = "no esta comprimido";
+		else if(fourCC == MakeFourCC('D', 'X', 'T', '1')) *format = TEXTURE_DXT1;
+		else if(fourCC == MakeFourCC('D', 'X', 'T', '5')) *format = TEXTURE_DXT5;
+		else error = "formato no soportado (solo DXT1 y DXT5)";
+
+		if(error == nullptr && (header.dwWidth == 0 || header.dwHeight == 0 || header.dwWidth > 16384 || header.dwHeight > 16384)) error = "tamanyo de imagen incorrecto";
+	}
+
+	if(error == nullptr){
+		// Sin el flag de mipmaps solo tiene la imagen entera
+		int levelCount = (header.dwFlags & DDSD_MIPMAPCOUNT) ? std::max(1u, header.dwMipMapCount) : 1;
+		int width = header.dwWidth;
+		int height = header.dwHeight;
+		unsigned long long offset = TEXTURE_HEADER_SIZE;
+
+		for(int i=0; i<levelCount && error == nullptr; i++){
+			TTextureFileLevel level;
+			level.width = width;
+			level.height = height;
+			level.offset = offset;
+			level.size = GetLevelSize(width, height, *format);
+
+			if(offset + level.size > size) error = "niveles incompletos";
+			else levels->push_back(level);
+
+			offset += level.size;
+			width = std::max(1, width / 2);
+			height = std::max(1, height / 2);
+		}
+	}
+
+	if(error != nullptr){
+		std::cout<<"Textura corrupta ("<<error<<"): "<<path<<std::endl;
+		levels->clear();
+		return false;
+	}
+	return true;
+}
+
+bool TTextureFile::Save(std::string path, const unsigned char* image, int width, int height, int format){
+	if(image == nullptr || width < 1 || height < 1) return false;
+	if(format == TEXTURE_AUTO) format = ChooseFormat(image, width, height);
+	if(format != TEXTURE_DXT1 && format != TEXTURE_DXT5) return false;
+
+	// Mipmaps hasta 1x1, cada uno a partir del anterior como glGenerateMipmap
+	std::vector<unsigned char> compressed;
+	std::vector<unsigned char> current(image, image + (unsigned long long)width * height * 4);
+	std::vector<unsigned char> next;
+	int levelWidth = width, levelHeight = height, levelCount = 0;
+
+	while(true){
+		int blockSize = 0;
+		unsigned char* blocks = nullptr;
+		if(format == TEXTURE_DXT1) blocks = convert_image_to_DXT1(current.data(), levelWidth, levelHeight, 4, &blockSize);
+		else blocks = convert_image_to_DXT5(current.data(), levelWidth, levelHeight, 4, &blockSize);
+		if(blocks == nullptr) return false;
+
+		compressed.insert(compressed.end(), blocks, blocks + blockSize);
+		free(blocks);
+		levelCount++;
+
+		if(levelWidth == 1 && levelHeight == 1) break;
+
+		int nextWidth = std::max(1, levelWidth / 2);
+		int nextHeight = std::max(1, levelHeight / 2);
+		next.resize((unsigned long long)nextWidth * nextHeight * 4);
+		mipmap_image(current.data(), levelWidth, levelHeight, 4, next.data(), levelWidth > 1 ? 2 : 1, levelHeight > 1 ? 2 : 1);
+		current.swap(next);
+		levelWidth = nextWidth;
+		levelHeight = nextHeight;
+	}
+
+	DDS_header header;
+	memset(&header, 0, sizeof(DDS_header));
+	header.dwMagic = MakeFourCC('D', 'D', 'S', ' ');
+	header.dwSize = 124;
+	header.dwFlags = DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT | DDSD_LINEARSIZE | DDSD_MIPMAPCOUNT;
+	header.dwWidth = width;
+	header.dwHeight = height;
+	header.dwPitchOrLinearSize = GetLevelSize(width, height, format);
+	header.dwMipMapCount = levelCount;
+	header.sPixelFormat.dwSize = 32;
+	header.sPixelFormat.dwFlags = DDPF_FOURCC;
+	header.sPixelFormat.dwFourCC = format == TEXTURE_DXT1 ? MakeFourCC('D', 'X', 'T', '1') : MakeFourCC('D', 'X', 'T', '5');
+	header.sCaps.dwCaps1 = DDSCAPS_TEXTURE | DDSCAPS_COMPLEX | DDSCAPS_MIPMAP;
+
+	std::ofstream file(path, std::ios::binary);
+	if(!file.is_open()){
+		std::cout<<"Error al escribir el archivo: "<<path<<std::endl;
+		return false;
+	}
+
+	file.write((const char*)&header, sizeof(DDS_header));
+	file.write((const char*)compressed.data(), compressed.size());
+	return file.good();
+}
+
+int TTextureFile::ChooseFormat(const unsigned char* image, int width, int height){
+	unsigned long long pixels = (unsigned long long)width * height;
+	for(unsigned long long i=0; i<pixels; i++){
+		if(image[i*4 + 3] != 255) return TEXTURE_DXT5;
+	}
+	return TEXTURE_DXT1;
+}
+
+int TTextureFile::ParseFormat(std::string name){
+	std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+	if(name == "none") return TEXTURE_NONE;
+	if(name == "auto") return TEXTURE_AUTO;
+	if(name == "dxt1") return TEXTURE_DXT1;
+	if(name == "dxt5") return TEXTURE_DXT5;
+	return -1;
+}
+
+unsigned long long TTextureFile::GetLevelSize(int width, int height, int format){
+	unsigned long long blocks = (unsigned long long)((width + 3) / 4) * ((height + 3) / 4);
+	return blocks * (format == TEXTURE_DXT1 ? 8 : 16);
+}
+
+std::string TTextureFile::GetCookedPath(std::string path){
+	std::size_t dot = path.find_last_of('.');
+	std::size_t slash = path.find_last_of("/\\");
+	if(dot != std::string::npos && (slash == std::string::npos || dot > slash)) path.erase(dot);
+	return path + ".dds";
+}
+
+bool TTextureFile::IsImageFile(std::string path){
+	std::size_t dot = path.find_last_of('.');
+	std::size_t slash = path.find_last_of("/\\");
+	if(dot == std::string::npos || (slash != std::string::npos && dot < slash)) return false;
+
+	std::string extension = path.substr(dot + 1);
+	std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+	return extension == "png" || extension == "jpg" || extension == "jpeg" || extension == "tga" || extension == "bmp";
+}
\ No newline at end of file
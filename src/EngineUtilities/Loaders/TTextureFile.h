@@ -0,0 +1,83 @@
+#ifndef TTEXTUREFILE_H
+#define TTEXTUREFILE_H
+
+/**
+ * @brief Compressed texture files (DDS with DXT1/DXT5 and all the mipmaps) shared by the engine loader and the offline asset cooker. No OpenGL.
+ *
+ * @file TTextureFile.h
+ */
+
+#include <string>
+#include <vector>
+
+/**
+ * @brief 	- Nivel de mipmap de un fichero DDS ya validado
+ */
+struct TTextureFileLevel{
+	int					width;		// width - Ancho del nivel
+	int					height;		// height - Alto del nivel
+	unsigned long long	offset;		// offset - Inicio de los bloques desde el principio del fichero
+	unsigned long long	size;		// size - Bytes de bloques del nivel
+};
+
+class TTextureFile{
+public:
+	/**
+	 * @brief	- Comprueba que el fichero es un DDS en DXT1 o DXT5 y que todos sus niveles caben en el fichero
+	 *
+	 * @param 	- data - Contenido del fichero
+	 * @param 	- size - Tamanyo del fichero
+	 * @param 	- path - Ruta del fichero para los mensajes de error
+	 * @param 	- format - TEXTURE_DXT1 o TEXTURE_DXT5
+	 * @param 	- levels - Niveles de mipmap, el 0 es la imagen entera
+	 * @return 	- bool - El fichero es valido
+	 */
+	static bool Validate(const unsigned char* data, unsigned long long size, std::string path, int* format, std::vector<TTextureFileLevel>* levels);
+
+	/**
+	 * @brief	- Genera los mipmaps de una imagen, los comprime y los guarda en un DDS
+	 *
+	 * @param 	- path - Ruta del fichero a escribir
+	 * @param 	- image - Pixeles RGBA, la primera fila es la de arriba (como los devuelve SOIL)
+	 * @param 	- width - Ancho de la imagen
+	 * @param 	- height - Alto de la imagen
+	 * @param 	- format - TEXTURE_DXT1, TEXTURE_DXT5 o TEXTURE_AUTO
+	 * @return 	- bool - Se ha escrito correctamente
+	 */
+	static bool Save(std::string path, const unsigned char* image, int width, int height, int format);
+
+	/**
+	 * @brief	- Elige el formato de una imagen RGBA: DXT5 si algun pixel es transparente, si no DXT1
+	 */
+	static int ChooseFormat(const unsigned char* image, int width, int height);
+
+	/**
+	 * @brief	- Convierte el nombre de un formato (none, auto, dxt1, dxt5) a su constante
+	 *
+	 * @return 	- int - Constante del formato, -1 si no existe
+	 */
+	static int ParseFormat(std::string name);
+
+	/**
+	 * @brief	- Bytes de bloques de 4x4 de un nivel (8 por bloque en DXT1, 16 en DXT5)
+	 */
+	static unsigned long long GetLevelSize(int width, int height, int format);
+
+	/**
+	 * @brief	- Devuelve la ruta del fichero cocinado de una textura (wall.png -> wall.dds)
+	 */
+	static std::string GetCookedPath(std::string path);
+
+	/**
+	 * @brief	- Comprueba si la ruta es de una imagen que se puede cocinar (png, jpg, tga o bmp)
+	 */
+	static bool IsImageFile(std::string path);
+
+	static const int TEXTURE_NONE = 0;						// TEXTURE_NONE - No se comprime, se sigue cargando la imagen original
+	static const int TEXTURE_AUTO = 1;						// TEXTURE_AUTO - DXT5 si tiene transparencia, si no DXT1
+	static const int TEXTURE_DXT1 = 2;						// TEXTURE_DXT1 - 4 bits por pixel, sin alfa
+	static const int TEXTURE_DXT5 = 3;						// TEXTURE_DXT5 - 8 bits por pixel, con alfa
+	static const unsigned int TEXTURE_HEADER_SIZE = 128;	// TEXTURE_HEADER_SIZE - Magic y cabecera del DDS
+};
+
+#endif
\ No newline at end of file
@@ -1,24 +1,37 @@
 #include "TTextureLoader.h"
+#include "TFileSystem.h"
 #include <SOIL2/SOIL2.h>
-#include <fstream>
 #include <string.h>
+#include <algorithm>
 
-bool TTextureLoader::LoadTexture(std::string path, unsigned char** imageData, int* width, int* height){
+bool TTextureLoader::LoadTexture(std::string path, unsigned char** imageData, int* width, int* height, int* channels){
 
-	std::ifstream file(path);									// |
-	if(!file.fail()) file.close();								// |
-	else{														// |
-		std::cout<<"File not found " + path<<std::endl;			// |
-		return false;											// | Comprobacion de que exista
+	// Se abre una sola vez (del pack o del disco) y se decodifica desde memoria
+	TVirtualFile file;
+	if(!file.Open(path)){
+		std::cout<<"File not found " + path<<std::endl;
+		return false;
 	}
+	const unsigned char* data = file.GetData();
+	int size = file.GetSize();
 
 	// Cargamos la imagen forzando el numero de canales a 4 (SOIL_LOAD_RGBA)
-	int channels;
-	*imageData = SOIL_load_image(path.c_str(), width, height, &channels, SOIL_LOAD_RGBA);
+	// Si se aceptan otros canales los jpg se quedan en RGB, las imagenes en escala de grises siguen pasando a RGBA
+	int fileChannels;
+	if(channels == nullptr) *imageData = SOIL_load_image_from_memory(data, size, width, height, &fileChannels, SOIL_LOAD_RGBA);
+	else{
+		*imageData = SOIL_load_image_from_memory(data, size, width, height, &fileChannels, SOIL_LOAD_AUTO);
+		if(*imageData != nullptr && fileChannels != 3 && fileChannels != 4){
+			SOIL_free_image_data(*imageData);
+			*imageData = SOIL_load_image_from_memory(data, size, width, height, &fileChannels, SOIL_LOAD_RGBA);
+			fileChannels = 4;
+		}
+		*channels = fileChannels;
+	}
 
 	// Comprobamos si hemos cargado la imagen
 	bool toRet = true;
-	if(imageData == nullptr){
+	if(*imageData == nullptr){
 		std::cout<<"Could not open file " + path<<std::endl;
 		toRet = false;
 	}
@@ -29,30 +42,25 @@ bool TTextureLoader::LoadTexture(std::string path, unsigned char** imageData, in
 bool TTextureLoader::LoadTextureBinary(std::string path, std::vector<unsigned char>* imageData, int* width, int* height){
 	bool output = false;
 
-	std::ifstream texFile;
-	texFile.open(path, std::ios::binary);
+	TVirtualFile texFile;
 
 	// Miramos si se ha abierto el documento correctamente
-	if(texFile.is_open()){
-		// Cargamos el ancho de la imagen
-		texFile.read(reinterpret_cast<char*>(width), sizeof(int));
-		// Cargamos el alto de la imagen
-		texFile.read(reinterpret_cast<char*>(height), sizeof(int));
+	if(texFile.Open(path) && texFile.GetSize() >= 2 * sizeof(int)){
+		const unsigned char* data = texFile.GetData();
+		// Cargamos el ancho y el alto de la imagen
+		memcpy(width, data, sizeof(int));
+		memcpy(height, data + sizeof(int), sizeof(int));
 
-		// Calculamos el numero de valores a cargar
-		int size = (*width)*(*height) * 4;
+		// Calculamos el numero de valores a cargar, sin pasarnos del fichero
+		unsigned long long size = (unsigned long long)std::max(0, *width) * std::max(0, *height) * 4;
+		size = std::min(size, (unsigned long long)texFile.GetSize() - 2 * sizeof(int));
 
 		// Cargamos todos los caracteres de la imagen
-		unsigned char currentChar;
-		for(int i=0; i<size; i++){
-			texFile.read(reinterpret_cast<char*>(&currentChar), sizeof(unsigned char));
-			imageData->push_back(currentChar);
-		}
+		imageData->insert(imageData->end(), data + 2 * sizeof(int), data + 2 * sizeof(int) + size);
 
 		// Damos la textura por cargada
 		output = true;
 	}
-	texFile.close();
 
 	return output;
 }
@@ -24,9 +24,11 @@ public:
 	 * @param 	- char - Informacion de la textura
 	 * @param 	- width - Ancho de la textura
 	 * @param 	- height - Altura de la textura
+	 * @param 	- channels - Si se pasa, las imagenes RGB se dejan con 3 canales y se devuelve cuantos tiene
+	 * 				Si no, siempre se cargan con 4 canales
 	 * @return 	- bool - Se ha cargado correctamene la imagen
 	 */
-	static bool LoadTexture(std::string path, unsigned char** imageData, int* width, int* height);
+	static bool LoadTexture(std::string path, unsigned char** imageData, int* width, int* height, int* channels = nullptr);
 	
 	/**
 	 * @brief - Cargamos la textura haciendo uso de un cargador binario
@@ -8,6 +8,23 @@
 // Glew for opengl
 #include <GL/glew.h>
 
+// Nombres en los shaders de los uniforms y atributos, en el mismo orden que sus enumeradores
+static const char* uniformNames[UNIFORM_COUNT] = {
+    "MVP", "ModelMatrix", "ViewMatrix", "ModelViewMatrix", "ProjectionMatrix", "NormalMatrix",
+    "DepthMVP", "MRot", "frameTime", "TextureScale", "uvMap", "specularMap", "bumpMap", "myMask",
+    "Material.Shininess", "Material.Diffuse", "Material.Specular", "Material.Ambient",
+    "LineColor", "AmbientLight", "nlights", "nshadowlights"
+};
+
+static const char* lightUniformNames[LIGHT_UNIFORM_COUNT] = {
+    "Position", "Diffuse", "Specular", "Attenuation", "Directional", "Direction", "ShadowLight", "ShadowMap"
+};
+
+static const char* attribNames[ATTRIB_COUNT] = {
+    "VertexPosition", "VertexNormal", "TextureCoords", "MaskCoords", "ParticleCenter", "ParticleColor",
+    "ParticleExtra", "Position", "position", "color", "overColor"
+};
+
 Program::Program(std::map<std::string, GLenum> shaderData){
     // Load all the shaders    
     m_shaders = std::vector<GLuint>(shaderData.size());
@@ -27,6 +44,14 @@ Program::Program(std::map<std::string, GLenum> shaderData){
         glAttachShader(m_programID, m_shaders[i]);
     }
 
+    // Fijamos las locations del formato de vertices de los meshes para que todos los programas compartan el VAO
+    glBindAttribLocation(m_programID, MESH_POSITION_LOCATION, "VertexPosition");
+    glBindAttribLocation(m_programID, MESH_POSITION_LOCATION, "Position");
+    glBindAttribLocation(m_programID, MESH_NORMAL_LOCATION, "VertexNormal");
+    glBindAttribLocation(m_programID, MESH_UV_LOCATION, "TextureCoords");
+    glBindAttribLocation(m_programID, MESH_TANGENT_LOCATION, "VertexTangent");
+    glBindAttribLocation(m_programID, MESH_INSTANCE_LOCATION, "InstanceModelMatrix");
+
     // Se linkea el programa a los shaders
     glLinkProgram(m_programID);
 
@@ -53,6 +78,9 @@ Program::Program(std::map<std::string, GLenum> shaderData){
         //throw std::runtime_error(msg);
         std::cout << msg << std::endl;
     }
+
+    // Guardamos las locations una unica vez para no preguntarlas al pintar
+    LoadLocations();
 }
 
 // Delete all shaders
@@ -72,4 +100,95 @@ GLuint Program::LoadShader(std::string shaderPath, GLenum shaderType){
 
 GLuint Program::GetProgramID(){
     return m_programID;
+}
+
+void Program::LoadLocations(){
+    m_uniforms.clear();
+    m_attribs.clear();
+
+    if(m_programID != 0){
+        GLint count = 0;
+        GLint maxLength = 0;
+
+        // UNIFORMS ACTIVOS
+        glGetProgramiv(m_programID, GL_ACTIVE_UNIFORMS, &count);
+        glGetProgramiv(m_programID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+        std::vector<char> name(maxLength + 1);
+
+        for(int i = 0; i < count; i++){
+            GLint size = 0;
+            GLenum type = 0;
+            glGetActiveUniform(m_programID, i, maxLength + 1, nullptr, &size, &type, &name[0]);
+            std::string uniform(&name[0]);
+            m_uniforms[uniform] = glGetUniformLocation(m_programID, uniform.c_str());
+
+            // Los arrays de tipos basicos solo aparecen una vez como "nombre[0]", guardamos todos sus elementos
+            size_t bracket = uniform.rfind("[0]");
+            if(size > 1 && bracket != std::string::npos && bracket + 3 == uniform.size()){
+                std::string base = uniform.substr(0, bracket);
+                for(int j = 1; j < size; j++){
+                    std::string element = base + "[" + std::to_string(j) + "]";
+                    m_uniforms[element] = glGetUniformLocation(m_programID, element.c_str());
+                }
+            }
+        }
+
+        // ATRIBUTOS ACTIVOS
+        glGetProgramiv(m_programID, GL_ACTIVE_ATTRIBUTES, &count);
+        glGetProgramiv(m_programID, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &maxLength);
+        name = std::vector<char>(maxLength + 1);
+
+        for(int i = 0; i < count; i++){
+            GLint size = 0;
+            GLenum type = 0;
+            glGetActiveAttrib(m_programID, i, maxLength + 1, nullptr, &size, &type, &name[0]);
+            std::string attrib(&name[0]);
+            m_attribs[attrib] = glGetAttribLocation(m_programID, attrib.c_str());
+        }
+    }
+
+    // Rellenamos las tablas con los nombres conocidos
+    for(int i = 0; i < UNIFORM_COUNT; i++) m_uniformLocations[i] = GetUniformLocation(std::string(uniformNames[i]));
+
+    for(int i = 0; i < MAX_SHADER_LIGHTS; i++){
+        std::string light = "Light[" + std::to_string(i) + "].";
+        for(int j = 0; j < LIGHT_UNIFORM_COUNT; j++) m_lightLocations[i][j] = GetUniformLocation(light + lightUniformNames[j]);
+    }
+
+    for(int i = 0; i < MAX_SHADER_SHADOWS; i++){
+        m_depthBiasLocations[i] = GetUniformLocation("DepthBiasMVPArray[" + std::to_string(i) + "]");
+    }
+
+    for(int i = 0; i < ATTRIB_COUNT; i++){
+        std::map<std::string, GLint>::iterator it = m_attribs.find(attribNames[i]);
+        if(it != m_attribs.end()) m_attribLocations[i] = it->second;
+        else m_attribLocations[i] = -1;
+    }
+}
+
+GLint Program::GetUniformLocation(UNIFORMTYPE uniform){
+    return m_uniformLocations[uniform];
+}
+
+GLint Program::GetLightUniformLocation(int light, LIGHTUNIFORMTYPE uniform){
+    GLint toRet = -1;
+    if(light >= 0 && light < MAX_SHADER_LIGHTS) toRet = m_lightLocations[light][uniform];
+    return toRet;
+}
+
+GLint Program::GetDepthBiasLocation(int num){
+    GLint toRet = -1;
+    if(num >= 0 && num < MAX_SHADER_SHADOWS) toRet = m_depthBiasLocations[num];
+    return toRet;
+}
+
+GLint Program::GetAttribLocation(ATTRIBTYPE attrib){
+    return m_attribLocations[attrib];
+}
+
+GLint Program::GetUniformLocation(std::string name){
+    GLint toRet = -1;
+    std::map<std::string, GLint>::iterator it = m_uniforms.find(name);
+    if(it != m_uniforms.end()) toRet = it->second;
+    return toRet;
 }
\ No newline at end of file
@@ -14,6 +14,7 @@
 
 typedef unsigned int GLuint;
 typedef unsigned int GLenum;
+typedef int GLint;
 
 class Program{
 
@@ -36,11 +37,66 @@ public:
      * @return  - GLuint - OpenGL ShaderID 
      */
     GLuint GetProgramID();
+
+    /**
+     * @brief   - Devuelve la location del uniform cacheada al linkar el programa
+     * 
+     * @param   - uniform - Uniform a buscar
+     * @return  - GLint - Location del uniform, -1 si el programa no lo utiliza
+     */
+    GLint GetUniformLocation(UNIFORMTYPE uniform);
+
+    /**
+     * @brief   - Devuelve la location de un campo de una luz del array Light[]
+     * 
+     * @param   - light - Indice de la luz
+     * @param   - uniform - Campo de la luz
+     * @return  - GLint - Location del uniform, -1 si el programa no lo utiliza
+     */
+    GLint GetLightUniformLocation(int light, LIGHTUNIFORMTYPE uniform);
+
+    /**
+     * @brief   - Devuelve la location de un elemento del array DepthBiasMVPArray[]
+     * 
+     * @param   - num - Indice de la luz con sombras
+     * @return  - GLint - Location del uniform, -1 si el programa no lo utiliza
+     */
+    GLint GetDepthBiasLocation(int num);
+
+    /**
+     * @brief   - Devuelve la location del atributo cacheada al linkar el programa
+     * 
+     * @param   - attrib - Atributo a buscar
+     * @return  - GLint - Location del atributo, -1 si el programa no lo utiliza
+     */
+    GLint GetAttribLocation(ATTRIBTYPE attrib);
+
+    /**
+     * @brief   - Busca por nombre un uniform activo del programa sin preguntar al driver
+     * 
+     * @param   - name - Nombre del uniform
+     * @return  - GLint - Location del uniform, -1 si el programa no lo utiliza
+     */
+    GLint GetUniformLocation(std::string name);
     
 private:
     GLuint m_programID;             // m_programID - Id del programa
     std::vector<GLuint> m_shaders;  // m_shaders - Shaders que utiliza el programa
 
+    std::map<std::string, GLint> m_uniforms;    // m_uniforms - Uniforms activos del programa por nombre
+    std::map<std::string, GLint> m_attribs;     // m_attribs - Atributos activos del programa por nombre
+
+    GLint m_uniformLocations[UNIFORM_COUNT];                                // m_uniformLocations - Locations de los uniforms conocidos
+    GLint m_lightLocations[MAX_SHADER_LIGHTS][LIGHT_UNIFORM_COUNT];         // m_lightLocations - Locations de los campos de cada luz
+    GLint m_depthBiasLocations[MAX_SHADER_SHADOWS];                         // m_depthBiasLocations - Locations de las matrices de sombras
+    GLint m_attribLocations[ATTRIB_COUNT];                                  // m_attribLocations - Locations de los atributos conocidos
+
+    /**
+     * @brief   - Lee todos los uniforms y atributos activos del programa una vez linkado
+     *              y rellena las tablas de locations
+     */
+    void LoadLocations();
+
     /**
      * @brief Creates shaders depending of type
      * 
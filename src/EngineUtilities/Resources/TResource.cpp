@@ -1,7 +1,15 @@
 #include "TResource.h"
+#include "./../TResourceManager.h"
 
-TResource::TResource(){
+unsigned int TResource::m_frame = 0;
 
+TResource::TResource(){
+	m_id = NO_RESOURCE_ID;
+	m_loaded = false;
+	m_evicted = false;
+	m_lastUse = m_frame;
+	m_references = 0;
+	m_pinned = false;
 }
 
 TResource::~TResource(){
@@ -17,6 +25,14 @@ void TResource::SetName(std::string name){
 	m_name = name;
 }
 
+TResourceId TResource::GetId(){
+	return m_id;
+}
+
+void TResource::SetId(TResourceId id){
+	m_id = id;
+}
+
 bool TResource::GetLoaded(){
 	return m_loaded;
 }
@@ -30,4 +46,86 @@ bool TResource::LoadFile(std::string name){
 	SetName(name);
 	toRet = LoadFile();
 	return toRet;
+}
+
+bool TResource::ReadFile(){
+	// Por defecto todo se carga en UploadFile
+	return true;
+}
+
+bool TResource::UploadFile(){
+	return LoadFile();
+}
+
+unsigned long long TResource::GetUploadSize(){
+	return 0;
+}
+
+RESOURCETYPE TResource::GetType(){
+	return NONE_RESOURCE;
+}
+
+unsigned long long TResource::GetCpuSize(){
+	return 0;
+}
+
+unsigned long long TResource::GetGpuSize(){
+	return 0;
+}
+
+bool TResource::Unload(){
+	return false;
+}
+
+bool TResource::Evict(){
+	// Los que no se han cargado bien no tienen nada que liberar
+	if(m_evicted || !m_loaded) return false;
+	m_evicted = Unload();
+	return m_evicted;
+}
+
+void TResource::Use(){
+	m_lastUse = m_frame;
+	if(!m_evicted) return;
+
+	// Se vuelve a cargar en segundo plano, mientras tanto se pinta la provisional
+	m_evicted = false;
+	TResourceManager::GetInstance()->ReloadResource(this);
+}
+
+bool TResource::GetEvicted(){
+	return m_evicted;
+}
+
+unsigned int TResource::GetLastUse(){
+	return m_lastUse;
+}
+
+void TResource::AddReference(){
+	m_references++;
+}
+
+int TResource::RemoveReference(){
+	m_references--;
+	return m_references;
+}
+
+int TResource::GetReferences(){
+	return m_references;
+}
+
+void TResource::SetPinned(bool pinned){
+	m_pinned = pinned;
+}
+
+bool TResource::GetPinned(){
+	return m_pinned;
+}
+
+void TResource::NextFrame(){
+	m_frame++;
+}
+
+unsigned int TResource::GetFrame(){
+	return m_frame;
 }
\ No newline at end of file
@@ -7,6 +7,7 @@
  * @file TResource.h
  */
 
+#include <ResourceTypes.h>
 #include <string>
 
 class TResource{
@@ -33,6 +34,102 @@ public:
 	 * @return 	- bool - El recurso se ha cargado correctamente
 	 */
 	bool LoadFile(std::string name);
+
+	/**
+	 * @brief	- Parte de la carga que no usa OpenGL (lectura de disco, decodificado...)
+	 * 				Se puede llamar desde los hilos del cargador asincrono, no puede tocar el TResourceManager
+	 * 
+	 * @return 	- bool - Se han leido los datos correctamente
+	 */
+	virtual bool ReadFile();
+
+	/**
+	 * @brief	- Parte de la carga que sube a la grafica lo leido en ReadFile, siempre en el hilo principal
+	 * 
+	 * @return 	- bool - El recurso se ha cargado correctamente
+	 */
+	virtual bool UploadFile();
+
+	/**
+	 * @brief	- Bytes que subira UploadFile a la grafica, para el presupuesto de subida por frame
+	 */
+	virtual unsigned long long GetUploadSize();
+
+	/**
+	 * @brief	- Tipo del recurso, para separar la memoria usada y los presupuestos por tipo
+	 */
+	virtual RESOURCETYPE GetType();
+
+	/**
+	 * @brief	- Bytes que ocupa el recurso en memoria principal
+	 */
+	virtual unsigned long long GetCpuSize();
+
+	/**
+	 * @brief	- Bytes que ocupa el recurso en la grafica
+	 */
+	virtual unsigned long long GetGpuSize();
+
+	/**
+	 * @brief	- Libera la memoria del recurso sin eliminarlo, los punteros al recurso siguen siendo validos
+	 * 				Se vuelve a cargar la proxima vez que se use
+	 * 
+	 * @return 	- bool - Se ha liberado, los recursos que no se pueden recargar devuelven false
+	 */
+	bool Evict();
+
+	/**
+	 * @brief	- Marca el recurso como usado en este frame y pide que se vuelva a cargar si se habia liberado
+	 * 				Solo desde el hilo principal, lo llaman los getters que se usan al pintar
+	 */
+	void Use();
+
+	/**
+	 * @brief	- Devuelve si el recurso se ha liberado por falta de memoria
+	 */
+	bool GetEvicted();
+
+	/**
+	 * @brief	- Devuelve el ultimo frame en el que se ha usado el recurso
+	 */
+	unsigned int GetLastUse();
+
+	/**
+	 * @brief	- Anyade una referencia, la llaman los TResourceHandle
+	 */
+	void AddReference();
+
+	/**
+	 * @brief	- Quita una referencia
+	 * 
+	 * @return 	- int - Referencias que quedan
+	 */
+	int RemoveReference();
+
+	/**
+	 * @brief	- Devuelve el numero de TResourceHandle que apuntan al recurso
+	 */
+	int GetReferences();
+
+	/**
+	 * @brief	- Fija el recurso para que no se elimine aunque no tenga referencias
+	 */
+	void SetPinned(bool pinned);
+
+	/**
+	 * @brief	- Devuelve si el recurso esta fijado
+	 */
+	bool GetPinned();
+
+	/**
+	 * @brief	- Pasa al siguiente frame, una vez por frame desde el TResourceManager
+	 */
+	static void NextFrame();
+
+	/**
+	 * @brief	- Devuelve el frame actual
+	 */
+	static unsigned int GetFrame();
 	
 	/**
 	 * @brief	- Devolvemos la ruta al recurso 
@@ -48,6 +145,16 @@ public:
 	 */
 	void SetName(std::string name);
 
+	/**
+	 * @brief	- Devuelve el id de la ruta en el TResourceManager
+	 */
+	TResourceId GetId();
+
+	/**
+	 * @brief	- Cambia el id de la ruta, solo lo llama el TResourceManager al crearlo
+	 */
+	void SetId(TResourceId id);
+
 	/**
 	 * @brief	- Devolvemos si el recurso esta correctamente cargado 
 	 * 
@@ -58,7 +165,22 @@ public:
 
 protected:
 	std::string m_name;				// m_name - Ruta al recurso
+	TResourceId m_id;				// m_id - Id de la ruta en el TResourceManager
 	bool m_loaded;					// m_loaded - Si el recurso se ha cargado bien
+	bool m_evicted;					// m_evicted - Se ha liberado su memoria y se tiene que recargar al usarse
+	unsigned int m_lastUse;			// m_lastUse - Ultimo frame en el que se ha usado
+	int m_references;				// m_references - Handles que apuntan al recurso
+	bool m_pinned;					// m_pinned - No se elimina aunque no tenga referencias
+
+	static unsigned int m_frame;	// m_frame - Frame actual
+
+	/**
+	 * @brief	- Libera la memoria en CPU y en la grafica del recurso, sin tocar su nombre ni sus dimensiones
+	 * 				Por defecto no se puede liberar
+	 * 
+	 * @return 	- bool - Se ha liberado
+	 */
+	virtual bool Unload();
 
 	/**
 	 * @brief	- Cambia el valor de si esta cargado bien 
@@ -49,6 +49,10 @@ bool TResourceMaterial::LoadFile(){
 	return toRet;
 }
 
+RESOURCETYPE TResourceMaterial::GetType(){
+	return MATERIAL_RESOURCE;
+}
+
 void TResourceMaterial::SetColorDifuse(glm::vec3 color){
 	m_colorDifuse = color;
 }
@@ -39,6 +39,11 @@ public:
      */
     bool LoadFile();
 
+    /**
+     * @brief   - Devuelve MATERIAL_RESOURCE
+     */
+    RESOURCETYPE GetType();
+
     /**
      * @brief   - Cambia el valor difuso del material 
      * 
@@ -1,8 +1,10 @@
 #include "TResourceMesh.h"
 #include "./../Loaders/TObjectLoader.h"
+#include "./../Loaders/TMeshFile.h"
 #include "./../TResourceManager.h"
 #include "./../TOcularEngine/VideoDriver.h"
 
+#include <ShaderTypes.h>
 #include <GL/glew.h>
 
 TResourceMesh::TResourceMesh(std::string name){
@@ -12,36 +14,62 @@ TResourceMesh::TResourceMesh(std::string name){
 	m_specularMap = nullptr;
 	m_bumpMap = nullptr;
 	m_basicMaterial = nullptr;
+	m_placeholder = nullptr;
+	m_pending = nullptr;
+	m_revision = 0;
+	m_gpuSize = 0;
 
 	m_center = glm::vec3(0,0,0);
 	m_size = glm::vec3(1,1,1);
+	m_cpuDataLoaded = false;
 
 	// Inicializamos los buffer
-	m_vbo = 0;
-	glGenBuffers(1, &m_vbo);
+	CreateBuffers();
 
-	m_ebo = 0;
-	glGenBuffers(1, &m_ebo);
+	// Cargamos el mesh
+	LoadFile();
+	SetDefaultTextures();
+}
 
-	m_uvbo = 0;
-	glGenBuffers(1, &m_uvbo);
+TResourceMesh::TResourceMesh(std::string name, TResourceMesh* placeholder){
+	// Inicializamos las variables
+	m_name = name;
+	m_basicTexture = nullptr;
+	m_specularMap = nullptr;
+	m_bumpMap = nullptr;
+	m_basicMaterial = nullptr;
+	m_placeholder = placeholder;
+	m_pending = nullptr;
+	m_revision = 0;
+	m_gpuSize = 0;
+
+	m_center = glm::vec3(0,0,0);
+	m_size = glm::vec3(1,1,1);
+	m_cpuDataLoaded = false;
 
-	m_nbo = 0;
-	glGenBuffers(1, &m_nbo);
+	// Inicializamos los buffer, se rellenan al subir el mesh
+	CreateBuffers();
 
-	// Cargamos el mesh
-	LoadFile();
+	// Las texturas por defecto son las provisionales de las texturas del mesh
+	SetDefaultTextures();
+}
+
+void TResourceMesh::SetDefaultTextures(){
+	TResourceManager* manager = TResourceManager::GetInstance();
 	// En el caso de que no tenga textura le ponemos una textura blanca por defecto
 	if(m_basicTexture == nullptr){
-		m_basicTexture = TResourceManager::GetInstance()->GetResourceTexture(VideoDriver::GetInstance()->GetAssetsPath() + "/textures/default_texture.png");
+		m_basicTexture = manager->GetResourceTexture(manager->GetDefaultId(DEFAULT_TEXTURE));
+		manager->PinResource(m_basicTexture);	// La comparten todos los mesh
 	}
 	// En el caso de que no tenga mapa de especulares le ponemos una textura blanca por defecto
 	if(m_specularMap == nullptr){
-		m_specularMap = TResourceManager::GetInstance()->GetResourceTexture(VideoDriver::GetInstance()->GetAssetsPath() + "/textures/default_texture.png");
+		m_specularMap = manager->GetResourceTexture(manager->GetDefaultId(DEFAULT_TEXTURE));
+		manager->PinResource(m_specularMap);	// La comparten todos los mesh
 	}
 	// En el caso de que no tenga mapa de normales le ponemos por defecto una textura azul (para que no se alteren las normales del objeto)
 	if(m_bumpMap == nullptr){
-		m_bumpMap = TResourceManager::GetInstance()->GetResourceTexture(VideoDriver::GetInstance()->GetAssetsPath() + "/textures/default_bump.png");
+		m_bumpMap = manager->GetResourceTexture(manager->GetDefaultId(DEFAULT_BUMP));
+		manager->PinResource(m_bumpMap);	// La comparten todos los mesh
 	}
 }
 
@@ -50,32 +78,97 @@ TResourceMesh::TResourceMesh(){
 	m_name = "";
 	m_basicTexture = nullptr;
 	m_basicMaterial = nullptr;
+	m_placeholder = nullptr;
+	m_pending = nullptr;
+	m_revision = 0;
+	m_gpuSize = 0;
 	m_center = glm::vec3(0,0,0);
 	m_size = glm::vec3(0,0,0);
+	m_cpuDataLoaded = false;
 
 	// Inicializamos los buffer
+	CreateBuffers();
+}
+
+TResourceMesh::~TResourceMesh(){
+	if(m_pending != nullptr) delete m_pending;
+
+	// Eliminamos el buffer
+	glBindBuffer(GL_ARRAY_BUFFER, 0);	
+
+	glDeleteVertexArrays(1, &m_vao);
+	glDeleteBuffers(1, &m_vbo);
+	glDeleteBuffers(1, &m_ebo);
+}
+
+void TResourceMesh::CreateBuffers(){
+	m_elementSize = 0;
+
+	m_vao = 0;
+	glGenVertexArrays(1, &m_vao);
+
 	m_vbo = 0;
 	glGenBuffers(1, &m_vbo);
 
 	m_ebo = 0;
 	glGenBuffers(1, &m_ebo);
+}
 
-	m_uvbo = 0;
-	glGenBuffers(1, &m_uvbo);
+void TResourceMesh::SetVertexData(std::vector<glm::vec3>* vertex, std::vector<glm::vec2>* uv, std::vector<glm::vec3>* normal, std::vector<unsigned int>* index, std::vector<glm::vec3>* tangent){
+	std::vector<float> data;
+	bool hasTangents = TMeshFile::InterleaveVertices(vertex, uv, normal, tangent, &data);
+	SetInterleavedData(data.data(), vertex->size(), hasTangents, index->data(), index->size());
+}
 
-	m_nbo = 0;
-	glGenBuffers(1, &m_nbo);
+void TResourceMesh::SetCpuData(std::vector<glm::vec3>* positions, std::vector<unsigned int>* indices){
+	m_positions = *positions;
+	m_indices = *indices;
+	m_cpuDataLoaded = true;
 }
 
-TResourceMesh::~TResourceMesh(){
-	// Eliminamos el buffer
-	glBindBuffer(GL_ARRAY_BUFFER, 0);	
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+void TResourceMesh::SetInterleavedData(const void* vertexData, int vertexCount, bool hasTangents, const unsigned int* index, int indexCount){
+	int floatsPerVertex = hasTangents ? 11 : 8;
 
-	glDeleteBuffers(1, &m_vbo);
-	glDeleteBuffers(1, &m_ebo);
-	glDeleteBuffers(1, &m_uvbo);
-	glDeleteBuffers(1, &m_nbo);
+	// Nos guardamos el VAO que estuviera activo para dejarlo igual al acabar
+	GLint previousVao = 0;
+	glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &previousVao);
+
+	glBindVertexArray(m_vao);
+
+	// Cargamos el buffer de vertices intercalados
+	glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+	glBufferData(GL_ARRAY_BUFFER, vertexCount*floatsPerVertex*sizeof(float), vertexData, GL_STATIC_DRAW);
+
+	// Cargamos el buffer de elementos, se queda enlazado en el VAO
+	m_elementSize = indexCount;
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexCount*sizeof(unsigned int), index, GL_STATIC_DRAW);
+
+	// Describimos el formato con las locations fijas que enlazan todos los programas
+	GLsizei stride = floatsPerVertex * sizeof(float);
+	glEnableVertexAttribArray(MESH_POSITION_LOCATION);
+	glVertexAttribPointer(MESH_POSITION_LOCATION, 3, GL_FLOAT, GL_FALSE, stride, (void*)0);
+
+	glEnableVertexAttribArray(MESH_NORMAL_LOCATION);
+	glVertexAttribPointer(MESH_NORMAL_LOCATION, 3, GL_FLOAT, GL_FALSE, stride, (void*)(3*sizeof(float)));
+
+	glEnableVertexAttribArray(MESH_UV_LOCATION);
+	glVertexAttribPointer(MESH_UV_LOCATION, 2, GL_FLOAT, GL_FALSE, stride, (void*)(6*sizeof(float)));
+
+	if(hasTangents){
+		glEnableVertexAttribArray(MESH_TANGENT_LOCATION);
+		glVertexAttribPointer(MESH_TANGENT_LOCATION, 3, GL_FLOAT, GL_FALSE, stride, (void*)(8*sizeof(float)));
+	}
+	else glDisableVertexAttribArray(MESH_TANGENT_LOCATION);
+
+	glBindVertexArray(previousVao);
+	m_gpuSize = (unsigned long long)vertexCount * stride + (unsigned long long)indexCount * sizeof(unsigned int);
+
+	// Las copias en CPU se sacan del fichero solo si se piden (los oclusores), con swap se libera la memoria
+	std::vector<glm::vec3>().swap(m_positions);
+	std::vector<unsigned int>().swap(m_indices);
+	m_cpuDataLoaded = false;
+	m_revision++;
 }
 
 void TResourceMesh::AddBumpMap(TResourceTexture* texture){
@@ -97,11 +190,80 @@ void TResourceMesh::AddMaterial(TResourceMaterial* material){
 bool TResourceMesh::LoadFile(){
 	// Cargamos el material haciendo uso de la carga binaria
 	// Para utilizar esta carga hemos tenido que tratar de antemano los obj
-	bool toRet = TObjectLoader::LoadObjBinary(this);
+	bool toRet = ReadFile() && UploadFile();
 	SetLoaded(toRet);
 	return toRet;
 }
 
+bool TResourceMesh::ReadFile(){
+	if(m_pending != nullptr) delete m_pending;
+	m_pending = new TMeshLoadData();
+
+	if(!TObjectLoader::ReadObjBinary(m_name, m_pending)){
+		delete m_pending;
+		m_pending = nullptr;
+		return false;
+	}
+	return true;
+}
+
+bool TResourceMesh::UploadFile(){
+	bool toRet = false;
+	if(m_pending != nullptr){
+		// Si tiene provisional es que se esta cargando en segundo plano, sus texturas tambien
+		toRet = TObjectLoader::UploadObjBinary(this, m_pending, m_placeholder != nullptr);
+		delete m_pending;
+		m_pending = nullptr;
+	}
+
+	// Si falla se sigue pintando el provisional
+	if(toRet) m_placeholder = nullptr;
+	SetLoaded(toRet);
+	return toRet;
+}
+
+unsigned long long TResourceMesh::GetUploadSize(){
+	if(m_pending == nullptr) return 0;
+	if(m_pending->mapped){
+		const TMeshFileHeader* header = &m_pending->header;
+		return (unsigned long long)header->vertexCount * header->vertexStride + (unsigned long long)header->indexCount * sizeof(unsigned int);
+	}
+	return m_pending->legacy.vertex.size() * 8 * sizeof(float) + m_pending->legacy.index.size() * sizeof(unsigned int);
+}
+
+bool TResourceMesh::Unload(){
+	// Mientras se carga en segundo plano no se puede liberar
+	if(m_placeholder != nullptr || m_pending != nullptr) return false;
+
+	glDeleteVertexArrays(1, &m_vao);
+	glDeleteBuffers(1, &m_vbo);
+	glDeleteBuffers(1, &m_ebo);
+	CreateBuffers();
+	m_gpuSize = 0;
+
+	// Con swap se libera la memoria, clear deja la capacidad
+	std::vector<glm::vec3>().swap(m_positions);
+	std::vector<unsigned int>().swap(m_indices);
+	m_cpuDataLoaded = false;
+	return true;
+}
+
+RESOURCETYPE TResourceMesh::GetType(){
+	return MESH_RESOURCE;
+}
+
+unsigned long long TResourceMesh::GetCpuSize(){
+	return m_positions.capacity() * sizeof(glm::vec3) + m_indices.capacity() * sizeof(unsigned int);
+}
+
+unsigned long long TResourceMesh::GetGpuSize(){
+	return m_gpuSize;
+}
+
+unsigned int TResourceMesh::GetRevision(){
+	return m_revision;
+}
+
 TResourceTexture* TResourceMesh::GetBumpMap(){
 	return m_bumpMap;
 }
@@ -115,33 +277,56 @@ TResourceTexture* TResourceMesh::GetTexture(){
 }
 
 TResourceMaterial* TResourceMesh::GetMaterial(){
+	if(m_basicMaterial == nullptr && m_placeholder != nullptr) return m_placeholder->GetMaterial();
 	return m_basicMaterial;
 }
 
+GLuint TResourceMesh::GetVertexArray(){
+	if(m_placeholder != nullptr) return m_placeholder->GetVertexArray();
+	Use();
+	return m_vao;
+}
+
 GLuint TResourceMesh::GetElementBuffer(){
+	if(m_placeholder != nullptr) return m_placeholder->GetElementBuffer();
 	return m_ebo;
 }
 
 GLuint TResourceMesh::GetVertexBuffer(){
+	if(m_placeholder != nullptr) return m_placeholder->GetVertexBuffer();
 	return m_vbo;
 }
 
-GLuint TResourceMesh::GetUvBuffer(){
-	return m_uvbo;
-}
-
-GLuint TResourceMesh::GetNormalBuffer(){
-	return m_nbo;
-}
-
 void TResourceMesh::SetElementSize(int value){
 	m_elementSize = value;
 }
 
 int TResourceMesh::GetElementSize(){
+	if(m_placeholder != nullptr) return m_placeholder->GetElementSize();
+	Use();
 	return m_elementSize;
 }
 
+void TResourceMesh::LoadCpuData(){
+	// Solo se intenta una vez, si el fichero no tiene geometria los vectores se quedan vacios
+	m_cpuDataLoaded = true;
+	TObjectLoader::LoadGeometryBinary(this, &m_positions, &m_indices);
+}
+
+std::vector<glm::vec3>* TResourceMesh::GetPositions(){
+	if(m_placeholder != nullptr) return m_placeholder->GetPositions();
+	Use();
+	if(!m_cpuDataLoaded) LoadCpuData();
+	return &m_positions;
+}
+
+std::vector<unsigned int>* TResourceMesh::GetIndices(){
+	if(m_placeholder != nullptr) return m_placeholder->GetIndices();
+	Use();
+	if(!m_cpuDataLoaded) LoadCpuData();
+	return &m_indices;
+}
+
 void TResourceMesh::SetSize(glm::vec3 size){
 	m_size = size;
 }
@@ -150,10 +335,17 @@ void TResourceMesh::SetCenter(glm::vec3 center){
 	m_center = center;
 }
 
+void TResourceMesh::SetPlaceholder(TResourceMesh* placeholder){
+	m_placeholder = placeholder;
+}
+
 glm::vec3 TResourceMesh::GetSize(){
+	// Al recargarse conserva sus dimensiones, solo la primera carga usa las del provisional
+	if(m_placeholder != nullptr && !m_loaded) return m_placeholder->GetSize();
  	return m_size;
 }
 
 glm::vec3 TResourceMesh::GetCenter(){
+	if(m_placeholder != nullptr && !m_loaded) return m_placeholder->GetCenter();
 	return m_center;
 }
@@ -11,9 +11,11 @@
 #include "TResourceTexture.h"
 #include "TResourceMaterial.h"
 #include <vector>
+#include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
 
 typedef unsigned int GLuint;
+struct TMeshLoadData;
 
 class TResourceMesh: public TResource {
 
@@ -32,6 +34,15 @@ public:
      */
     TResourceMesh(std::string name);
 
+    /**
+     * @brief   - Constructor de un mesh que se carga en segundo plano, no lee nada hasta llamar a ReadFile
+     *              Mientras tanto se pinta con la geometria del mesh provisional
+     * 
+     * @param   - name - Ruta al mesh 
+     * @param   - placeholder - Mesh que se muestra mientras se carga
+     */
+    TResourceMesh(std::string name, TResourceMesh* placeholder);
+
     /**
      * @brief   - Destructor del TResourceMesh en el que se eliminan los buffers 
      */
@@ -44,6 +55,46 @@ public:
      */
     bool LoadFile();
 
+    /**
+     * @brief   - Abre el fichero del mesh sin usar OpenGL 
+     * 
+     * @return  - bool - Se ha leido el mesh
+     */
+    bool ReadFile();
+
+    /**
+     * @brief   - Sube el mesh leido a la grafica y carga sus texturas y material
+     *              Si se esta cargando en segundo plano las texturas tambien se piden en segundo plano
+     * 
+     * @return  - bool - Se ha subido el mesh
+     */
+    bool UploadFile();
+
+    /**
+     * @brief   - Bytes de vertices y elementos que se subiran a la grafica
+     */
+    unsigned long long GetUploadSize();
+
+    /**
+     * @brief   - Devuelve MESH_RESOURCE
+     */
+    RESOURCETYPE GetType();
+
+    /**
+     * @brief   - Bytes de las copias en CPU de las posiciones y los elementos
+     */
+    unsigned long long GetCpuSize();
+
+    /**
+     * @brief   - Bytes de los buffers de vertices y elementos en la grafica
+     */
+    unsigned long long GetGpuSize();
+
+    /**
+     * @brief   - Devuelve la revision del mesh, cambia cada vez que se sube una geometria nueva
+     */
+    unsigned int GetRevision();
+
     /**
      * @brief   - Cambia la textura del recurso 
      * 
@@ -79,6 +130,36 @@ public:
      */
     void SetElementSize(int value);
 
+    /**
+     * @brief   - Sube los vertices intercalados (posicion/normal/uv/tangente) y los elementos a la grafica
+     *              y deja configurado el VAO del mesh
+     * 
+     * @param   - vertex - Posiciones de los vertices
+     * @param   - uv - Uvs de los vertices
+     * @param   - normal - Normales de los vertices
+     * @param   - index - Elementos del mesh
+     * @param   - tangent - Tangentes de los vertices, opcional
+     */
+    void SetVertexData(std::vector<glm::vec3>* vertex, std::vector<glm::vec2>* uv, std::vector<glm::vec3>* normal, std::vector<unsigned int>* index, std::vector<glm::vec3>* tangent = nullptr);
+
+    /**
+     * @brief   - Guarda las copias en CPU de las posiciones y los elementos ya subidos
+     *              Para los meshes que no salen de un fichero binario y no se pueden leer al pedirlas
+     */
+    void SetCpuData(std::vector<glm::vec3>* positions, std::vector<unsigned int>* indices);
+
+    /**
+     * @brief   - Sube a la grafica vertices que ya estan intercalados (posicion/normal/uv/tangente)
+     *              sin copiarlos, p.e. directamente desde las paginas de un fichero mapeado
+     * 
+     * @param   - vertexData - Vertices intercalados, 8 floats por vertice u 11 con tangentes
+     * @param   - vertexCount - Numero de vertices
+     * @param   - hasTangents - Los vertices llevan tangente
+     * @param   - index - Elementos del mesh
+     * @param   - indexCount - Numero de elementos
+     */
+    void SetInterleavedData(const void* vertexData, int vertexCount, bool hasTangents, const unsigned int* index, int indexCount);
+
     /**
      * @brief   - Devuelve el recurso textura del objeto
      *  
@@ -114,7 +195,13 @@ public:
 // ===================================================================================================== 
     
     /**************************************************************************
-     * @brief Devuelve un puntero al buffer de vertices
+     * @brief Devuelve el VAO del mesh, con el buffer de vertices y el de elementos ya enlazados
+     *          Si se habia liberado el mesh lo vuelve a cargar
+     **************************************************************************/  
+    GLuint GetVertexArray();
+
+    /**************************************************************************
+     * @brief Devuelve un puntero al buffer de vertices intercalados
      **************************************************************************/  
     GLuint GetVertexBuffer();
 
@@ -124,19 +211,20 @@ public:
     GLuint GetElementBuffer();
 
     /**************************************************************************
-     * @brief Devuelve un puntero al buffer de uv
+     * @brief Devuelve el numero de Vertices que tiene el modelo
      **************************************************************************/  
-    GLuint GetUvBuffer();
+    int GetElementSize();
 
     /**************************************************************************
-     * @brief Devuelve un puntero al buffer de normales
+     * @brief Devuelve las posiciones de los vertices para rasterizar el mesh como oclusor
+     *          Se leen del fichero (TOEM o formato antiguo) la primera vez que se piden
      **************************************************************************/  
-    GLuint GetNormalBuffer();
+    std::vector<glm::vec3>* GetPositions();
 
     /**************************************************************************
-     * @brief Devuelve el numero de Vertices que tiene el modelo
+     * @brief Devuelve los elementos del mesh, tres por triangulo
      **************************************************************************/  
-    int GetElementSize();
+    std::vector<unsigned int>* GetIndices();
 
     /**************************************************************************
      * @brief Guarda el size del modelo
@@ -148,6 +236,11 @@ public:
      **************************************************************************/  
     void SetCenter(glm::vec3 center);
 
+    /**
+     * @brief   - Cambia el mesh que se pinta hasta que se vuelve a subir este, al recargarlo
+     */
+    void SetPlaceholder(TResourceMesh* placeholder);
+
     /**************************************************************************
      * @brief Devuelve el size del modelo
      **************************************************************************/  
@@ -160,15 +253,43 @@ public:
 
 private:
     int m_elementSize;                      // m_elementSize - Numero de elementos que tiene el recurso
-    TResourceTexture*   m_basicTexture;     // m_basicTexture - Textura que tiene almacenada el recurso
-    TResourceTexture*   m_specularMap;      // m_specularMap - Mapa de especulares que tiene almacenada el recurso
-    TResourceTexture*   m_bumpMap;          // m_bumpMap - Mapa de normales que tiene almacenada el recurso
-    TResourceMaterial*  m_basicMaterial;    // m_basicMaterial - Material que tiene almacenado el recurso
+    TResourceHandle<TResourceTexture>   m_basicTexture;     // m_basicTexture - Textura que tiene almacenada el recurso
+    TResourceHandle<TResourceTexture>   m_specularMap;      // m_specularMap - Mapa de especulares que tiene almacenada el recurso
+    TResourceHandle<TResourceTexture>   m_bumpMap;          // m_bumpMap - Mapa de normales que tiene almacenada el recurso
+    TResourceHandle<TResourceMaterial>  m_basicMaterial;    // m_basicMaterial - Material que tiene almacenado el recurso
+    TResourceHandle<TResourceMesh>      m_placeholder;      // m_placeholder - Mesh que se pinta hasta que se sube este, vacio si ya esta subido
+    TMeshLoadData*      m_pending;          // m_pending - Mesh leido de disco pendiente de subir
+    unsigned int        m_revision;         // m_revision - Se incrementa al subir la geometria
+    unsigned long long  m_gpuSize;          // m_gpuSize - Bytes de vertices y elementos subidos a la grafica
 
-    GLuint m_vbo;       // m_vbo - BUffer de vertices
-    GLuint m_uvbo;      // m_uvbo - Buffer de Uvs
+    GLuint m_vao;       // m_vao - Vertex array con el formato de vertices del mesh
+    GLuint m_vbo;       // m_vbo - Buffer de vertices intercalados (posicion/normal/uv/tangente)
     GLuint m_ebo;       // m_ebo - Buffer de elementos
-    GLuint m_nbo;       // m_nbo - Buffer de normales
+
+    std::vector<glm::vec3>      m_positions;    // m_positions - Copia en CPU de las posiciones para el buffer de oclusion
+    std::vector<unsigned int>   m_indices;      // m_indices - Copia en CPU de los elementos para el buffer de oclusion
+    bool                        m_cpuDataLoaded;    // m_cpuDataLoaded - Las copias en CPU estan al dia con la grafica
+
+    /**************************************************************************
+     * @brief Lee del fichero las posiciones y los elementos para las copias en CPU
+     **************************************************************************/  
+    void LoadCpuData();
+
+    /**************************************************************************
+     * @brief Crea el VAO y los buffers del mesh
+     **************************************************************************/  
+    void CreateBuffers();
+
+    /**************************************************************************
+     * @brief Pone las texturas por defecto a las que no se han cargado
+     **************************************************************************/  
+    void SetDefaultTextures();
+
+    /**************************************************************************
+     * @brief Elimina los buffers de la grafica y las copias en CPU
+     *          Las texturas y el material son recursos aparte y no se tocan
+     **************************************************************************/  
+    bool Unload();
 
     glm::vec3 m_size;       // m_size - Tamanyo del objeto
     glm::vec3 m_center;     // m_center - Centro del objeto
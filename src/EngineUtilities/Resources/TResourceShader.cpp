@@ -1,6 +1,6 @@
 #include "TResourceShader.h"
+#include "../Loaders/TFileSystem.h"
 #include <iostream>
-#include <fstream>
 #include <stdexcept>
 
 TResourceShader::TResourceShader(std::string name, GLenum shaderType){
@@ -18,6 +18,10 @@ GLuint TResourceShader::GetShaderGluint(){
 	return m_shader;
 }
 
+RESOURCETYPE TResourceShader::GetType(){
+	return SHADER_RESOURCE;
+}
+
 bool TResourceShader::LoadFile(){
 	bool toRet = false;
 	m_shader = LoadShader();
@@ -26,11 +30,9 @@ bool TResourceShader::LoadFile(){
 }
 
 GLuint TResourceShader::LoadShader(){
-    // Read shader from file
-    std::ifstream in(m_name);
+    // Read shader from file (del pack o del disco)
     std::string src = "";
-    std::string line = "";
-    while(std::getline(in,line)) src += line + "\n";
+    if(!TFileSystem::GetInstance()->ReadText(m_name, &src)) std::cerr << "Shader not found: " << m_name << std::endl;
 
     const char* source = src.c_str();
 
@@ -32,6 +32,11 @@ public:
 	 *********************************************/
     bool LoadFile();
 
+    /**
+     * @brief   - Devuelve SHADER_RESOURCE
+     */
+    RESOURCETYPE GetType();
+
     /**
      * @brief   - Devolvemos un puntero al shader ya compilado 
      *
@@ -1,62 +1,215 @@
 #include "TResourceTexture.h"
 #include "../Loaders/TTextureLoader.h"
+#include "../Loaders/TFileSystem.h"
 #include <SOIL2/SOIL2.h>
 #include <GL/glew.h>
 
 #include <iostream>
 
-TResourceTexture::TResourceTexture(std::string name){
-	m_name = name;
+bool TResourceTexture::m_keepImageData = false;
 
-	glBindBuffer(GL_TEXTURE_2D, 0);	
-	glGenBuffers(1, &m_textureID);
+static void SetTextureParameters(bool mipmaps){
+	// Algunos Parametros de Textura --> https://www.khronos.org/registry/OpenGL-Refpages/es2.0/xhtml/glTexParameter.xml
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
 
-	m_loaded = false;
+	// Algunos Filtros de Textura --> https://www.khronos.org/registry/OpenGL-Refpages/es2.0/xhtml/glTexParameter.xml
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, mipmaps ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+}
+
+TResourceTexture::TResourceTexture(std::string name){
+	m_name = name;
+	m_placeholder = nullptr;
+	m_imageData = nullptr;
+	m_width = 0;
+	m_height = 0;
+	m_channels = 4;
+	m_gpuSize = 0;
+	m_file = nullptr;
+	m_format = TTextureFile::TEXTURE_NONE;
+	m_textureID = 0;	// El nombre de la textura lo da glGenTextures al subirla
 
 	LoadFile();
 }
 
+TResourceTexture::TResourceTexture(std::string name, TResourceTexture* placeholder){
+	m_name = name;
+	m_placeholder = placeholder;
+	m_imageData = nullptr;
+	m_width = 0;
+	m_height = 0;
+	m_channels = 4;
+	m_gpuSize = 0;
+	m_file = nullptr;
+	m_format = TTextureFile::TEXTURE_NONE;
+	m_textureID = 0;
+}
 
 TResourceTexture::~TResourceTexture(){
-	if(m_loaded) SOIL_free_image_data(m_imageData);	// Liberar el array de datos
-	glBindBuffer(GL_TEXTURE_2D, 0);		// |
-	glDeleteBuffers(1, &m_textureID);	// | Eliminar el buffer de datos de OpenGL
+	if(m_imageData != nullptr) SOIL_free_image_data(m_imageData);	// Liberar el array de datos
+	if(m_file != nullptr) delete m_file;			// Deshacer el mapeo del DDS si no se llego a subir
+	if(m_textureID != 0) glDeleteTextures(1, &m_textureID);	// Eliminar la textura de OpenGL
 }
 
 bool TResourceTexture::LoadFile(){
-	bool toRet = TTextureLoader::LoadTexture(m_name, &m_imageData, &m_width, &m_height);
+	bool toRet = ReadFile() && UploadFile();
 	SetLoaded(toRet);
+	return toRet;
+}
+
+bool TResourceTexture::ReadFile(){
+	// Si se vuelve a leer liberamos la imagen anterior
+	// No toca m_loaded, se lee desde los hilos del cargador y solo UploadFile dice si se puede usar
+	if(m_imageData != nullptr) SOIL_free_image_data(m_imageData);
+	m_imageData = nullptr;
+
+	// La version cocinada tiene preferencia, no hay que decodificar ni generar mipmaps
+	if(ReadCompressed()) return true;
+
+	if(TTextureLoader::LoadTexture(m_name, &m_imageData, &m_width, &m_height, &m_channels)) return true;
+	m_imageData = nullptr;
+	return false;
+}
+
+bool TResourceTexture::ReadCompressed(){
+	if(!GLEW_EXT_texture_compression_s3tc) return false;
 
-	if(toRet){
-		m_loaded = true;
-		// Generamos la nueva texgura
-		glGenTextures(1, &m_textureID);
-		
-		// Bindeamos los parametros a nuestra textura de OpenGL
-		glBindTexture(GL_TEXTURE_2D, m_textureID);
-		
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, m_width, m_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, m_imageData);	// Cargamos nuestros datos en la textura de OpenGL
-
-		// Algunos Parametros de Textura --> https://www.khronos.org/registry/OpenGL-Refpages/es2.0/xhtml/glTexParameter.xml
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-
-		// Algunos Filtros de Textura --> https://www.khronos.org/registry/OpenGL-Refpages/es2.0/xhtml/glTexParameter.xml
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-		glGenerateMipmap(GL_TEXTURE_2D);
+	std::string path = TTextureFile::GetCookedPath(m_name);
+	if(m_file == nullptr) m_file = new TVirtualFile();
+
+	if(!m_file->Open(path) || !TTextureFile::Validate(m_file->GetData(), m_file->GetSize(), path, &m_format, &m_levels)){
+		delete m_file;
+		m_file = nullptr;
+		return false;
 	}
+
+	m_width = m_levels[0].width;
+	m_height = m_levels[0].height;
+	return true;
+}
+
+bool TResourceTexture::UploadFile(){
+	bool toRet = false;
+	if(m_file != nullptr) toRet = UploadCompressed();
+	else if(m_imageData != nullptr) toRet = UploadImage();
+	SetLoaded(toRet);
+
+	// Ya se puede usar, dejamos de mostrar la provisional
+	if(toRet) m_placeholder = nullptr;
 	return toRet;
 }
 
+bool TResourceTexture::UploadCompressed(){
+	// DXT1 sin alfa, las cocinadas con transparencia van en DXT5
+	GLenum internalFormat = m_format == TTextureFile::TEXTURE_DXT1 ? GL_COMPRESSED_RGB_S3TC_DXT1_EXT : GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+	const unsigned char* data = m_file->GetData();
+	int levels = m_levels.size();
+	m_gpuSize = GetUploadSize();
+
+	glGenTextures(1, &m_textureID);
+	glBindTexture(GL_TEXTURE_2D, m_textureID);
+
+	// Los bloques van a la grafica directamente desde las paginas mapeadas
+	for(int i=0; i<levels; i++){
+		const TTextureFileLevel* level = &m_levels[i];
+		glCompressedTexImage2D(GL_TEXTURE_2D, i, internalFormat, level->width, level->height, 0, level->size, data + level->offset);
+	}
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels - 1);
+	SetTextureParameters(levels > 1);
+
+	delete m_file;
+	m_file = nullptr;
+	return true;
+}
+
+bool TResourceTexture::UploadImage(){
+	GLenum format = m_channels == 3 ? GL_RGB : GL_RGBA;
+	m_gpuSize = GetUploadSize();
+
+	// Generamos la nueva texgura
+	glGenTextures(1, &m_textureID);
+	
+	// Bindeamos los parametros a nuestra textura de OpenGL
+	glBindTexture(GL_TEXTURE_2D, m_textureID);
+	
+	// Las filas en RGB no tienen por que estar alineadas a 4 bytes
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glTexImage2D(GL_TEXTURE_2D, 0, format, m_width, m_height, 0, format, GL_UNSIGNED_BYTE, m_imageData);	// Cargamos nuestros datos en la textura de OpenGL
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+	SetTextureParameters(true);
+	glGenerateMipmap(GL_TEXTURE_2D);
+
+	// Ya esta en la grafica, la copia decodificada solo se guarda si se pide
+	if(!m_keepImageData){
+		SOIL_free_image_data(m_imageData);
+		m_imageData = nullptr;
+	}
+	return true;
+}
+
+bool TResourceTexture::Unload(){
+	// Mientras se carga en segundo plano no se puede liberar
+	if(m_placeholder != nullptr || m_file != nullptr) return false;
+
+	if(m_imageData != nullptr) SOIL_free_image_data(m_imageData);
+	m_imageData = nullptr;
+
+	glDeleteTextures(1, &m_textureID);
+	m_textureID = 0;
+	m_gpuSize = 0;
+	return true;
+}
+
+RESOURCETYPE TResourceTexture::GetType(){
+	return TEXTURE_RESOURCE;
+}
+
+unsigned long long TResourceTexture::GetCpuSize(){
+	// Solo cuenta la copia decodificada, las subidas sin guardarla y las cocinadas no tienen
+	if(m_imageData == nullptr) return 0;
+	return (unsigned long long)m_width * m_height * m_channels;
+}
+
+unsigned long long TResourceTexture::GetGpuSize(){
+	return m_gpuSize;
+}
+
+void TResourceTexture::SetKeepImageData(bool keep){
+	m_keepImageData = keep;
+}
+
+unsigned long long TResourceTexture::GetUploadSize(){
+	unsigned long long size = 0;
+	if(m_file != nullptr){
+		int levels = m_levels.size();
+		for(int i=0; i<levels; i++) size += m_levels[i].size;
+		return size;
+	}
+
+	// Imagen mas un tercio de los mipmaps
+	size = (unsigned long long)m_width * m_height * m_channels;
+	return size + size / 3;
+}
+
+void TResourceTexture::SetPlaceholder(TResourceTexture* placeholder){
+	m_placeholder = placeholder;
+}
+
 GLuint TResourceTexture::GetTextureId(){
+	if(m_placeholder != nullptr) return m_placeholder->GetTextureId();
+	Use();
 	return m_textureID;
 }
 
 int  TResourceTexture::GetWidth(){
+	// Al recargarse conserva sus dimensiones, solo la primera carga usa las de la provisional
+	if(m_placeholder != nullptr && !m_loaded) return m_placeholder->GetWidth();
 	return m_width;
 }
 int  TResourceTexture::GetHeight(){
+	if(m_placeholder != nullptr && !m_loaded) return m_placeholder->GetHeight();
 	return m_height;
 }
 
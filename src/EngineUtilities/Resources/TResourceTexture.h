@@ -8,10 +8,13 @@
  */
 
 #include "TResource.h"
+#include "./../Loaders/TTextureFile.h"
+#include "./../TResourceHandle.h"
 #include <vector>
 
 // Forward declaration
 typedef unsigned int GLuint;
+class TVirtualFile;
 
 class TResourceTexture: public TResource {
 
@@ -23,6 +26,15 @@ public:
      */
     TResourceTexture(std::string name);
 
+    /**
+     * @brief   - Constructor de una textura que se carga en segundo plano, no lee nada hasta llamar a ReadFile
+     *              Mientras tanto devuelve el id y las dimensiones de la textura provisional
+     * 
+     * @param   - name - Ruta a la textura 
+     * @param   - placeholder - Textura que se muestra mientras se carga
+     */
+    TResourceTexture(std::string name, TResourceTexture* placeholder);
+
     /**
      * @brief   - Destructor de la textura, vaciamos y elminamos los buffers 
      */
@@ -36,7 +48,53 @@ public:
     bool LoadFile();
 
     /**
-     * @brief   - Devuelve un puntero a la textura 
+     * @brief   - Lee y decodifica la imagen sin usar OpenGL 
+     *              Si existe la version cocinada (.dds) y la grafica soporta DXT se mapea esa en su lugar
+     * 
+     * @return  - bool - Se ha leido la imagen
+     */
+    bool ReadFile();
+
+    /**
+     * @brief   - Crea la textura de OpenGL con la imagen leida y genera los mipmaps
+     *              Las cocinadas se suben comprimidas con sus mipmaps ya calculados
+     * 
+     * @return  - bool - Se ha subido la textura
+     */
+    bool UploadFile();
+
+    /**
+     * @brief   - Bytes de la imagen y sus mipmaps, comprimidos si es una textura cocinada
+     */
+    unsigned long long GetUploadSize();
+
+    /**
+     * @brief   - Devuelve TEXTURE_RESOURCE
+     */
+    RESOURCETYPE GetType();
+
+    /**
+     * @brief   - Bytes de la imagen decodificada si se sigue guardando despues de subirla
+     */
+    unsigned long long GetCpuSize();
+
+    /**
+     * @brief   - Bytes de la textura y sus mipmaps en la grafica
+     */
+    unsigned long long GetGpuSize();
+
+    /**
+     * @brief   - Cambia si las texturas guardan la imagen decodificada despues de subirla, por defecto no
+     */
+    static void SetKeepImageData(bool keep);
+
+    /**
+     * @brief   - Cambia la textura que se muestra hasta que se vuelve a subir esta, al recargarla
+     */
+    void SetPlaceholder(TResourceTexture* placeholder);
+
+    /**
+     * @brief   - Devuelve un puntero a la textura, si se habia liberado pide que se vuelva a cargar
      *
      * @return  - GLuint - Puntero de la textura 
      */
@@ -64,11 +122,41 @@ public:
     std::string GetTexturePath();
     
 private:
-    unsigned char* m_imageData; // m_imageData - Datos de la imagen
+    unsigned char* m_imageData; // m_imageData - Datos de la imagen decodificada, nullptr si no se guardan
     int m_width;                // m_width - Ancho de la imagen    
     int m_height;               // m_height - Alto de la imagen
-    bool m_loaded;              // m_loaded - Ha cargado correctamente el recurso
     GLuint m_textureID;         // m_textureID - Puntero a la imagen
+    TResourceHandle<TResourceTexture> m_placeholder;    // m_placeholder - Textura que se muestra hasta que se sube esta, vacio si ya esta subida
+    int m_channels;             // m_channels - Canales de la imagen sin comprimir (3 o 4)
+    unsigned long long m_gpuSize;   // m_gpuSize - Bytes subidos a la grafica
+
+    static bool m_keepImageData;    // m_keepImageData - Se guarda la imagen decodificada despues de subirla
+
+    TVirtualFile* m_file;                   // m_file - DDS cocinado (del pack o mapeado) hasta que se sube, nullptr si se carga la imagen
+    int m_format;                           // m_format - TEXTURE_DXT1 o TEXTURE_DXT5 del DDS cocinado
+    std::vector<TTextureFileLevel> m_levels;    // m_levels - Mipmaps del DDS cocinado
+
+    /**
+     * @brief   - Mapea y valida la version cocinada de la textura
+     * 
+     * @return  - bool - Existe y se puede usar
+     */
+    bool ReadCompressed();
+
+    /**
+     * @brief   - Sube todos los mipmaps del DDS mapeado y lo cierra
+     */
+    bool UploadCompressed();
+
+    /**
+     * @brief   - Sube la imagen sin comprimir y genera los mipmaps
+     */
+    bool UploadImage();
+
+    /**
+     * @brief   - Elimina la textura de la grafica y la imagen decodificada
+     */
+    bool Unload();
 
 };
 
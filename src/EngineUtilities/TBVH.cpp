@@ -0,0 +1,225 @@
+#include "./TBVH.h"
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+#include <glm/vector_relational.hpp>
+
+TBVH::TBVH(){
+	m_root = -1;
+	m_freeList = -1;
+	m_leafCount = 0;
+}
+
+TBVH::~TBVH(){
+	m_nodes.clear();
+	m_stack.clear();
+}
+
+void TBVH::Clear(){
+	m_nodes.clear();
+	m_root = -1;
+	m_freeList = -1;
+	m_leafCount = 0;
+}
+
+int TBVH::AllocateNode(){
+	int node;
+	if(m_freeList != -1){
+		node = m_freeList;
+		m_freeList = m_nodes[node].parent;		// Los nodos libres guardan el siguiente libre en parent
+	}
+	else{
+		node = m_nodes.size();
+		m_nodes.push_back(TBVHNode());
+	}
+
+	m_nodes[node].parent = -1;
+	m_nodes[node].left = -1;
+	m_nodes[node].right = -1;
+	m_nodes[node].item = -1;
+	return node;
+}
+
+void TBVH::FreeNode(int node){
+	m_nodes[node].parent = m_freeList;
+	m_nodes[node].item = -1;
+	m_freeList = node;
+}
+
+float TBVH::HalfArea(glm::vec3 min, glm::vec3 max){
+	glm::vec3 size = max - min;
+	return size.x * size.y + size.y * size.z + size.z * size.x;
+}
+
+int TBVH::Insert(glm::vec3 min, glm::vec3 max, int item){
+	int leaf = AllocateNode();
+
+	// Ampliamos la caja para que los objetos que se mueven poco no reinserten la hoja cada frame
+	glm::vec3 margin = (max - min) * m_margin + glm::vec3(m_minMargin);
+	m_nodes[leaf].min = min - margin;
+	m_nodes[leaf].max = max + margin;
+	m_nodes[leaf].item = item;
+
+	InsertLeaf(leaf);
+	m_leafCount++;
+	return leaf;
+}
+
+void TBVH::Remove(int proxy){
+	RemoveLeaf(proxy);
+	FreeNode(proxy);
+	m_leafCount--;
+}
+
+bool TBVH::Move(int proxy, glm::vec3 min, glm::vec3 max){
+	TBVHNode& node = m_nodes[proxy];
+
+	// Si sigue dentro de la caja ampliada no hace falta tocar el arbol
+	if(glm::all(glm::greaterThanEqual(min, node.min)) && glm::all(glm::lessThanEqual(max, node.max))) return false;
+
+	RemoveLeaf(proxy);
+
+	glm::vec3 margin = (max - min) * m_margin + glm::vec3(m_minMargin);
+	m_nodes[proxy].min = min - margin;
+	m_nodes[proxy].max = max + margin;
+
+	InsertLeaf(proxy);
+	return true;
+}
+
+void TBVH::InsertLeaf(int leaf){
+	if(m_root == -1){
+		m_root = leaf;
+		m_nodes[leaf].parent = -1;
+		return;
+	}
+
+	glm::vec3 leafMin = m_nodes[leaf].min;
+	glm::vec3 leafMax = m_nodes[leaf].max;
+
+	// Bajamos por el hijo que menos aumenta el area hasta que sea mas barato colgarla del nodo actual
+	int index = m_root;
+	while(m_nodes[index].left != -1){
+		TBVHNode& node = m_nodes[index];
+
+		float area = HalfArea(node.min, node.max);
+		float combined = HalfArea(glm::min(node.min, leafMin), glm::max(node.max, leafMax));
+
+		float cost = 2.0f * combined;						// Coste de crear un padre nuevo para el nodo y la hoja
+		float inheritance = 2.0f * (combined - area);		// Aumento de area que pagan todos los ancestros
+
+		float childCost[2];
+		int children[2] = {node.left, node.right};
+		for(int i=0; i<2; i++){
+			TBVHNode& child = m_nodes[children[i]];
+			float childArea = HalfArea(glm::min(child.min, leafMin), glm::max(child.max, leafMax));
+			if(child.left != -1) childArea -= HalfArea(child.min, child.max);
+			childCost[i] = childArea + inheritance;
+		}
+
+		if(cost < childCost[0] && cost < childCost[1]) break;
+		index = childCost[0] < childCost[1] ? children[0] : children[1];
+	}
+
+	// Creamos un padre nuevo con el hermano encontrado y la hoja
+	int sibling = index;
+	int oldParent = m_nodes[sibling].parent;
+	int newParent = AllocateNode();			// Puede mover el vector, no guardamos referencias antes
+
+	m_nodes[newParent].parent = oldParent;
+	m_nodes[newParent].left = sibling;
+	m_nodes[newParent].right = leaf;
+	m_nodes[sibling].parent = newParent;
+	m_nodes[leaf].parent = newParent;
+
+	if(oldParent == -1) m_root = newParent;
+	else if(m_nodes[oldParent].left == sibling) m_nodes[oldParent].left = newParent;
+	else m_nodes[oldParent].right = newParent;
+
+	Refit(newParent);
+}
+
+void TBVH::RemoveLeaf(int leaf){
+	if(leaf == m_root){
+		m_root = -1;
+		return;
+	}
+
+	int parent = m_nodes[leaf].parent;
+	int grandParent = m_nodes[parent].parent;
+	int sibling = m_nodes[parent].left == leaf ? m_nodes[parent].right : m_nodes[parent].left;
+
+	// El hermano ocupa el sitio del padre, que ya no hace falta
+	m_nodes[sibling].parent = grandParent;
+	if(grandParent == -1) m_root = sibling;
+	else{
+		if(m_nodes[grandParent].left == parent) m_nodes[grandParent].left = sibling;
+		else m_nodes[grandParent].right = sibling;
+		Refit(grandParent);
+	}
+
+	FreeNode(parent);
+	m_nodes[leaf].parent = -1;
+}
+
+void TBVH::Refit(int node){
+	while(node != -1){
+		TBVHNode& current = m_nodes[node];
+		TBVHNode& left = m_nodes[current.left];
+		TBVHNode& right = m_nodes[current.right];
+
+		current.min = glm::min(left.min, right.min);
+		current.max = glm::max(left.max, right.max);
+		node = current.parent;
+	}
+}
+
+void TBVH::Query(TFrustum* frustum, std::vector<int>* output){
+	if(m_root == -1) return;
+
+	const glm::vec4* planes = frustum->GetPlanes();
+
+	// Los nodos que ya sabemos que estan dentro se guardan en negativo (-2 - nodo) para no volver a comprobarlos
+	m_stack.clear();
+	m_stack.push_back(m_root);
+
+	while(!m_stack.empty()){
+		int value = m_stack.back();
+		m_stack.pop_back();
+
+		bool inside = value < 0;
+		int index = inside ? -2 - value : value;
+		TBVHNode& node = m_nodes[index];
+
+		if(!inside){
+			bool outside = false;
+			inside = true;
+			for(int i=0; i<6 && !outside; i++){
+				glm::vec3 normal(planes[i]);
+
+				// Esquina mas adelantada y mas atrasada de la caja respecto a la normal del plano
+				glm::vec3 positive(normal.x >= 0 ? node.max.x : node.min.x, normal.y >= 0 ? node.max.y : node.min.y, normal.z >= 0 ? node.max.z : node.min.z);
+				glm::vec3 negative(normal.x >= 0 ? node.min.x : node.max.x, normal.y >= 0 ? node.min.y : node.max.y, normal.z >= 0 ? node.min.z : node.max.z);
+
+				if(glm::dot(normal, positive) + planes[i].w < 0) outside = true;
+				else if(glm::dot(normal, negative) + planes[i].w < 0) inside = false;
+			}
+			if(outside) continue;
+		}
+
+		if(node.left == -1){
+			output->push_back(node.item);
+		}
+		else if(inside){
+			m_stack.push_back(-2 - node.left);
+			m_stack.push_back(-2 - node.right);
+		}
+		else{
+			m_stack.push_back(node.left);
+			m_stack.push_back(node.right);
+		}
+	}
+}
+
+int TBVH::GetLeafCount(){
+	return m_leafCount;
+}
@@ -0,0 +1,123 @@
+#ifndef TBVH_H
+#define TBVH_H
+
+/**
+ * @brief Dynamic bounding volume hierarchy over world space AABBs used to cull against the frustum.
+ *
+ * @file TBVH.h
+ */
+
+#include "./TFrustum.h"
+#include <glm/vec3.hpp>
+#include <vector>
+
+struct TBVHNode{
+	glm::vec3	min;		// min - Esquina minima de la caja (ampliada en las hojas)
+	glm::vec3	max;		// max - Esquina maxima de la caja (ampliada en las hojas)
+	int			parent;		// parent - Nodo padre (-1 para la raiz), siguiente libre si el nodo no se usa
+	int			left;		// left - Hijo izquierdo (-1 en las hojas)
+	int			right;		// right - Hijo derecho (-1 en las hojas)
+	int			item;		// item - Valor que devuelve la consulta al llegar a la hoja
+};
+
+class TBVH{
+public:
+	/**
+	 * @brief	- Constructor del arbol vacio
+	 */
+	TBVH();
+
+	/**
+	 * @brief	- Destructor del arbol
+	 */
+	~TBVH();
+
+	/**
+	 * @brief	- Elimina todas las hojas del arbol
+	 */
+	void Clear();
+
+	/**
+	 * @brief	- Anyade una caja al arbol
+	 *
+	 * @param 	- min - Esquina minima de la caja en coordenadas mundo
+	 * @param 	- max - Esquina maxima de la caja en coordenadas mundo
+	 * @param 	- item - Valor que se devuelve al consultar la caja
+	 * @return 	- int - Id de la hoja para moverla o quitarla
+	 */
+	int Insert(glm::vec3 min, glm::vec3 max, int item);
+
+	/**
+	 * @brief	- Quita una hoja del arbol
+	 *
+	 * @param 	- proxy - Id devuelto por Insert
+	 */
+	void Remove(int proxy);
+
+	/**
+	 * @brief	- Actualiza la caja de una hoja. Las hojas guardan una caja ampliada,
+	 * 				solo se reinsertan cuando la caja nueva se sale de ella
+	 *
+	 * @param 	- proxy - Id devuelto por Insert
+	 * @param 	- min - Nueva esquina minima
+	 * @param 	- max - Nueva esquina maxima
+	 * @return 	- bool - Se ha tenido que reinsertar la hoja
+	 */
+	bool Move(int proxy, glm::vec3 min, glm::vec3 max);
+
+	/**
+	 * @brief	- Devuelve los items de todas las hojas que tocan el frustum
+	 * 				Los subarboles enteros dentro del frustum se anyaden sin comprobar sus hojas
+	 *
+	 * @param 	- frustum - Frustum de la camara con los planos ya calculados
+	 * @param 	- output - Vector en el que se anyaden los items visibles
+	 */
+	void Query(TFrustum* frustum, std::vector<int>* output);
+
+	/**
+	 * @brief	- Devuelve el numero de hojas del arbol
+	 */
+	int GetLeafCount();
+
+private:
+	/**
+	 * @brief	- Coge un nodo de la lista de libres o amplia el vector
+	 */
+	int AllocateNode();
+
+	/**
+	 * @brief	- Devuelve un nodo a la lista de libres
+	 */
+	void FreeNode(int node);
+
+	/**
+	 * @brief	- Cuelga la hoja del hermano que menos aumenta el area de las cajas
+	 */
+	void InsertLeaf(int leaf);
+
+	/**
+	 * @brief	- Descuelga la hoja del arbol sin liberarla
+	 */
+	void RemoveLeaf(int leaf);
+
+	/**
+	 * @brief	- Recalcula las cajas desde el nodo hasta la raiz
+	 */
+	void Refit(int node);
+
+	/**
+	 * @brief	- Devuelve la mitad del area de la caja, coste de la heuristica SAH
+	 */
+	static float HalfArea(glm::vec3 min, glm::vec3 max);
+
+	std::vector<TBVHNode>	m_nodes;		// m_nodes - Nodos internos y hojas del arbol
+	std::vector<int>		m_stack;		// m_stack - Pila reutilizada en las consultas
+	int						m_root;			// m_root - Nodo raiz (-1 si esta vacio)
+	int						m_freeList;		// m_freeList - Primer nodo libre (-1 si no hay)
+	int						m_leafCount;	// m_leafCount - Numero de hojas
+
+	static constexpr float	m_margin = 0.1f;	// m_margin - Margen relativo con el que se amplian las hojas
+	static constexpr float	m_minMargin = 0.05f;	// m_minMargin - Margen minimo para las cajas sin volumen
+};
+
+#endif
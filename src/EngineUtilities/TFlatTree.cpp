@@ -0,0 +1,334 @@
+#include "./TFlatTree.h"
+#include "./TNode.h"
+#include "./TRenderQueue.h"
+#include "./TOcclusionBuffer.h"
+#include "./Entities/TTransform.h"
+#include <algorithm>
+#include <limits>
+
+TFlatTree::TFlatTree(TNode* root){
+	m_root = root;
+	m_structureVersion = 0;
+	m_built = false;
+	m_boundsPending = true;
+	m_subtreePending = false;
+}
+
+TFlatTree::~TFlatTree(){}
+
+void TFlatTree::Build(){
+	m_nodes.clear();
+	m_parents.clear();
+	m_transforms.clear();
+	m_localMatrices.clear();
+	m_worldMatrices.clear();
+	m_revisions.clear();
+	m_drawList.clear();
+	m_entries.clear();
+	m_bvh.Clear();
+
+	// Pila de nodos pendientes junto al indice de su padre (sin recursividad)
+	std::vector<std::pair<TNode*, int>> pending;
+	pending.push_back(std::pair<TNode*, int>(m_root, -1));
+
+	while(!pending.empty()){
+		TNode* node = pending.back().first;
+		int parent = pending.back().second;
+		pending.pop_back();
+
+		int index = m_nodes.size();
+		m_nodes.push_back(node);
+		m_parents.push_back(parent);
+		m_localMatrices.push_back(glm::mat4(1.0f));
+
+		// Los nodos limpios conservan su matriz mundo, solo se recalculan los sucios en la siguiente pasada
+		if(node->IsDirty()) m_worldMatrices.push_back(glm::mat4(1.0f));
+		else m_worldMatrices.push_back(node->GetWorldMatrix());
+		m_revisions.push_back(node->GetWorldRevision());
+		m_entries.push_back(-1);
+
+		TEntity* entity = node->GetEntity();
+		if(entity != nullptr && entity->IsTransform()){
+			m_transforms.push_back((TTransform*)entity);
+		}
+		else{
+			m_transforms.push_back(nullptr);
+			if(entity != nullptr){
+				m_entries[index] = m_drawList.size();
+				m_drawList.push_back(index);	// Las entidades que no son transformaciones se pintan
+			}
+		}
+
+		// Metemos los hijos al reves para mantener el orden original de pintado
+		std::vector<TNode*> children = node->GetChildren();
+		for(int i = children.size() - 1; i >= 0; i--){
+			if(children[i] != nullptr) pending.push_back(std::pair<TNode*, int>(children[i], index));
+		}
+	}
+
+	// Las cajas se calculan en el siguiente UpdateBounds, cuando ya estan las matrices mundo
+	int drawSize = m_drawList.size();
+	m_boundsMin.assign(drawSize, glm::vec3(0.0f));
+	m_boundsMax.assign(drawSize, glm::vec3(0.0f));
+	m_proxies.assign(drawSize, -1);
+	m_boundsWorldRevisions.assign(drawSize, 0);
+	m_boundsRevisions.assign(drawSize, 0);
+	m_boundsPending = true;
+
+	// Los descendientes de un nodo van justo detras de el, guardamos donde acaba cada subarbol
+	int nodeSize = m_nodes.size();
+	m_subtreeEnd.assign(nodeSize, 0);
+	for(int i = nodeSize - 1; i >= 0; i--){
+		m_subtreeEnd[i] = std::max(m_subtreeEnd[i], i + 1);
+		if(m_parents[i] >= 0) m_subtreeEnd[m_parents[i]] = std::max(m_subtreeEnd[m_parents[i]], m_subtreeEnd[i]);
+	}
+
+	// Todas las cajas de los subarboles se calculan de nuevo
+	m_subtreeMin.assign(nodeSize, glm::vec3(std::numeric_limits<float>::max()));
+	m_subtreeMax.assign(nodeSize, glm::vec3(-std::numeric_limits<float>::max()));
+	m_subtreeInfinite.assign(nodeSize, 0);
+	m_subtreeDirty.assign(nodeSize, 1);
+	m_subtreePending = true;
+
+	m_structureVersion = m_root->GetStructureVersion();
+	m_built = true;
+}
+
+void TFlatTree::UpdateWorldMatrices(){
+	int size = m_nodes.size();
+	for(int i=0; i<size; i++){
+		TNode* node = m_nodes[i];
+
+		if(node->IsDirty()){
+			// La matriz mundo del padre ya esta calculada porque siempre va antes en el vector
+			if(m_transforms[i] != nullptr) m_localMatrices[i] = m_transforms[i]->GetTransform();
+
+			int parent = m_parents[i];
+			if(parent >= 0) m_worldMatrices[i] = m_localMatrices[i] * m_worldMatrices[parent];
+			else if(node->GetParent() != nullptr) m_worldMatrices[i] = m_localMatrices[i] * node->GetParent()->GetWorldMatrix();
+			else m_worldMatrices[i] = m_localMatrices[i];
+
+			node->SetWorldMatrix(m_worldMatrices[i]);
+			m_revisions[i] = node->GetWorldRevision();
+		}
+		else if(node->GetWorldRevision() != m_revisions[i]){
+			// El nodo ya se recalculo al consultarlo desde fuera, solo copiamos su matriz
+			m_worldMatrices[i] = node->GetWorldMatrix();
+			m_revisions[i] = node->GetWorldRevision();
+		}
+	}
+}
+
+void TFlatTree::UpdateBounds(){
+	bool rebuilt = m_boundsPending;
+	m_boundsPending = false;
+	m_unbounded.clear();
+
+	int size = m_drawList.size();
+	for(int i=0; i<size; i++){
+		int index = m_drawList[i];
+		TEntity* entity = m_nodes[index]->GetEntity();
+
+		// Solo recalculamos la caja si se ha movido el nodo o ha cambiado el tamanyo de la entidad
+		unsigned int boundsRevision = entity->GetBoundsRevision();
+		if(rebuilt || m_boundsWorldRevisions[i] != m_revisions[index] || m_boundsRevisions[i] != boundsRevision){
+			m_boundsWorldRevisions[i] = m_revisions[index];
+			m_boundsRevisions[i] = boundsRevision;
+
+			glm::vec3 min, max;
+			if(entity->GetWorldBounds(m_worldMatrices[index], &min, &max)){
+				m_boundsMin[i] = min;
+				m_boundsMax[i] = max;
+				if(m_proxies[i] < 0) m_proxies[i] = m_bvh.Insert(min, max, i);
+				else m_bvh.Move(m_proxies[i], min, max);
+			}
+			else if(m_proxies[i] >= 0){
+				m_bvh.Remove(m_proxies[i]);
+				m_proxies[i] = -1;
+			}
+
+			MarkSubtreeDirty(index);
+		}
+
+		if(m_proxies[i] < 0) m_unbounded.push_back(i);
+	}
+
+	if(m_subtreePending) UpdateSubtreeBounds();
+}
+
+void TFlatTree::MarkSubtreeDirty(int node){
+	// Si un nodo ya esta marcado sus antecesores tambien lo estan
+	while(node >= 0 && !m_subtreeDirty[node]){
+		m_subtreeDirty[node] = 1;
+		m_subtreeMin[node] = glm::vec3(std::numeric_limits<float>::max());
+		m_subtreeMax[node] = glm::vec3(-std::numeric_limits<float>::max());
+		m_subtreeInfinite[node] = 0;
+		node = m_parents[node];
+	}
+	m_subtreePending = true;
+}
+
+void TFlatTree::UpdateSubtreeBounds(){
+	// Los hijos van siempre detras del padre, recorriendo al reves cada caja esta completa antes de sumarla al padre
+	for(int i = m_nodes.size() - 1; i >= 0; i--){
+		if(m_subtreeDirty[i]){
+			int entry = m_entries[i];
+			if(entry >= 0){
+				if(m_proxies[entry] >= 0){
+					m_subtreeMin[i] = glm::min(m_subtreeMin[i], m_boundsMin[entry]);
+					m_subtreeMax[i] = glm::max(m_subtreeMax[i], m_boundsMax[entry]);
+				}
+				else m_subtreeInfinite[i] = 1;	// Una entidad sin caja impide descartar la rama
+			}
+			m_subtreeDirty[i] = 0;
+		}
+
+		int parent = m_parents[i];
+		if(parent >= 0 && m_subtreeDirty[parent]){
+			if(m_subtreeInfinite[i]) m_subtreeInfinite[parent] = 1;
+			m_subtreeMin[parent] = glm::min(m_subtreeMin[parent], m_subtreeMin[i]);
+			m_subtreeMax[parent] = glm::max(m_subtreeMax[parent], m_subtreeMax[i]);
+		}
+	}
+	m_subtreePending = false;
+}
+
+bool TFlatTree::IsSubtreeCulled(int node, TFrustum* frustum){
+	if(m_subtreeInfinite[node]) return false;
+
+	// Un subarbol sin cajas no tiene nada que pintar
+	glm::vec3 min = m_subtreeMin[node];
+	glm::vec3 max = m_subtreeMax[node];
+	if(min.x > max.x || min.y > max.y || min.z > max.z) return true;
+
+	return !frustum->TestBox(min, max);
+}
+
+void TFlatTree::Update(){
+	// Solo reconstruimos en el caso de que se haya anyadido o quitado algun nodo de este subarbol
+	if(!m_built || m_structureVersion != m_root->GetStructureVersion()) Build();
+	UpdateWorldMatrices();
+	UpdateBounds();
+}
+
+void TFlatTree::DrawEntry(int entry){
+	int index = m_drawList[entry];
+	TEntity* entity = m_nodes[index]->GetEntity();
+
+	TEntity::ModelMatrix = m_worldMatrices[index];
+	entity->BeginDraw();
+	entity->EndDraw();
+}
+
+void TFlatTree::CullOccluded(TOcclusionBuffer* buffer){
+	// Primero se rasterizan los oclusores visibles, luego se comprueba el resto contra la jerarquia
+	// Los oclusores que ya ha rasterizado otro portal este frame no se repiten ni se reconstruye la jerarquia
+	int size = m_visible.size();
+	for(int i=0; i<size; i++){
+		int index = m_drawList[m_visible[i]];
+		TEntity* entity = m_nodes[index]->GetEntity();
+		if(entity->IsOccluder()) entity->DrawOccluder(buffer, m_worldMatrices[index]);
+	}
+	buffer->BuildHierarchy();
+
+	int visible = 0;
+	for(int i=0; i<size; i++){
+		int entry = m_visible[i];
+		if(m_nodes[m_drawList[entry]]->GetEntity()->IsOccluder() || buffer->TestBox(m_boundsMin[entry], m_boundsMax[entry])){
+			m_visible[visible++] = entry;
+		}
+	}
+	m_visible.resize(visible);
+}
+
+void TFlatTree::Draw(){
+	Update();
+
+	// Las entidades se guardan en la cola de pintado y se pintan ordenadas por estado al final
+	TRenderQueue* queue = TRenderQueue::GetInstance();
+	queue->Begin();
+
+	if(TEntity::m_checkClipping){
+		// Los planos se sacan una vez, con los limites de pantalla de los portales que se esten pintando
+		m_frustum.Update(TEntity::ProjMatrix * TEntity::ViewMatrix, TEntity::m_clippingLimits);
+
+		// Si todo el subarbol queda fuera (p.e. una habitacion fuera del portal) no hay nada que consultar
+		if(IsSubtreeCulled(0, &m_frustum)){
+			queue->End();
+			return;
+		}
+
+		// El BVH devuelve las entidades cuya caja ampliada toca el frustum
+		m_candidates.clear();
+		m_bvh.Query(&m_frustum, &m_candidates);
+
+		// Comprobamos las cajas exactas de todos los candidatos de golpe
+		m_candidateBounds.Clear();
+		int size = m_candidates.size();
+		for(int i=0; i<size; i++) m_candidateBounds.Add(m_boundsMin[m_candidates[i]], m_boundsMax[m_candidates[i]]);
+		m_frustum.CullBoxes(&m_candidateBounds, &m_candidateMask);
+
+		m_visible.clear();
+		for(int i=0; i<size; i++){
+			if(TFrustum::IsVisible(m_candidateMask, i)) m_visible.push_back(m_candidates[i]);
+		}
+
+		// Quitamos las que quedan detras de los oclusores
+		if(TEntity::m_checkOcclusion && TEntity::m_occlusionBuffer != nullptr) CullOccluded(TEntity::m_occlusionBuffer);
+
+		// Las entidades sin caja se pintan siempre
+		m_visible.insert(m_visible.end(), m_unbounded.begin(), m_unbounded.end());
+
+		// Mantenemos el orden del arbol para que la cola desempate igual que antes
+		std::sort(m_visible.begin(), m_visible.end());
+
+		// Los meshes no vuelven a comprobar el clipping, ya lo ha hecho el frustum
+		TEntity::m_clippingChecked = true;
+		size = m_visible.size();
+		for(int i=0; i<size; i++) DrawEntry(m_visible[i]);
+		TEntity::m_clippingChecked = false;
+	}
+	else{
+		int size = m_drawList.size();
+		for(int i=0; i<size; i++) DrawEntry(i);
+	}
+
+	queue->End();
+}
+
+void TFlatTree::DrawShadows(){
+	Update();
+
+	// Los meshes enlazan su VAO a traves de la cola, empezamos y acabamos con el estado limpio
+	TRenderQueue* queue = TRenderQueue::GetInstance();
+	queue->ResetState();
+
+	// Con el clipping activado saltamos las ramas que quedan fuera de lo que ve la luz
+	bool culling = TEntity::m_checkClipping;
+	if(culling) m_shadowFrustum.Update(TEntity::DepthWVP);
+
+	int size = m_nodes.size();
+	int i = 0;
+	while(i < size){
+		if(culling && IsSubtreeCulled(i, &m_shadowFrustum)){
+			i = m_subtreeEnd[i];	// Nos saltamos el nodo y todos sus descendientes
+			continue;
+		}
+
+		if(m_entries[i] >= 0){
+			TEntity* entity = m_nodes[i]->GetEntity();
+
+			TEntity::ModelMatrix = m_worldMatrices[i];
+			entity->DrawShadow();		// For mesh sets drawingShadows to true
+			entity->BeginDraw();		// for mesh: if drawingShadows, doesnt draw
+			entity->EndDraw();			// For mesh sets drawingShadows to false
+		}
+		i++;
+	}
+
+	queue->ResetState();
+}
+
+int TFlatTree::GetNodeCount(){
+	return m_nodes.size();
+}
@@ -0,0 +1,145 @@
+#ifndef TFLATTREE_H
+#define TFLATTREE_H
+
+/**
+ * @brief Flattened depth-first representation of a scene subtree.
+ *
+ * @file TFlatTree.h
+ */
+
+#include "./TBVH.h"
+#include <glm/mat4x4.hpp>
+#include <vector>
+
+class TNode;
+class TTransform;
+class TOcclusionBuffer;
+
+class TFlatTree{
+public:
+	/**
+	 * @brief	- Constructor del arbol aplanado a partir del nodo raiz del subarbol
+	 *
+	 * @param 	- root - Nodo desde el que se aplana el arbol
+	 */
+	TFlatTree(TNode* root);
+
+	/**
+	 * @brief	- Destructor del arbol aplanado, no elimina los nodos
+	 */
+	~TFlatTree();
+
+	/**
+	 * @brief	- Reconstruye el arbol si ha cambiado su estructura y calcula las matrices mundo
+	 * 				en una sola pasada lineal
+	 */
+	void Update();
+
+	/**
+	 * @brief	- Pinta las entidades de la lista de pintado con su matriz mundo
+	 * 				Con el clipping activado no se pinta nada si la caja de todo el subarbol queda fuera
+	 * 				y si no solo se recorren las que devuelve la consulta al BVH
+	 * 				y cuya caja pasa la comprobacion por lotes contra los planos del frustum
+	 * 				Las entidades se mandan a la TRenderQueue que las pinta ordenadas al acabar
+	 */
+	void Draw();
+
+	/**
+	 * @brief	- Pinta las sombras de las entidades de la lista de pintado
+	 * 				Con el clipping activado se saltan las ramas cuya caja queda fuera del frustum de la luz
+	 */
+	void DrawShadows();
+
+	/**
+	 * @brief	- Devuelve el numero de nodos del arbol aplanado
+	 *
+	 * @return 	- int - Numero de nodos
+	 */
+	int GetNodeCount();
+
+private:
+	/**
+	 * @brief	- Recorre el subarbol en profundidad y rellena los vectores
+	 */
+	void Build();
+
+	/**
+	 * @brief	- Calcula las matrices mundo de los nodos que han cambiado
+	 * 				Como los padres siempre van antes que los hijos basta con una pasada
+	 */
+	void UpdateWorldMatrices();
+
+	/**
+	 * @brief	- Actualiza en el BVH las cajas de las entidades cuya matriz mundo o tamanyo ha cambiado
+	 */
+	void UpdateBounds();
+
+	/**
+	 * @brief	- Pinta la entidad de una posicion de la lista de pintado
+	 */
+	void DrawEntry(int entry);
+
+	/**
+	 * @brief	- Rasteriza los oclusores de las entradas visibles y quita de m_visible las que quedan tapadas
+	 *
+	 * @param 	- buffer - Buffer de oclusion de la camara, se comparte entre todos los arboles del frame
+	 */
+	void CullOccluded(TOcclusionBuffer* buffer);
+
+	/**
+	 * @brief	- Marca el nodo y sus antecesores para recalcular la caja de su subarbol
+	 */
+	void MarkSubtreeDirty(int node);
+
+	/**
+	 * @brief	- Recalcula las cajas de los subarboles marcados en una pasada de hijos a padres
+	 */
+	void UpdateSubtreeBounds();
+
+	/**
+	 * @brief	- Indica si todo el subarbol del nodo queda fuera del frustum
+	 *
+	 * @param 	- node - Indice del nodo en el arbol aplanado
+	 * @param 	- frustum - Frustum con el que se compara
+	 * @return 	- bool - Se puede saltar la rama entera
+	 */
+	bool IsSubtreeCulled(int node, TFrustum* frustum);
+
+	TNode*						m_root;				// m_root - Nodo raiz del subarbol aplanado
+	unsigned int				m_structureVersion;	// m_structureVersion - Version de la estructura del raiz con la que se construyo
+	bool						m_built;			// m_built - Se ha construido al menos una vez
+	bool						m_boundsPending;	// m_boundsPending - Hay que calcular todas las cajas tras reconstruir
+
+	std::vector<TNode*>			m_nodes;			// m_nodes - Nodos en orden de recorrido en profundidad
+	std::vector<int>			m_parents;			// m_parents - Indice del padre de cada nodo (-1 para la raiz)
+	std::vector<TTransform*>	m_transforms;		// m_transforms - Transformacion de cada nodo (nullptr si no tiene)
+	std::vector<glm::mat4>		m_localMatrices;	// m_localMatrices - Matriz local de cada nodo
+	std::vector<glm::mat4>		m_worldMatrices;	// m_worldMatrices - Matriz mundo de cada nodo
+	std::vector<unsigned int>	m_revisions;		// m_revisions - Revision de la matriz mundo copiada de cada nodo
+	std::vector<int>			m_drawList;			// m_drawList - Indices de los nodos con entidades a pintar
+	std::vector<int>			m_entries;			// m_entries - Entrada de la lista de pintado de cada nodo (-1 si no tiene)
+	std::vector<int>			m_subtreeEnd;		// m_subtreeEnd - Indice siguiente al ultimo descendiente de cada nodo
+
+	std::vector<glm::vec3>		m_subtreeMin;		// m_subtreeMin - Esquina minima de la caja de cada subarbol
+	std::vector<glm::vec3>		m_subtreeMax;		// m_subtreeMax - Esquina maxima de la caja de cada subarbol
+	std::vector<char>			m_subtreeInfinite;	// m_subtreeInfinite - El subarbol tiene alguna entidad sin caja
+	std::vector<char>			m_subtreeDirty;		// m_subtreeDirty - Hay que recalcular la caja del subarbol
+	bool						m_subtreePending;	// m_subtreePending - Hay algun subarbol marcado
+	TFrustum					m_shadowFrustum;	// m_shadowFrustum - Planos de la luz que calcula las sombras
+
+	TBVH						m_bvh;				// m_bvh - Cajas mundo de las entidades de la lista de pintado
+	std::vector<glm::vec3>		m_boundsMin;		// m_boundsMin - Esquina minima de la caja mundo de cada entrada
+	std::vector<glm::vec3>		m_boundsMax;		// m_boundsMax - Esquina maxima de la caja mundo de cada entrada
+	std::vector<int>			m_proxies;			// m_proxies - Hoja del BVH de cada entrada de la lista de pintado (-1 si no tiene caja)
+	std::vector<unsigned int>	m_boundsWorldRevisions;	// m_boundsWorldRevisions - Revision de la matriz mundo con la que se calculo la caja
+	std::vector<unsigned int>	m_boundsRevisions;	// m_boundsRevisions - Revision de la caja local con la que se calculo la caja
+	std::vector<int>			m_unbounded;		// m_unbounded - Entradas sin caja que se pintan siempre
+	std::vector<int>			m_visible;			// m_visible - Entradas a pintar en el frame actual
+
+	TFrustum					m_frustum;			// m_frustum - Planos de la camara del frame actual
+	std::vector<int>			m_candidates;		// m_candidates - Entradas cuya caja ampliada toca el frustum
+	TBoundsArray				m_candidateBounds;	// m_candidateBounds - Cajas exactas de los candidatos en SoA
+	std::vector<unsigned int>	m_candidateMask;	// m_candidateMask - Bit de visibilidad de cada candidato
+};
+
+#endif
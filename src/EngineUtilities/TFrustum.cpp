@@ -0,0 +1,178 @@
+#include "./TFrustum.h"
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+#include <cmath>
+
+#if defined(__AVX__)
+	#include <immintrin.h>
+	#define TFRUSTUM_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define TFRUSTUM_SSE
+#endif
+
+void TBoundsArray::Clear(){
+	centerX.clear();
+	centerY.clear();
+	centerZ.clear();
+	extentX.clear();
+	extentY.clear();
+	extentZ.clear();
+}
+
+void TBoundsArray::Add(glm::vec3 min, glm::vec3 max){
+	glm::vec3 center = (min + max) * 0.5f;
+	glm::vec3 extent = (max - min) * 0.5f;
+
+	centerX.push_back(center.x);
+	centerY.push_back(center.y);
+	centerZ.push_back(center.z);
+	extentX.push_back(extent.x);
+	extentY.push_back(extent.y);
+	extentZ.push_back(extent.z);
+}
+
+int TBoundsArray::Size(){
+	return centerX.size();
+}
+
+TFrustum::TFrustum(){
+	// Planos que siempre dan positivo, no se descarta nada
+	for(int i=0; i<6; i++) m_planes[i] = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+}
+
+void TFrustum::Update(const glm::mat4& viewProj, const float* limits){
+	ExtractPlanes(viewProj, limits, m_planes);
+}
+
+void TFrustum::ExtractPlanes(const glm::mat4& viewProj, const float* limits, glm::vec4* planes){
+	// Filas de la matriz (glm guarda las columnas)
+	glm::vec4 row0(viewProj[0][0], viewProj[1][0], viewProj[2][0], viewProj[3][0]);
+	glm::vec4 row1(viewProj[0][1], viewProj[1][1], viewProj[2][1], viewProj[3][1]);
+	glm::vec4 row2(viewProj[0][2], viewProj[1][2], viewProj[2][2], viewProj[3][2]);
+	glm::vec4 row3(viewProj[0][3], viewProj[1][3], viewProj[2][3], viewProj[3][3]);
+
+	// Los portales reducen la zona visible de la pantalla, x <= limite * w
+	float limitRight = 1.0f, limitLeft = -1.0f, limitUp = 1.0f, limitDown = -1.0f;
+	if(limits != nullptr){
+		limitRight = limits[0];
+		limitLeft = limits[1];
+		limitUp = limits[2];
+		limitDown = limits[3];
+	}
+
+	planes[0] = row0 - row3 * limitLeft;	// Izquierda
+	planes[1] = row3 * limitRight - row0;	// Derecha
+	planes[2] = row1 - row3 * limitDown;	// Abajo
+	planes[3] = row3 * limitUp - row1;		// Arriba
+	planes[4] = row3 + row2;				// Cerca
+	planes[5] = row3 - row2;				// Lejos
+}
+
+const glm::vec4* TFrustum::GetPlanes(){
+	return m_planes;
+}
+
+bool TFrustum::TestBox(glm::vec3 min, glm::vec3 max){
+	glm::vec3 center = (min + max) * 0.5f;
+	glm::vec3 extent = (max - min) * 0.5f;
+
+	// La caja esta fuera si la distancia del centro mas su radio proyectado queda detras de algun plano
+	for(int i=0; i<6; i++){
+		glm::vec3 normal(m_planes[i]);
+		float distance = glm::dot(normal, center) + m_planes[i].w;
+		float radius = glm::dot(glm::abs(normal), extent);
+		if(distance + radius < 0.0f) return false;
+	}
+	return true;
+}
+
+bool TFrustum::IsVisible(const std::vector<unsigned int>& mask, int box){
+	return (mask[box >> 5] >> (box & 31)) & 1u;
+}
+
+void TFrustum::CullBoxesScalar(TBoundsArray* boxes, int first, std::vector<unsigned int>* mask){
+	int count = boxes->Size();
+	for(int i=first; i<count; i++){
+		bool visible = true;
+		for(int p=0; p<6 && visible; p++){
+			const glm::vec4& plane = m_planes[p];
+			float distance = plane.x * boxes->centerX[i] + plane.y * boxes->centerY[i] + plane.z * boxes->centerZ[i] + plane.w;
+			float radius = std::abs(plane.x) * boxes->extentX[i] + std::abs(plane.y) * boxes->extentY[i] + std::abs(plane.z) * boxes->extentZ[i];
+			if(distance + radius < 0.0f) visible = false;
+		}
+		if(visible) (*mask)[i >> 5] |= 1u << (i & 31);
+	}
+}
+
+void TFrustum::CullBoxes(TBoundsArray* boxes, std::vector<unsigned int>* mask){
+	int count = boxes->Size();
+	mask->assign((count + 31) / 32, 0u);
+	int i = 0;
+
+	const float* cx = boxes->centerX.data();
+	const float* cy = boxes->centerY.data();
+	const float* cz = boxes->centerZ.data();
+	const float* ex = boxes->extentX.data();
+	const float* ey = boxes->extentY.data();
+	const float* ez = boxes->extentZ.data();
+
+#if defined(TFRUSTUM_AVX)
+	// Cargamos los planos una vez, repetidos en los 8 carriles
+	__m256 planeN[6][3], planeA[6][3], planeW[6];
+	for(int p=0; p<6; p++){
+		for(int c=0; c<3; c++){
+			planeN[p][c] = _mm256_set1_ps(m_planes[p][c]);
+			planeA[p][c] = _mm256_set1_ps(std::abs(m_planes[p][c]));
+		}
+		planeW[p] = _mm256_set1_ps(m_planes[p].w);
+	}
+	__m256 zero = _mm256_setzero_ps();
+
+	// 8 cajas por iteracion, como 32 es multiplo de 8 los bits nunca cruzan de palabra
+	for(; i + 8 <= count; i += 8){
+		__m256 centerX = _mm256_loadu_ps(cx + i), centerY = _mm256_loadu_ps(cy + i), centerZ = _mm256_loadu_ps(cz + i);
+		__m256 extentX = _mm256_loadu_ps(ex + i), extentY = _mm256_loadu_ps(ey + i), extentZ = _mm256_loadu_ps(ez + i);
+		__m256 outside = zero;
+
+		for(int p=0; p<6; p++){
+			__m256 distance = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(planeN[p][0], centerX), _mm256_mul_ps(planeN[p][1], centerY)), _mm256_add_ps(_mm256_mul_ps(planeN[p][2], centerZ), planeW[p]));
+			__m256 radius = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(planeA[p][0], extentX), _mm256_mul_ps(planeA[p][1], extentY)), _mm256_mul_ps(planeA[p][2], extentZ));
+			outside = _mm256_or_ps(outside, _mm256_cmp_ps(_mm256_add_ps(distance, radius), zero, _CMP_LT_OQ));
+		}
+
+		unsigned int visible = ~((unsigned int)_mm256_movemask_ps(outside)) & 0xFFu;
+		(*mask)[i >> 5] |= visible << (i & 31);
+	}
+#elif defined(TFRUSTUM_SSE)
+	// Cargamos los planos una vez, repetidos en los 4 carriles
+	__m128 planeN[6][3], planeA[6][3], planeW[6];
+	for(int p=0; p<6; p++){
+		for(int c=0; c<3; c++){
+			planeN[p][c] = _mm_set1_ps(m_planes[p][c]);
+			planeA[p][c] = _mm_set1_ps(std::abs(m_planes[p][c]));
+		}
+		planeW[p] = _mm_set1_ps(m_planes[p].w);
+	}
+	__m128 zero = _mm_setzero_ps();
+
+	// 4 cajas por iteracion, como 32 es multiplo de 4 los bits nunca cruzan de palabra
+	for(; i + 4 <= count; i += 4){
+		__m128 centerX = _mm_loadu_ps(cx + i), centerY = _mm_loadu_ps(cy + i), centerZ = _mm_loadu_ps(cz + i);
+		__m128 extentX = _mm_loadu_ps(ex + i), extentY = _mm_loadu_ps(ey + i), extentZ = _mm_loadu_ps(ez + i);
+		__m128 outside = zero;
+
+		for(int p=0; p<6; p++){
+			__m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(planeN[p][0], centerX), _mm_mul_ps(planeN[p][1], centerY)), _mm_add_ps(_mm_mul_ps(planeN[p][2], centerZ), planeW[p]));
+			__m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(planeA[p][0], extentX), _mm_mul_ps(planeA[p][1], extentY)), _mm_mul_ps(planeA[p][2], extentZ));
+			outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, radius), zero));
+		}
+
+		unsigned int visible = ~((unsigned int)_mm_movemask_ps(outside)) & 0xFu;
+		(*mask)[i >> 5] |= visible << (i & 31);
+	}
+#endif
+
+	// Las cajas que no llenan un registro (o todas sin SIMD) se comprueban una a una
+	CullBoxesScalar(boxes, i, mask);
+}
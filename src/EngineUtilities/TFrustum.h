@@ -0,0 +1,100 @@
+#ifndef TFRUSTUM_H
+#define TFRUSTUM_H
+
+/**
+ * @brief Frustum planes of a camera and batch culling of world space AABBs against them.
+ *
+ * @file TFrustum.h
+ */
+
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <glm/mat4x4.hpp>
+#include <vector>
+
+struct TBoundsArray{
+	std::vector<float>	centerX;	// centerX - Coordenada X del centro de cada caja
+	std::vector<float>	centerY;	// centerY - Coordenada Y del centro de cada caja
+	std::vector<float>	centerZ;	// centerZ - Coordenada Z del centro de cada caja
+	std::vector<float>	extentX;	// extentX - Mitad del tamanyo en X de cada caja
+	std::vector<float>	extentY;	// extentY - Mitad del tamanyo en Y de cada caja
+	std::vector<float>	extentZ;	// extentZ - Mitad del tamanyo en Z de cada caja
+
+	/**
+	 * @brief	- Vacia las cajas sin liberar la memoria
+	 */
+	void Clear();
+
+	/**
+	 * @brief	- Anyade una caja a partir de sus esquinas
+	 */
+	void Add(glm::vec3 min, glm::vec3 max);
+
+	/**
+	 * @brief	- Devuelve el numero de cajas
+	 */
+	int Size();
+};
+
+class TFrustum{
+public:
+	/**
+	 * @brief	- Constructor del frustum, por defecto no descarta nada hasta llamar a Update
+	 */
+	TFrustum();
+
+	/**
+	 * @brief	- Saca los seis planos del frustum una vez por camara
+	 *
+	 * @param 	- viewProj - Matriz Projection * View
+	 * @param 	- limits - Limites de la pantalla en NDC (+X, -X, +Y, -Y), nullptr para la pantalla entera
+	 */
+	void Update(const glm::mat4& viewProj, const float* limits = nullptr);
+
+	/**
+	 * @brief	- Comprueba una caja contra los seis planos
+	 *
+	 * @param 	- min - Esquina minima de la caja
+	 * @param 	- max - Esquina maxima de la caja
+	 * @return 	- bool - La caja toca el frustum
+	 */
+	bool TestBox(glm::vec3 min, glm::vec3 max);
+
+	/**
+	 * @brief	- Comprueba todas las cajas a la vez (8 por iteracion con AVX, 4 con SSE)
+	 * 				y escribe un bit por caja, 1 si es visible
+	 *
+	 * @param 	- boxes - Cajas a comprobar
+	 * @param 	- mask - Mascara de visibilidad, un unsigned int por cada 32 cajas
+	 */
+	void CullBoxes(TBoundsArray* boxes, std::vector<unsigned int>* mask);
+
+	/**
+	 * @brief	- Version sin SIMD de CullBoxes, se usa para las cajas que sobran y en plataformas sin SSE
+	 */
+	void CullBoxesScalar(TBoundsArray* boxes, int first, std::vector<unsigned int>* mask);
+
+	/**
+	 * @brief	- Devuelve los planos (a, b, c, d) con las normales hacia dentro
+	 */
+	const glm::vec4* GetPlanes();
+
+	/**
+	 * @brief	- Saca los seis planos de la matriz Projection * View (normales hacia dentro)
+	 *
+	 * @param 	- viewProj - Matriz Projection * View
+	 * @param 	- limits - Limites de la pantalla en NDC (+X, -X, +Y, -Y), nullptr para la pantalla entera
+	 * @param 	- planes - Array de seis planos
+	 */
+	static void ExtractPlanes(const glm::mat4& viewProj, const float* limits, glm::vec4* planes);
+
+	/**
+	 * @brief	- Indica si el mask tiene a 1 el bit de la caja
+	 */
+	static bool IsVisible(const std::vector<unsigned int>& mask, int box);
+
+private:
+	glm::vec4	m_planes[6];	// m_planes - Izquierda, derecha, abajo, arriba, cerca y lejos
+};
+
+#endif
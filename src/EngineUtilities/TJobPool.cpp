@@ -0,0 +1,104 @@
+#include "TJobPool.h"
+
+#include <algorithm>
+
+TJobPool* TJobPool::GetInstance(){
+	static TJobPool instance;
+	return &instance;
+}
+
+TJobPool::TJobPool(){
+	m_job = nullptr;
+	m_jobCount = 0;
+	m_nextJob = 0;
+	m_doneJobs = 0;
+	m_stop = false;
+
+	// Un hilo por nucleo, el principal incluido
+	m_threadCount = std::max(1, (int)std::thread::hardware_concurrency());
+}
+
+TJobPool::~TJobPool(){
+	StopThreads();
+}
+
+void TJobPool::StartThreads(){
+	if((int)m_threads.size() == m_threadCount - 1) return;
+	StopThreads();
+
+	m_stop = false;
+	for(int i=1; i<m_threadCount; i++) m_threads.push_back(std::thread(&TJobPool::Worker, this));
+}
+
+void TJobPool::StopThreads(){
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stop = true;
+	}
+	m_workCondition.notify_all();
+
+	int size = m_threads.size();
+	for(int i=0; i<size; i++) m_threads[i].join();
+	m_threads.clear();
+}
+
+void TJobPool::SetThreadCount(int count){
+	if(count <= 0) count = std::max(1, (int)std::thread::hardware_concurrency());
+	if(count == m_threadCount) return;
+
+	// Los hilos se vuelven a crear en el siguiente Run
+	StopThreads();
+	m_threadCount = count;
+}
+
+int TJobPool::GetThreadCount(){
+	return m_threadCount;
+}
+
+void TJobPool::Run(int count, const TJob& job){
+	if(count <= 0) return;
+
+	// Con un solo indice o un solo hilo no merece la pena despertar a nadie
+	if(count == 1 || m_threadCount <= 1){
+		for(int i=0; i<count; i++) job(i);
+		return;
+	}
+
+	StartThreads();
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_job = &job;
+	m_jobCount = count;
+	m_nextJob = 0;
+	m_doneJobs = 0;
+	m_workCondition.notify_all();
+
+	// El hilo principal trabaja como uno mas y luego espera a los indices que siguen en otros hilos
+	while(m_nextJob < m_jobCount) RunNext(lock);
+	m_doneCondition.wait(lock, [this]{ return m_doneJobs == m_jobCount; });
+
+	m_job = nullptr;
+	m_jobCount = 0;
+	m_nextJob = 0;
+	m_doneJobs = 0;
+}
+
+void TJobPool::RunNext(std::unique_lock<std::mutex>& lock){
+	int index = m_nextJob++;
+	const TJob* job = m_job;
+
+	lock.unlock();
+	(*job)(index);
+	lock.lock();
+
+	m_doneJobs++;
+	if(m_doneJobs == m_jobCount) m_doneCondition.notify_all();
+}
+
+void TJobPool::Worker(){
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while(true){
+		m_workCondition.wait(lock, [this]{ return m_stop || m_nextJob < m_jobCount; });
+		if(m_stop) return;
+		RunNext(lock);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,88 @@
+#ifndef TJOBPOOL_H
+#define TJOBPOOL_H
+
+/**
+ * @brief Pool of worker threads for the per-frame work: splits a job in indices and waits until all of them are done.
+ *
+ * @file TJobPool.h
+ */
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+/**
+ * @brief 	- Trabajo que se reparte, se llama una vez por indice desde cualquier hilo
+ */
+typedef std::function<void(int)> TJob;
+
+class TJobPool{
+public:
+	/**
+	 * @brief	- Devuelve la instancia del pool
+	 */
+	static TJobPool* GetInstance();
+
+	/**
+	 * @brief	- Destructor, para y espera a los hilos
+	 */
+	~TJobPool();
+
+	/**
+	 * @brief	- Llama al trabajo con los indices de 0 a count-1 repartidos entre los hilos y espera a que acaben
+	 * 				El hilo que llama tambien coge indices. Solo se llama desde el hilo principal
+	 *
+	 * @param 	- count - Numero de indices
+	 * @param 	- job - Trabajo a hacer con cada indice
+	 */
+	void Run(int count, const TJob& job);
+
+	/**
+	 * @brief	- Cambia el numero de hilos que trabajan, contando el que llama a Run
+	 * 				1 lo hace todo en el hilo principal, 0 usa un hilo por nucleo
+	 */
+	void SetThreadCount(int count);
+
+	/**
+	 * @brief	- Devuelve el numero de hilos que trabajan, contando el que llama a Run
+	 */
+	int GetThreadCount();
+
+private:
+	TJobPool();
+
+	/**
+	 * @brief	- Bucle de los hilos, esperan a que haya indices y los hacen
+	 */
+	void Worker();
+
+	/**
+	 * @brief	- Coge el siguiente indice y lo hace, se llama con el mutex cogido y lo suelta mientras trabaja
+	 */
+	void RunNext(std::unique_lock<std::mutex>& lock);
+
+	/**
+	 * @brief	- Crea los hilos si no se han creado ya
+	 */
+	void StartThreads();
+
+	/**
+	 * @brief	- Para y espera a los hilos
+	 */
+	void StopThreads();
+
+	std::vector<std::thread>	m_threads;			// m_threads - Hilos del pool, sin contar el principal
+	std::mutex					m_mutex;			// m_mutex - Protege el trabajo actual y sus indices
+	std::condition_variable		m_workCondition;	// m_workCondition - Avisa a los hilos de que hay indices o de que paren
+	std::condition_variable		m_doneCondition;	// m_doneCondition - Avisa al hilo principal de que se han acabado los indices
+	const TJob*					m_job;				// m_job - Trabajo actual, nullptr si no hay
+	int							m_jobCount;			// m_jobCount - Indices del trabajo actual
+	int							m_nextJob;			// m_nextJob - Siguiente indice a coger
+	int							m_doneJobs;			// m_doneJobs - Indices acabados
+	int							m_threadCount;		// m_threadCount - Hilos que trabajan contando el principal
+	bool						m_stop;				// m_stop - Los hilos tienen que parar
+};
+
+#endif
\ No newline at end of file
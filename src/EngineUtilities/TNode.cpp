@@ -1,4 +1,5 @@
 #include "TNode.h"
+#include "TFlatTree.h"
 #include "Entities/TTransform.h"
 #include <glm/gtx/matrix_decompose.hpp>
 #include <iostream>
@@ -8,21 +9,43 @@
 TNode::TNode(){
 	m_parent = nullptr;
 	m_entity = nullptr;
+	m_worldMatrix = glm::mat4(1.0f);
+	m_dirty = true;
+	m_worldRevision = 0;
+	m_structureVersion = 0;
+	m_flatTree = nullptr;
 }
 
 TNode::TNode(TEntity* entity){
 	m_parent = nullptr;
 	m_entity = entity;
+	m_worldMatrix = glm::mat4(1.0f);
+	m_dirty = true;
+	m_worldRevision = 0;
+	m_structureVersion = 0;
+	m_flatTree = nullptr;
+	if(m_entity != nullptr) m_entity->SetOwnerNode(this);
 }
 
 TNode::TNode(TNode* parent, TEntity* entity){
 	m_parent = parent;
 	m_entity = entity;
+	m_worldMatrix = glm::mat4(1.0f);
+	m_dirty = true;
+	m_worldRevision = 0;
+	m_structureVersion = 0;
+	m_flatTree = nullptr;
+	if(m_entity != nullptr) m_entity->SetOwnerNode(this);
 	// La adjuntamos al nodo padre el nodo actual
 	parent->AddChild(this);
 }
 
 TNode::~TNode(){
+	if(m_flatTree != nullptr){
+		delete m_flatTree;
+		m_flatTree = nullptr;
+	}
+
 	// A la hora de eliminar un nodo eliminamos tambien todos los nodos hijo
 	int size = m_children.size();
 	for(int i = size - 1; i>=0; i--){
@@ -48,12 +71,16 @@ TNode::~TNode(){
 int TNode::AddChild(TNode* child){
 	int position = m_children.size();
 	m_children.push_back(child);
+	child->SetDirty();	// Su matriz mundo pasa a depender de la del nodo actual
+	StructureChanged();
 	return position;	// Devolvemos la posicion en la que se pone el hijo
 }
 
 int TNode::AddFirstChild(TNode* child){
 	int position = 0;
 	m_children.insert(m_children.begin(), child);
+	child->SetDirty();	// Su matriz mundo pasa a depender de la del nodo actual
+	StructureChanged();
 	return position;	// Devolvemos la posicion en la que se pone el hijo
 }
 
@@ -63,6 +90,8 @@ int TNode::RemoveChild(TNode* child){
 		TNode* node = m_children[i];
 		if(node == child){
 			m_children.erase(m_children.begin()+i);
+			child->SetDirty();
+			StructureChanged();
 			return i;	// Devolvemos la posicion en la que se encontraba el nodo
 		}
 	}
@@ -76,6 +105,9 @@ bool TNode::SetEntity(TEntity* entity){
 	// En el caso de que ya hubiera una entidad no la cambiamos
 	if(m_entity == nullptr){
 		m_entity = entity;
+		if(m_entity != nullptr) m_entity->SetOwnerNode(this);
+		SetDirty();
+		StructureChanged();
 		toReturn = true;
 	}
 	
@@ -95,6 +127,8 @@ bool TNode::SetParent(TNode* parent){
 			m_parent->RemoveChild(this);
 		}
 		m_parent = parent;
+		SetDirty();
+		StructureChanged();
 		
 		toReturn = true;
 	}
@@ -106,51 +140,50 @@ TNode* TNode::GetParent(){
 }
 
 void TNode::Draw(){
-	if(m_entity != nullptr) m_entity->BeginDraw();
-	
-	int size = m_children.size();
-	for(int i=0; i<size; i++){
-		TNode* child = m_children[i];	// Pintamos cada uno de los hijos del nodo
-		child->Draw();
-	}
-	
-	if(m_entity != nullptr) m_entity->EndDraw();
+	// Aplanamos el subarbol la primera vez que se pinta desde este nodo
+	if(m_flatTree == nullptr) m_flatTree = new TFlatTree(this);
+	m_flatTree->Draw();
 }
 
 void TNode::DrawShadows(){
-	if(m_entity != nullptr){
-		m_entity->DrawShadow();						// For mesh sets drawingShadows to true
-		m_entity->BeginDraw();						// for mesh: if drawingShadowsn, doenst draw
-		// ^^^^^^^^^^^^^^^^^^^^	THIS NEED TO BE DONE DUE TO STACK PUSHS AND POPS
-	}
-	
-	int size = m_children.size();
-	for(int i=0; i<size; i++){
-		TNode* child = m_children[i];	// Pintamos cada uno de los hijos del nodo
-		child->DrawShadows();
-	}
-	if(m_entity != nullptr) m_entity->EndDraw();	// For mesh sets drawingShadows to false
+	if(m_flatTree == nullptr) m_flatTree = new TFlatTree(this);
+	m_flatTree->DrawShadows();
 }
 
 glm::mat4 TNode::GetTransformMatrix(){
-	TNode* auxParent;
-	glm::mat4 toReturn;
-
-	auxParent = GetParent();
-	if(auxParent != nullptr){
-		// Inicializamos la variable toReturn con la transformacion del nodo padre
-		toReturn = ((TTransform*)auxParent->GetEntity())->GetTransform();
-		auxParent = auxParent->GetParent();
+	glm::mat4 toReturn = glm::mat4(1.0f);
+
+	// La transformacion desde la raiz hasta el nodo actual es la matriz mundo cacheada del padre
+	if(m_parent != nullptr) toReturn = m_parent->GetWorldMatrix();
+
+	return toReturn;
+}
+
+const glm::mat4& TNode::GetWorldMatrix(){
+	if(m_dirty){
+		// Primero nos aseguramos de que la matriz del padre este actualizada
+		glm::mat4 parentMatrix = glm::mat4(1.0f);
+		if(m_parent != nullptr) parentMatrix = m_parent->GetWorldMatrix();
+
+		// Acumulamos la transformacion del nodo (mismo orden que la antigua pila de matrices)
+		if(m_entity != nullptr && m_entity->IsTransform()) m_worldMatrix = ((TTransform*)m_entity)->GetTransform() * parentMatrix;
+		else m_worldMatrix = parentMatrix;
+
+		m_dirty = false;
+		m_worldRevision++;
 	}
+	return m_worldMatrix;
+}
 
-	while(auxParent != nullptr){
-		// Vamos acumulando transformaciones mientras vamos subiendo por el arbol
-		toReturn = toReturn * ((TTransform*)auxParent->GetEntity())->GetTransform();
-		auxParent = auxParent->GetParent();
+void TNode::SetDirty(){
+	// Si el nodo ya estaba sucio sus descendientes tambien lo estan, no hace falta seguir bajando
+	if(m_dirty) return;
+
+	m_dirty = true;
+	int size = m_children.size();
+	for(int i=0; i<size; i++){
+		m_children[i]->SetDirty();
 	}
-	
-	// Al acabar tendremos la transformacion del nodo actual desde la raiz del arbol
-	return toReturn;
 }
 
 glm::vec3 TNode::GetTranslation(){
@@ -212,6 +245,29 @@ glm::vec3 TNode::GetScale(){
 	return toRet;
 }
 
+bool TNode::IsDirty(){
+	return m_dirty;
+}
+
+void TNode::SetWorldMatrix(const glm::mat4& world){
+	m_worldMatrix = world;
+	m_dirty = false;
+	m_worldRevision++;
+}
+
+unsigned int TNode::GetWorldRevision(){
+	return m_worldRevision;
+}
+
+unsigned int TNode::GetStructureVersion(){
+	return m_structureVersion;
+}
+
+void TNode::StructureChanged(){
+	// El cambio tambien afecta a los arboles aplanados de todos los ancestros
+	for(TNode* node = this; node != nullptr; node = node->m_parent) node->m_structureVersion++;
+}
+
 std::vector<TNode*>	TNode::GetChildren(){
 	return m_children;
 }
\ No newline at end of file
@@ -10,6 +10,8 @@
 #include "./Entities/TEntity.h"
 #include <vector>
 
+class TFlatTree;
+
 class TNode{
 public:
 	/**
@@ -78,12 +80,13 @@ public:
 	int 		RemoveChild(TNode* child);
 
 	/**
-	 * @brief	- Pintamos el nodo 
+	 * @brief	- Pintamos el nodo y todos sus descendientes
+	 * 				El subarbol se recorre de forma lineal a traves de su TFlatTree
 	 */
 	virtual 	void Draw();					
 
 	/**
-	 * @brief	- Pintamos las sombras del nodo 
+	 * @brief	- Pintamos las sombras del nodo y de todos sus descendientes
 	 */
 	void DrawShadows();						
 
@@ -115,6 +118,49 @@ public:
 	 */
 	glm::mat4	GetTransformMatrix();
 
+	/**
+	 * @brief	- Devuelve la matriz mundo del nodo (la de sus ancestros acumulada con la suya propia)
+	 * 				Solo se recalcula en el caso de que alguna transformacion por encima haya cambiado
+	 * 
+	 * @return 	- glm::mat4 - Matriz mundo cacheada del nodo
+	 */
+	const glm::mat4& GetWorldMatrix();
+
+	/**
+	 * @brief	- Marca la matriz mundo del nodo y la de todos sus descendientes como no valida
+	 */
+	void		SetDirty();
+
+	/**
+	 * @brief	- Indica si la matriz mundo del nodo se tiene que volver a calcular
+	 * 
+	 * @return 	- bool - La matriz mundo esta sucia
+	 */
+	bool		IsDirty();
+
+	/**
+	 * @brief	- Guarda la matriz mundo calculada desde fuera (recorrido lineal) y limpia el flag
+	 * 
+	 * @param 	- world - Matriz mundo ya calculada del nodo
+	 */
+	void		SetWorldMatrix(const glm::mat4& world);
+
+	/**
+	 * @brief	- Devuelve cuantas veces se ha recalculado la matriz mundo del nodo
+	 * 				Sirve para saber si la copia del TFlatTree esta desactualizada
+	 * 
+	 * @return 	- unsigned int - Revision de la matriz mundo
+	 */
+	unsigned int GetWorldRevision();
+
+	/**
+	 * @brief	- Devuelve la version de la estructura del subarbol que empieza en el nodo
+	 * 				Se incrementa cada vez que se anyade, quita o elimina un nodo dentro de el
+	 * 
+	 * @return 	- unsigned int - Version de la estructura
+	 */
+	unsigned int GetStructureVersion();
+
 	/**
 	 * @brief	- Devuelve la translacion que acumula el nodo actual 
 
@@ -140,7 +186,18 @@ protected:
 	TEntity*			m_entity;				// m_entity - Entidad que marca el tipo de nodo, con sus propias funciones
 	std::vector<TNode*>	m_children;				// m_children - Vector de nodos hijos
 	TNode*				m_parent;				// m_parent - Nodo padre al actual
-	
+
+	glm::mat4			m_worldMatrix;			// m_worldMatrix - Matriz mundo cacheada del nodo
+	bool				m_dirty;				// m_dirty - La matriz mundo se tiene que volver a calcular
+	unsigned int		m_worldRevision;		// m_worldRevision - Numero de veces que se ha recalculado la matriz mundo
+	TFlatTree*			m_flatTree;				// m_flatTree - Subarbol aplanado que se usa al pintar desde este nodo
+	unsigned int		m_structureVersion;		// m_structureVersion - Version de la estructura del subarbol
+
+	/**
+	 * @brief	- Incrementa la version de la estructura del nodo y de todos sus ancestros
+	 */
+	void StructureChanged();
+
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,323 @@
+#include "./TOcclusionBuffer.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define TOCCLUSION_SSE
+#endif
+
+TOcclusionBuffer::TOcclusionBuffer(int width, int height){
+	// El ancho es multiplo de 4 para que cada fila se recorra de 4 en 4 pixeles sin salirse
+	m_width = std::max(4, (width + 3) & ~3);
+	m_height = std::max(1, height);
+	m_depth.assign(m_width * m_height, 1.0f);
+	m_viewProj = glm::mat4(1.0f);
+	m_hierarchyDirty = true;
+	m_triangleCount = 0;
+
+	// Cada nivel tiene la mitad de pixeles (redondeando hacia arriba) hasta llegar a 1x1
+	// El nivel 0 no guarda copia, lee directamente de m_depth
+	TOcclusionLevel level;
+	level.width = m_width;
+	level.height = m_height;
+	m_levels.push_back(level);
+
+	while(level.width > 1 || level.height > 1){
+		level.width = (level.width + 1) / 2;
+		level.height = (level.height + 1) / 2;
+		level.minDepth.assign(level.width * level.height, 1.0f);
+		level.maxDepth.assign(level.width * level.height, 1.0f);
+		m_levels.push_back(level);
+	}
+}
+
+TOcclusionBuffer::~TOcclusionBuffer(){
+	m_depth.clear();
+	m_levels.clear();
+	m_stack.clear();
+}
+
+void TOcclusionBuffer::Clear(const glm::mat4& viewProj){
+	std::fill(m_depth.begin(), m_depth.end(), 1.0f);
+	m_viewProj = viewProj;
+	m_hierarchyDirty = true;
+	m_triangleCount = 0;
+}
+
+glm::vec3 TOcclusionBuffer::ToScreen(glm::vec4 clip){
+	float invW = 1.0f / clip.w;
+	return glm::vec3(
+		(clip.x * invW * 0.5f + 0.5f) * m_width,
+		(clip.y * invW * 0.5f + 0.5f) * m_height,
+		clip.z * invW * 0.5f + 0.5f
+	);
+}
+
+void TOcclusionBuffer::RasterizeMesh(const glm::mat4& model, std::vector<glm::vec3>* positions, std::vector<unsigned int>* indices){
+	glm::mat4 mvp = m_viewProj * model;
+
+	int size = indices->size() - indices->size() % 3;
+	for(int i=0; i<size; i+=3){
+		glm::vec3 a = positions->at(indices->at(i));
+		glm::vec3 b = positions->at(indices->at(i+1));
+		glm::vec3 c = positions->at(indices->at(i+2));
+		RasterizeTriangle(mvp * glm::vec4(a, 1.0f), mvp * glm::vec4(b, 1.0f), mvp * glm::vec4(c, 1.0f));
+	}
+}
+
+void TOcclusionBuffer::RasterizeTriangle(glm::vec4 v0, glm::vec4 v1, glm::vec4 v2){
+	// Distancia al plano cercano (z >= -w), positiva delante de la camara
+	glm::vec4 input[3] = {v0, v1, v2};
+	float distance[3] = {v0.z + v0.w, v1.z + v1.w, v2.z + v2.w};
+
+	if(distance[0] >= 0 && distance[1] >= 0 && distance[2] >= 0){
+		RasterizeScreenTriangle(ToScreen(v0), ToScreen(v1), ToScreen(v2));
+		return;
+	}
+	if(distance[0] < 0 && distance[1] < 0 && distance[2] < 0) return;
+
+	// Recortamos contra el plano cercano, un triangulo da como mucho 4 vertices
+	glm::vec4 clipped[4];
+	int count = 0;
+	for(int i=0; i<3; i++){
+		int next = (i + 1) % 3;
+		if(distance[i] >= 0) clipped[count++] = input[i];
+		if((distance[i] >= 0) != (distance[next] >= 0)){
+			float t = distance[i] / (distance[i] - distance[next]);
+			clipped[count++] = input[i] + (input[next] - input[i]) * t;
+		}
+	}
+
+	glm::vec3 first = ToScreen(clipped[0]);
+	for(int i=1; i+1<count; i++) RasterizeScreenTriangle(first, ToScreen(clipped[i]), ToScreen(clipped[i+1]));
+}
+
+void TOcclusionBuffer::RasterizeScreenTriangle(glm::vec3 p0, glm::vec3 p1, glm::vec3 p2){
+	// Los triangulos de espaldas no se pintan, tampoco pueden tapar nada
+	float area = (p1.x - p0.x) * (p2.y - p0.y) - (p1.y - p0.y) * (p2.x - p0.x);
+	if(area <= 0.0f) return;
+
+	float minX = std::max(0.0f, std::floor(std::min(p0.x, std::min(p1.x, p2.x))));
+	float maxX = std::min((float)(m_width - 1), std::floor(std::max(p0.x, std::max(p1.x, p2.x))));
+	float minY = std::max(0.0f, std::floor(std::min(p0.y, std::min(p1.y, p2.y))));
+	float maxY = std::min((float)(m_height - 1), std::floor(std::max(p0.y, std::max(p1.y, p2.y))));
+	if(minX > maxX || minY > maxY) return;
+
+	m_hierarchyDirty = true;
+	m_triangleCount++;
+
+	// Funciones de arista E = A*x + B*y + C, positivas dentro del triangulo
+	// La arista i es la opuesta al vertice i
+	glm::vec3 points[3] = {p0, p1, p2};
+	float edgeA[3], edgeB[3], edgeC[3];
+	for(int i=0; i<3; i++){
+		glm::vec3 a = points[(i + 1) % 3];
+		glm::vec3 b = points[(i + 2) % 3];
+		edgeA[i] = a.y - b.y;
+		edgeB[i] = b.x - a.x;
+		edgeC[i] = -(edgeA[i] * a.x + edgeB[i] * a.y);
+	}
+
+	// La profundidad en NDC es lineal en pantalla, z = zA*x + zB*y + zC
+	float invArea = 1.0f / area;
+	float depth1 = (p1.z - p0.z) * invArea;
+	float depth2 = (p2.z - p0.z) * invArea;
+	float zA = edgeA[1] * depth1 + edgeA[2] * depth2;
+	float zB = edgeB[1] * depth1 + edgeB[2] * depth2;
+	float zC = p0.z + edgeC[1] * depth1 + edgeC[2] * depth2;
+
+	int startX = (int)minX & ~3;	// Alineado a 4, las filas tienen un ancho multiplo de 4
+	int endX = (int)maxX;
+	int startY = (int)minY;
+	int endY = (int)maxY;
+
+#if defined(TOCCLUSION_SSE)
+	__m128 offsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+	__m128 zero = _mm_setzero_ps();
+	__m128 one = _mm_set1_ps(1.0f);
+	__m128 vEdgeA[3], vEdgeC[3];
+	for(int i=0; i<3; i++){
+		vEdgeA[i] = _mm_set1_ps(edgeA[i]);
+		vEdgeC[i] = _mm_set1_ps(edgeC[i]);
+	}
+	__m128 vZA = _mm_set1_ps(zA);
+	__m128 vZC = _mm_set1_ps(zC);
+
+	for(int y=startY; y<=endY; y++){
+		float py = y + 0.5f;
+		__m128 rowEdge[3];
+		for(int i=0; i<3; i++) rowEdge[i] = _mm_set1_ps(edgeB[i] * py);
+		__m128 rowDepth = _mm_set1_ps(zB * py);
+		float* row = &m_depth[y * m_width];
+
+		for(int x=startX; x<=endX; x+=4){
+			__m128 px = _mm_add_ps(_mm_set1_ps((float)x), offsets);
+
+			__m128 e0 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vEdgeA[0], px), rowEdge[0]), vEdgeC[0]);
+			__m128 e1 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vEdgeA[1], px), rowEdge[1]), vEdgeC[1]);
+			__m128 e2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vEdgeA[2], px), rowEdge[2]), vEdgeC[2]);
+			__m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(e0, zero), _mm_cmpge_ps(e1, zero)), _mm_cmpge_ps(e2, zero));
+			if(_mm_movemask_ps(inside) == 0) continue;
+
+			__m128 depth = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vZA, px), rowDepth), vZC);
+			depth = _mm_max_ps(_mm_min_ps(depth, one), zero);
+
+			__m128 previous = _mm_loadu_ps(row + x);
+			__m128 nearest = _mm_min_ps(previous, depth);
+			_mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearest), _mm_andnot_ps(inside, previous)));
+		}
+	}
+#else
+	for(int y=startY; y<=endY; y++){
+		float py = y + 0.5f;
+		float* row = &m_depth[y * m_width];
+
+		for(int x=startX; x<=endX; x++){
+			float px = x + 0.5f;
+			float e0 = (edgeA[0] * px + edgeB[0] * py) + edgeC[0];
+			float e1 = (edgeA[1] * px + edgeB[1] * py) + edgeC[1];
+			float e2 = (edgeA[2] * px + edgeB[2] * py) + edgeC[2];
+			if(e0 < 0.0f || e1 < 0.0f || e2 < 0.0f) continue;
+
+			float depth = (zA * px + zB * py) + zC;
+			depth = std::max(std::min(depth, 1.0f), 0.0f);
+			row[x] = std::min(row[x], depth);
+		}
+	}
+#endif
+}
+
+void TOcclusionBuffer::BuildHierarchy(){
+	if(!m_hierarchyDirty) return;
+
+	int levels = m_levels.size();
+	for(int l=1; l<levels; l++){
+		TOcclusionLevel& previous = m_levels[l - 1];
+		TOcclusionLevel& current = m_levels[l];
+
+		const float* previousMin = l == 1 ? m_depth.data() : previous.minDepth.data();
+		const float* previousMax = l == 1 ? m_depth.data() : previous.maxDepth.data();
+
+		for(int y=0; y<current.height; y++){
+			int y0 = y * 2;
+			int y1 = std::min(y0 + 1, previous.height - 1);
+
+			for(int x=0; x<current.width; x++){
+				int x0 = x * 2;
+				int x1 = std::min(x0 + 1, previous.width - 1);
+
+				int a = y0 * previous.width + x0, b = y0 * previous.width + x1;
+				int c = y1 * previous.width + x0, d = y1 * previous.width + x1;
+
+				current.minDepth[y * current.width + x] = std::min(std::min(previousMin[a], previousMin[b]), std::min(previousMin[c], previousMin[d]));
+				current.maxDepth[y * current.width + x] = std::max(std::max(previousMax[a], previousMax[b]), std::max(previousMax[c], previousMax[d]));
+			}
+		}
+	}
+
+	m_hierarchyDirty = false;
+}
+
+bool TOcclusionBuffer::TestBox(glm::vec3 min, glm::vec3 max){
+	if(m_triangleCount == 0) return true;
+	BuildHierarchy();
+
+	// Proyectamos las 8 esquinas y nos quedamos con el rectangulo en pantalla y la profundidad mas cercana
+	float minX = m_width, maxX = -1.0f, minY = m_height, maxY = -1.0f;
+	float nearest = 1.0f;
+
+	for(int i=0; i<8; i++){
+		glm::vec3 corner(i & 1 ? max.x : min.x, i & 2 ? max.y : min.y, i & 4 ? max.z : min.z);
+		glm::vec4 clip = m_viewProj * glm::vec4(corner, 1.0f);
+
+		// Si la caja cruza el plano cercano la camara esta dentro o muy cerca, no se puede descartar
+		if(clip.z + clip.w < 0.0f || clip.w <= 0.0f) return true;
+
+		glm::vec3 screen = ToScreen(clip);
+		minX = std::min(minX, screen.x);
+		maxX = std::max(maxX, screen.x);
+		minY = std::min(minY, screen.y);
+		maxY = std::max(maxY, screen.y);
+		nearest = std::min(nearest, screen.z);
+	}
+
+	// Lo que queda fuera de la pantalla lo decide el frustum
+	if(maxX < 0.0f || maxY < 0.0f || minX >= m_width || minY >= m_height) return true;
+
+	int x0 = (int)std::max(0.0f, std::floor(minX));
+	int x1 = (int)std::min((float)(m_width - 1), std::floor(maxX));
+	int y0 = (int)std::max(0.0f, std::floor(minY));
+	int y1 = (int)std::min((float)(m_height - 1), std::floor(maxY));
+
+	// Empezamos en el nivel en el que el rectangulo ocupa como mucho 4x4 pixeles
+	int level = 0;
+	int levels = m_levels.size();
+	while(level < levels - 1 && ((x1 >> level) - (x0 >> level) >= 4 || (y1 >> level) - (y0 >> level) >= 4)) level++;
+
+	m_stack.clear();
+	for(int y=y0>>level; y<=y1>>level; y++){
+		for(int x=x0>>level; x<=x1>>level; x++){
+			m_stack.push_back(level);
+			m_stack.push_back(x);
+			m_stack.push_back(y);
+		}
+	}
+
+	while(!m_stack.empty()){
+		int y = m_stack.back(); m_stack.pop_back();
+		int x = m_stack.back(); m_stack.pop_back();
+		int l = m_stack.back(); m_stack.pop_back();
+
+		TOcclusionLevel& current = m_levels[l];
+		int index = y * current.width + x;
+		float maxDepth = l == 0 ? m_depth[index] : current.maxDepth[index];
+
+		// Todos los oclusores de la zona estan delante de la caja
+		if(nearest > maxDepth) continue;
+
+		// La caja esta delante de todos los oclusores de la zona, bajar de nivel no va a cambiar nada
+		float minDepth = l == 0 ? m_depth[index] : current.minDepth[index];
+		if(l == 0 || nearest < minDepth) return true;
+
+		// Bajamos a los hijos que toca el rectangulo
+		int child = l - 1;
+		TOcclusionLevel& finer = m_levels[child];
+		int cx0 = std::max(x * 2, x0 >> child), cx1 = std::min(std::min(x * 2 + 1, finer.width - 1), x1 >> child);
+		int cy0 = std::max(y * 2, y0 >> child), cy1 = std::min(std::min(y * 2 + 1, finer.height - 1), y1 >> child);
+		for(int cy=cy0; cy<=cy1; cy++){
+			for(int cx=cx0; cx<=cx1; cx++){
+				m_stack.push_back(child);
+				m_stack.push_back(cx);
+				m_stack.push_back(cy);
+			}
+		}
+	}
+
+	return false;
+}
+
+float TOcclusionBuffer::GetDepth(int x, int y, int level, bool maxDepth){
+	if(level <= 0) return m_depth[y * m_width + x];
+	BuildHierarchy();
+
+	TOcclusionLevel& current = m_levels[level];
+	int index = y * current.width + x;
+	return maxDepth ? current.maxDepth[index] : current.minDepth[index];
+}
+
+int TOcclusionBuffer::GetWidth(){
+	return m_width;
+}
+
+int TOcclusionBuffer::GetHeight(){
+	return m_height;
+}
+
+int TOcclusionBuffer::GetLevelCount(){
+	return m_levels.size();
+}
+
+int TOcclusionBuffer::GetTriangleCount(){
+	return m_triangleCount;
+}
@@ -0,0 +1,117 @@
+#ifndef TOCCLUSIONBUFFER_H
+#define TOCCLUSIONBUFFER_H
+
+/**
+ * @brief Low resolution software depth buffer with a min/max hierarchy used to cull occluded AABBs on the CPU.
+ *
+ * @file TOcclusionBuffer.h
+ */
+
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <glm/mat4x4.hpp>
+#include <vector>
+
+class TOcclusionBuffer{
+public:
+	/**
+	 * @brief	- Constructor del buffer de oclusion, no utiliza OpenGL
+	 *
+	 * @param 	- width - Ancho en pixeles, se redondea a multiplo de 4
+	 * @param 	- height - Alto en pixeles
+	 */
+	TOcclusionBuffer(int width = 256, int height = 128);
+
+	/**
+	 * @brief	- Destructor del buffer de oclusion
+	 */
+	~TOcclusionBuffer();
+
+	/**
+	 * @brief	- Vacia el buffer (profundidad 1, lejos) y guarda la camara con la que se rasteriza
+	 *
+	 * @param 	- viewProj - Matriz Projection * View de la camara
+	 */
+	void Clear(const glm::mat4& viewProj);
+
+	/**
+	 * @brief	- Rasteriza los triangulos de un oclusor guardando la profundidad mas cercana de cada pixel
+	 * 				Los triangulos de espaldas se descartan igual que al pintar y los que cruzan el plano cercano se recortan
+	 *
+	 * @param 	- model - Matriz mundo del oclusor
+	 * @param 	- positions - Posiciones locales de los vertices
+	 * @param 	- indices - Tres indices por triangulo
+	 */
+	void RasterizeMesh(const glm::mat4& model, std::vector<glm::vec3>* positions, std::vector<unsigned int>* indices);
+
+	/**
+	 * @brief	- Rasteriza un triangulo ya en coordenadas de clip
+	 */
+	void RasterizeTriangle(glm::vec4 v0, glm::vec4 v1, glm::vec4 v2);
+
+	/**
+	 * @brief	- Construye la jerarquia de profundidades minimas y maximas si se ha rasterizado algo nuevo
+	 */
+	void BuildHierarchy();
+
+	/**
+	 * @brief	- Comprueba si una caja mundo queda detras de los oclusores rasterizados
+	 * 				Si la jerarquia no esta al dia se construye antes
+	 *
+	 * @param 	- min - Esquina minima de la caja
+	 * @param 	- max - Esquina maxima de la caja
+	 * @return 	- bool - False si la caja esta tapada seguro, true si puede verse
+	 */
+	bool TestBox(glm::vec3 min, glm::vec3 max);
+
+	/**
+	 * @brief	- Devuelve la profundidad (0 cerca, 1 lejos) guardada en un pixel del nivel indicado
+	 *
+	 * @param 	- level - Nivel de la jerarquia (0 es el buffer completo)
+	 * @param 	- maxDepth - Devuelve la profundidad maxima, si no la minima
+	 */
+	float GetDepth(int x, int y, int level = 0, bool maxDepth = true);
+
+	/**
+	 * @brief	- Devuelven el tamanyo del buffer y el numero de niveles de la jerarquia
+	 */
+	int GetWidth();
+	int GetHeight();
+	int GetLevelCount();
+
+	/**
+	 * @brief	- Devuelve el numero de triangulos rasterizados desde el ultimo Clear
+	 */
+	int GetTriangleCount();
+
+private:
+	/**
+	 * @brief	- Rasteriza un triangulo ya proyectado a pixeles, 4 pixeles por iteracion con SSE
+	 *
+	 * @param 	- p0, p1, p2 - Posicion en pixeles (x, y) y profundidad (z) de los vertices en sentido antihorario
+	 */
+	void RasterizeScreenTriangle(glm::vec3 p0, glm::vec3 p1, glm::vec3 p2);
+
+	/**
+	 * @brief	- Pasa un vertice de coordenadas de clip a pixeles y profundidad [0, 1]
+	 */
+	glm::vec3 ToScreen(glm::vec4 clip);
+
+	struct TOcclusionLevel{
+		int					width;		// width - Ancho del nivel en pixeles
+		int					height;		// height - Alto del nivel en pixeles
+		std::vector<float>	minDepth;	// minDepth - Profundidad minima de los pixeles que cubre cada pixel del nivel
+		std::vector<float>	maxDepth;	// maxDepth - Profundidad maxima de los pixeles que cubre cada pixel del nivel
+	};
+
+	int							m_width;			// m_width - Ancho del buffer, multiplo de 4
+	int							m_height;			// m_height - Alto del buffer
+	std::vector<float>			m_depth;			// m_depth - Profundidad del oclusor mas cercano de cada pixel (fila 0 abajo)
+	std::vector<TOcclusionLevel>	m_levels;		// m_levels - Jerarquia de profundidades, el nivel 0 comparte tamanyo con el buffer
+	std::vector<int>			m_stack;			// m_stack - Pila reutilizada al recorrer la jerarquia (nivel, x, y)
+	glm::mat4					m_viewProj;			// m_viewProj - Camara con la que se rasteriza
+	bool						m_hierarchyDirty;	// m_hierarchyDirty - Se ha rasterizado algo desde la ultima jerarquia
+	int							m_triangleCount;	// m_triangleCount - Triangulos rasterizados desde el ultimo Clear
+};
+
+#endif
@@ -0,0 +1,87 @@
+#include "TParticlePool.h"
+#include <new>
+
+#define PARTICLE_POOL_MIN_CLASS	10		// El bloque mas pequenyo es de 1 KB (2^10)
+#define PARTICLE_POOL_CLASSES	48		// Clases de tamanyo, hasta 2^57 bytes
+#define PARTICLE_POOL_ALIGNMENT	32		// Los bloques se alinean al tamanyo de un registro AVX
+#define PARTICLE_POOL_MAX_FREE	(64ull << 20)	// A partir de 64 MB libres se liberan los bloques mas grandes
+
+TParticlePool* TParticlePool::GetInstance(){
+	static TParticlePool instance;
+	return &instance;
+}
+
+TParticlePool::TParticlePool(){
+	m_free.resize(PARTICLE_POOL_CLASSES);
+	m_usedBytes = 0;
+	m_freeBytes = 0;
+}
+
+TParticlePool::~TParticlePool(){
+	Trim();
+}
+
+int TParticlePool::GetSizeClass(unsigned long long bytes){
+	int sizeClass = 0;
+	while((1ull << (sizeClass + PARTICLE_POOL_MIN_CLASS)) < bytes) sizeClass++;
+	return sizeClass;
+}
+
+unsigned char* TParticlePool::Allocate(unsigned long long bytes, unsigned long long* size){
+	int sizeClass = GetSizeClass(bytes);
+	*size = 1ull << (sizeClass + PARTICLE_POOL_MIN_CLASS);
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_usedBytes += *size;
+
+	// Si otro sistema ha dejado un bloque de este tamanyo se reutiliza
+	std::vector<unsigned char*>& blocks = m_free[sizeClass];
+	if(!blocks.empty()){
+		unsigned char* block = blocks.back();
+		blocks.pop_back();
+		m_freeBytes -= *size;
+		return block;
+	}
+	return (unsigned char*)::operator new(*size, std::align_val_t(PARTICLE_POOL_ALIGNMENT));
+}
+
+void TParticlePool::Release(int sizeClass){
+	unsigned char* block = m_free[sizeClass].back();
+	m_free[sizeClass].pop_back();
+	m_freeBytes -= 1ull << (sizeClass + PARTICLE_POOL_MIN_CLASS);
+	::operator delete(block, std::align_val_t(PARTICLE_POOL_ALIGNMENT));
+}
+
+void TParticlePool::Free(unsigned char* block, unsigned long long size){
+	if(block == nullptr) return;
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_free[GetSizeClass(size)].push_back(block);
+	m_usedBytes -= size;
+	m_freeBytes += size;
+
+	// Para que un pico de particulas no deje la memoria retenida para siempre, empezando por los bloques mas grandes
+	for(int i=PARTICLE_POOL_CLASSES-1; i>=0 && m_freeBytes > PARTICLE_POOL_MAX_FREE; i--){
+		while(!m_free[i].empty() && m_freeBytes > PARTICLE_POOL_MAX_FREE) Release(i);
+	}
+}
+
+unsigned long long TParticlePool::Trim(){
+	std::lock_guard<std::mutex> lock(m_mutex);
+	unsigned long long freed = m_freeBytes;
+
+	for(int i=0; i<PARTICLE_POOL_CLASSES; i++){
+		while(!m_free[i].empty()) Release(i);
+	}
+	return freed;
+}
+
+unsigned long long TParticlePool::GetUsedBytes(){
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_usedBytes;
+}
+
+unsigned long long TParticlePool::GetFreeBytes(){
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_freeBytes;
+}
\ No newline at end of file
@@ -0,0 +1,80 @@
+#ifndef TPARTICLEPOOL_H
+#define TPARTICLEPOOL_H
+
+/**
+ * @brief Memory shared by every particle system: blocks in power of two sizes that are kept when a system
+ * 		  grows or is deleted and reused by the next one that needs that size.
+ *
+ * @file TParticlePool.h
+ */
+
+#include <vector>
+#include <mutex>
+
+class TParticlePool{
+public:
+	/**
+	 * @brief	- Devuelve la instancia del pool
+	 */
+	static TParticlePool* GetInstance();
+
+	/**
+	 * @brief	- Destructor, libera todos los bloques
+	 */
+	~TParticlePool();
+
+	/**
+	 * @brief	- Da un bloque de al menos los bytes pedidos, reutilizando uno libre si lo hay
+	 *
+	 * @param 	- bytes - Bytes que se necesitan
+	 * @param 	- size - Bytes que tiene de verdad el bloque (potencia de 2)
+	 * @return 	- unsigned char* - Bloque, alineado a 32 bytes
+	 */
+	unsigned char* Allocate(unsigned long long bytes, unsigned long long* size);
+
+	/**
+	 * @brief	- Devuelve un bloque al pool para que lo use otro sistema
+	 * 				Si los bloques libres pasan de 64 MB se liberan los mas grandes
+	 *
+	 * @param 	- block - Bloque a devolver
+	 * @param 	- size - Tamanyo que dio Allocate
+	 */
+	void Free(unsigned char* block, unsigned long long size);
+
+	/**
+	 * @brief	- Libera de verdad los bloques que no esta usando nadie (p.e. al cambiar de nivel)
+	 *
+	 * @return 	- unsigned long long - Bytes liberados
+	 */
+	unsigned long long Trim();
+
+	/**
+	 * @brief	- Devuelve los bytes de los bloques que estan usando los sistemas
+	 */
+	unsigned long long GetUsedBytes();
+
+	/**
+	 * @brief	- Devuelve los bytes de los bloques libres guardados para reutilizar
+	 */
+	unsigned long long GetFreeBytes();
+
+private:
+	TParticlePool();
+
+	/**
+	 * @brief	- Devuelve la clase de tamanyo (potencia de 2) donde caben los bytes
+	 */
+	static int GetSizeClass(unsigned long long bytes);
+
+	/**
+	 * @brief	- Libera el ultimo bloque libre de la clase de tamanyo, con el mutex ya cogido
+	 */
+	void Release(int sizeClass);
+
+	std::vector<std::vector<unsigned char*>>	m_free;			// m_free - Bloques libres de cada clase de tamanyo
+	unsigned long long							m_usedBytes;	// m_usedBytes - Bytes dados y no devueltos
+	unsigned long long							m_freeBytes;	// m_freeBytes - Bytes de los bloques libres
+	std::mutex									m_mutex;		// m_mutex - Los sistemas se crean y se borran desde cualquier hilo
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,99 @@
+#include "TPathTable.h"
+
+#define PATH_TABLE_START 256	// Casillas iniciales de la tabla, potencia de 2
+
+TPathTable::TPathTable(){
+	m_paths.push_back("");		// El id 0 es NO_RESOURCE_ID
+	m_hashes.push_back(0);
+	m_slots.assign(PATH_TABLE_START, NO_RESOURCE_ID);
+}
+
+TResourceId TPathTable::Intern(const std::string& path){
+	Normalize(path, &m_buffer);
+	unsigned int hash = Hash(m_buffer);
+	unsigned int slot = FindSlot(m_buffer, hash);
+	if(m_slots[slot] != NO_RESOURCE_ID) return m_slots[slot];
+
+	// Ruta nueva, se mantiene la tabla como mucho a la mitad
+	TResourceId id = m_paths.size();
+	m_paths.push_back(m_buffer);
+	m_hashes.push_back(hash);
+	m_slots[slot] = id;
+	if(m_paths.size() * 2 > m_slots.size()) Grow();
+	return id;
+}
+
+TResourceId TPathTable::Find(const std::string& path){
+	Normalize(path, &m_buffer);
+	return m_slots[FindSlot(m_buffer, Hash(m_buffer))];
+}
+
+const std::string& TPathTable::GetPath(TResourceId id){
+	if(id >= m_paths.size()) return m_paths[NO_RESOURCE_ID];
+	return m_paths[id];
+}
+
+unsigned int TPathTable::GetCount(){
+	return m_paths.size() - 1;
+}
+
+void TPathTable::Normalize(const std::string& path, std::string* output){
+	std::string& newName = *output;
+	newName.assign(path);		// Reutiliza la memoria que ya tenia
+	if(newName.empty()) return;
+
+	std::string toSearch = "./";	//Pattern to delete (cabe sin reservar memoria)
+	int pos = 0;
+
+	do {
+		pos = newName.find(toSearch, pos);
+		bool erase = true;
+
+		if (pos == -1) erase = false; 								//If not found
+		else if (pos == 0) erase = true;							//If first position
+		else if (newName.at(pos-1) != '.') erase = true;			//If hasnt dot behind
+		else if (newName.at(pos-1) == '.') {erase = false; pos++;}	//If has dot behind
+
+		//Erase the current position and next (./)
+		if (erase) newName.erase(pos,2);
+	} while (pos != -1); // While we find "./"
+
+	//If there's a slash at the begining, erase it
+	if (!newName.empty() && newName.at(0) == '/') newName.erase(0,1);
+
+	//Erase the slashes at the end
+	while (!newName.empty() && newName.at(newName.length()-1) == '/') newName.erase(newName.length()-1,1);
+}
+
+unsigned int TPathTable::Hash(const std::string& path){
+	unsigned int hash = 2166136261u;
+	int size = path.length();
+	for(int i=0; i<size; i++){
+		hash ^= (unsigned char)path[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+unsigned int TPathTable::FindSlot(const std::string& path, unsigned int hash){
+	// Sondeo lineal, la tabla nunca se llena
+	unsigned int mask = m_slots.size() - 1;
+	unsigned int slot = hash & mask;
+	while(m_slots[slot] != NO_RESOURCE_ID){
+		TResourceId id = m_slots[slot];
+		if(m_hashes[id] == hash && m_paths[id] == path) break;
+		slot = (slot + 1) & mask;
+	}
+	return slot;
+}
+
+void TPathTable::Grow(){
+	m_slots.assign(m_slots.size() * 2, NO_RESOURCE_ID);
+	unsigned int mask = m_slots.size() - 1;
+	int size = m_paths.size();
+	for(int id=1; id<size; id++){
+		unsigned int slot = m_hashes[id] & mask;
+		while(m_slots[slot] != NO_RESOURCE_ID) slot = (slot + 1) & mask;
+		m_slots[slot] = id;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,79 @@
+#ifndef TPATHTABLE_H
+#define TPATHTABLE_H
+
+/**
+ * @brief Interns the resource paths of the TResourceManager. Every treated path gets
+ * 		  a stable 32-bit id once, later lookups hash the path in a flat table without allocating.
+ *
+ * @file TPathTable.h
+ */
+
+#include <ResourceTypes.h>
+#include <vector>
+#include <string>
+
+class TPathTable{
+public:
+	/**
+	 * @brief	- Tabla vacia
+	 */
+	TPathTable();
+
+	/**
+	 * @brief	- Devuelve el id de la ruta, si no existia le da uno nuevo
+	 * 				Solo reserva memoria la primera vez que ve la ruta
+	 *
+	 * @param 	- path - Ruta sin tratar
+	 * @return 	- TResourceId - Id de la ruta tratada
+	 */
+	TResourceId Intern(const std::string& path);
+
+	/**
+	 * @brief	- Busca el id de la ruta sin anyadirla ni reservar memoria
+	 *
+	 * @param 	- path - Ruta sin tratar
+	 * @return 	- TResourceId - Id de la ruta tratada, NO_RESOURCE_ID si no esta
+	 */
+	TResourceId Find(const std::string& path);
+
+	/**
+	 * @brief	- Devuelve la ruta tratada de un id
+	 */
+	const std::string& GetPath(TResourceId id);
+
+	/**
+	 * @brief	- Devuelve el numero de rutas, los ids van de 1 a GetCount()
+	 */
+	unsigned int GetCount();
+
+	/**
+	 * @brief	- Trata la ruta: quita los "./" que sobran, la barra del principio y las del final
+	 *
+	 * @param 	- path - Ruta sin tratar
+	 * @param 	- output - Ruta tratada, reutiliza su memoria
+	 */
+	static void Normalize(const std::string& path, std::string* output);
+
+private:
+	/**
+	 * @brief	- FNV-1a de 32 bits de la ruta
+	 */
+	static unsigned int Hash(const std::string& path);
+
+	/**
+	 * @brief	- Devuelve la casilla de la tabla con la ruta o la casilla vacia donde iria
+	 */
+	unsigned int FindSlot(const std::string& path, unsigned int hash);
+
+	/**
+	 * @brief	- Duplica la tabla y vuelve a colocar todos los ids
+	 */
+	void Grow();
+
+	std::vector<std::string> m_paths;	// m_paths - Ruta tratada de cada id, el 0 no se usa
+	std::vector<unsigned int> m_hashes;	// m_hashes - Hash de cada id, para no volver a calcularlo al crecer
+	std::vector<TResourceId> m_slots;	// m_slots - Tabla abierta de ids (potencia de 2), NO_RESOURCE_ID en las vacias
+	std::string m_buffer;				// m_buffer - Donde se trata la ruta buscada, mantiene su memoria entre busquedas
+};
+
+#endif
\ No newline at end of file
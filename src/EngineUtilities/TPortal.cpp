@@ -64,9 +64,9 @@ bool TPortal::CheckVisibility(){
 	}else{	
 		PrepareLimits();
 
-		// NOTA: Se supone que el m_stack.top() debe estar como identidad, sin aplicar ninguna transformacion
+		// NOTA: Las habitaciones y los portales se pintan sin ninguna transformacion por encima
 		// Calculamos la matriz MVP del portal
-		glm::mat4 mvp = TEntity::ProjMatrix * TEntity::ViewMatrix * TEntity::m_stack.top() * m_transform;
+		glm::mat4 mvp = TEntity::ProjMatrix * TEntity::ViewMatrix * m_transform;
 
 		int upDown, leftRight, nearFar;
 		upDown = leftRight = nearFar = 0;
@@ -194,16 +194,16 @@ void TPortal::DrawDebug(){
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 	
 	// Apply object's transformation matrix 
-	glm::mat4 m = TEntity::ProjMatrix * TEntity::ViewMatrix * TEntity::m_stack.top() * m_transform;
-	GLuint uniform_m = glGetUniformLocation(myProgram->GetProgramID(), "MVP");
+	glm::mat4 m = TEntity::ProjMatrix * TEntity::ViewMatrix * m_transform;
+	GLuint uniform_m = myProgram->GetUniformLocation(MVP_UNIFORM);
 	glUniformMatrix4fv(uniform_m, 1, GL_FALSE, &m[0][0]);
 
 	// Send light color
-	GLuint linecolor = glGetUniformLocation(myProgram->GetProgramID(), "LineColor");
+	GLuint linecolor = myProgram->GetUniformLocation(LINECOLOR_UNIFORM);
 	glUniform3fv(linecolor, 1, glm::value_ptr(glm::vec3(0.0f, 1.0f, 0.0f)));
 
 	// Send each vertex data
-	GLuint attribute_v_coord = glGetAttribLocation(myProgram->GetProgramID(), "VertexPosition");	
+	GLuint attribute_v_coord = myProgram->GetAttribLocation(VERTEXPOSITION_ATTRIB);	
 	glBindBuffer(GL_ARRAY_BUFFER, vbo_vertices);
 	glEnableVertexAttribArray(attribute_v_coord);
 
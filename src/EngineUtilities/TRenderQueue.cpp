@@ -0,0 +1,221 @@
+#include "./TRenderQueue.h"
+#include "./Entities/TEntity.h"
+#include "./Resources/TResourceMesh.h"
+#include "./TStreamBuffer.h"
+#include <GL/glew.h>
+#include <algorithm>
+#include <cstdint>
+
+TRenderQueue* TRenderQueue::GetInstance(){
+	static TRenderQueue instance;
+	return &instance;
+}
+
+TRenderQueue::TRenderQueue(){
+	m_recording = 0;
+	m_lastDrawCount = 0;
+	m_lastInstancedCount = 0;
+	m_defaultVao = 0;
+	for(unsigned int i=0; i<m_textureUnits; i++) m_boundTextures[i] = (GLuint)-1;
+	m_boundMesh = nullptr;
+	m_materialProgram = NONE_SHADER;
+	m_boundMaterial = nullptr;
+}
+
+TRenderQueue::~TRenderQueue(){
+	m_records.clear();
+}
+
+void TRenderQueue::Begin(){
+	m_recording++;
+}
+
+void TRenderQueue::End(){
+	if(m_recording > 0) m_recording--;
+	if(m_recording == 0) Flush();
+}
+
+bool TRenderQueue::IsRecording(){
+	return m_recording > 0;
+}
+
+void TRenderQueue::Push(TEntity* entity, unsigned long long key, bool sharesState){
+	// Si nadie ha abierto la cola pintamos directamente como antes
+	if(m_recording == 0){
+		ResetState();
+		entity->DrawQueued();
+		ResetState();
+		return;
+	}
+
+	TDrawRecord record;
+	record.key = key;
+	record.entity = entity;
+	record.model = TEntity::ModelMatrix;
+	record.sharesState = sharesState;
+	m_records.push_back(record);
+}
+
+void TRenderQueue::Flush(){
+	// Entre grabar y pintar se ha podido cambiar el estado de OpenGL
+	ResetState();
+
+	// Ordenacion estable para que los registros con la misma clave mantengan el orden del arbol
+	std::stable_sort(m_records.begin(), m_records.end(), [](const TDrawRecord& a, const TDrawRecord& b){
+		return a.key < b.key;
+	});
+
+	int instanced = 0;
+	int size = m_records.size();
+	int i = 0;
+	while(i < size){
+		TDrawRecord& record = m_records[i];
+
+		// Los registros iguales seguidos solo cambian en la profundidad
+		// La clave puede colisionar, asi que la entidad confirma que comparte todo el estado
+		int last = i + 1;
+		if(record.sharesState){
+			unsigned long long state = GetStateKey(record.key);
+			while(last < size && m_records[last].sharesState && GetStateKey(m_records[last].key) == state
+				&& record.entity->CanInstanceWith(m_records[last].entity)) last++;
+		}
+
+		if(last - i >= m_minInstances){
+			m_instanceModels.clear();
+			for(int j=i; j<last; j++) m_instanceModels.push_back(m_records[j].model);
+
+			TEntity::ModelMatrix = record.model;
+			record.entity->DrawInstanced(&m_instanceModels);
+			instanced++;
+		}
+		else{
+			TEntity::ModelMatrix = record.model;
+
+			// Las entidades que no usan la cache pintan con el VAO por defecto y pueden dejar otro estado enlazado
+			if(!record.sharesState && m_boundMesh != nullptr) ResetState();
+			record.entity->DrawQueued();
+			if(!record.sharesState) ResetState();
+			last = i + 1;
+		}
+
+		i = last;
+	}
+
+	// Dejamos enlazado el VAO por defecto para lo que se pinte fuera de la cola
+	ResetState();
+
+	m_lastDrawCount = size;
+	m_lastInstancedCount = instanced;
+	m_records.clear();
+}
+
+unsigned int TRenderQueue::GetDepth(){
+	glm::vec4 clip = TEntity::ProjMatrix * TEntity::ViewMatrix * TEntity::ModelMatrix * glm::vec4(0,0,0,1);
+	if(clip.w <= 0.0f) return 0;
+
+	float depth = (clip.z / clip.w + 1.0f) / 2.0f;	// Pasamos de [-1,1] a [0,1]
+	depth = std::min(std::max(depth, 0.0f), 1.0f);
+	return (unsigned int)(depth * 0xFFF);
+}
+
+unsigned long long TRenderQueue::MakeKey(RENDERLAYER layer, SHADERTYPE program, TResourceMaterial* material, unsigned int textures, unsigned int mesh){
+	unsigned long long materialId = (((uintptr_t)material) >> 4) & 0xFF;
+	unsigned long long depth = GetDepth();
+	if(layer == TRANSPARENT_LAYER) depth = 0xFFF - depth;	// Las transparencias de detras hacia delante
+
+	unsigned long long key = 0;
+	key |= ((unsigned long long)layer & 0xF) << 60;
+
+	// Las transparencias se ordenan primero por profundidad y despues por estado, para que se mezclen bien
+	if(layer == TRANSPARENT_LAYER){
+		key |= (depth & 0xFFF) << 48;
+		key |= ((unsigned long long)(program + 1) & 0xFF) << 40;
+		key |= materialId << 32;
+		key |= ((unsigned long long)textures & 0xFFFF) << 16;
+		key |= (unsigned long long)mesh & 0xFFFF;
+		return key;
+	}
+
+	key |= ((unsigned long long)(program + 1) & 0xFF) << 52;
+	key |= materialId << 44;
+	key |= ((unsigned long long)textures & 0xFFFF) << 28;
+	key |= ((unsigned long long)mesh & 0xFFFF) << 12;
+	key |= depth & 0xFFF;
+	return key;
+}
+
+unsigned long long TRenderQueue::GetStateKey(unsigned long long key){
+	if((key >> 60) == TRANSPARENT_LAYER) return key & ~(0xFFFull << 48);
+	return key & ~0xFFFull;
+}
+
+unsigned int TRenderQueue::MakeTextureSet(GLuint texture0, GLuint texture1, GLuint texture2){
+	return (texture0 ^ (texture1 << 5) ^ (texture2 << 10)) & 0xFFFF;
+}
+
+bool TRenderQueue::BindTexture(unsigned int unit, GLuint texture){
+	if(unit < m_textureUnits && m_boundTextures[unit] == texture) return false;
+
+	glActiveTexture(GL_TEXTURE0 + unit);
+	glBindTexture(GL_TEXTURE_2D, texture);
+	if(unit < m_textureUnits) m_boundTextures[unit] = texture;
+	return true;
+}
+
+bool TRenderQueue::BindMesh(TResourceMesh* mesh){
+	if(m_boundMesh == mesh) return false;
+	glBindVertexArray(mesh->GetVertexArray());
+	m_boundMesh = mesh;
+	return true;
+}
+
+bool TRenderQueue::UseMaterial(SHADERTYPE program, TResourceMaterial* material){
+	if(m_materialProgram == program && m_boundMaterial == material) return false;
+	m_materialProgram = program;
+	m_boundMaterial = material;
+	return true;
+}
+
+void TRenderQueue::BindInstances(std::vector<glm::mat4>* models){
+	// Las matrices se escriben en el TStreamBuffer, sin esperar al pintado anterior
+	TStreamBuffer* stream = TStreamBuffer::GetInstance();
+	GLintptr offset = stream->Push(&models->at(0)[0][0], models->size() * sizeof(glm::mat4));
+	glBindBuffer(GL_ARRAY_BUFFER, stream->GetBuffer());
+
+	// Una mat4 ocupa cuatro localizaciones consecutivas, una por columna
+	for(int i=0; i<4; i++){
+		GLuint location = MESH_INSTANCE_LOCATION + i;
+		glEnableVertexAttribArray(location);
+		glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void*)(offset + i * sizeof(glm::vec4)));
+		glVertexAttribDivisor(location, 1);
+	}
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void TRenderQueue::UnbindInstances(){
+	for(int i=0; i<4; i++){
+		GLuint location = MESH_INSTANCE_LOCATION + i;
+		glVertexAttribDivisor(location, 0);
+		glDisableVertexAttribArray(location);
+	}
+}
+
+void TRenderQueue::ResetState(){
+	for(unsigned int i=0; i<m_textureUnits; i++) m_boundTextures[i] = (GLuint)-1;	// Ninguna textura conocida
+	m_boundMesh = nullptr;
+	m_materialProgram = NONE_SHADER;
+	m_boundMaterial = nullptr;
+	glBindVertexArray(m_defaultVao);
+}
+
+void TRenderQueue::SetDefaultVertexArray(GLuint vao){
+	m_defaultVao = vao;
+}
+
+int TRenderQueue::GetLastDrawCount(){
+	return m_lastDrawCount;
+}
+
+int TRenderQueue::GetLastInstancedCount(){
+	return m_lastInstancedCount;
+}
@@ -0,0 +1,191 @@
+#ifndef TRENDERQUEUE_H
+#define TRENDERQUEUE_H
+
+/**
+ * @brief Queue of draw records sorted by render state before being submitted.
+ *
+ * @file TRenderQueue.h
+ */
+
+#include <ShaderTypes.h>
+#include <glm/mat4x4.hpp>
+#include <vector>
+
+typedef unsigned int GLuint;
+
+class TEntity;
+class TResourceMesh;
+class TResourceMaterial;
+
+enum RENDERLAYER {
+	BACKGROUND_LAYER	= 0,	// Se pinta antes que nada y sin escribir en el ZBuffer (dome)
+	OPAQUE_LAYER		= 1,	// Objetos opacos, se pintan de delante hacia atras
+	TRANSPARENT_LAYER	= 2		// Objetos con transparencia, se pintan de detras hacia delante
+};
+
+struct TDrawRecord{
+	unsigned long long	key;			// key - Clave por la que se ordena el registro
+	TEntity*			entity;			// entity - Entidad a pintar
+	glm::mat4			model;			// model - Matriz mundo con la que se pinta la entidad
+	bool				sharesState;	// sharesState - La entidad usa la cache de estado de la cola
+};
+
+class TRenderQueue{
+public:
+	/**
+	 * @brief	- Devuelve la instancia de la cola de pintado
+	 */
+	static TRenderQueue* GetInstance();
+
+	/**
+	 * @brief	- Destructor de la cola de pintado
+	 */
+	~TRenderQueue();
+
+	/**
+	 * @brief	- Empieza a guardar registros de pintado en vez de pintar directamente
+	 * 				Se puede anidar, solo se pinta al cerrar el ultimo Begin
+	 */
+	void Begin();
+
+	/**
+	 * @brief	- Deja de guardar registros, en el caso de ser el ultimo los ordena y los pinta
+	 */
+	void End();
+
+	/**
+	 * @brief	- Anyade una entidad a la cola con la matriz TEntity::ModelMatrix actual
+	 * 				Si la cola no esta grabando la entidad se pinta directamente
+	 *
+	 * @param 	- entity - Entidad a pintar
+	 * @param 	- key - Clave de ordenacion, ver MakeKey
+	 * @param 	- sharesState - La entidad utiliza BindTexture/BindMesh/UseMaterial y no ensucia otro estado
+	 */
+	void Push(TEntity* entity, unsigned long long key, bool sharesState = false);
+
+	/**
+	 * @brief	- Indica si la cola esta guardando registros
+	 *
+	 * @return 	- bool - Hay algun Begin abierto
+	 */
+	bool IsRecording();
+
+	/**
+	 * @brief	- Construye la clave de ordenacion de 64 bits
+	 * 				capa (4) | programa (8) | material (8) | texturas (16) | mesh (16) | profundidad (12)
+	 * 				En la capa transparente: capa (4) | profundidad invertida (12) | programa | material | texturas | mesh
+	 *
+	 * @param 	- layer - Capa en la que se pinta la entidad
+	 * @param 	- program - Shader con el que se pinta
+	 * @param 	- material - Material de la entidad (puede ser nullptr)
+	 * @param 	- textures - Id combinado del set de texturas, ver MakeTextureSet
+	 * @param 	- mesh - Id del mesh o del buffer que se pinta
+	 * @return 	- unsigned long long - Clave de ordenacion
+	 */
+	static unsigned long long MakeKey(RENDERLAYER layer, SHADERTYPE program, TResourceMaterial* material, unsigned int textures, unsigned int mesh);
+
+	/**
+	 * @brief	- Combina los ids de hasta tres texturas en un unico id para la clave
+	 */
+	static unsigned int MakeTextureSet(GLuint texture0, GLuint texture1 = 0, GLuint texture2 = 0);
+
+	/**
+	 * @brief	- Enlaza la textura en la unidad indicada solo si no estaba ya enlazada
+	 *
+	 * @param 	- unit - Unidad de textura (0 a 3)
+	 * @param 	- texture - Id de la textura de OpenGL
+	 * @return 	- bool - Se ha tenido que enlazar la textura
+	 */
+	bool BindTexture(unsigned int unit, GLuint texture);
+
+	/**
+	 * @brief	- Enlaza el VAO del mesh solo si no era el ultimo enlazado
+	 *
+	 * @param 	- mesh - Mesh a pintar
+	 * @return 	- bool - Se ha tenido que enlazar el VAO
+	 */
+	bool BindMesh(TResourceMesh* mesh);
+
+	/**
+	 * @brief	- Indica si hay que volver a enviar los uniforms del material
+	 *
+	 * @param 	- program - Shader con el que se pinta el material
+	 * @param 	- material - Material a enviar
+	 * @return 	- bool - El material o el programa son distintos a los del ultimo pintado
+	 */
+	bool UseMaterial(SHADERTYPE program, TResourceMaterial* material);
+
+	/**
+	 * @brief	- Escribe las matrices mundo en el TStreamBuffer y las enlaza como atributo por instancia
+	 * 				en el VAO enlazado (localizaciones MESH_INSTANCE_LOCATION a MESH_INSTANCE_LOCATION + 3)
+	 *
+	 * @param 	- models - Matrices mundo de cada instancia
+	 */
+	void BindInstances(std::vector<glm::mat4>* models);
+
+	/**
+	 * @brief	- Desactiva el atributo por instancia en el VAO enlazado para que los pintados normales no lo lean
+	 */
+	void UnbindInstances();
+
+	/**
+	 * @brief	- Olvida el estado enlazado y vuelve a enlazar el VAO por defecto
+	 * 				Se llama cuando alguien cambia el estado de OpenGL por su cuenta
+	 */
+	void ResetState();
+
+	/**
+	 * @brief	- Guarda el VAO por defecto que utilizan las entidades sin VAO propio
+	 *
+	 * @param 	- vao - VAO por defecto de la escena
+	 */
+	void SetDefaultVertexArray(GLuint vao);
+
+	/**
+	 * @brief	- Devuelve el numero de registros pintados en el ultimo vaciado de la cola
+	 */
+	int GetLastDrawCount();
+
+	/**
+	 * @brief	- Devuelve el numero de llamadas de pintado instanciadas del ultimo vaciado de la cola
+	 */
+	int GetLastInstancedCount();
+
+private:
+	/**
+	 * @brief	- Constructor privado de la cola
+	 */
+	TRenderQueue();
+
+	/**
+	 * @brief	- Ordena los registros y los pinta saltando los cambios de estado repetidos
+	 */
+	void Flush();
+
+	/**
+	 * @brief	- Devuelve la profundidad del origen de la entidad actual en la pantalla cuantizada a 12 bits
+	 */
+	static unsigned int GetDepth();
+
+	/**
+	 * @brief	- Devuelve la clave sin la profundidad, igual para los registros que comparten estado
+	 */
+	static unsigned long long GetStateKey(unsigned long long key);
+
+	std::vector<TDrawRecord>	m_records;			// m_records - Registros pendientes de pintar
+	int							m_recording;		// m_recording - Numero de Begin abiertos
+	int							m_lastDrawCount;	// m_lastDrawCount - Registros pintados en el ultimo vaciado
+	int							m_lastInstancedCount;	// m_lastInstancedCount - Grupos instanciados en el ultimo vaciado
+
+	static const int			m_minInstances = 2;	// m_minInstances - Registros iguales a partir de los que se instancia
+	std::vector<glm::mat4>		m_instanceModels;	// m_instanceModels - Matrices del grupo que se esta pintando
+
+	static const unsigned int	m_textureUnits = 4;
+	GLuint						m_boundTextures[m_textureUnits];	// m_boundTextures - Textura enlazada en cada unidad
+	TResourceMesh*				m_boundMesh;		// m_boundMesh - Mesh con el VAO enlazado
+	GLuint						m_defaultVao;		// m_defaultVao - VAO por defecto de la escena
+	SHADERTYPE					m_materialProgram;	// m_materialProgram - Programa al que se envio el material
+	TResourceMaterial*			m_boundMaterial;	// m_boundMaterial - Ultimo material enviado
+};
+
+#endif
@@ -0,0 +1,10 @@
+#include "TResourceHandle.h"
+#include "TResourceManager.h"
+
+void TResourceHandleBase::Acquire(TResource* resource){
+	if(resource != nullptr) resource->AddReference();
+}
+
+void TResourceHandleBase::Release(TResource* resource){
+	if(resource != nullptr) TResourceManager::GetInstance()->ReleaseReference(resource);
+}
\ No newline at end of file
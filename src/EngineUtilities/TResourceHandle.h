@@ -0,0 +1,120 @@
+#ifndef TRESOURCEHANDLE_H
+#define TRESOURCEHANDLE_H
+
+/**
+ * @brief Reference-counted handle to a resource of the TResourceManager. The resource is destroyed when the last handle goes away, unless it is pinned.
+ *
+ * @file TResourceHandle.h
+ */
+
+#include "Resources/TResource.h"
+#include <cstddef>
+
+/**
+ * @brief 	- Parte comun de todos los handles, avisa al TResourceManager al soltar la ultima referencia
+ */
+class TResourceHandleBase{
+protected:
+	/**
+	 * @brief	- Anyade una referencia al recurso (si no es nullptr)
+	 */
+	static void Acquire(TResource* resource);
+
+	/**
+	 * @brief	- Quita una referencia al recurso, si era la ultima y no esta fijado el TResourceManager lo elimina
+	 */
+	static void Release(TResource* resource);
+};
+
+template <class T>
+class TResourceHandle: private TResourceHandleBase{
+public:
+	/**
+	 * @brief	- Handle vacio
+	 */
+	TResourceHandle(){
+		m_resource = nullptr;
+	}
+
+	/**
+	 * @brief	- Handle a un recurso, le anyade una referencia
+	 *
+	 * @param 	- resource - Recurso del TResourceManager o nullptr
+	 */
+	TResourceHandle(T* resource){
+		m_resource = resource;
+		Acquire(m_resource);
+	}
+
+	TResourceHandle(const TResourceHandle& other){
+		m_resource = other.m_resource;
+		Acquire(m_resource);
+	}
+
+	TResourceHandle(TResourceHandle&& other){
+		m_resource = other.m_resource;
+		other.m_resource = nullptr;
+	}
+
+	/**
+	 * @brief	- Suelta la referencia, puede eliminar el recurso
+	 */
+	~TResourceHandle(){
+		Release(m_resource);
+	}
+
+	TResourceHandle& operator=(const TResourceHandle& other){
+		// Primero se coge la nueva por si es el mismo recurso
+		T* previous = m_resource;
+		m_resource = other.m_resource;
+		Acquire(m_resource);
+		Release(previous);
+		return *this;
+	}
+
+	TResourceHandle& operator=(TResourceHandle&& other){
+		if(this == &other) return *this;
+		T* previous = m_resource;
+		m_resource = other.m_resource;
+		other.m_resource = nullptr;
+		Release(previous);
+		return *this;
+	}
+
+	/**
+	 * @brief	- Devuelve el recurso sin anyadir una referencia, solo es valido mientras exista el handle
+	 */
+	T* Get() const{
+		return m_resource;
+	}
+
+	T* operator->() const{
+		return m_resource;
+	}
+
+	T& operator*() const{
+		return *m_resource;
+	}
+
+	/**
+	 * @brief	- Se puede usar como puntero mientras exista el handle
+	 * 				Desde un handle temporal no compila, el recurso se eliminaria al acabar la linea
+	 */
+	operator T*() const &{
+		return m_resource;
+	}
+	operator T*() const && = delete;
+
+	bool operator==(std::nullptr_t) const{
+		return m_resource == nullptr;
+	}
+
+	bool operator!=(std::nullptr_t) const{
+		return m_resource != nullptr;
+	}
+
+private:
+	T* m_resource;	// m_resource - Recurso al que apunta, nullptr si esta vacio
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,234 @@
+#include "TResourceLoader.h"
+#include "Resources/TResource.h"
+
+#include <algorithm>
+#include <chrono>
+
+TResourceLoader::TResourceLoader(){
+	m_stop = false;
+	m_uploadBytes = 8 << 20;	// 8 MB por frame
+	m_uploadTime = 2.0f;		// 2 ms por frame
+}
+
+TResourceLoader::~TResourceLoader(){
+	Clear();
+}
+
+void TResourceLoader::Clear(){
+	StopThreads();
+
+	// Los recursos los elimina el TResourceManager, aqui solo las cargas
+	std::map<TResource*, TLoadJob*>::iterator it = m_jobs.begin();
+	for(; it != m_jobs.end(); ++it) delete it->second;
+
+	m_jobs.clear();
+	m_queue.clear();
+	m_read.clear();
+}
+
+void TResourceLoader::StartThreads(){
+	if(!m_threads.empty()) return;
+
+	// Dejamos un nucleo para el hilo principal
+	int threadCount = std::max(1, (int)std::thread::hardware_concurrency() - 1);
+	m_stop = false;
+	for(int i=0; i<threadCount; i++) m_threads.push_back(std::thread(&TResourceLoader::Worker, this));
+}
+
+void TResourceLoader::StopThreads(){
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stop = true;
+	}
+	m_workCondition.notify_all();
+
+	int size = m_threads.size();
+	for(int i=0; i<size; i++) m_threads[i].join();
+	m_threads.clear();
+}
+
+void TResourceLoader::Load(TResource* resource, TResourceCallback callback){
+	if(AddCallback(resource, callback)) return;
+
+	TLoadJob* job = new TLoadJob();
+	job->resource = resource;
+	job->state = JOB_QUEUED;
+	job->read = false;
+	if(callback != nullptr) job->callbacks.push_back(callback);
+
+	StartThreads();
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_jobs[resource] = job;
+		m_queue.push_back(job);
+	}
+	m_workCondition.notify_one();
+}
+
+bool TResourceLoader::AddCallback(TResource* resource, TResourceCallback callback){
+	std::lock_guard<std::mutex> lock(m_mutex);
+	std::map<TResource*, TLoadJob*>::iterator it = m_jobs.find(resource);
+	if(it == m_jobs.end()) return false;
+
+	if(callback != nullptr) it->second->callbacks.push_back(callback);
+	return true;
+}
+
+void TResourceLoader::Worker(){
+	while(true){
+		TLoadJob* job = nullptr;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_workCondition.wait(lock, [this]{ return m_stop || !m_queue.empty(); });
+			if(m_stop) return;
+
+			job = m_queue.front();
+			m_queue.pop_front();
+			job->state = JOB_READING;
+		}
+		Read(job);
+	}
+}
+
+void TResourceLoader::Read(TLoadJob* job){
+	// Disco y decodificado, sin OpenGL
+	bool read = job->resource->ReadFile();
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		job->read = read;
+		job->state = JOB_READ;
+		m_read.push_back(job);
+	}
+	m_readCondition.notify_all();
+}
+
+void TResourceLoader::Upload(TLoadJob* job){
+	// Si no se ha podido leer UploadFile lo marca como no cargado sin tocar la grafica
+	job->resource->UploadFile();
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		Remove(job);
+	}
+
+	// Las funciones pueden pedir nuevas cargas, se llaman sin el mutex
+	int size = job->callbacks.size();
+	for(int i=0; i<size; i++) job->callbacks[i](job->resource);
+	delete job;
+}
+
+void TResourceLoader::Remove(TLoadJob* job){
+	std::deque<TLoadJob*>::iterator queued = std::find(m_queue.begin(), m_queue.end(), job);
+	if(queued != m_queue.end()) m_queue.erase(queued);
+
+	std::deque<TLoadJob*>::iterator read = std::find(m_read.begin(), m_read.end(), job);
+	if(read != m_read.end()) m_read.erase(read);
+
+	m_jobs.erase(job->resource);
+}
+
+void TResourceLoader::Update(){
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	unsigned long long bytes = 0;
+	int uploaded = 0;
+
+	while(true){
+		TLoadJob* job = nullptr;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if(m_read.empty()) return;
+			job = m_read.front();
+		}
+
+		// El primero siempre se sube para que las cargas grandes no se queden atascadas
+		unsigned long long size = job->read ? job->resource->GetUploadSize() : 0;
+		float elapsed = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+		if(uploaded > 0 && (bytes + size > m_uploadBytes || elapsed >= m_uploadTime)) return;
+
+		Upload(job);
+		bytes += size;
+		uploaded++;
+	}
+}
+
+void TResourceLoader::WaitAll(){
+	while(true){
+		TLoadJob* job = nullptr;
+		bool read = false;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			if(m_jobs.empty()) return;
+
+			if(!m_read.empty()) job = m_read.front();
+			else if(!m_queue.empty()){
+				// Mientras esperamos leemos nosotros tambien
+				job = m_queue.front();
+				m_queue.pop_front();
+				job->state = JOB_READING;
+				read = true;
+			}
+			else{
+				m_readCondition.wait(lock);
+				continue;
+			}
+		}
+
+		// Sin presupuesto, las subidas de los recursos pueden pedir otros (texturas de un mesh)
+		if(read) Read(job);
+		else Upload(job);
+	}
+}
+
+bool TResourceLoader::Finish(TResource* resource){
+	TLoadJob* job = nullptr;
+	bool read = false;
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		std::map<TResource*, TLoadJob*>::iterator it = m_jobs.find(resource);
+		if(it == m_jobs.end()) return false;
+		job = it->second;
+
+		// Si ningun hilo lo ha cogido lo leemos aqui, si no esperamos a que acabe
+		if(job->state == JOB_QUEUED){
+			m_queue.erase(std::find(m_queue.begin(), m_queue.end(), job));
+			job->state = JOB_READING;
+			read = true;
+		}
+		else m_readCondition.wait(lock, [job]{ return job->state == JOB_READ; });
+	}
+
+	if(read) job->read = resource->ReadFile();
+	Upload(job);
+	return true;
+}
+
+void TResourceLoader::Cancel(TResource* resource){
+	TLoadJob* job = nullptr;
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		std::map<TResource*, TLoadJob*>::iterator it = m_jobs.find(resource);
+		if(it == m_jobs.end()) return;
+		job = it->second;
+
+		// No se puede eliminar el recurso mientras un hilo lo esta leyendo
+		m_readCondition.wait(lock, [job]{ return job->state != JOB_READING; });
+		Remove(job);
+	}
+	delete job;
+}
+
+bool TResourceLoader::IsPending(TResource* resource){
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_jobs.find(resource) != m_jobs.end();
+}
+
+int TResourceLoader::GetPendingCount(){
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_jobs.size();
+}
+
+void TResourceLoader::SetUploadBudget(unsigned long long bytes, float milliseconds){
+	m_uploadBytes = bytes;
+	m_uploadTime = milliseconds;
+}
@@ -0,0 +1,160 @@
+#ifndef TRESOURCELOADER_H
+#define TRESOURCELOADER_H
+
+/**
+ * @brief Loads resources in the background: worker threads read and decode, the main thread uploads to OpenGL.
+ *
+ * @file TResourceLoader.h
+ */
+
+#include <vector>
+#include <deque>
+#include <map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+class TResource;
+
+/**
+ * @brief 	- Funcion a la que se llama al acabar de cargar un recurso, en el hilo principal
+ * 				Si no se ha podido cargar el recurso tiene GetLoaded() a false
+ */
+typedef std::function<void(TResource*)> TResourceCallback;
+
+/**
+ * @brief 	- Carga pendiente de un recurso
+ */
+struct TLoadJob{
+	TResource*						resource;	// resource - Recurso que se carga
+	int								state;		// state - JOB_QUEUED, JOB_READING o JOB_READ
+	bool							read;		// read - Resultado de ReadFile
+	std::vector<TResourceCallback>	callbacks;	// callbacks - Funciones a llamar al acabar
+};
+
+class TResourceLoader{
+public:
+	/**
+	 * @brief	- Constructor del cargador, los hilos no se crean hasta la primera carga
+	 */
+	TResourceLoader();
+
+	/**
+	 * @brief	- Destructor, para los hilos y descarta las cargas pendientes
+	 */
+	~TResourceLoader();
+
+	/**
+	 * @brief	- Pide la carga en segundo plano de un recurso ya creado y sin cargar
+	 * 				Si el recurso ya estaba pendiente solo se anyade la funcion
+	 *
+	 * @param 	- resource - Recurso a cargar
+	 * @param 	- callback - Funcion a llamar al acabar, opcional
+	 */
+	void Load(TResource* resource, TResourceCallback callback = nullptr);
+
+	/**
+	 * @brief	- Anyade una funcion a un recurso pendiente
+	 *
+	 * @return 	- bool - El recurso estaba pendiente, si no no se guarda la funcion
+	 */
+	bool AddCallback(TResource* resource, TResourceCallback callback);
+
+	/**
+	 * @brief	- Sube a la grafica los recursos ya leidos sin pasarse del presupuesto del frame
+	 * 				Se llama una vez por frame desde el hilo principal, al menos sube un recurso
+	 */
+	void Update();
+
+	/**
+	 * @brief	- Acaba todas las cargas pendientes (p.e. en una pantalla de carga)
+	 * 				El hilo principal tambien lee recursos mientras espera
+	 */
+	void WaitAll();
+
+	/**
+	 * @brief	- Acaba la carga de un recurso pendiente en el momento, para cuando se pide de forma sincrona
+	 *
+	 * @return 	- bool - El recurso estaba pendiente
+	 */
+	bool Finish(TResource* resource);
+
+	/**
+	 * @brief	- Descarta la carga de un recurso que se va a eliminar, esperando si se esta leyendo
+	 */
+	void Cancel(TResource* resource);
+
+	/**
+	 * @brief	- Para los hilos y descarta todas las cargas, antes de eliminar los recursos
+	 */
+	void Clear();
+
+	/**
+	 * @brief	- Devuelve si el recurso tiene una carga pendiente
+	 */
+	bool IsPending(TResource* resource);
+
+	/**
+	 * @brief	- Devuelve el numero de recursos pendientes, leyendose o por subir
+	 */
+	int GetPendingCount();
+
+	/**
+	 * @brief	- Cambia el presupuesto de subida a la grafica por frame
+	 *
+	 * @param 	- bytes - Bytes maximos por frame
+	 * @param 	- milliseconds - Tiempo maximo por frame
+	 */
+	void SetUploadBudget(unsigned long long bytes, float milliseconds);
+
+	static const int JOB_QUEUED = 0;	// JOB_QUEUED - Esperando a un hilo
+	static const int JOB_READING = 1;	// JOB_READING - Un hilo esta leyendo el recurso
+	static const int JOB_READ = 2;		// JOB_READ - Leido, esperando a subirse a la grafica
+
+private:
+	/**
+	 * @brief	- Bucle de los hilos, cogen el siguiente recurso de la cola y lo leen
+	 */
+	void Worker();
+
+	/**
+	 * @brief	- Crea los hilos si no se han creado ya
+	 */
+	void StartThreads();
+
+	/**
+	 * @brief	- Para y espera a los hilos
+	 */
+	void StopThreads();
+
+	/**
+	 * @brief	- Lee un recurso y lo marca como leido, se llama sin el mutex cogido
+	 */
+	void Read(TLoadJob* job);
+
+	/**
+	 * @brief	- Sube un recurso leido, lo quita de los pendientes y llama a sus funciones
+	 * 				Se llama sin el mutex cogido desde el hilo principal
+	 */
+	void Upload(TLoadJob* job);
+
+	/**
+	 * @brief	- Quita la carga de las colas y de los pendientes, con el mutex cogido
+	 */
+	void Remove(TLoadJob* job);
+
+	std::map<TResource*, TLoadJob*>	m_jobs;				// m_jobs - Cargas pendientes por recurso
+	std::deque<TLoadJob*>			m_queue;			// m_queue - Cargas esperando a un hilo
+	std::deque<TLoadJob*>			m_read;				// m_read - Cargas leidas esperando a subirse, en orden de llegada
+	std::vector<std::thread>		m_threads;			// m_threads - Hilos que leen los recursos
+	std::mutex						m_mutex;			// m_mutex - Protege las colas, los pendientes y el estado de las cargas
+	std::condition_variable			m_workCondition;	// m_workCondition - Avisa a los hilos de que hay trabajo o de que paren
+	std::condition_variable			m_readCondition;	// m_readCondition - Avisa al hilo principal de que se ha leido un recurso
+	bool							m_stop;				// m_stop - Los hilos tienen que parar
+
+	unsigned long long				m_uploadBytes;		// m_uploadBytes - Bytes maximos subidos por frame
+	float							m_uploadTime;		// m_uploadTime - Milisegundos maximos subiendo por frame
+};
+
+#endif
\ No newline at end of file
@@ -1,130 +1,348 @@
 #include "TResourceManager.h"
+#include "./../TOcularEngine/VideoDriver.h"
 #include <iostream>
+#include <algorithm>
+
+// Rutas de los recursos del motor dentro de la carpeta de assets, en el orden de DEFAULTRESOURCE
+static const char* DEFAULT_PATHS[DEFAULT_RESOURCES] = {
+	"/textures/default_texture.png",
+	"/textures/default_bump.png",
+	"/textures/default_particle.png",
+	"/models/cube.obj",
+	"/models/sphere.obj",
+	"/models/dome.obj",
+	"/textures/invisible_texture.png",
+	"/textures/default_font.png",
+	"/textures/default_skydome.jpg"
+};
 
 TResourceManager* TResourceManager::GetInstance() {
 	static TResourceManager instance;
 	return &instance;
 }
 
-TResourceManager::TResourceManager(){}
+TResourceManager::TResourceManager(){
+	m_asyncLoading = false;
+	m_clearing = false;
+	for(int i=0; i<RESOURCE_TYPES; i++){
+		m_cpuBudget[i] = 0;
+		m_gpuBudget[i] = 0;
+	}
+	for(int i=0; i<DEFAULT_RESOURCES; i++) m_defaultIds[i] = NO_RESOURCE_ID;
+	m_resources.push_back(nullptr);	// NO_RESOURCE_ID
+}
 
 /*********************************************
  * @brief Destructor
  *********************************************/
 TResourceManager::~TResourceManager(){
-	std::map<std::string, TResource*>::iterator it = m_resources.begin();
+	m_loader.Clear();	// Paramos los hilos antes de eliminar los recursos que estan leyendo
+	m_clearing = true;	// Los handles de unos recursos a otros ya no eliminan nada
 
-	for(; it != m_resources.end(); it++){
-		TResource* tResource = it->second;
-		if (tResource != nullptr) delete tResource;	//Delete the resource in the map
+	int size = m_resources.size();
+	for(int i=0; i<size; i++){
+		TResource* tResource = m_resources[i];
+		if (tResource != nullptr) delete tResource;	//Delete the resource in the table
 	}
 
-	m_resources.clear();		//Clear the map
+	m_resources.clear();		//Clear the table
 }
 
 /*********************************************
- * @brief Find the resource of the string passed
- * @param std::string path of the resource
+ * @brief Find the resource of the id passed
+ * @param TResourceId id of the resource path
  *********************************************/
-TResource* TResourceManager::FindResource(std::string name){
-	TResource* output = nullptr;
-	std::map<std::string, TResource*>::iterator it = m_resources.find(name); // Buscamos el recurso
-	if (it != m_resources.end()) output = it->second;	// En el caso de que exista lo almacenamos en el output y lo devolvemos
-	return output;						
+TResource* TResourceManager::FindResource(TResourceId id){
+	if(id >= m_resources.size()) return nullptr;	// Ruta sin recurso creado todavia
+	return m_resources[id];
+}
+
+void TResourceManager::AddResource(TResourceId id, TResource* resource){
+	if(id >= m_resources.size()) m_resources.resize(m_paths.GetCount() + 1, nullptr);
+	m_resources[id] = resource;
+	resource->SetId(id);
+}
+
+TResourceId TResourceManager::GetResourceId(const std::string& path){
+	return m_paths.Intern(path);
+}
+
+TResourceId TResourceManager::GetDefaultId(DEFAULTRESOURCE resource){
+	// Se recalculan solo si cambia la carpeta de assets
+	const std::string& assets = VideoDriver::GetInstance()->GetAssetsPath();
+	if(m_defaultIds[0] == NO_RESOURCE_ID || m_defaultsPath != assets){
+		m_defaultsPath = assets;
+		for(int i=0; i<DEFAULT_RESOURCES; i++) m_defaultIds[i] = m_paths.Intern(assets + DEFAULT_PATHS[i]);
+	}
+	return m_defaultIds[resource];
 }
 
-TResourceTexture* TResourceManager::GetResourceTexture(std::string name){ 
-	TResourceTexture* toRet = nullptr;
-	std::string path = TreatName(name);				// Tratamos la ruta para quitar elementos innecesarios de la ruta
-	toRet = (TResourceTexture*)FindResource(path);	// Buscamos el recurso
+const std::string& TResourceManager::GetResourcePath(TResourceId id){
+	return m_paths.GetPath(id);
+}
+
+TResourceHandle<TResourceTexture> TResourceManager::GetResourceTexture(const std::string& name){
+	return GetResourceTexture(m_paths.Intern(name));	// Tratamos la ruta y buscamos su id
+}
+
+TResourceHandle<TResourceTexture> TResourceManager::GetResourceTexture(TResourceId id){ 
+	if(id == NO_RESOURCE_ID || id > m_paths.GetCount()) return nullptr;
+	TResourceTexture* toRet = (TResourceTexture*)FindResource(id);	// Buscamos el recurso
 	if(toRet == nullptr){							
-		toRet = new TResourceTexture(path);			//
-		m_resources[path] = toRet;					// Si no existe lo creamos y cargamos
+		toRet = new TResourceTexture(m_paths.GetPath(id));	//
+		AddResource(id, toRet);								// Si no existe lo creamos y cargamos
 	}
+	else m_loader.Finish(toRet);					// Si se estaba cargando en segundo plano la acabamos ahora
 	return toRet;									// Devolvemos el recurso
 }
 
-TResourceMesh* TResourceManager::GetResourceMesh(std::string name){ 
-	TResourceMesh* toRet = nullptr;
-	std::string path = TreatName(name);				// Tratamos la ruta para quitar elemenots innecesarios d la ruta
-	toRet = (TResourceMesh*)FindResource(path);		// Buscamos el recurso
+TResourceHandle<TResourceMesh> TResourceManager::GetResourceMesh(const std::string& name){
+	return GetResourceMesh(m_paths.Intern(name));
+}
+
+TResourceHandle<TResourceMesh> TResourceManager::GetResourceMesh(TResourceId id){ 
+	if(id == NO_RESOURCE_ID || id > m_paths.GetCount()) return nullptr;
+	TResourceMesh* toRet = (TResourceMesh*)FindResource(id);	// Buscamos el recurso
 	if(toRet == nullptr) {
-		toRet = new TResourceMesh(path);			//
-		m_resources[path] = toRet;					// Si no existe lo creamos y cargamos
+		toRet = new TResourceMesh(m_paths.GetPath(id));	//
+		AddResource(id, toRet);							// Si no existe lo creamos y cargamos
 	}
+	else m_loader.Finish(toRet);					// Si se estaba cargando en segundo plano la acabamos ahora
 	return toRet;									// Devolvemos el recurso
 }
 
-TResourceMaterial* TResourceManager::GetResourceMaterial(std::string name){
+TResourceHandle<TResourceTexture> TResourceManager::GetResourceTextureAsync(const std::string& name, TResourceCallback callback, TResourceTexture* placeholder){
+	return GetResourceTextureAsync(m_paths.Intern(name), callback, placeholder);
+}
+
+TResourceHandle<TResourceTexture> TResourceManager::GetResourceTextureAsync(TResourceId id, TResourceCallback callback, TResourceTexture* placeholder){
+	if(id == NO_RESOURCE_ID || id > m_paths.GetCount()) return nullptr;
+	TResourceTexture* toRet = (TResourceTexture*)FindResource(id);
+	if(toRet == nullptr){
+		// Se crea sin cargar y se muestra la provisional hasta que se sube
+		// La textura por defecto se queda fijada, la usan todas las cargas
+		if(placeholder == nullptr){
+			TResourceHandle<TResourceTexture> defaultTexture = GetResourceTexture(GetDefaultId(DEFAULT_TEXTURE));
+			PinResource(defaultTexture);
+			placeholder = defaultTexture;
+		}
+		toRet = new TResourceTexture(m_paths.GetPath(id), placeholder);
+		AddResource(id, toRet);
+		m_loader.Load(toRet, callback);
+	}
+	else if(callback != nullptr && !m_loader.AddCallback(toRet, callback)) callback(toRet);	// Ya estaba cargada
+	return toRet;
+}
+
+TResourceHandle<TResourceMesh> TResourceManager::GetResourceMeshAsync(const std::string& name, TResourceCallback callback){
+	return GetResourceMeshAsync(m_paths.Intern(name), callback);
+}
+
+TResourceHandle<TResourceMesh> TResourceManager::GetResourceMeshAsync(TResourceId id, TResourceCallback callback){
+	if(id == NO_RESOURCE_ID || id > m_paths.GetCount()) return nullptr;
+	TResourceMesh* toRet = (TResourceMesh*)FindResource(id);
+	if(toRet == nullptr){
+		// Se crea sin cargar y se pinta el cubo hasta que se sube, el cubo se queda fijado
+		TResourceHandle<TResourceMesh> placeholder = GetResourceMesh(GetDefaultId(DEFAULT_MESH));
+		PinResource(placeholder);
+		toRet = new TResourceMesh(m_paths.GetPath(id), placeholder);
+		AddResource(id, toRet);
+		m_loader.Load(toRet, callback);
+	}
+	else if(callback != nullptr && !m_loader.AddCallback(toRet, callback)) callback(toRet);	// Ya estaba cargado
+	return toRet;
+}
+
+void TResourceManager::UpdateLoads(){
+	m_loader.Update();
+}
+
+void TResourceManager::WaitAll(){
+	m_loader.WaitAll();
+}
+
+int TResourceManager::GetPendingLoads(){
+	return m_loader.GetPendingCount();
+}
+
+void TResourceManager::SetUploadBudget(unsigned long long bytes, float milliseconds){
+	m_loader.SetUploadBudget(bytes, milliseconds);
+}
+
+void TResourceManager::SetAsyncLoading(bool async){
+	m_asyncLoading = async;
+}
+
+bool TResourceManager::GetAsyncLoading(){
+	return m_asyncLoading;
+}
+
+void TResourceManager::UpdateMemory(){
+	TResource::NextFrame();
+	for(int i=0; i<RESOURCE_TYPES; i++){
+		if(m_cpuBudget[i] != 0 || m_gpuBudget[i] != 0) EvictResources((RESOURCETYPE)i);
+	}
+}
+
+void TResourceManager::EvictResources(RESOURCETYPE type){
+	unsigned long long cpu = 0, gpu = 0;
+	GetMemoryUsage(type, &cpu, &gpu);
+
+	unsigned long long cpuBudget = m_cpuBudget[type];
+	unsigned long long gpuBudget = m_gpuBudget[type];
+	if((cpuBudget == 0 || cpu <= cpuBudget) && (gpuBudget == 0 || gpu <= gpuBudget)) return;
+
+	// Candidatos: cargados, sin carga pendiente y sin usar en el ultimo frame pintado
+	// Los pendientes se miran antes que nada, sus datos los esta escribiendo un hilo del cargador
+	// Los que tienen handles pueden volver a pintarse, al usarse se recargan en segundo plano con la provisional
+	unsigned int frame = TResource::GetFrame();
+	std::vector<TResource*> candidates;
+	int resources = m_resources.size();
+	for(int i=0; i<resources; i++){
+		TResource* resource = m_resources[i];
+		if(resource == nullptr || m_loader.IsPending(resource)) continue;
+		if(resource->GetType() != type || !resource->GetLoaded() || resource->GetEvicted()) continue;
+		if(resource->GetLastUse() + 1 >= frame) continue;
+		candidates.push_back(resource);
+	}
+
+	// Del que lleva mas tiempo sin usarse al mas reciente
+	std::sort(candidates.begin(), candidates.end(), [](TResource* a, TResource* b){ return a->GetLastUse() < b->GetLastUse(); });
+
+	int size = candidates.size();
+	for(int i=0; i<size; i++){
+		if((cpuBudget == 0 || cpu <= cpuBudget) && (gpuBudget == 0 || gpu <= gpuBudget)) break;
+
+		TResource* resource = candidates[i];
+		unsigned long long resourceCpu = resource->GetCpuSize();
+		unsigned long long resourceGpu = resource->GetGpuSize();
+		if(!resource->Evict()) continue;
+
+		cpu -= std::min(cpu, resourceCpu);
+		gpu -= std::min(gpu, resourceGpu);
+	}
+}
+
+void TResourceManager::SetMemoryBudget(RESOURCETYPE type, unsigned long long cpuBytes, unsigned long long gpuBytes){
+	if(type < 0 || type >= RESOURCE_TYPES) return;
+	m_cpuBudget[type] = cpuBytes;
+	m_gpuBudget[type] = gpuBytes;
+}
+
+void TResourceManager::GetMemoryUsage(RESOURCETYPE type, unsigned long long* cpuBytes, unsigned long long* gpuBytes){
+	*cpuBytes = 0;
+	*gpuBytes = 0;
+
+	int size = m_resources.size();
+	for(int i=0; i<size; i++){
+		TResource* resource = m_resources[i];
+		if(resource == nullptr) continue;
+		if(type != NONE_RESOURCE && resource->GetType() != type) continue;
+		if(m_loader.IsPending(resource)) continue;	// Lo esta leyendo un hilo del cargador, se cuenta al subirlo
+		*cpuBytes += resource->GetCpuSize();
+		*gpuBytes += resource->GetGpuSize();
+	}
+}
+
+void TResourceManager::ReloadResource(TResource* resource){
+	TResource* placeholder = nullptr;
+	if(resource->GetType() == TEXTURE_RESOURCE){
+		TResourceHandle<TResourceTexture> defaultTexture = GetResourceTexture(GetDefaultId(DEFAULT_TEXTURE));
+		PinResource(defaultTexture);
+		if(defaultTexture != resource) ((TResourceTexture*)resource)->SetPlaceholder(defaultTexture);
+		placeholder = defaultTexture;
+	}
+	else if(resource->GetType() == MESH_RESOURCE){
+		TResourceHandle<TResourceMesh> defaultMesh = GetResourceMesh(GetDefaultId(DEFAULT_MESH));
+		PinResource(defaultMesh);
+		if(defaultMesh != resource) ((TResourceMesh*)resource)->SetPlaceholder(defaultMesh);
+		placeholder = defaultMesh;
+	}
+
+	// Los de por defecto no tienen provisional, se cargan en el momento
+	if(placeholder == nullptr || placeholder == resource) resource->LoadFile();
+	else m_loader.Load(resource);
+}
+
+void TResourceManager::SetKeepTextureData(bool keep){
+	TResourceTexture::SetKeepImageData(keep);
+}
+
+TResourceHandle<TResourceMaterial> TResourceManager::GetResourceMaterial(const std::string& name){
 	// En el caso de los materiales en nombre no sera el path para el recurso
 	// Sera directamente el nombre del material
 	TResourceMaterial* toRet = nullptr;
-	std::string path = TreatName(name);
-	toRet = (TResourceMaterial*)FindResource(path);
+	TResourceId id = m_paths.Intern(name);
+	toRet = (TResourceMaterial*)FindResource(id);
 	if(toRet == nullptr) {
 		// Una vez llegados aqui significa que no se ha encontrado un material con este nombre
 		// Asi que crearemos uno nuevo con este nombre para que se rellene a partir del puntero
-		toRet = new TResourceMaterial(path);
-		m_resources[path] = toRet;
+		toRet = new TResourceMaterial(m_paths.GetPath(id));
+		AddResource(id, toRet);
 	}
 	return toRet;
 }
 
-TResourceShader* TResourceManager::GetResourceShader(std::string name, GLenum shaderType){ 
+TResourceShader* TResourceManager::GetResourceShader(const std::string& name, GLenum shaderType){ 
 	TResourceShader* toRet = nullptr;
-	std::string path = TreatName(name);				// Tratamos la ruta para quitar elemenots innecesarios d la ruta
-	toRet = (TResourceShader*)FindResource(path);	// Buscamos el recurso
+	TResourceId id = m_paths.Intern(name);			// Tratamos la ruta para quitar elemenots innecesarios d la ruta
+	toRet = (TResourceShader*)FindResource(id);		// Buscamos el recurso
 	if(toRet == nullptr) {
-		toRet = new TResourceShader(path, shaderType);	//
-		m_resources[path] = toRet;						// En caso de no encontrarlo lo creamos y cargamos
+		toRet = new TResourceShader(m_paths.GetPath(id), shaderType);	//
+		AddResource(id, toRet);											// En caso de no encontrarlo lo creamos y cargamos
+		toRet->SetPinned(true);							// Los programas se quedan con el shader compilado
 	}
 	return toRet;									// Devolvemos el recurso
 }		
 
-bool TResourceManager::DeleteResourceTexture(std::string name){
-	std::string path = TreatName(name);	// Tratamos la ruta
+bool TResourceManager::DeleteResourceTexture(const std::string& name){
+	TResource* resource = FindResource(m_paths.Find(name));
+	if(resource == nullptr) return false;
 
-	// Buscamos entre los recursos uno que se llame igual que la ruta pasada
-	std::map<std::string, TResource*>::iterator it = m_resources.begin();
-	for(; it != m_resources.end(); ++it){
-		if(path.compare(it->first) == 0){
-			delete it->second;				//
-			m_resources.erase(it);			//
-			return true;					// En el caso de encontrarlo lo eliminamos
-		}
-	}
-	return false;
+	// Mientras alguien la use no se puede eliminar, se eliminara al soltarla
+	resource->SetPinned(false);
+	if(resource->GetReferences() > 0) return false;
+
+	DestroyResource(resource);
+	return true;
 }
 
-std::string TResourceManager::TreatName(std::string newName) {
+void TResourceManager::PinResource(TResource* resource){
+	if(resource != nullptr) resource->SetPinned(true);
+}
 
-	std::string toSearch = "./";	//Pattern to delete
-	int pos = 0;
+void TResourceManager::UnpinResource(TResource* resource){
+	if(resource == nullptr) return;
+	resource->SetPinned(false);
+	if(resource->GetReferences() <= 0) DestroyResource(resource);
+}
 
-	do {
-		pos = newName.find(toSearch, pos);
-		bool erase = true;
+void TResourceManager::ReleaseReference(TResource* resource){
+	// Al cerrar se eliminan todos juntos, sin mirar las referencias
+	if(m_clearing) return;
+	if(resource->RemoveReference() <= 0 && !resource->GetPinned()) DestroyResource(resource);
+}
 
-		if (pos == -1) erase = false; 								//If not found
-		else if (pos == 0) erase = true;							//If first position 
-		else if (newName.at(pos-1) != '.') erase = true;			//If hasnt dot behind
-		else if (newName.at(pos-1) == '.') {erase = false; pos++;}	//If has dot behind
+void TResourceManager::DestroyResource(TResource* resource){
+	m_loader.Cancel(resource);	// Si se estaba cargando se descarta
 
-		//Erase the current position and next (./)
-		if (erase) newName.erase(pos,2); 
-	} while (pos != -1); // While we find "./"
+	// Se quita antes de eliminarlo, al eliminarse puede soltar a su vez otros recursos
+	// La ruta mantiene su id por si se vuelve a pedir
+	TResourceId id = resource->GetId();
+	if(FindResource(id) == resource) m_resources[id] = nullptr;
+	delete resource;
+}
 
-	 //If there's a slash at the begining, erase it
-	if (newName.at(0) == '/') newName.erase(0,1);
+int TResourceManager::ReleaseUnused(){
+	// Se recogen antes porque eliminar un recurso puede eliminar otros del mapa
+	std::vector<TResource*> unused;
+	int resources = m_resources.size();
+	for(int i=0; i<resources; i++){
+		TResource* resource = m_resources[i];
+		if(resource != nullptr && resource->GetReferences() <= 0 && !resource->GetPinned()) unused.push_back(resource);
+	}
 
-	//Erase the slashes at the end
-	bool finish = false;
-	do {
-		finish = false;
-		if (newName.at(newName.length()-1) == '/') {
-			newName.erase(newName.length()-1,1);
-			finish = true;
-		} 
-	} while (finish);
-	return newName;
-}
+	int size = unused.size();
+	for(int i=0; i<size; i++) DestroyResource(unused[i]);
+	return size;
+}
\ No newline at end of file
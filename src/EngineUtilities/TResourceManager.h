@@ -3,7 +3,9 @@
 
 /**
  * @brief ResourceManager will load all resources and control
- * 		  that resources only are read once.
+ * 		  that resources only are read once. Textures, meshes and materials
+ * 		  are handed out as reference-counted handles and destroyed with the last one.
+ * 		  Every path is treated once and interned as a TResourceId, later requests by id go straight to the resource.
  * 
  * @file TResourceManager.h
  */
@@ -13,9 +15,11 @@
 #include "Resources/TResourceMesh.h"
 #include "Resources/TResourceShader.h"
 #include "Resources/TResourceMaterial.h"
+#include "TResourceLoader.h"
+#include "TResourceHandle.h"
+#include "TPathTable.h"
 
 #include <vector>
-#include <map>
 #include <string>
 #include <GL/glew.h>
 
@@ -32,36 +36,195 @@ public:
 	static TResourceManager* GetInstance();	//Singleton class
 
 	//****************** Getters ******************
-	TResourceTexture*	GetResourceTexture	(std::string name);
-	TResourceMesh*		GetResourceMesh		(std::string name);
-	TResourceMaterial*	GetResourceMaterial	(std::string name);
-	TResourceShader* 	GetResourceShader	(std::string name, GLenum shaderType);
+	// Los recursos duran lo que el ultimo handle, los shaders no se eliminan hasta cerrar
+	// Por ruta se trata y se busca su id sin reservar memoria (si ya existe), por id se va directo al recurso
+	TResourceHandle<TResourceTexture>	GetResourceTexture	(const std::string& name);
+	TResourceHandle<TResourceTexture>	GetResourceTexture	(TResourceId id);
+	TResourceHandle<TResourceMesh>		GetResourceMesh		(const std::string& name);
+	TResourceHandle<TResourceMesh>		GetResourceMesh		(TResourceId id);
+	TResourceHandle<TResourceMaterial>	GetResourceMaterial	(const std::string& name);
+	TResourceShader* 					GetResourceShader	(const std::string& name, GLenum shaderType);
 	//*********************************************
 
 	/**
-	 * @brief	- Elimina el recurso pasado por parametros 
+	 * @brief	- Devuelve el id de una ruta, para guardarlo y pedir el recurso sin tratar la ruta cada vez
+	 * 				El id no cambia aunque el recurso se elimine y se vuelva a cargar
+	 * 
+	 * @param 	- path - Ruta del recurso
+	 * @return 	- TResourceId - Id de la ruta tratada
+	 */
+	TResourceId GetResourceId(const std::string& path);
+
+	/**
+	 * @brief	- Devuelve el id de un recurso del motor dentro de la carpeta de assets actual
+	 */
+	TResourceId GetDefaultId(DEFAULTRESOURCE resource);
+
+	/**
+	 * @brief	- Devuelve la ruta tratada de un id
+	 */
+	const std::string& GetResourcePath(TResourceId id);
+
+	/**
+	 * @brief	- Devuelve la textura al momento y la carga en segundo plano, mientras tanto muestra la provisional
+	 * 				Si ya estaba cargada o pendiente devuelve la misma
+	 * 
+	 * @param 	- name - Ruta de la textura
+	 * @param 	- callback - Funcion a llamar al acabar de cargarla, opcional
+	 * @param 	- placeholder - Textura provisional, por defecto la textura blanca
+	 * @return 	- TResourceTexture - Textura que se esta cargando
+	 */
+	TResourceHandle<TResourceTexture> GetResourceTextureAsync(const std::string& name, TResourceCallback callback = nullptr, TResourceTexture* placeholder = nullptr);
+	TResourceHandle<TResourceTexture> GetResourceTextureAsync(TResourceId id, TResourceCallback callback = nullptr, TResourceTexture* placeholder = nullptr);
+
+	/**
+	 * @brief	- Devuelve el mesh al momento y lo carga en segundo plano, mientras tanto se pinta el cubo
+	 * 				Sus texturas tambien se cargan en segundo plano
+	 * 
+	 * @param 	- name - Ruta del mesh
+	 * @param 	- callback - Funcion a llamar al acabar de cargarlo, opcional
+	 * @return 	- TResourceMesh - Mesh que se esta cargando
+	 */
+	TResourceHandle<TResourceMesh> GetResourceMeshAsync(const std::string& name, TResourceCallback callback = nullptr);
+	TResourceHandle<TResourceMesh> GetResourceMeshAsync(TResourceId id, TResourceCallback callback = nullptr);
+
+	/**
+	 * @brief	- Sube a la grafica los recursos ya leidos dentro del presupuesto del frame, una vez por frame
+	 */
+	void UpdateLoads();
+
+	/**
+	 * @brief	- Espera a que acaben todas las cargas en segundo plano (pantallas de carga)
+	 */
+	void WaitAll();
+
+	/**
+	 * @brief	- Devuelve el numero de recursos que se estan cargando en segundo plano
+	 */
+	int GetPendingLoads();
+
+	/**
+	 * @brief	- Cambia el presupuesto de subida a la grafica por frame
+	 * 
+	 * @param 	- bytes - Bytes maximos por frame
+	 * @param 	- milliseconds - Tiempo maximo por frame
+	 */
+	void SetUploadBudget(unsigned long long bytes, float milliseconds);
+
+	/**
+	 * @brief	- Activa o desactiva que los meshes y texturas de las entidades se carguen en segundo plano
+	 */
+	void SetAsyncLoading(bool async);
+
+	/**
+	 * @brief	- Devuelve si las entidades cargan sus recursos en segundo plano
+	 */
+	bool GetAsyncLoading();
+
+	/**
+	 * @brief	- Pasa al siguiente frame y libera los recursos menos usados de los tipos que se pasan de presupuesto
+	 * 				Una vez por frame, antes de pintar
+	 */
+	void UpdateMemory();
+
+	/**
+	 * @brief	- Cambia el presupuesto de memoria de un tipo de recurso (texturas o meshes)
+	 * 				Al pasarse se liberan los que llevan mas tiempo sin usarse, aunque tengan referencias
+	 * 				Se recargan en segundo plano al volver a usarse
+	 * 
+	 * @param 	- type - Tipo de recurso
+	 * @param 	- cpuBytes - Bytes maximos en memoria principal, 0 sin limite
+	 * @param 	- gpuBytes - Bytes maximos en la grafica, 0 sin limite
+	 */
+	void SetMemoryBudget(RESOURCETYPE type, unsigned long long cpuBytes, unsigned long long gpuBytes);
+
+	/**
+	 * @brief	- Devuelve la memoria que usan los recursos de un tipo, sin los que tienen una carga pendiente
+	 * 
+	 * @param 	- type - Tipo de recurso, NONE_RESOURCE para sumar todos
+	 * @param 	- cpuBytes - Bytes en memoria principal
+	 * @param 	- gpuBytes - Bytes en la grafica
+	 */
+	void GetMemoryUsage(RESOURCETYPE type, unsigned long long* cpuBytes, unsigned long long* gpuBytes);
+
+	/**
+	 * @brief	- Vuelve a cargar en segundo plano un recurso liberado, lo llama TResource::Use al volver a usarlo
+	 * 				Las texturas y los meshes muestran el de por defecto hasta que se suben
+	 */
+	void ReloadResource(TResource* resource);
+
+	/**
+	 * @brief	- Cambia si las texturas guardan la imagen decodificada despues de subirla, por defecto no
+	 */
+	void SetKeepTextureData(bool keep);
+
+	/**
+	 * @brief	- Fija un recurso para que no se elimine aunque no lo use nadie (p.e. los precargados)
+	 */
+	void PinResource(TResource* resource);
+
+	/**
+	 * @brief	- Deja de fijar un recurso, si no tiene referencias se elimina en el momento
+	 */
+	void UnpinResource(TResource* resource);
+
+	/**
+	 * @brief	- Elimina todos los recursos sin referencias que no estan fijados
+	 * 
+	 * @return 	- int - Numero de recursos eliminados
+	 */
+	int ReleaseUnused();
+
+	/**
+	 * @brief	- Deja de fijar la textura y la elimina si no la usa nadie
 	 * 
 	 * @param 	- path - Ruta del recurso a eliminar 
-	 * @return 	- bool - Si se ha eliminado correctamente el recurso
+	 * @return 	- bool - Si se ha eliminado el recurso, si aun tiene referencias se elimina al soltar la ultima
 	 */
-	bool DeleteResourceTexture(std::string path);
+	bool DeleteResourceTexture(const std::string& path);
 
 private:
+	friend class TResourceHandleBase;
+
 	TResourceManager();
 
+	/**
+	 * @brief	- Quita una referencia al recurso y lo elimina si era la ultima y no esta fijado
+	 */
+	void ReleaseReference(TResource* resource);
+
+	/**
+	 * @brief	- Descarta su carga pendiente, lo quita de la tabla y lo elimina
+	 */
+	void DestroyResource(TResource* resource);
+
 	/*********************************************
-	 * @brief Find the resource of the string passed
-	 * @param std::string path of the resource
+	 * @brief Find the resource of the id passed
+	 * @param TResourceId id of the resource path
 	 *********************************************/
-	TResource* FindResource(std::string);
+	TResource* FindResource(TResourceId id);
+
+	/**
+	 * @brief	- Guarda un recurso nuevo en la casilla de su id
+	 */
+	void AddResource(TResourceId id, TResource* resource);
+
+	/**
+	 * @brief	- Libera los recursos de un tipo que no se han usado en el ultimo frame,
+	 * 				del mas antiguo al mas reciente hasta bajar del presupuesto
+	 */
+	void EvictResources(RESOURCETYPE type);
 
-	/********************************************
-	 * @brief  Modifies the name of the resource
-	 * @param  std::string newName for the resource
-	 ********************************************/
-	std::string TreatName(std::string newName);
+	TPathTable m_paths;								// m_paths - Ids de todas las rutas pedidas
+	std::vector<TResource*> m_resources;			// m_resources - Recurso de cada id, nullptr si no esta creado
+	TResourceId m_defaultIds[DEFAULT_RESOURCES];	// m_defaultIds - Ids de los recursos del motor
+	std::string m_defaultsPath;						// m_defaultsPath - Carpeta de assets con la que se calcularon m_defaultIds
+	TResourceLoader m_loader;						// m_loader - Cargador de los recursos pedidos en segundo plano
+	bool m_asyncLoading;							// m_asyncLoading - Las entidades piden sus recursos en segundo plano
+	bool m_clearing;								// m_clearing - Se estan eliminando todos los recursos, las referencias ya no cuentan
 
-	std::map<std::string, TResource*> m_resources;	// m_resources - mapa con todos los recursos ordenados por la ruta
+	unsigned long long m_cpuBudget[RESOURCE_TYPES];	// m_cpuBudget - Bytes maximos en memoria principal por tipo, 0 sin limite
+	unsigned long long m_gpuBudget[RESOURCE_TYPES];	// m_gpuBudget - Bytes maximos en la grafica por tipo, 0 sin limite
 	
 };
 
@@ -240,16 +240,16 @@ void TRoom::DrawDebug(){
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 	
 	// Apply object's transformation matrix 
-	glm::mat4 m = TEntity::ProjMatrix * TEntity::ViewMatrix * TEntity::m_stack.top() * m_transform;
-	GLuint uniform_m = glGetUniformLocation(myProgram->GetProgramID(), "MVP");
+	glm::mat4 m = TEntity::ProjMatrix * TEntity::ViewMatrix * m_transform;
+	GLuint uniform_m = myProgram->GetUniformLocation(MVP_UNIFORM);
 	glUniformMatrix4fv(uniform_m, 1, GL_FALSE, &m[0][0]);
 
 	// Send light color
-	GLuint linecolor = glGetUniformLocation(myProgram->GetProgramID(), "LineColor");
+	GLuint linecolor = myProgram->GetUniformLocation(LINECOLOR_UNIFORM);
 	glUniform3fv(linecolor, 1, glm::value_ptr(glm::vec3(1.0f, 0.0f, 0.0f)));
 
 	// Send each vertex data
-	GLuint attribute_v_coord = glGetAttribLocation(myProgram->GetProgramID(), "VertexPosition");	
+	GLuint attribute_v_coord = myProgram->GetAttribLocation(VERTEXPOSITION_ATTRIB);	
 	glBindBuffer(GL_ARRAY_BUFFER, vbo_vertices);
 	glEnableVertexAttribArray(attribute_v_coord);
 
@@ -0,0 +1,177 @@
+#include "./TStreamBuffer.h"
+#include <cstring>
+
+TStreamBuffer* TStreamBuffer::GetInstance(){
+	static TStreamBuffer instance;
+	return &instance;
+}
+
+TStreamBuffer::TStreamBuffer(){
+	m_buffer = 0;
+	m_size = 0;
+	m_head = 0;
+	m_regionStart = 0;
+	m_mapped = nullptr;
+	m_persistent = false;
+	m_mapOffset = 0;
+	m_mapBytes = 0;
+	m_revision = 0;
+}
+
+TStreamBuffer::~TStreamBuffer(){
+	Release();
+}
+
+void TStreamBuffer::Release(){
+	Destroy();
+	m_staging.clear();
+}
+
+void TStreamBuffer::Create(GLsizeiptr size){
+	Destroy();
+
+	glGenBuffers(1, &m_buffer);
+	glBindBuffer(GL_ARRAY_BUFFER, m_buffer);
+	m_size = size;
+
+	// Con ARB_buffer_storage se mapea una vez y se escribe directamente, los fences dicen cuando se puede pisar
+	if(GLEW_ARB_buffer_storage || GLEW_VERSION_4_4){
+		GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		glBufferStorage(GL_ARRAY_BUFFER, size, NULL, flags);
+		m_mapped = (unsigned char*)glMapBufferRange(GL_ARRAY_BUFFER, 0, size, flags);
+		m_persistent = m_mapped != nullptr;
+
+		// Si el driver no lo deja mapear se vuelve a crear como uno normal (buffer storage es inmutable)
+		if(!m_persistent){
+			glDeleteBuffers(1, &m_buffer);
+			glGenBuffers(1, &m_buffer);
+			glBindBuffer(GL_ARRAY_BUFFER, m_buffer);
+		}
+	}
+
+	// Sin mapear se sube con glBufferSubData y se deja el buffer a OpenGL (orphaning) al dar la vuelta
+	if(!m_persistent) glBufferData(GL_ARRAY_BUFFER, size, NULL, GL_STREAM_DRAW);
+
+	m_head = 0;
+	m_regionStart = 0;
+	m_revision++;
+}
+
+void TStreamBuffer::Destroy(){
+	int size = m_regions.size();
+	for(int i=0; i<size; i++) glDeleteSync(m_regions[i].fence);
+	m_regions.clear();
+
+	if(m_buffer != 0){
+		if(m_persistent){
+			glBindBuffer(GL_ARRAY_BUFFER, m_buffer);
+			glUnmapBuffer(GL_ARRAY_BUFFER);
+		}
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		glDeleteBuffers(1, &m_buffer);
+	}
+
+	m_buffer = 0;
+	m_size = 0;
+	m_mapped = nullptr;
+	m_persistent = false;
+}
+
+GLintptr TStreamBuffer::Reserve(GLsizeiptr bytes){
+	// Si no cabe ni en el buffer entero se crea uno mas grande, lo ya pintado sigue usando el anterior
+	if(m_buffer == 0 || bytes > m_size){
+		GLsizeiptr size = m_defaultSize;
+		while(size < bytes) size *= 2;
+		if(size < m_size) size = m_size;
+		Create(size);
+	}
+
+	GLintptr offset = (m_head + m_alignment - 1) & ~(m_alignment - 1);
+	if(offset + bytes > m_size){
+		// Damos la vuelta: lo escrito hasta aqui se protege con un fence o se deja a OpenGL
+		if(m_persistent) Fence();
+		else{
+			glBindBuffer(GL_ARRAY_BUFFER, m_buffer);
+			glBufferData(GL_ARRAY_BUFFER, m_size, NULL, GL_STREAM_DRAW);
+		}
+		offset = 0;
+		m_regionStart = 0;
+		m_revision++;
+	}
+
+	if(m_persistent) Wait(offset, offset + bytes);
+	m_head = offset + bytes;
+	return offset;
+}
+
+void TStreamBuffer::Fence(){
+	if(m_head <= m_regionStart) return;
+
+	TStreamRegion region;
+	region.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	region.start = m_regionStart;
+	region.end = m_head;
+	m_regions.push_back(region);
+	m_regionStart = m_head;
+}
+
+void TStreamBuffer::Wait(GLintptr start, GLintptr end){
+	// Los fences acaban en orden, asi que basta con esperar al mas nuevo que se pisa
+	int last = -1;
+	int size = m_regions.size();
+	for(int i=0; i<size; i++){
+		if(m_regions[i].start < end && start < m_regions[i].end) last = i;
+	}
+	if(last < 0) return;
+
+	GLenum result = GL_TIMEOUT_EXPIRED;
+	while(result == GL_TIMEOUT_EXPIRED) result = glClientWaitSync(m_regions[last].fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+
+	for(int i=0; i<=last; i++) glDeleteSync(m_regions[i].fence);
+	m_regions.erase(m_regions.begin(), m_regions.begin() + (last + 1));
+}
+
+void* TStreamBuffer::Map(GLsizeiptr bytes, GLintptr* offset){
+	m_mapOffset = Reserve(bytes);
+	m_mapBytes = bytes;
+	*offset = m_mapOffset;
+
+	if(m_persistent) return m_mapped + m_mapOffset;
+
+	if((GLsizeiptr)m_staging.size() < bytes) m_staging.resize(bytes);
+	return m_staging.data();
+}
+
+void TStreamBuffer::Unmap(){
+	// Mapeado y coherente ya esta en la grafica, si no se sube la copia
+	if(!m_persistent && m_mapBytes > 0){
+		glBindBuffer(GL_ARRAY_BUFFER, m_buffer);
+		glBufferSubData(GL_ARRAY_BUFFER, m_mapOffset, m_mapBytes, m_staging.data());
+	}
+	m_mapBytes = 0;
+}
+
+GLintptr TStreamBuffer::Push(const void* data, GLsizeiptr bytes){
+	GLintptr offset = 0;
+	void* memory = Map(bytes, &offset);
+	if(bytes > 0) memcpy(memory, data, bytes);
+	Unmap();
+	return offset;
+}
+
+void TStreamBuffer::EndFrame(){
+	if(m_persistent) Fence();
+	m_revision++;
+}
+
+GLuint TStreamBuffer::GetBuffer(){
+	return m_buffer;
+}
+
+unsigned int TStreamBuffer::GetRevision(){
+	return m_revision;
+}
+
+bool TStreamBuffer::IsPersistent(){
+	return m_persistent;
+}
\ No newline at end of file
@@ -0,0 +1,138 @@
+#ifndef TSTREAMBUFFER_H
+#define TSTREAMBUFFER_H
+
+/**
+ * @brief Ring buffer shared by all the vertex data that is sent again every frame (particles, 2D, lines, instances).
+ * 		  Persistently mapped with fences where ARB_buffer_storage exists, orphaned when it wraps on older contexts.
+ *
+ * @file TStreamBuffer.h
+ */
+
+#include <GL/glew.h>
+#include <vector>
+
+class TStreamBuffer{
+public:
+	/**
+	 * @brief	- Devuelve la instancia del buffer
+	 */
+	static TStreamBuffer* GetInstance();
+
+	/**
+	 * @brief	- Destructor, libera el buffer
+	 */
+	~TStreamBuffer();
+
+	/**
+	 * @brief	- Coge sitio en el buffer para escribir y devuelve donde hacerlo
+	 * 				Con el buffer mapeado es la memoria de la grafica, si no una copia que se sube en Unmap
+	 * 				Puede cambiar el GL_ARRAY_BUFFER enlazado
+	 *
+	 * @param 	- bytes - Bytes que se van a escribir
+	 * @param 	- offset - Posicion en el buffer de los datos, para los glVertexAttribPointer
+	 * @return 	- void* - Memoria donde escribir los bytes
+	 */
+	void* Map(GLsizeiptr bytes, GLintptr* offset);
+
+	/**
+	 * @brief	- Acaba de escribir lo pedido en el ultimo Map, antes de pintar con ello
+	 */
+	void Unmap();
+
+	/**
+	 * @brief	- Copia unos datos al buffer (Map, memcpy y Unmap)
+	 *
+	 * @param 	- data - Datos a copiar
+	 * @param 	- bytes - Bytes a copiar
+	 * @return 	- GLintptr - Posicion en el buffer de los datos
+	 */
+	GLintptr Push(const void* data, GLsizeiptr bytes);
+
+	/**
+	 * @brief	- Marca el final del frame, la grafica avisa cuando acaba con lo escrito hasta aqui
+	 * 				Se llama antes de cambiar el buffer de la ventana
+	 */
+	void EndFrame();
+
+	/**
+	 * @brief	- Libera el buffer, se llama mientras exista el contexto de OpenGL
+	 */
+	void Release();
+
+	/**
+	 * @brief	- Devuelve el buffer a enlazar para pintar con lo escrito
+	 */
+	GLuint GetBuffer();
+
+	/**
+	 * @brief	- Devuelve un numero que cambia al acabar el frame, al dar la vuelta y al recrear el buffer
+	 * 				Lo subido con otra revision puede estar sobreescrito y hay que volver a subirlo
+	 */
+	unsigned int GetRevision();
+
+	/**
+	 * @brief	- Devuelve si el buffer esta mapeado siempre (ARB_buffer_storage) o se deja a OpenGL al dar la vuelta
+	 */
+	bool IsPersistent();
+
+private:
+	TStreamBuffer();
+
+	/**
+	 * @brief 	- Trozo del buffer que la grafica puede estar leyendo todavia
+	 */
+	struct TStreamRegion{
+		GLsync		fence;		// fence - Avisa cuando la grafica acaba con el trozo
+		GLintptr	start;		// start - Primer byte del trozo
+		GLintptr	end;		// end - Byte siguiente al ultimo del trozo
+	};
+
+	/**
+	 * @brief	- Crea el buffer, mapeado si se puede
+	 *
+	 * @param 	- size - Bytes del buffer
+	 */
+	void Create(GLsizeiptr size);
+
+	/**
+	 * @brief	- Deja el buffer y los fences
+	 */
+	void Destroy();
+
+	/**
+	 * @brief	- Busca sitio para los bytes detras de lo ultimo escrito o al principio si no caben
+	 *
+	 * @param 	- bytes - Bytes que se van a escribir
+	 * @return 	- GLintptr - Posicion donde escribirlos
+	 */
+	GLintptr Reserve(GLsizeiptr bytes);
+
+	/**
+	 * @brief	- Pone un fence a lo escrito desde el ultimo
+	 */
+	void Fence();
+
+	/**
+	 * @brief	- Espera a que la grafica acabe con los trozos que se pisan con el rango
+	 *
+	 * @param 	- start - Primer byte del rango
+	 * @param 	- end - Byte siguiente al ultimo del rango
+	 */
+	void Wait(GLintptr start, GLintptr end);
+
+	GLuint						m_buffer;			// m_buffer - Buffer de OpenGL, 0 si no se ha creado
+	GLsizeiptr					m_size;				// m_size - Bytes del buffer
+	GLintptr					m_head;				// m_head - Byte siguiente al ultimo escrito
+	GLintptr					m_regionStart;		// m_regionStart - Principio de lo escrito que no tiene fence
+	unsigned char*				m_mapped;			// m_mapped - Memoria del buffer mapeado, nullptr si no es persistente
+	bool						m_persistent;		// m_persistent - El buffer esta mapeado siempre
+	std::vector<TStreamRegion>	m_regions;			// m_regions - Trozos con fence, del mas antiguo al mas nuevo
+	std::vector<unsigned char>	m_staging;			// m_staging - Copia donde se escribe sin mapear, se sube en Unmap
+	GLintptr					m_mapOffset;		// m_mapOffset - Posicion del ultimo Map
+	GLsizeiptr					m_mapBytes;			// m_mapBytes - Bytes del ultimo Map
+	unsigned int				m_revision;			// m_revision - Cambia cuando lo subido puede dejar de valer
+	static const GLsizeiptr		m_defaultSize = 4 * 1024 * 1024;	// m_defaultSize - Bytes del buffer al crearlo
+	static const GLintptr		m_alignment = 16;	// m_alignment - Alineacion de cada Map
+};
+
+#endif
\ No newline at end of file
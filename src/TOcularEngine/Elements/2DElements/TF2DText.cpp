@@ -5,6 +5,7 @@
 #include "./../../VideoDriver.h"
 #include "./../../../EngineUtilities/TResourceManager.h"
 #include "./../../../EngineUtilities/Resources/Program.h"
+#include "./../../../EngineUtilities/TStreamBuffer.h"
 
 TF2DText::TF2DText(std::string text , TOEvector2df position){
     m_text = text;
@@ -16,16 +17,9 @@ TF2DText::TF2DText(std::string text , TOEvector2df position){
 
     m_program = TWODTEXT_SHADER;
 
-	//Bind the vertex and uv buffers
-    m_VBO = 0;
-    glGenBuffers(1, &m_VBO);
-
-    m_UVBO = 0;
-    glGenBuffers(1, &m_UVBO);
-
-    //Font texture path
-	std::string tex_path = VideoDriver::GetInstance()->GetAssetsPath() + "/textures/default_font.png";
-	m_texture = TResourceManager::GetInstance()->GetResourceTexture(tex_path);
+    //Font texture
+	TResourceManager* manager = TResourceManager::GetInstance();
+	m_texture = manager->GetResourceTexture(manager->GetDefaultId(DEFAULT_FONT));
 
 	//Load the text texture rectangles for each letter
     SetText(m_text);
@@ -44,12 +38,6 @@ TF2DText::TF2DText(std::string text , TOEvector2df position){
 }
 
 TF2DText::~TF2DText(){
-	//Unbind the buffers
-    glBindBuffer(GL_ARRAY_BUFFER, 0);   
-    glDeleteBuffers(1, &m_VBO);
-    
-    glBindBuffer(GL_ARRAY_BUFFER, 0);   
-    glDeleteBuffers(1, &m_UVBO);
 }
 
 void TF2DText::Draw() const {
@@ -61,22 +49,23 @@ void TF2DText::Draw() const {
 	//Get the shader program
     Program* myProgram = VideoDriver::GetInstance()->SetShaderProgram(m_program);
 
-    //Send the text position
-    glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
+    //Write the text vertices in the shared stream buffer
+    TStreamBuffer* stream = TStreamBuffer::GetInstance();
+    GLintptr offset = stream->Push(m_textData.data(), m_textData.size()*sizeof(float));
+    glBindBuffer(GL_ARRAY_BUFFER, stream->GetBuffer());
 
-    GLint posAttrib = glGetAttribLocation(myProgram->GetProgramID(), "VertexPosition");
-    glVertexAttribPointer(posAttrib, 2, GL_FLOAT, GL_FALSE, 0*sizeof(float), 0);
+    //Send the text position
+    GLint posAttrib = myProgram->GetAttribLocation(VERTEXPOSITION_ATTRIB);
+    glVertexAttribPointer(posAttrib, 2, GL_FLOAT, GL_FALSE, 4*sizeof(float), (const GLvoid*)offset);
     glEnableVertexAttribArray(posAttrib);
 	
     //Send the texture coordinates
-	glBindBuffer(GL_ARRAY_BUFFER, m_UVBO);
-
-    GLuint uvAttrib = glGetAttribLocation(myProgram->GetProgramID(), "TextureCoords");
-    glVertexAttribPointer(uvAttrib, 2, GL_FLOAT, GL_FALSE, 0*sizeof(float), 0);
+    GLuint uvAttrib = myProgram->GetAttribLocation(TEXTURECOORDS_ATTRIB);
+    glVertexAttribPointer(uvAttrib, 2, GL_FLOAT, GL_FALSE, 4*sizeof(float), (const GLvoid*)(offset + 2*sizeof(float)));
     glEnableVertexAttribArray(uvAttrib);
     
     //Send the texture data
-	GLuint TextureID = glGetUniformLocation(myProgram->GetProgramID(), "uvMap");
+	GLuint TextureID = myProgram->GetUniformLocation(UVMAP_UNIFORM);
 	glUniform1i(TextureID, 0);
     
     glActiveTexture(GL_TEXTURE0);
@@ -150,12 +139,15 @@ void TF2DText::SetText(std::string txt){
 
 	m_vertexSize = textVertex.size();
 
-	//Send the buffer data
-	glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
-	glBufferData(GL_ARRAY_BUFFER, textVertex.size()*sizeof(glm::vec2), &textVertex[0], GL_STATIC_DRAW);
-
-	glBindBuffer(GL_ARRAY_BUFFER, m_UVBO);
-	glBufferData(GL_ARRAY_BUFFER, textUv.size()*sizeof(glm::vec2), &textUv[0], GL_STATIC_DRAW);
+	//Store the vertex data interleaved (position, uv), it is sent to the stream buffer in every Draw
+	int vertexCount = textVertex.size();
+	m_textData.resize(vertexCount * 4);
+	for(int i=0; i<vertexCount; i++){
+		m_textData[4*i+0] = textVertex[i].x;
+		m_textData[4*i+1] = textVertex[i].y;
+		m_textData[4*i+2] = textUv[i].x;
+		m_textData[4*i+3] = textUv[i].y;
+	}
 	
 	//Store the positions and dimensions of the text
 	TOEvector2di w_dims = VideoDriver::GetInstance()->GetWindowDimensions();
@@ -8,6 +8,7 @@
  */
 
 #include "TFDrawable.h"
+#include "./../../../EngineUtilities/TResourceHandle.h"
 #include <vector>
 #include <TOEvector2d.h>
 
@@ -91,8 +92,8 @@ private:
     std::string             m_text;         //Actual text displayed
     float                   m_textSize;     //Character size in pixels
     float                   m_vertexSize;   //Vertex array size
-    TResourceTexture*       m_texture;      //Font texture path
-    GLuint                  m_VBO, m_UVBO;  //Opengl buffer objects
+    TResourceHandle<TResourceTexture> m_texture;    //Font texture path
+    std::vector<float>      m_textData;     //Position and uv of every vertex, written in the stream buffer when drawn
 
 };
 
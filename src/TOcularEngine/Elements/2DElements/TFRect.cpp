@@ -2,6 +2,7 @@
 #include <GL/glew.h>
 #include "./../../../EngineUtilities/TResourceManager.h"
 #include "./../../../EngineUtilities/Resources/Program.h"
+#include "./../../../EngineUtilities/TStreamBuffer.h"
 #include "./../../VideoDriver.h"
 
 TFRect::TFRect(TOEvector2df position, TOEvector2df size, float rotation){
@@ -18,8 +19,8 @@ TFRect::TFRect(TOEvector2df position, TOEvector2df size, float rotation){
     m_mask_size = size;
 
     //Load the texture mask resource
-    std::string mask = VideoDriver::GetInstance()->GetAssetsPath() + "/textures/default_texture.png";
-    m_mask = TResourceManager::GetInstance()->GetResourceTexture(mask);
+    TResourceManager* manager = TResourceManager::GetInstance();
+    m_mask = manager->GetResourceTexture(manager->GetDefaultId(DEFAULT_TEXTURE));
     m_mask_rect = TOEvector4df(0.0f, 0.0f,1.0f, 1.0f); //initially the whole mask is loaded (OpenGL units from 0 to 1)
 
     //Save the object position adn size data in pixel units
@@ -28,16 +29,9 @@ TFRect::TFRect(TOEvector2df position, TOEvector2df size, float rotation){
 
     //Rectangles dont use texture
     m_InData.texture = "";
-
-    //Bind vertex buffer
-    m_VBO = 0;
-    glGenBuffers( 1, &m_VBO );
 }
 
 TFRect::~TFRect(){
-    //Unbind buffers
-    glBindBuffer(GL_ARRAY_BUFFER, 0);   
-    glDeleteBuffers(1, &m_VBO);
 }
 
 void TFRect::Draw() const{
@@ -78,25 +72,26 @@ void TFRect::Draw() const{
         m_position.X + upLeftCorner.x,      m_position.Y + upLeftCorner.y,      m_mask_rect.X ,  m_mask_rect.Y,    m_color.GetR(), m_color.GetG(), m_color.GetB(), m_color.GetA()
     };
 
-    //Bind vertex buffer and attribute pointers
-    glBindBuffer( GL_ARRAY_BUFFER, m_VBO );
-    glBufferData( GL_ARRAY_BUFFER, sizeof( vertices ), vertices, GL_STATIC_DRAW );
+    //Write the vertices in the shared stream buffer, bind it and the attribute pointers
+    TStreamBuffer* stream = TStreamBuffer::GetInstance();
+    GLintptr offset = stream->Push(vertices, sizeof( vertices ));
+    glBindBuffer( GL_ARRAY_BUFFER, stream->GetBuffer() );
     
-    GLint posAttrib = glGetAttribLocation(myProgram->GetProgramID(), "position");
-    glVertexAttribPointer(posAttrib, 2, GL_FLOAT, GL_FALSE, 8 * sizeof( float ), ( GLvoid * ) 0 );
+    GLint posAttrib = myProgram->GetAttribLocation(POSITION2D_ATTRIB);
+    glVertexAttribPointer(posAttrib, 2, GL_FLOAT, GL_FALSE, 8 * sizeof( float ), ( GLvoid * ) offset );
     glEnableVertexAttribArray(posAttrib);
 
     //Mask coords
-    GLuint uvMaskAttrib = glGetAttribLocation(myProgram->GetProgramID(), "MaskCoords");
+    GLuint uvMaskAttrib = myProgram->GetAttribLocation(MASKCOORDS_ATTRIB);
     glEnableVertexAttribArray(uvMaskAttrib);
-    glVertexAttribPointer(uvMaskAttrib, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (const GLvoid*)(2 * sizeof(float)));
+    glVertexAttribPointer(uvMaskAttrib, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (const GLvoid*)(offset + 2 * sizeof(float)));
 
-    GLint colAttrib = glGetAttribLocation(myProgram->GetProgramID(), "color");
+    GLint colAttrib = myProgram->GetAttribLocation(COLOR2D_ATTRIB);
     glEnableVertexAttribArray(colAttrib);
-    glVertexAttribPointer(colAttrib, 4, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(4*sizeof(float)));
+    glVertexAttribPointer(colAttrib, 4, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(offset + 4*sizeof(float)));
 
     //Load the mask texture
-    GLuint MaskID = glGetUniformLocation(myProgram->GetProgramID(), "myMask");
+    GLuint MaskID = myProgram->GetUniformLocation(MASK_UNIFORM);
     glUniform1i(MaskID, 1);
 
     glActiveTexture(GL_TEXTURE1);
@@ -8,6 +8,7 @@
  */
 
 #include "TFDrawable.h"
+#include "./../../../EngineUtilities/TResourceHandle.h"
 #include <TOEvector4d.h>
 
 //FAST FORWARD DECLARATIONS
@@ -45,8 +46,7 @@ private:
      */
     ~TFRect();
 
-    GLuint m_VBO;               //Vertex buffer object
-    TResourceTexture* m_mask;   //Mask texture
+    TResourceHandle<TResourceTexture> m_mask;   //Mask texture
     TOEvector2df m_mask_size;   //Mask texture size
     TOEvector4df m_mask_rect;   //Mask texture rectangle
 };
@@ -3,6 +3,7 @@
 #include "./../../../EngineUtilities/Resources/TResourceTexture.h"
 #include "./../../../EngineUtilities/TResourceManager.h"
 #include "./../../../EngineUtilities/Resources/Program.h"
+#include "./../../../EngineUtilities/TStreamBuffer.h"
 #include "./../../VideoDriver.h"
 #include "./../TOcularEngine/TOcularEngine.h"
 
@@ -15,8 +16,7 @@ TFSprite::TFSprite(std::string texture, TOEvector2df position, TOEvector2df size
     m_rotation    = 0;
 
     //Load the texture resource
-    if(texture.compare("")==0) texture = VideoDriver::GetInstance()->GetAssetsPath() + "/textures/invisible_texture.png";
-	m_texture = TResourceManager::GetInstance()->GetResourceTexture(texture);
+    SetTexture(texture);
     m_texture_size = size;
     m_rect = TOEvector4df(0.0f, 0.0f,1.0f, 1.0f);       //initially the recangle is the whole texture size (0 to 1 OpenGL coordinates)
     m_mask_rect = TOEvector4df(0.0f, 0.0f,1.0f, 1.0f);  //initially the recangle is the whole texture size (0 to 1 OpenGL coordinates)
@@ -27,11 +27,6 @@ TFSprite::TFSprite(std::string texture, TOEvector2df position, TOEvector2df size
     //Save the position and size data in pixel units
     m_InData.position = position;
     m_InData.size = size;
-    m_InData.texture = texture;
-
-    //Bind buffers
-    m_VBO = 0;
-    glGenBuffers(1, &m_VBO);
 
     //Initial over color
     m_color.SetRGBA(1,1,1,1);
@@ -39,13 +34,11 @@ TFSprite::TFSprite(std::string texture, TOEvector2df position, TOEvector2df size
     //Initial texture scroll velocity
     scrollH = 0;
     scrollV = 0;
-    std::string mask = VideoDriver::GetInstance()->GetAssetsPath() + "/textures/default_texture.png";
-    m_mask = TResourceManager::GetInstance()->GetResourceTexture(mask);
+    TResourceManager* manager = TResourceManager::GetInstance();
+    m_mask = manager->GetResourceTexture(manager->GetDefaultId(DEFAULT_TEXTURE));
 }
 
 TFSprite::~TFSprite(){
-    glBindBuffer(GL_ARRAY_BUFFER, 0);   
-    glDeleteBuffers(1, &m_VBO);
 }
 
 void TFSprite::SetRect(float x, float y, float w, float h){
@@ -69,9 +62,11 @@ void TFSprite::SetTextureRect(float x, float y, float w, float h){
 }
 
 void TFSprite::SetTexture(std::string texture){
-    if(texture.compare("")==0) texture = VideoDriver::GetInstance()->GetAssetsPath() + "/textures/invisible_texture.png";
-	m_texture = TResourceManager::GetInstance()->GetResourceTexture(texture);
-    m_InData.texture = texture;
+    //Empty path shows the invisible texture, its id is cached by the manager
+    TResourceManager* manager = TResourceManager::GetInstance();
+    TResourceId id = texture.compare("")==0 ? manager->GetDefaultId(DEFAULT_INVISIBLE) : manager->GetResourceId(texture);
+	m_texture = manager->GetResourceTexture(id);
+    m_InData.texture = manager->GetResourcePath(id);
 }
 
 std::string TFSprite::GetTexture() const {return m_InData.texture;}
@@ -109,43 +104,44 @@ void TFSprite::Draw() const{
         m_position.X + upLeftCorner.x,      m_position.Y + upLeftCorner.y,      m_rect.X +scrollH,  m_rect.Y+scrollV,   m_mask_rect.X ,  m_mask_rect.Y,    m_color.GetR(), m_color.GetG(), m_color.GetB(), m_color.GetA()
     };
 
-    //Bind the buffers
-    glBindBuffer( GL_ARRAY_BUFFER, m_VBO );
-    glBufferData( GL_ARRAY_BUFFER, sizeof( vertices ), vertices, GL_STATIC_DRAW );
+    //Write the vertices in the shared stream buffer and bind it
+    TStreamBuffer* stream = TStreamBuffer::GetInstance();
+    GLintptr offset = stream->Push(vertices, sizeof( vertices ));
+    glBindBuffer( GL_ARRAY_BUFFER, stream->GetBuffer() );
 
     //Position data
-    GLint posAttrib = glGetAttribLocation(myProgram->GetProgramID(), "VertexPosition");
+    GLint posAttrib = myProgram->GetAttribLocation(VERTEXPOSITION_ATTRIB);
     glEnableVertexAttribArray(posAttrib);
-    glVertexAttribPointer(posAttrib, 2, GL_FLOAT, GL_FALSE, 10*sizeof(float),  0);
+    glVertexAttribPointer(posAttrib, 2, GL_FLOAT, GL_FALSE, 10*sizeof(float), (const GLvoid*)offset);
 
     //Texture coords
-    GLuint uvAttrib = glGetAttribLocation(myProgram->GetProgramID(), "TextureCoords");
+    GLuint uvAttrib = myProgram->GetAttribLocation(TEXTURECOORDS_ATTRIB);
     glEnableVertexAttribArray(uvAttrib);
-    glVertexAttribPointer(uvAttrib, 2, GL_FLOAT, GL_FALSE, 10*sizeof(float), (const GLvoid*)(2 * sizeof(float)));
+    glVertexAttribPointer(uvAttrib, 2, GL_FLOAT, GL_FALSE, 10*sizeof(float), (const GLvoid*)(offset + 2 * sizeof(float)));
     
     //Mask coords
-    GLuint uvMaskAttrib = glGetAttribLocation(myProgram->GetProgramID(), "MaskCoords");
+    GLuint uvMaskAttrib = myProgram->GetAttribLocation(MASKCOORDS_ATTRIB);
     glEnableVertexAttribArray(uvMaskAttrib);
-    glVertexAttribPointer(uvMaskAttrib, 2, GL_FLOAT, GL_FALSE, 10*sizeof(float), (const GLvoid*)(4 * sizeof(float)));
+    glVertexAttribPointer(uvMaskAttrib, 2, GL_FLOAT, GL_FALSE, 10*sizeof(float), (const GLvoid*)(offset + 4 * sizeof(float)));
     
     //Load the texture 
-	GLuint TextureID = glGetUniformLocation(myProgram->GetProgramID(), "uvMap");
+	GLuint TextureID = myProgram->GetUniformLocation(UVMAP_UNIFORM);
 	glUniform1i(TextureID, 0);
     
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, m_texture->GetTextureId());
     
     //Load mask texture
-    GLuint MaskID = glGetUniformLocation(myProgram->GetProgramID(), "myMask");
+    GLuint MaskID = myProgram->GetUniformLocation(MASK_UNIFORM);
     glUniform1i(MaskID, 1);
 
     glActiveTexture(GL_TEXTURE1);
 	glBindTexture(GL_TEXTURE_2D, m_mask->GetTextureId());
 
     //Color attribute
-    GLuint colAttrib = glGetAttribLocation(myProgram->GetProgramID(), "overColor");
+    GLuint colAttrib = myProgram->GetAttribLocation(OVERCOLOR_ATTRIB);
     glEnableVertexAttribArray(colAttrib);
-    glVertexAttribPointer(colAttrib, 4, GL_FLOAT, GL_FALSE, 10*sizeof(float), (const GLvoid*)(6 * sizeof(float)));
+    glVertexAttribPointer(colAttrib, 4, GL_FLOAT, GL_FALSE, 10*sizeof(float), (const GLvoid*)(offset + 6 * sizeof(float)));
 
     //Draw the elements
     glDrawArrays(GL_TRIANGLES, 0, 6);
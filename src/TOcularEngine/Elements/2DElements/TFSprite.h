@@ -8,6 +8,7 @@
  */
 
 #include "TFDrawable.h"
+#include "./../../../EngineUtilities/TResourceHandle.h"
 #include <TOEvector4d.h>
 
 //FAST FORWARD DECLARATION
@@ -129,11 +130,11 @@ private:
      */
     ~TFSprite();
 
-    TResourceTexture* 	m_texture;  //Texture resource
+    TResourceHandle<TResourceTexture> m_texture;    //Texture resource
     TOEvector2df m_texture_size;    //Texture size in OpenLG units
     TOEvector4df m_rect;            //Texture rectangle coordinates in OpenGL units
     TOEvector4df m_mask_rect;       //Mask texture rectangle coordinates in OpenGL units
-    TResourceTexture* m_mask;       //Mask texture resource
-    GLuint m_VAO, m_VBO;            //Vertex Array and Vertex Buffer objects
+    TResourceHandle<TResourceTexture> m_mask;       //Mask texture resource
+    GLuint m_VAO;                   //Vertex Array object
 };
 #endif
\ No newline at end of file
@@ -0,0 +1,97 @@
+#include "./BatchParticleManager.h"
+
+#if defined(__AVX__)
+	#include <immintrin.h>
+	#define BATCHPARTICLE_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define BATCHPARTICLE_SSE
+#endif
+
+BatchParticleManager::BatchParticleManager(){
+	m_gravity = 0.0f;
+	m_drag = 0.0f;
+	m_acceleration = TOEvector3df(0, 0, 0);
+}
+
+BatchParticleManager::~BatchParticleManager(){}
+
+void BatchParticleManager::UpdateParticle(Particle& p, float deltaTime){
+	float damping = 1.0f - m_drag * deltaTime;
+	if(damping < 0.0f) damping = 0.0f;
+
+	p.speed.X = (p.speed.X + m_acceleration.X * deltaTime) * damping;
+	p.speed.Y = (p.speed.Y + (m_acceleration.Y - m_gravity) * deltaTime) * damping;
+	p.speed.Z = (p.speed.Z + m_acceleration.Z * deltaTime) * damping;
+
+	p.pos.X += p.speed.X * deltaTime;
+	p.pos.Y += p.speed.Y * deltaTime;
+	p.pos.Z += p.speed.Z * deltaTime;
+}
+
+void BatchParticleManager::UpdateParticles(TParticleArray* particles, int first, int count, float deltaTime){
+	// The drag is the same for every particle, so it is computed once per frame
+	float damping = 1.0f - m_drag * deltaTime;
+	if(damping < 0.0f) damping = 0.0f;
+
+	IntegrateAxis(particles->posX + first, particles->speedX + first, count, m_acceleration.X, damping, deltaTime);
+	IntegrateAxis(particles->posY + first, particles->speedY + first, count, m_acceleration.Y - m_gravity, damping, deltaTime);
+	IntegrateAxis(particles->posZ + first, particles->speedZ + first, count, m_acceleration.Z, damping, deltaTime);
+}
+
+bool BatchParticleManager::IsThreadSafe(){
+	return true;
+}
+
+void BatchParticleManager::IntegrateAxis(float* pos, float* speed, int count, float accel, float damping, float deltaTime){
+	int i = 0;
+	float accelStep = accel * deltaTime;
+
+#if defined(BATCHPARTICLE_AVX)
+	// 8 particles per iteration
+	__m256 vAccel = _mm256_set1_ps(accelStep), vDamping = _mm256_set1_ps(damping), vDelta = _mm256_set1_ps(deltaTime);
+	for(; i + 8 <= count; i += 8){
+		__m256 s = _mm256_mul_ps(_mm256_add_ps(_mm256_loadu_ps(speed + i), vAccel), vDamping);
+		_mm256_storeu_ps(speed + i, s);
+		_mm256_storeu_ps(pos + i, _mm256_add_ps(_mm256_loadu_ps(pos + i), _mm256_mul_ps(s, vDelta)));
+	}
+#elif defined(BATCHPARTICLE_SSE)
+	// 4 particles per iteration
+	__m128 vAccel = _mm_set1_ps(accelStep), vDamping = _mm_set1_ps(damping), vDelta = _mm_set1_ps(deltaTime);
+	for(; i + 4 <= count; i += 4){
+		__m128 s = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(speed + i), vAccel), vDamping);
+		_mm_storeu_ps(speed + i, s);
+		_mm_storeu_ps(pos + i, _mm_add_ps(_mm_loadu_ps(pos + i), _mm_mul_ps(s, vDelta)));
+	}
+#endif
+
+	// The ones that do not fill a register (or all of them without SIMD)
+	for(; i<count; i++){
+		speed[i] = (speed[i] + accelStep) * damping;
+		pos[i] += speed[i] * deltaTime;
+	}
+}
+
+void BatchParticleManager::SetGravity(float gravity){
+	m_gravity = gravity;
+}
+
+void BatchParticleManager::SetDrag(float drag){
+	m_drag = drag;
+}
+
+void BatchParticleManager::SetAcceleration(TOEvector3df acceleration){
+	m_acceleration = acceleration;
+}
+
+float BatchParticleManager::GetGravity(){
+	return m_gravity;
+}
+
+float BatchParticleManager::GetDrag(){
+	return m_drag;
+}
+
+TOEvector3df BatchParticleManager::GetAcceleration(){
+	return m_acceleration;
+}
\ No newline at end of file
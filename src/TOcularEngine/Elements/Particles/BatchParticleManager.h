@@ -0,0 +1,97 @@
+#ifndef BATCHPARTICLEMANAGER_H
+#define BATCHPARTICLEMANAGER_H
+
+/**
+ * @brief Particle Manager that moves the particles with gravity, drag and a constant acceleration,
+ * 		  updating whole spans of particles with SSE/AVX.
+ *
+ * @file BatchParticleManager.h
+ */
+
+#include "./ParticleManager.h"
+
+class BatchParticleManager: public ParticleManager{
+public:
+	/**
+	 * @brief Construct a new Batch Particle Manager object without forces (the particles keep their speed)
+	 *
+	 */
+	BatchParticleManager();
+
+	/**
+	 * @brief Destroy the Batch Particle Manager object
+	 *
+	 */
+	virtual ~BatchParticleManager();
+
+	/**
+	 * @brief Update one particle with the same forces as UpdateParticles
+	 *
+	 * @param p: particle to update
+	 * @param deltaTime: time between frames
+	 */
+	virtual void UpdateParticle(Particle& p, float deltaTime) override;
+
+	/**
+	 * @brief Update a span of particles at once, dead particles are updated too (they are not drawn)
+	 *
+	 * @param particles: particles of the system
+	 * @param first: first particle to update
+	 * @param count: number of particles to update
+	 * @param deltaTime: time between frames
+	 */
+	virtual void UpdateParticles(TParticleArray* particles, int first, int count, float deltaTime) override;
+
+	/**
+	 * @brief Returns true, the spans only depend on the forces and their own particles
+	 */
+	virtual bool IsThreadSafe() override;
+
+	/**
+	 * @brief Set the gravity, pulls the particles down the Y axis
+	 *
+	 * @param gravity: acceleration of the gravity (units per second squared)
+	 */
+	void SetGravity(float gravity);
+
+	/**
+	 * @brief Set the drag, fraction of the speed lost every second
+	 *
+	 * @param drag: drag of the particles
+	 */
+	void SetDrag(float drag);
+
+	/**
+	 * @brief Set a constant acceleration added to the gravity (wind, buoyancy...)
+	 *
+	 * @param acceleration: acceleration (units per second squared)
+	 */
+	void SetAcceleration(TOEvector3df acceleration);
+
+	/**
+	 * @brief Get the gravity
+	 */
+	float GetGravity();
+
+	/**
+	 * @brief Get the drag
+	 */
+	float GetDrag();
+
+	/**
+	 * @brief Get the constant acceleration
+	 */
+	TOEvector3df GetAcceleration();
+
+private:
+	float			m_gravity;			// Gravity down the Y axis
+	float			m_drag;				// Fraction of the speed lost every second
+	TOEvector3df	m_acceleration;		// Constant acceleration
+
+	/**
+	 * @brief Integrates one axis of a span: speed += accel * dt, speed *= damping, pos += speed * dt
+	 */
+	static void IntegrateAxis(float* pos, float* speed, int count, float accel, float damping, float deltaTime);
+};
+
+#endif
\ No newline at end of file
@@ -1,4 +1,118 @@
 #include "./ParticleManager.h"
+#include <cstring>
+
+// Every field starts aligned to 32 bytes, the size of an AVX register
+static unsigned long long AlignField(unsigned long long bytes){
+	return (bytes + 31) & ~31ull;
+}
+
+TParticleArray::TParticleArray(){
+	Place(nullptr, 0);
+}
+
+unsigned long long TParticleArray::GetBytes(int count){
+	return 12 * AlignField(count * sizeof(float)) + 3 * AlignField(count * sizeof(unsigned char));
+}
+
+void TParticleArray::Place(unsigned char* memory, int count){
+	capacity = count;
+	unsigned long long floatBytes = AlignField(count * sizeof(float));
+	unsigned long long byteBytes = AlignField(count * sizeof(unsigned char));
+
+	float** floats[12] = {&posX, &posY, &posZ, &speedX, &speedY, &speedZ, &translationX, &translationY, &translationZ, &size, &rotation, &life};
+	for(int i=0; i<12; i++){
+		*floats[i] = (float*)memory;
+		if(memory != nullptr) memory += floatBytes;
+	}
+
+	unsigned char** bytes[3] = {&r, &g, &b};
+	for(int i=0; i<3; i++){
+		*bytes[i] = memory;
+		if(memory != nullptr) memory += byteBytes;
+	}
+}
+
+void TParticleArray::Copy(const TParticleArray& other, int count){
+	if(count <= 0) return;
+	memcpy(posX, other.posX, count * sizeof(float));
+	memcpy(posY, other.posY, count * sizeof(float));
+	memcpy(posZ, other.posZ, count * sizeof(float));
+	memcpy(speedX, other.speedX, count * sizeof(float));
+	memcpy(speedY, other.speedY, count * sizeof(float));
+	memcpy(speedZ, other.speedZ, count * sizeof(float));
+	memcpy(translationX, other.translationX, count * sizeof(float));
+	memcpy(translationY, other.translationY, count * sizeof(float));
+	memcpy(translationZ, other.translationZ, count * sizeof(float));
+	memcpy(r, other.r, count * sizeof(unsigned char));
+	memcpy(g, other.g, count * sizeof(unsigned char));
+	memcpy(b, other.b, count * sizeof(unsigned char));
+	memcpy(size, other.size, count * sizeof(float));
+	memcpy(rotation, other.rotation, count * sizeof(float));
+	memcpy(life, other.life, count * sizeof(float));
+}
+
+void TParticleArray::Clear(int first, int count){
+	for(int i=first; i<first+count; i++){
+		posX[i] = posY[i] = posZ[i] = 0.0f;
+		speedX[i] = speedY[i] = speedZ[i] = 0.0f;
+		translationX[i] = translationY[i] = translationZ[i] = 0.0f;
+		r[i] = g[i] = b[i] = 0;
+		size[i] = rotation[i] = 0.0f;
+		life[i] = -1.0f;
+	}
+}
+
+int TParticleArray::Size(){
+	return capacity;
+}
+
+void TParticleArray::Get(int index, Particle* p){
+	p->pos = TOEvector3df(posX[index], posY[index], posZ[index]);
+	p->speed = TOEvector3df(speedX[index], speedY[index], speedZ[index]);
+	p->translation = TOEvector3df(translationX[index], translationY[index], translationZ[index]);
+	p->r = r[index];
+	p->g = g[index];
+	p->b = b[index];
+	p->size = size[index];
+	p->rotation = rotation[index];
+	p->life = life[index];
+}
+
+void TParticleArray::Set(int index, const Particle& p){
+	posX[index] = p.pos.X;
+	posY[index] = p.pos.Y;
+	posZ[index] = p.pos.Z;
+	speedX[index] = p.speed.X;
+	speedY[index] = p.speed.Y;
+	speedZ[index] = p.speed.Z;
+	translationX[index] = p.translation.X;
+	translationY[index] = p.translation.Y;
+	translationZ[index] = p.translation.Z;
+	r[index] = p.r;
+	g[index] = p.g;
+	b[index] = p.b;
+	size[index] = p.size;
+	rotation[index] = p.rotation;
+	life[index] = p.life;
+}
+
+void TParticleArray::Move(int from, int to){
+	posX[to] = posX[from];
+	posY[to] = posY[from];
+	posZ[to] = posZ[from];
+	speedX[to] = speedX[from];
+	speedY[to] = speedY[from];
+	speedZ[to] = speedZ[from];
+	translationX[to] = translationX[from];
+	translationY[to] = translationY[from];
+	translationZ[to] = translationZ[from];
+	r[to] = r[from];
+	g[to] = g[from];
+	b[to] = b[from];
+	size[to] = size[from];
+	rotation[to] = rotation[from];
+	life[to] = life[from];
+}
 
 ParticleManager::ParticleManager(){}
 
@@ -40,3 +154,28 @@ void ParticleManager::UpdateParticle(Particle& p, float deltaTime){
 	p.pos.Y += p.speed.Y * deltaTime;
 	p.pos.Z += p.speed.Z * deltaTime;
 }
+
+void ParticleManager::InitParticles(TParticleArray* particles, int first, int count){
+	// Adapter for the managers that init one particle at a time
+	Particle p;
+	for(int i=first; i<first+count; i++){
+		particles->Get(i, &p);
+		InitParticle(p);
+		particles->Set(i, p);
+	}
+}
+
+void ParticleManager::UpdateParticles(TParticleArray* particles, int first, int count, float deltaTime){
+	// Adapter for the managers that update one particle at a time, only the live ones like before
+	Particle p;
+	for(int i=first; i<first+count; i++){
+		if(particles->life[i] <= 0.0f) continue;
+		particles->Get(i, &p);
+		UpdateParticle(p, deltaTime);
+		particles->Set(i, p);
+	}
+}
+
+bool ParticleManager::IsThreadSafe(){
+	return false;
+}
\ No newline at end of file
@@ -8,6 +8,7 @@
  */
 
 #include <TOEvector3d.h>
+#include <vector>
 
 struct Particle{
 	TOEvector3df pos, speed, translation;		// Position, speed and traslation
@@ -16,6 +17,95 @@ struct Particle{
 	float life = -1.0f;							// time of life
 };
 
+/**
+ * @brief What a particle system does when it has to create particles and it is full
+ */
+enum PARTICLEFULLPOLICY{
+	PARTICLE_DROP		= 0,	// The new particles are not created
+	PARTICLE_RECYCLE	= 1,	// The particles closest to dying are replaced by the new ones
+	PARTICLE_GROW		= 2		// The system doubles its capacity
+};
+
+/**
+ * @brief Particles of a system stored as one array per field (structure of arrays),
+ * 		  so the batch updates can load several particles in a SIMD register.
+ * 		  The arrays do not own their memory, the system places them in a block of the TParticlePool.
+ */
+struct TParticleArray{
+	float			*posX, *posY, *posZ;						// Position of every particle
+	float			*speedX, *speedY, *speedZ;					// Speed of every particle
+	float			*translationX, *translationY, *translationZ;	// Traslation of every particle
+	unsigned char	*r, *g, *b;									// Color of every particle
+	float			*size, *rotation;							// Size and rotation of every particle
+	float			*life;										// Time of life, dead if it is not positive
+	int				capacity;									// Number of particles that fit in the arrays
+
+	/**
+	 * @brief Construct an empty array, without memory
+	 */
+	TParticleArray();
+
+	/**
+	 * @brief Returns the bytes needed to place a number of particles (every field aligned to 32 bytes)
+	 * 
+	 * @param count: number of particles
+	 */
+	static unsigned long long GetBytes(int count);
+
+	/**
+	 * @brief Points the arrays to a block of memory, its contents are not touched
+	 * 
+	 * @param memory: block of at least GetBytes(count) bytes
+	 * @param count: number of particles that fit
+	 */
+	void Place(unsigned char* memory, int count);
+
+	/**
+	 * @brief Copies the first particles of other arrays (when the system moves to a bigger block)
+	 * 
+	 * @param other: arrays to copy
+	 * @param count: number of particles to copy
+	 */
+	void Copy(const TParticleArray& other, int count);
+
+	/**
+	 * @brief Sets a span of particles to zero and dead
+	 * 
+	 * @param first: first particle
+	 * @param count: number of particles
+	 */
+	void Clear(int first, int count);
+
+	/**
+	 * @brief Returns the number of particles that fit
+	 */
+	int Size();
+
+	/**
+	 * @brief Copies a particle to the per particle struct
+	 * 
+	 * @param index: particle to read
+	 * @param p: struct to fill
+	 */
+	void Get(int index, Particle* p);
+
+	/**
+	 * @brief Copies a per particle struct into the arrays
+	 * 
+	 * @param index: particle to write
+	 * @param p: values of the particle
+	 */
+	void Set(int index, const Particle& p);
+
+	/**
+	 * @brief Copies a particle over another one (to fill the hole of a dead particle)
+	 * 
+	 * @param from: particle to copy
+	 * @param to: particle to overwrite
+	 */
+	void Move(int from, int to);
+};
+
 class ParticleManager{
 public:
 	/**
@@ -44,6 +134,35 @@ public:
 	 * @param deltaTime: time between frames
 	 */
 	virtual void UpdateParticle(Particle& p, float deltaTime);
+
+	/**
+	 * @brief Inits a span of particles. By default calls InitParticle for each one
+	 * 
+	 * @param particles: particles of the system
+	 * @param first: first particle to init
+	 * @param count: number of particles to init
+	 */
+	virtual void InitParticles(TParticleArray* particles, int first, int count);
+
+	/**
+	 * @brief Updates a span of particles at once. By default calls UpdateParticle for each live one,
+	 * 		  managers that work on the arrays directly (BatchParticleManager) override it.
+	 * 		  Only called from several threads at the same time (with different spans) if IsThreadSafe returns true
+	 * 
+	 * @param particles: particles of the system
+	 * @param first: first particle to update
+	 * @param count: number of particles to update
+	 * @param deltaTime: time between frames
+	 */
+	virtual void UpdateParticles(TParticleArray* particles, int first, int count, float deltaTime);
+
+	/**
+	 * @brief Returns if UpdateParticles can run on the worker threads of the TJobPool.
+	 * 		  By default false: the spans are updated on the main thread, in order, so UpdateParticle
+	 * 		  can use rand() or shared state and gives the same result every run.
+	 * 		  A manager that returns true must only write the particles of its span and read nothing that changes during the update
+	 */
+	virtual bool IsThreadSafe();
 	
 };
 
@@ -4,7 +4,7 @@
 #include "./../../../EngineUtilities/TNode.h"
 #include "./../../VideoDriver.h"
 
-TFParticleSystem::TFParticleSystem(TOEvector3df position, TOEvector3df rotation, TOEvector3df scale) : TFNode(){	
+TFParticleSystem::TFParticleSystem(TOEvector3df position, TOEvector3df rotation, TOEvector3df scale, int capacity) : TFNode(){	
 	TTransform*  t = (TTransform*) m_scaleNode->GetEntity();
 	t->Scale(scale.X, scale.Y, scale.Z);
 
@@ -14,7 +14,7 @@ TFParticleSystem::TFParticleSystem(TOEvector3df position, TOEvector3df rotation,
 	t = (TTransform*) m_positionNode->GetEntity();
 	t->Translate(position.X, position.Y, position.Z);
 
-	m_entityNode->SetEntity(new TParticleSystem());
+	m_entityNode->SetEntity(new TParticleSystem("", capacity));
 }
 
 TFParticleSystem::~TFParticleSystem(){
@@ -55,6 +55,10 @@ void TFParticleSystem::Update(float deltaTime){
 	mySystem->Update(deltaTime);
 }
 
+TParticleSystem* TFParticleSystem::GetSystem(){
+	return (TParticleSystem*)m_entityNode->GetEntity();
+}
+
 void TFParticleSystem::SetNewPerSecond(int newPerSecond){
 	TParticleSystem* mySystem = (TParticleSystem*)m_entityNode->GetEntity();
 	mySystem->SetNewPerSecond(newPerSecond);
@@ -63,4 +67,29 @@ void TFParticleSystem::SetNewPerSecond(int newPerSecond){
 int TFParticleSystem::GetNewPerSecond(){
 	TParticleSystem* mySystem = (TParticleSystem*)m_entityNode->GetEntity();
 	return mySystem->GetNewPerSecond();
+}
+
+void TFParticleSystem::SetFullPolicy(PARTICLEFULLPOLICY policy){
+	TParticleSystem* mySystem = (TParticleSystem*)m_entityNode->GetEntity();
+	mySystem->SetFullPolicy(policy);
+}
+
+PARTICLEFULLPOLICY TFParticleSystem::GetFullPolicy(){
+	TParticleSystem* mySystem = (TParticleSystem*)m_entityNode->GetEntity();
+	return mySystem->GetFullPolicy();
+}
+
+int TFParticleSystem::GetParticleCount(){
+	TParticleSystem* mySystem = (TParticleSystem*)m_entityNode->GetEntity();
+	return mySystem->GetParticleCount();
+}
+
+void TFParticleSystem::SetCapacity(int capacity){
+	TParticleSystem* mySystem = (TParticleSystem*)m_entityNode->GetEntity();
+	mySystem->SetCapacity(capacity);
+}
+
+int TFParticleSystem::GetCapacity(){
+	TParticleSystem* mySystem = (TParticleSystem*)m_entityNode->GetEntity();
+	return mySystem->GetCapacity();
 }
\ No newline at end of file
@@ -9,6 +9,9 @@
 
 #include "./../TFNode.h"
 #include "ParticleManager.h"
+#include "BatchParticleManager.h"
+
+class TParticleSystem;
 
 class TFParticleSystem: public TFNode{
 	friend class SceneManager;
@@ -61,6 +64,41 @@ public:
 	 */
 	int GetNewPerSecond();
 
+	/**
+	 * @brief Set what happens when particles are created and the system is full
+	 * 
+	 * @param policy: PARTICLE_DROP, PARTICLE_RECYCLE (default) or PARTICLE_GROW
+	 */
+	void SetFullPolicy(PARTICLEFULLPOLICY policy);
+
+	/**
+	 * @brief Get what happens when particles are created and the system is full
+	 * 
+	 * @return PARTICLEFULLPOLICY 
+	 */
+	PARTICLEFULLPOLICY GetFullPolicy();
+
+	/**
+	 * @brief Get the number of live particles
+	 * 
+	 * @return int: live particles
+	 */
+	int GetParticleCount();
+
+	/**
+	 * @brief Set the maximum number of live particles, the memory is taken from the particle pool as they are created
+	 * 
+	 * @param capacity: particles that fit (the last live ones are removed if there are more)
+	 */
+	void SetCapacity(int capacity);
+
+	/**
+	 * @brief Get the maximum number of live particles
+	 * 
+	 * @return int: particles that fit
+	 */
+	int GetCapacity();
+
 private:
 	/**
 	 * @brief Construct a new ParticleSystem object
@@ -68,13 +106,22 @@ private:
 	 * @param position 
 	 * @param rotation 
 	 * @param scale 
+	 * @param capacity: maximum number of live particles
 	 */
 	TFParticleSystem(
 		TOEvector3df position = TOEvector3df(0, 0, 0),
 		TOEvector3df rotation = TOEvector3df(0, 0, 0),
-		TOEvector3df scale = TOEvector3df(1, 1, 1)
+		TOEvector3df scale = TOEvector3df(1, 1, 1),
+		int capacity = 10000
 	);
 	
+	/**
+	 * @brief Get the Particle System entity, the SceneManager updates all of them at once
+	 * 
+	 * @return TParticleSystem* 
+	 */
+	TParticleSystem* GetSystem();
+
 	/**
 	//  * @brief Destroy the ParticleSystem
 	 * 
@@ -27,7 +27,7 @@ void TFAnimation::SetTexture(std::string texturePath){
 
 void TFAnimation::SetInvisible(){
     TAnimation* myAnim = (TAnimation*) m_entityNode->GetEntity();
-	myAnim->ChangeTexture(VideoDriver::GetInstance()->GetAssetsPath() + "/textures/invisible_texture.png");
+	myAnim->ChangeTexture(TResourceManager::GetInstance()->GetDefaultId(DEFAULT_INVISIBLE));
 }
 
 void TFAnimation::SetBoundBox(bool visible){
@@ -105,42 +105,28 @@ void TFLight::DrawLight(int num){
 	}
 
 	VideoDriver* vd = VideoDriver::GetInstance();
-	GLuint progID = vd->GetProgram(vd->GetCurrentProgram())->GetProgramID();
+	Program* myProgram = vd->GetProgram(vd->GetCurrentProgram());
 
-	std::string str = "Light["+std::to_string(num)+"].";
-	std::string aux = "";
-
-	aux = str +"Position";
+	// Las locations de cada campo de la luz estan cacheadas en el programa
 	position = TEntity::ViewMatrix * position;
-	glUniform3fv(glGetUniformLocation(progID, aux.c_str()), 1, &position[0]);
-
-	aux = str +"Diffuse";
-	glUniform3fv(glGetUniformLocation(progID, aux.c_str()), 1, &diffuse[0]);
-
-	aux = str +"Specular";
-	glUniform3fv(glGetUniformLocation(progID, aux.c_str()), 1, &specular[0]);
-
-	aux = str +"Attenuation";
-	glUniform1f(glGetUniformLocation(progID, aux.c_str()), att);
-
-	aux = str +"Directional";
-	glUniform1i(glGetUniformLocation(progID, aux.c_str()), directional);
+	glUniform3fv(myProgram->GetLightUniformLocation(num, LIGHT_POSITION), 1, &position[0]);
+	glUniform3fv(myProgram->GetLightUniformLocation(num, LIGHT_DIFFUSE), 1, &diffuse[0]);
+	glUniform3fv(myProgram->GetLightUniformLocation(num, LIGHT_SPECULAR), 1, &specular[0]);
+	glUniform1f(myProgram->GetLightUniformLocation(num, LIGHT_ATTENUATION), att);
+	glUniform1i(myProgram->GetLightUniformLocation(num, LIGHT_DIRECTIONAL), directional);
 
 	if(directional){
-		aux = str +"Direction";
-		glUniform3fv(glGetUniformLocation(progID, aux.c_str()), 1, &direction[0]);
+		glUniform3fv(myProgram->GetLightUniformLocation(num, LIGHT_DIRECTION), 1, &direction[0]);
 	}
 
-	aux = str +"ShadowLight";
-	glUniform1i(glGetUniformLocation(progID, aux.c_str()), shadowlight);
+	glUniform1i(myProgram->GetLightUniformLocation(num, LIGHT_SHADOWLIGHT), shadowlight);
 
 	if(shadowlight){
 		// SEND THE SHADOW MAP
-		aux = str +"ShadowMap";
 		GLint textureNumber = 50 + num;	// Empezamos en el 50 para dejar sitio a las demas texturas
 		glActiveTexture(GL_TEXTURE0 + textureNumber);
 		glBindTexture(GL_TEXTURE_2D, m_shadowMap);
-		glUniform1i(glGetUniformLocation(progID, aux.c_str()), textureNumber);
+		glUniform1i(myProgram->GetLightUniformLocation(num, LIGHT_SHADOWMAP), textureNumber);
 	}
 }
 // SEND MVP TO THE SHADER
@@ -155,10 +141,9 @@ void TFLight::DrawLightMVP(int num){
 	glm::mat4 depthBIASMVP = biasMatrix * m_depthWVP;
 
 	// SEND
-	std::string aux = "DepthBiasMVPArray["+std::to_string(num)+"]";
 	VideoDriver* vd = VideoDriver::GetInstance();
-	GLuint progID = vd->GetProgram(vd->GetCurrentProgram())->GetProgramID();
-	glUniformMatrix4fv(glGetUniformLocation(progID, aux.c_str()), 1, GL_FALSE, &depthBIASMVP[0][0]);
+	Program* myProgram = vd->GetProgram(vd->GetCurrentProgram());
+	glUniformMatrix4fv(myProgram->GetDepthBiasLocation(num), 1, GL_FALSE, &depthBIASMVP[0][0]);
 }
 
 void TFLight::SetBoundBox(bool box){
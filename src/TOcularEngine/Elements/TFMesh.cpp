@@ -44,16 +44,17 @@ void TFMesh::SetMesh(std::string meshPath){
 
 void TFMesh::CreateCube(){
 	TMesh* myMesh = (TMesh*) m_entityNode->GetEntity();
-	myMesh->LoadMesh(VideoDriver::GetInstance()->GetAssetsPath() + "/models/cube.obj");
+	myMesh->LoadMesh("");	// Vacio carga el cubo
 }
 
 void TFMesh::CreateSphere(){
 	TMesh* myMesh = (TMesh*) m_entityNode->GetEntity();
-	myMesh->LoadMesh(VideoDriver::GetInstance()->GetAssetsPath() + "/models/sphere.obj");
+	myMesh->LoadMesh(TResourceManager::GetInstance()->GetDefaultId(DEFAULT_SPHERE));
 }
 
 void TFMesh::SetInvisible(){
-	SetTexture(VideoDriver::GetInstance()->GetAssetsPath() + "/textures/invisible_texture.png");
+	TMesh* myMesh = (TMesh*) m_entityNode->GetEntity();
+	myMesh->ChangeTexture(TResourceManager::GetInstance()->GetDefaultId(DEFAULT_INVISIBLE));
 }
 
 void TFMesh::SetBoundBox(bool visible){
@@ -61,6 +62,11 @@ void TFMesh::SetBoundBox(bool visible){
 	myMesh->SetBBVisibility(visible);
 }
 
+void TFMesh::SetOccluder(bool occluder){
+	TMesh* myMesh = (TMesh*) m_entityNode->GetEntity();
+	myMesh->SetOccluder(occluder);
+}
+
 void TFMesh::SetTextureScale(float valueX, float valueY){
 	TMesh* myMesh = (TMesh*) m_entityNode->GetEntity();
 	myMesh->SetTextureScale(valueX, valueY);
@@ -65,6 +65,14 @@ public:
 	 * @param visible: true = visible
 	 */
 	void SetBoundBox(bool visible) override; 
+
+	/**
+	 * @brief Marks the mesh as an occluder (walls, big static meshes)
+	 * 		Its triangles are rasterized on the CPU to skip the objects it hides
+	 * 
+	 * @param occluder: true = hides other objects
+	 */
+	void SetOccluder(bool occluder);
 	
 	/**
 	 * @brief Set the Texture Mapping Scale
@@ -4,6 +4,13 @@
 #include "./../EngineUtilities/Entities/TTransform.h"
 #include "./../EngineUtilities/TNode.h"
 #include "./../EngineUtilities/TRoom.h"
+#include "./../EngineUtilities/TRenderQueue.h"
+#include "./../EngineUtilities/TOcclusionBuffer.h"
+#include "./../EngineUtilities/TResourceManager.h"
+#include "./../EngineUtilities/TJobPool.h"
+#include "./../EngineUtilities/TParticlePool.h"
+#include "./../EngineUtilities/TStreamBuffer.h"
+#include "./../EngineUtilities/Entities/TParticleSystem.h"
 
 #include <algorithm>    // std::find
 #include <limits>		// std::numeric_limits<T>::max
@@ -26,12 +33,17 @@ SceneManager::SceneManager(){
 	m_currentRoom = -1;
 	m_dome = nullptr;
 	m_vao = 0;
+	m_occlusionBuffer = new TOcclusionBuffer();
 }
 
 SceneManager::~SceneManager(){
 	// Eliminamos los objetos de la escena
 	ClearElements();
 
+	// Eliminamos el buffer de oclusion
+	if(TEntity::m_occlusionBuffer == m_occlusionBuffer) TEntity::m_occlusionBuffer = nullptr;
+	delete m_occlusionBuffer;
+
 	// ELiminamos el buffer de vertices
 	glBindVertexArray(0);
 	glDeleteVertexArrays(1, &m_vao);
@@ -61,9 +73,7 @@ TFLight* SceneManager::AddLight(TOEvector3df position, TOEvector3df rotation, TO
 }
 
 TFMesh* SceneManager::AddMesh(TOEvector3df position, TOEvector3df rotation, TOEvector3df scale, std::string meshPath){
-	// En el caso de pasar una cadena vacia vamos a cargar un cubo
-	if(meshPath.compare("")==0) meshPath = VideoDriver::GetInstance()->GetAssetsPath() + "/models/cube.obj";
-
+	// En el caso de pasar una cadena vacia el TMesh carga el cubo por defecto
 	TFMesh* toRet = nullptr;
 	// Creamos el mesh
 	toRet = new TFMesh(position, rotation, scale, meshPath);
@@ -122,12 +132,13 @@ TFSprite* SceneManager::AddSprite(std::string texture, TOEvector2df position, TO
 	return toRet;
 }
 
-TFParticleSystem* SceneManager::AddParticleSystem(TOEvector3df position, TOEvector3df rotation, TOEvector3df scale){
+TFParticleSystem* SceneManager::AddParticleSystem(TOEvector3df position, TOEvector3df rotation, TOEvector3df scale, int capacity){
 	TFParticleSystem* toRet = nullptr;
 	// Creamos un sistema de particulas
-	toRet = new TFParticleSystem(position, rotation, scale);
-	// Lo anyadimos al vector de objetos
+	toRet = new TFParticleSystem(position, rotation, scale, capacity);
+	// Lo anyadimos al vector de objetos y al de sistemas de particulas
 	m_objects.push_back(toRet);
+	m_particleSystems.push_back(toRet);
 	// Lo ligamos a la raiz del arbol de escena
 	toRet->Attach(m_SceneTreeRoot);
 	return toRet;
@@ -259,6 +270,7 @@ bool SceneManager::DeleteMesh(TFNode* node){
 		if(*it == node){
 			// En el caso de encontrarlo lo eliminamos
 			m_objects.erase(it);
+			RemoveParticleSystem(node);
 			delete node;
 			toRet = true;
 		}
@@ -290,6 +302,7 @@ bool SceneManager::DeleteAnimation(TFNode* node){
 		if(node == m_objects[i]){
 			// EN el caso de encontrarlo lo eliminamos
 			m_objects.erase(m_objects.begin() + i);
+			RemoveParticleSystem(node);
 			delete node;
 			toRet = true;
 		}
@@ -357,6 +370,7 @@ void SceneManager::ChangeMainCamera(TFCamera* camera){
 void SceneManager::InitScene(){
 	glGenVertexArrays(1, &m_vao); // CREAMOS EL ARRAY DE VERTICES PARA LOS OBJETOS
 	glBindVertexArray(m_vao);
+	TRenderQueue::GetInstance()->SetDefaultVertexArray(m_vao);	// Los meshes tienen su propio VAO, este es para el resto
 }
 
 void SceneManager::Update(){
@@ -367,6 +381,28 @@ void SceneManager::Update(){
 	}
 }
 
+void SceneManager::UpdateParticles(float deltaTime){
+	// Primero las particulas nuevas de cada sistema, en serie y siempre en el mismo orden
+	// Los managers que no se pueden usar desde varios hilos se actualizan aqui mismo, tambien en orden
+	std::vector<std::pair<TParticleSystem*, int>> chunks;
+	int size = m_particleSystems.size();
+	for(int i=0; i<size; i++){
+		TParticleSystem* system = m_particleSystems[i]->GetSystem();
+		int count = system->BeginUpdate(deltaTime);
+		if(!system->IsThreadSafe()){
+			for(int j=0; j<count; j++) system->UpdateChunk(j);
+			continue;
+		}
+		for(int j=0; j<count; j++) chunks.push_back(std::pair<TParticleSystem*, int>(system, j));
+	}
+
+	// Los trozos de los demas sistemas se reparten entre los hilos
+	TJobPool::GetInstance()->Run(chunks.size(), [&chunks](int i){ chunks[i].first->UpdateChunk(chunks[i].second); });
+
+	// Se juntan y se suben a la grafica desde el hilo principal
+	for(int i=0; i<size; i++) m_particleSystems[i]->GetSystem()->EndUpdate();
+}
+
 void SceneManager::Draw(){
 	unsigned int currentFrame = TEntity::currentFrame;
 	currentFrame++;
@@ -400,6 +436,9 @@ void SceneManager::Draw(){
 	// Send lights position to shader
 	SendLights();
 
+	// Los oclusores se vuelven a rasterizar cada frame con la camara actual
+	if(TEntity::m_checkOcclusion) m_occlusionBuffer->Clear(TEntity::ProjMatrix * TEntity::ViewMatrix);
+
 	// Draw all of the elements in tree
     m_SceneTreeRoot->Draw();
     
@@ -513,6 +552,11 @@ void SceneManager::SetClipping(bool value){
 	TEntity::m_checkClipping = value;
 }
 
+void SceneManager::SetOcclusion(bool value){
+	TEntity::m_checkOcclusion = value;
+	TEntity::m_occlusionBuffer = value ? m_occlusionBuffer : nullptr;
+}
+
 void SceneManager::SetSendLights(bool value){
 	m_sendLights = value;
 }
@@ -538,6 +582,7 @@ void SceneManager::ClearElements(){
 		delete m_objects[i];
 	}
 	m_objects.clear();
+	m_particleSystems.clear();
 
 	// ELiminamos las habitaciones
 	size = m_rooms.size();
@@ -599,6 +644,10 @@ void SceneManager::SendLights(){
 	SendLightsToShader();
 	SendShadowLightsToShader();
 
+	vd->SetShaderProgram(INSTANCED_SHADER);
+	SendLightsToShader();
+	SendShadowLightsToShader();
+
 	vd->SetShaderProgram(STANDARD_SHADER);
 	SendLightsToShader();
 	SendShadowLightsToShader();
@@ -612,18 +661,18 @@ void SceneManager::SendShadowLightsToShader(){
 	if(m_sendLights){
 		size = SendLightMVP();
 	}
-	GLuint progID = vd->GetProgram(vd->GetCurrentProgram())->GetProgramID();
-	glUniform1i(glGetUniformLocation(progID, "nshadowlights"), size);
+	Program* myProgram = vd->GetProgram(vd->GetCurrentProgram());
+	glUniform1i(myProgram->GetUniformLocation(NSHADOWLIGHTS_UNIFORM), size);
 }
 
 
 void SceneManager::SendLightsToShader(){
 	// Gets the Programs
 	VideoDriver* vd = VideoDriver::GetInstance();
-	GLuint programID = vd->GetProgram(vd->GetCurrentProgram())->GetProgramID();
+	Program* myProgram = vd->GetProgram(vd->GetCurrentProgram());
 
 	// Sends the Ambient Light
-	GLint ambLocation = glGetUniformLocation(programID, "AmbientLight");
+	GLint ambLocation = myProgram->GetUniformLocation(AMBIENTLIGHT_UNIFORM);
 	glUniform3fv(ambLocation, 1, &m_ambientLight[0]);
 
 	// Draw all lights
@@ -640,7 +689,7 @@ void SceneManager::SendLightsToShader(){
 	}
 
     // Send size of lights
-	GLuint nlightspos = glGetUniformLocation(programID, "nlights");
+	GLint nlightspos = myProgram->GetUniformLocation(NLIGHTS_UNIFORM);
 	glUniform1i(nlightspos, size);
 }
 
@@ -659,6 +708,10 @@ int SceneManager::SendLightMVP(){
 void SceneManager::ResetManager(){
 	// Elimianmos los objetos del arbol
 	ClearElements();
+	// Los recursos que solo usaban esos objetos ya no tienen referencias
+	TResourceManager::GetInstance()->ReleaseUnused();
+	// Y la memoria que han dejado los sistemas de particulas
+	TParticlePool::GetInstance()->Trim();
 	// Creamos una raiz del arbol nueva
 	TTransform* myTransform = new TTransform();
 	m_SceneTreeRoot = new TNode(myTransform);
@@ -666,6 +719,11 @@ void SceneManager::ResetManager(){
 }
 
 // PRIVATE FUNCTIONS
+void SceneManager::RemoveParticleSystem(TFNode* node){
+	std::vector<TFParticleSystem*>::iterator it = std::find(m_particleSystems.begin(), m_particleSystems.end(), node);
+	if(it != m_particleSystems.end()) m_particleSystems.erase(it);
+}
+
 bool SceneManager::Light2Room(TFNode* node){
 	// Buscamos la luz en el vector de luces
 	int size = m_lights.size();
@@ -682,46 +740,43 @@ bool SceneManager::Light2Room(TFNode* node){
 }
 
 void SceneManager::DrawAllLines(){
+	if(vertexVector.empty()) return;
 	Program* myProgram = VideoDriver::GetInstance()->SetShaderProgram(BB_SHADER);
 
-	// Full buffer of all vertices
-	GLuint vbo_vertices;
-	glGenBuffers(1, &vbo_vertices);
-	glBindBuffer(GL_ARRAY_BUFFER, vbo_vertices);
-	glBufferData(GL_ARRAY_BUFFER, vertexVector.size()*sizeof(GLfloat), &vertexVector[0], GL_STATIC_DRAW);
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	// All the vertices in the shared stream buffer
+	TStreamBuffer* stream = TStreamBuffer::GetInstance();
+	GLintptr offset = stream->Push(&vertexVector[0], vertexVector.size()*sizeof(GLfloat));
 
 	// Apply object's transformation matrix
 	glm::mat4 m = TEntity::ProjMatrix * TEntity::ViewMatrix;
-	GLuint uniform_m = glGetUniformLocation(myProgram->GetProgramID(), "MVP");
+	GLuint uniform_m = myProgram->GetUniformLocation(MVP_UNIFORM);
 	glUniformMatrix4fv(uniform_m, 1, GL_FALSE, &m[0][0]);
 
 	// Send light color
-	GLuint linecolor = glGetUniformLocation(myProgram->GetProgramID(), "LineColor");
+	GLuint linecolor = myProgram->GetUniformLocation(LINECOLOR_UNIFORM);
 	//glUniform3f(linecolor, color.X, color.Y, color.Z);
 	glUniform3f(linecolor, 1.0f, 1.0f, 0.0f);
 
 	// Send each vertex data
-	GLuint attribute_v_coord = glGetAttribLocation(myProgram->GetProgramID(), "VertexPosition");	
+	GLuint attribute_v_coord = myProgram->GetAttribLocation(VERTEXPOSITION_ATTRIB);	
 	glEnableVertexAttribArray(attribute_v_coord);
 
-	glBindBuffer(GL_ARRAY_BUFFER, vbo_vertices);
+	glBindBuffer(GL_ARRAY_BUFFER, stream->GetBuffer());
 	glVertexAttribPointer(
 		attribute_v_coord,  // attribute
 		4,                  // number of elements per vertex, here (x,y,z,w)
 		GL_FLOAT,           // the type of each element
 		GL_FALSE,           // take our values as-is
 		0,                  // no extra data between each position
-		0                   // offset of first element
+		(GLvoid*)offset     // offset of first element in the stream buffer
 	);
 	
-	// Send shader
-	glDrawArrays(GL_LINES, 0, vertexVector.size());
+	// Send shader, 4 floats per vertex
+	glDrawArrays(GL_LINES, 0, vertexVector.size()/4);
 
 	glDisableVertexAttribArray(attribute_v_coord);
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
 
-	glDeleteBuffers(1, &vbo_vertices);
 	vertexVector.clear();
 }
 
@@ -26,6 +26,7 @@
 // Forward declaration
 #include <GL/glew.h>
 class Program;
+class TOcclusionBuffer;
 
 class SceneManager{
     friend class TFRoom;
@@ -133,10 +134,11 @@ public:
      * @param position  (TOEvector3df)
      * @param rotation  (TOEvector3df)
      * @param scale     (TOEvector3df)
+     * @param capacity  (int)           Maximum number of live particles, its memory is taken as they are created
      * 
      * @return TFParticleSystem* 
      */
-    TFParticleSystem* AddParticleSystem(TOEvector3df position, TOEvector3df rotation, TOEvector3df scale);
+    TFParticleSystem* AddParticleSystem(TOEvector3df position, TOEvector3df rotation, TOEvector3df scale, int capacity = 10000);
 
     /**
      * @brief Adds a Room in the Scene
@@ -248,6 +250,15 @@ public:
      * 
      */
     void Update();
+
+    /**
+     * @brief   - Actualiza todos los sistemas de particulas de la escena a la vez en el TJobPool
+     *              Cada sistema se parte en trozos y se juntan antes de volver, listos para el Draw
+     *              El resultado no depende del numero de hilos
+     * 
+     * @param   - deltaTime - DeltaTime del frame
+     */
+    void UpdateParticles(float deltaTime);
     
     /**
      * @brief   - Pinta la escena
@@ -290,6 +301,14 @@ public:
      */
     void SetClipping(bool value);
 
+    /**
+     * @brief De/Active the CPU occlusion culling, the objects hidden behind the meshes
+     *      marked as occluders are not drawn. Only works with the clipping active
+     * 
+     * @param value True-Activate / False-Deactivate
+     */
+    void SetOcclusion(bool value);
+
     /**
      * @brief Push the TFDrawable object to the background of the elements
      * 
@@ -347,12 +366,14 @@ private:
     std::vector<TFNode*>        m_objects;          // m_objects - Pointers to the nodes created
     std::vector<TFDrawable*>    m_2Delems;          // m_2Delems - Pointers to the 2Delements created
     std::vector<TFDrawable*>    m_bkg2Delems;       // m_bkg2Delems - Pointers to the 2Delements created situated at the background
+    std::vector<TFParticleSystem*>  m_particleSystems;  // m_particleSystems - Particle systems created, also in m_objects
 
     glm::vec3 m_ambientLight;   // m_ambientLight - Ambient Light values
     TFCamera* m_main_camera;    // m_main_camera - Pointer to the main camera
     TFDome* m_dome;             // m_dome - Pointer to the dome of the scene
     int m_numshadowlights;      // m_numshadowlights - NUmber of shadow lights
     bool m_sendLights;          // m_sendLights - Send the lights to the shaders?
+    TOcclusionBuffer* m_occlusionBuffer;    // m_occlusionBuffer - CPU depth buffer where the occluders are rasterized each frame
 
 
     /**
@@ -373,6 +394,11 @@ private:
      */
     void UpdateCurrentRoom();
 
+    /**
+     * @brief Removes a node from the particle systems if it is one (before deleting it)
+     */
+    void RemoveParticleSystem(TFNode* node);
+
     /**
      * @brief   - Recalculate all the lights position 
      */
@@ -1,5 +1,6 @@
 #include "TOcularEngine.h"
 #include "./../EngineUtilities/TResourceManager.h"
+#include "./../EngineUtilities/Loaders/TFileSystem.h"
 
 VideoDriver* toe::GetVideoDriver(){
     privateVideoDriver = VideoDriver::GetInstance();
@@ -40,11 +41,56 @@ TFSprite* toe::AddSprite(std::string texture, TOEvector2df position, TOEvector2d
 }
 
 void toe::LoadMesh(std::string path){
-	TResourceManager::GetInstance()->GetResourceMesh(path);
+	// Lo que se precarga se queda fijado aunque nadie lo use todavia
+	TResourceManager* manager = TResourceManager::GetInstance();
+	TResourceHandle<TResourceMesh> mesh = manager->GetResourceMesh(path);
+	manager->PinResource(mesh);
 }
 
 void toe::LoadTexture(std::string path){
-	TResourceManager::GetInstance()->GetResourceTexture(path);
+	TResourceManager* manager = TResourceManager::GetInstance();
+	TResourceHandle<TResourceTexture> texture = manager->GetResourceTexture(path);
+	manager->PinResource(texture);
+}
+
+void toe::LoadMeshAsync(std::string path, std::function<void(bool)> callback){
+    TResourceCallback onLoad = nullptr;
+    if(callback != nullptr) onLoad = [callback](TResource* resource){ callback(resource->GetLoaded()); };
+    TResourceManager* manager = TResourceManager::GetInstance();
+    TResourceHandle<TResourceMesh> mesh = manager->GetResourceMeshAsync(path, onLoad);
+    manager->PinResource(mesh);
+}
+
+void toe::LoadTextureAsync(std::string path, std::function<void(bool)> callback){
+    TResourceCallback onLoad = nullptr;
+    if(callback != nullptr) onLoad = [callback](TResource* resource){ callback(resource->GetLoaded()); };
+    TResourceManager* manager = TResourceManager::GetInstance();
+    TResourceHandle<TResourceTexture> texture = manager->GetResourceTextureAsync(path, onLoad);
+    manager->PinResource(texture);
+}
+
+void toe::WaitLoads(){
+    TResourceManager::GetInstance()->WaitAll();
+}
+
+int toe::GetPendingLoads(){
+    return TResourceManager::GetInstance()->GetPendingLoads();
+}
+
+void toe::SetUploadBudget(unsigned long long bytes, float milliseconds){
+    TResourceManager::GetInstance()->SetUploadBudget(bytes, milliseconds);
+}
+
+bool toe::MountAssetPack(std::string path){
+    return TFileSystem::GetInstance()->MountPack(path, VideoDriver::GetInstance()->GetAssetsPath());
+}
+
+void toe::SetMemoryBudget(RESOURCETYPE type, unsigned long long cpuBytes, unsigned long long gpuBytes){
+    TResourceManager::GetInstance()->SetMemoryBudget(type, cpuBytes, gpuBytes);
+}
+
+void toe::GetMemoryUsage(RESOURCETYPE type, unsigned long long* cpuBytes, unsigned long long* gpuBytes){
+    TResourceManager::GetInstance()->GetMemoryUsage(type, cpuBytes, gpuBytes);
 }
 
 void toe::UnloadTexture(std::string path){
@@ -52,19 +98,27 @@ void toe::UnloadTexture(std::string path){
 }
 
 GLuint toe::GetTextureID(std::string path){
-    return TResourceManager::GetInstance()->GetResourceTexture(path)->GetTextureId();
+    // El id se devuelve fuera del motor, la textura tiene que seguir viva hasta UnloadTexture
+    TResourceManager* manager = TResourceManager::GetInstance();
+    TResourceHandle<TResourceTexture> texture = manager->GetResourceTexture(path);
+    manager->PinResource(texture);
+    return texture->GetTextureId();
 }
 
 TOEvector2di toe::GetTextureDims(std::string path){
-    int w = TResourceManager::GetInstance()->GetResourceTexture(path)->GetWidth();
-    int h = TResourceManager::GetInstance()->GetResourceTexture(path)->GetHeight();
+    // Se fija como en GetTextureID, si no se cargaria y se eliminaria en cada llamada
+    TResourceManager* manager = TResourceManager::GetInstance();
+    TResourceHandle<TResourceTexture> texture = manager->GetResourceTexture(path);
+    manager->PinResource(texture);
+    int w = texture->GetWidth();
+    int h = texture->GetHeight();
     return TOEvector2di(w,h);
 }
 
 int toe::GetTextureWidth(std::string path){
-    return TResourceManager::GetInstance()->GetResourceTexture(path)->GetWidth();
+    return GetTextureDims(path).X;
 }
 
 int toe::GetTextureHeight(std::string path){
-    return TResourceManager::GetInstance()->GetResourceTexture(path)->GetHeight();
+    return GetTextureDims(path).Y;
 }
\ No newline at end of file
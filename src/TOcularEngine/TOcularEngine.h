@@ -8,6 +8,8 @@
  */
 
 #include "VideoDriver.h"
+#include <ResourceTypes.h>
+#include <functional>
 
 namespace toe{
     /**
@@ -90,6 +92,68 @@ namespace toe{
      */
     void LoadTexture(std::string path);
 
+    /**
+     * @brief   - Carga un mesh en segundo plano 
+     * 
+     * @param   - path - Ruta del mesh 
+     * @param   - callback - Funcion a la que se llama al acabar con si se ha cargado bien, opcional
+     */
+    void LoadMeshAsync(std::string path, std::function<void(bool)> callback = nullptr);
+
+    /**
+     * @brief   - Carga una textura en segundo plano 
+     * 
+     * @param   - path - Ruta de la textura 
+     * @param   - callback - Funcion a la que se llama al acabar con si se ha cargado bien, opcional
+     */
+    void LoadTextureAsync(std::string path, std::function<void(bool)> callback = nullptr);
+
+    /**
+     * @brief   - Espera a que acaben todas las cargas en segundo plano, para las pantallas de carga 
+     */
+    void WaitLoads();
+
+    /**
+     * @brief   - Devuelve el numero de recursos que se estan cargando en segundo plano 
+     */
+    int GetPendingLoads();
+
+    /**
+     * @brief   - Cambia lo que se puede subir a la grafica por frame de los recursos cargados en segundo plano 
+     * 
+     * @param   - bytes - Bytes maximos por frame
+     * @param   - milliseconds - Tiempo maximo por frame
+     */
+    void SetUploadBudget(unsigned long long bytes, float milliseconds);
+
+    /**
+     * @brief   - Monta un pack de assets (AssetCooker --pack), sus ficheros tienen preferencia sobre los sueltos
+     *              El de la carpeta de assets (assets.toep) se monta solo al crear la ventana
+     * 
+     * @param   - path - Ruta del pack
+     * @return  - bool - Se ha montado, si no sigue leyendo los ficheros sueltos
+     */
+    bool MountAssetPack(std::string path);
+
+    /**
+     * @brief   - Cambia la memoria maxima de las texturas o los meshes, al pasarse se liberan los que llevan mas tiempo sin usarse, aunque sigan en la escena,
+     *              y se vuelven a cargar en segundo plano al usarse
+     * 
+     * @param   - type - TEXTURE_RESOURCE o MESH_RESOURCE
+     * @param   - cpuBytes - Bytes maximos en memoria principal, 0 sin limite
+     * @param   - gpuBytes - Bytes maximos en la grafica, 0 sin limite
+     */
+    void SetMemoryBudget(RESOURCETYPE type, unsigned long long cpuBytes, unsigned long long gpuBytes);
+
+    /**
+     * @brief   - Devuelve la memoria que usan los recursos de un tipo 
+     * 
+     * @param   - type - Tipo de recurso, NONE_RESOURCE para todos
+     * @param   - cpuBytes - Bytes en memoria principal
+     * @param   - gpuBytes - Bytes en la grafica
+     */
+    void GetMemoryUsage(RESOURCETYPE type, unsigned long long* cpuBytes, unsigned long long* gpuBytes);
+
     /**
      * @brief   - Elimina una textura 
      * 
@@ -106,6 +170,7 @@ namespace toe{
 
     /**
      * @brief   - Consigue las dimensiones de una textura 
+     *              La textura se queda cargada hasta UnloadTexture, como con GetTextureID
      * 
      * @param   - path - Ruta de la textura a la que conseguir la textura 
      */
@@ -1,6 +1,8 @@
 #include "VideoDriver.h"
 #include "./../EngineUtilities/Resources/Program.h"
 #include "./../EngineUtilities/TResourceManager.h"
+#include "./../EngineUtilities/Loaders/TFileSystem.h"
+#include "./../EngineUtilities/TStreamBuffer.h"
 #include <stdio.h>
 #include <string.h>
 
@@ -74,6 +76,9 @@ bool VideoDriver::CreateWindows(std::string window_name, TOEvector2di dimensions
 	glCullFace(GL_BACK);			// Hacerlo Backface
 	glFrontFace(GL_CW);				// Hacer las caras que miran a al camara Counter Clockwise
 
+	// Si hay un pack de la carpeta de assets a su lado (assets.toep) todo se lee de el
+	TFileSystem::GetInstance()->MountPack(m_assetsPath + ".toep", m_assetsPath);
+
 	initShaders();					// Cargamos los shaders
 	privateSceneManager->InitScene();
 
@@ -85,6 +90,12 @@ bool VideoDriver::Update(){
 	glfwPollEvents();
 	ClearScreen();
 
+	// Subimos a la grafica los recursos cargados en segundo plano, con el presupuesto del frame
+	TResourceManager::GetInstance()->UpdateLoads();
+
+	// Liberamos los recursos sin usar de los tipos que se pasan de presupuesto
+	TResourceManager::GetInstance()->UpdateMemory();
+
 	privateSceneManager->Update();
 	return true;
 }
@@ -107,6 +118,9 @@ void VideoDriver::EndDraw(){
 	privateSceneManager->Draw2DElements();
 	end2DDrawState();		// Lo volvemos a dejar listo para 3D
 
+	// Lo escrito este frame en el buffer de streaming no se pisa hasta que la grafica lo pinte
+	TStreamBuffer::GetInstance()->EndFrame();
+
 	glfwSwapBuffers(m_window);
 }
 
@@ -131,6 +145,9 @@ void VideoDriver::Drop(){
 	// Eliminamos el SceneManager
 	if(privateSceneManager != nullptr) delete privateSceneManager;
 
+	// Eliminamos el buffer de streaming mientras existe el contexto
+	TStreamBuffer::GetInstance()->Release();
+
 	// Eliminamos la ventana
 	glfwDestroyWindow(m_window);
 	glfwTerminate();
@@ -204,7 +221,7 @@ GLFWwindow* VideoDriver::GetWindow(){
 	return m_window;
 }
 
-std::string VideoDriver::GetAssetsPath(){
+const std::string& VideoDriver::GetAssetsPath(){
 	return m_assetsPath;
 }
 
@@ -283,6 +300,12 @@ void VideoDriver::initShaders(){
 	shaders.insert(std::pair<std::string, GLenum>(m_assetsPath + "/shaders/ShaderStand.frag", GL_FRAGMENT_SHADER));
 	m_programs.insert(std::pair<SHADERTYPE, Program*>(STANDARD_SHADER, new Program(shaders)));
 
+	// CARGAMOS EL PROGRAMA STANDAR CON INSTANCIAS
+	shaders = std::map<std::string, GLenum>();
+	shaders.insert(std::pair<std::string, GLenum>(m_assetsPath + "/shaders/ShaderStandInstanced.vs", GL_VERTEX_SHADER));
+	shaders.insert(std::pair<std::string, GLenum>(m_assetsPath + "/shaders/ShaderStand.frag", GL_FRAGMENT_SHADER));
+	m_programs.insert(std::pair<SHADERTYPE, Program*>(INSTANCED_SHADER, new Program(shaders)));
+
 	// CARGAMOS EL PROGRAMA DE TEXTO
 	shaders = std::map<std::string, GLenum>();
 	shaders.insert(std::pair<std::string, GLenum>(m_assetsPath + "/shaders/ShaderText.vs", GL_VERTEX_SHADER));
@@ -416,6 +439,22 @@ void VideoDriver::DisableClipping(){
 	privateSceneManager->SetClipping(false);
 }
 
+void VideoDriver::EnableOcclusion(){
+	privateSceneManager->SetOcclusion(true);
+}
+
+void VideoDriver::DisableOcclusion(){
+	privateSceneManager->SetOcclusion(false);
+}
+
+void VideoDriver::EnableAsyncLoading(){
+	TResourceManager::GetInstance()->SetAsyncLoading(true);
+}
+
+void VideoDriver::DisableAsyncLoading(){
+	TResourceManager::GetInstance()->SetAsyncLoading(false);
+}
+
 void VideoDriver::ChangeShader(SHADERTYPE shader, ENTITYTYPE entity){
 	privateSceneManager->ChangeShader(shader, entity);
 }
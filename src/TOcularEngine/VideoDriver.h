@@ -100,6 +100,27 @@ public:
 	 */
 	void DisableClipping();
 
+	/**
+	 * @brief	- Activa el descarte en CPU de los objetos tapados por los oclusores (necesita el clipping)
+	 */
+	void EnableOcclusion();
+
+	/**
+	 * @brief	- Desactiva el descarte por oclusion
+	 */
+	void DisableOcclusion();
+
+	/**
+	 * @brief	- Los meshes y texturas que se anyaden o cambian en la escena se cargan en segundo plano
+	 * 				Mientras tanto se pintan el cubo y la textura por defecto, la subida a la grafica se hace en Update
+	 */
+	void EnableAsyncLoading();
+
+	/**
+	 * @brief	- Vuelve a cargar los recursos de la escena al momento
+	 */
+	void DisableAsyncLoading();
+
 //GETTERS
 	/**
 	 * @brief Returns an instance of the Video Driver
@@ -187,7 +208,7 @@ public:
 	 * 
 	 * @return std::string 
 	 */
-	std::string GetAssetsPath();
+	const std::string& GetAssetsPath();
 
 	/**
 	 * @brief Get the Cursor Position
@@ -259,6 +259,10 @@ int main(){
 	TFParticleSystem* ps2 = sm->AddParticleSystem(TOEvector3df(17,0,20), TOEvector3df(0,0,0), TOEvector3df(1,1,1));
 	ps->SetManager(new ColoredParticle(true, false, false)); 
 	//ps1->SetManager(new ColoredParticle(false, true, false));
+	BatchParticleManager* smoke = new BatchParticleManager();
+	smoke->SetAcceleration(TOEvector3df(0.0f, 0.25f, 0.0f));
+	smoke->SetDrag(0.05f);
+	ps1->SetManager(smoke);
 	ps2->SetManager(new ColoredParticle(false, false, true));
 
 	// SUZANNE
@@ -304,9 +308,7 @@ int main(){
 			RotateLights(rot, meshes[0], meshes[1], meshes[2]);
 
 			// UPDATE PARTICLES
-			ps->Update(0.16f);
-			ps1->Update(0.16f);
-			ps2->Update(0.16f);
+			sm->UpdateParticles(0.16f);
 
 			//// TOGGLE LIGHTS
 			shadowLight->SetActive(false);
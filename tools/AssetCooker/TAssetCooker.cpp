@@ -0,0 +1,435 @@
+#include "TAssetCooker.h"
+#include "./../../src/EngineUtilities/Loaders/TMeshFile.h"
+#include "./../../src/EngineUtilities/Loaders/TObjParser.h"
+#include "./../../src/EngineUtilities/Loaders/TTextureFile.h"
+#include "./../../src/EngineUtilities/Loaders/TPackFile.h"
+
+// El cocinador no enlaza SOIL2 (necesita OpenGL), solo el decodificador de stb
+#define STB_IMAGE_IMPLEMENTATION
+#include <SOIL2/stb_image.h>
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <filesystem>
+#include <algorithm>
+#include <thread>
+#include <cstring>
+
+namespace fs = std::filesystem;
+
+TAssetCooker::TAssetCooker(std::string assetsPath, int threads){
+	m_assetsPath = assetsPath;
+	m_manifestPath = (fs::path(assetsPath) / "cook_manifest.txt").string();
+	m_formatsPath = (fs::path(assetsPath) / "cook_textures.txt").string();
+	m_threads = threads > 0 ? threads : std::max(1u, std::thread::hardware_concurrency());
+	m_force = false;
+	m_nextJob = 0;
+}
+
+TAssetCooker::~TAssetCooker(){
+	m_jobs.clear();
+	m_manifest.clear();
+	m_textureFormats.clear();
+}
+
+unsigned long long TAssetCooker::Hash(const void* data, unsigned long long size, unsigned long long hash){
+	const unsigned char* bytes = (const unsigned char*)data;
+	for(unsigned long long i=0; i<size; i++){
+		hash ^= bytes[i];
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+bool TAssetCooker::ReadFile(std::string path, std::vector<char>* content){
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	if(!file.is_open()) return false;
+
+	long long size = file.tellg();
+	file.seekg(0);
+	content->resize(size);
+	file.read(content->data(), size);
+	return file.good() || size == 0;
+}
+
+bool TAssetCooker::IsTextObj(const std::vector<char>* content){
+	// Los binarios empiezan por floats, en los primeros bytes siempre aparece algun caracter de control
+	int size = std::min((int)content->size(), 512);
+	if(size == 0) return false;
+	for(int i=0; i<size; i++){
+		unsigned char c = (*content)[i];
+		if(c < 9 || (c > 13 && c < 32)) return false;
+	}
+	return true;
+}
+
+std::string TAssetCooker::FindMaterialLibrary(std::string source, const std::vector<char>* content){
+	fs::path path(source);
+
+	// Los obj de texto dicen su mtl, el binario antiguo usa siempre el del mismo nombre (como TMaterialLoader)
+	if(IsTextObj(content)){
+		std::istringstream stream(std::string(content->begin(), content->end()));
+		std::string line;
+		while(std::getline(stream, line)){
+			if(line.compare(0, 7, "mtllib ") != 0) continue;
+			std::string name = line.substr(7);
+			name.erase(name.find_last_not_of(" \t\r") + 1);
+			return (path.parent_path() / name).string();
+		}
+	}
+
+	return path.replace_extension(".mtl").string();
+}
+
+std::string TAssetCooker::GetCookedPath(std::string source){
+	if(TTextureFile::IsImageFile(source)) return TTextureFile::GetCookedPath(source);
+	return TMeshFile::GetCookedPath(source);
+}
+
+void TAssetCooker::LoadTextureFormats(){
+	m_textureFormats.clear();
+
+	std::ifstream file(m_formatsPath);
+	std::string line;
+	int lineNumber = 0;
+	while(std::getline(file, line)){
+		lineNumber++;
+		std::istringstream stream(line);
+		std::string path, name;
+		if(!(stream>>path) || path[0] == '#') continue;
+
+		int format = stream>>name ? TTextureFile::ParseFormat(name) : -1;
+		if(format < 0){
+			std::cout<<"Formato de textura incorrecto en "<<m_formatsPath<<":"<<lineNumber<<std::endl;
+			continue;
+		}
+		m_textureFormats[path] = format;
+	}
+}
+
+int TAssetCooker::GetTextureFormat(std::string relative){
+	int format = TTextureFile::TEXTURE_AUTO;
+	std::size_t longest = 0;
+
+	// Una ruta exacta o una carpeta que la contiene, gana la mas concreta
+	std::map<std::string, int>::iterator it = m_textureFormats.begin();
+	for(; it != m_textureFormats.end(); ++it){
+		const std::string& rule = it->first;
+		bool folder = rule.back() == '/';
+		bool matches = folder ? relative.compare(0, rule.size(), rule) == 0 : relative == rule;
+		if(matches && rule.size() >= longest){
+			longest = rule.size();
+			format = it->second;
+		}
+	}
+	return format;
+}
+
+void TAssetCooker::CollectJobs(){
+	m_jobs.clear();
+	LoadTextureFormats();
+
+	std::error_code error;
+	fs::recursive_directory_iterator it(m_assetsPath, error), end;
+	for(; !error && it != end; it.increment(error)){
+		if(!it->is_regular_file()) continue;
+
+		TCookJob job;
+		job.source = it->path().string();
+		job.relative = fs::relative(it->path(), m_assetsPath).generic_string();
+		job.state = COOK_SKIPPED;
+		job.format = TTextureFile::TEXTURE_NONE;
+
+		if(it->path().extension() == ".obj") job.type = COOK_MESH;
+		else if(TTextureFile::IsImageFile(job.source)) job.type = COOK_TEXTURE;
+		else continue;
+
+		std::vector<char> content;
+		ReadFile(job.source, &content);
+		job.output = GetCookedPath(job.source);
+
+		if(job.type == COOK_MESH){
+			// El hash cubre el obj, su mtl y las versiones del cocinador y del formato
+			std::vector<char> material;
+			ReadFile(FindMaterialLibrary(job.source, &content), &material);
+
+			unsigned int versions[2] = {m_cookerVersion, TMeshFile::MESHFILE_VERSION};
+			job.hash = Hash(versions, sizeof(versions));
+			job.hash = Hash(content.data(), content.size(), job.hash);
+			job.hash = Hash(material.data(), material.size(), job.hash);
+		}
+		else{
+			// Las que no se comprimen se cargan tal cual, su DDS antiguo se borra al no estar en el manifiesto
+			job.format = GetTextureFormat(job.relative);
+			if(job.format == TTextureFile::TEXTURE_NONE) continue;
+
+			// El hash cubre la imagen, el formato elegido y la version del cocinador
+			unsigned int versions[2] = {m_cookerVersion, (unsigned int)job.format};
+			job.hash = Hash(versions, sizeof(versions));
+			job.hash = Hash(content.data(), content.size(), job.hash);
+		}
+
+		m_jobs.push_back(job);
+	}
+
+	if(error) std::cout<<"Error al recorrer la carpeta: "<<m_assetsPath<<" ("<<error.message()<<")"<<std::endl;
+
+	// Orden estable para que el manifiesto no cambie entre ejecuciones
+	std::sort(m_jobs.begin(), m_jobs.end(), [](const TCookJob& a, const TCookJob& b){ return a.relative < b.relative; });
+}
+
+void TAssetCooker::LoadManifest(){
+	m_manifest.clear();
+
+	std::ifstream file(m_manifestPath);
+	std::string line;
+	while(std::getline(file, line)){
+		// Cada linea: hash <tab> fuente relativo a la carpeta de assets
+		if(line.empty() || line[0] == '#') continue;
+		std::size_t tab = line.find('\t');
+		if(tab == std::string::npos) continue;
+		m_manifest[line.substr(tab + 1)] = line.substr(0, tab);
+	}
+}
+
+bool TAssetCooker::SaveManifest(){
+	std::ofstream file(m_manifestPath);
+	if(!file.is_open()){
+		std::cout<<"Error al escribir el manifiesto: "<<m_manifestPath<<std::endl;
+		return false;
+	}
+
+	file<<"# Generado por AssetCooker, no editar. hash <tab> fuente"<<std::endl;
+	int size = m_jobs.size();
+	for(int i=0; i<size; i++){
+		if(m_jobs[i].state == COOK_FAILED) continue;
+		file<<std::hex<<std::setw(16)<<std::setfill('0')<<m_jobs[i].hash<<'\t'<<m_jobs[i].relative<<std::endl;
+	}
+	return file.good();
+}
+
+void TAssetCooker::Log(std::string message){
+	std::lock_guard<std::mutex> lock(m_mutex);
+	std::cout<<message<<std::endl;
+}
+
+int TAssetCooker::Cook(bool force){
+	m_force = force;
+	CollectJobs();
+	LoadManifest();
+
+	// Los fuentes que ya no existen (o texturas que han pasado a none) se quitan junto con su fichero cocinado
+	std::map<std::string, bool> current;
+	int jobCount = m_jobs.size();
+	for(int i=0; i<jobCount; i++) current[m_jobs[i].relative] = true;
+
+	for(std::map<std::string, std::string>::iterator it = m_manifest.begin(); it != m_manifest.end(); ++it){
+		if(current.find(it->first) != current.end()) continue;
+		fs::path source = fs::path(m_assetsPath) / it->first;
+
+		std::error_code error;
+		fs::remove(GetCookedPath(source.string()), error);
+		Log("Eliminado: " + it->first);
+	}
+
+	// Cada hilo va cogiendo el siguiente fichero, son independientes entre si
+	m_nextJob = 0;
+	int threadCount = std::min(m_threads, std::max(1, (int)m_jobs.size()));
+	std::vector<std::thread> threads;
+	for(int i=0; i<threadCount; i++) threads.push_back(std::thread(&TAssetCooker::Worker, this));
+	for(int i=0; i<threadCount; i++) threads[i].join();
+
+	int cooked = 0, skipped = 0, failed = 0;
+	int size = m_jobs.size();
+	for(int i=0; i<size; i++){
+		if(m_jobs[i].state == COOK_DONE) cooked++;
+		else if(m_jobs[i].state == COOK_SKIPPED) skipped++;
+		else failed++;
+	}
+
+	SaveManifest();
+	std::cout<<"Cocinados: "<<cooked<<", sin cambios: "<<skipped<<", errores: "<<failed<<" ("<<threadCount<<" hilos)"<<std::endl;
+	return failed;
+}
+
+void TAssetCooker::Worker(){
+	while(true){
+		TCookJob* job = nullptr;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if(m_nextJob >= (int)m_jobs.size()) return;
+			job = &m_jobs[m_nextJob++];
+		}
+
+		// Solo se cocina si el contenido ha cambiado o falta el fichero
+		std::stringstream hash;
+		hash<<std::hex<<std::setw(16)<<std::setfill('0')<<job->hash;
+		std::map<std::string, std::string>::iterator it = m_manifest.find(job->relative);
+		bool changed = m_force || it == m_manifest.end() || it->second != hash.str() || !fs::exists(job->output);
+
+		if(!changed){
+			job->state = COOK_SKIPPED;
+			continue;
+		}
+
+		bool cooked = job->type == COOK_TEXTURE ? CookTexture(job) : CookMesh(job);
+		if(cooked){
+			job->state = COOK_DONE;
+			Log("Cocinado: " + job->relative);
+		}
+		else{
+			job->state = COOK_FAILED;
+			Log("Error al cocinar: " + job->relative);
+		}
+	}
+}
+
+bool TAssetCooker::CookMesh(TCookJob* job){
+	std::vector<char> content;
+	if(!ReadFile(job->source, &content)) return false;
+
+	// Un obj que ya es TOEM se carga tal cual en el motor
+	if(TMeshFile::IsMeshFile((const unsigned char*)content.data(), content.size())){
+		Log("Ya esta en formato TOEM, no se cocina: " + job->relative);
+		return false;
+	}
+
+	TMeshData mesh;
+	mesh.hasMaterial = false;
+	fs::path outputDir = fs::path(job->output).parent_path();
+	std::string materialLibrary = FindMaterialLibrary(job->source, &content);
+	std::string textures[3];
+
+	if(IsTextObj(&content)){
+		// Obj de texto: el parser ya lo indexa, el bounding box se calcula aqui en lugar de al arrancar
+		std::string library;
+		if(!TObjParser::ParseObj(job->source, &mesh.vertex, &mesh.uv, &mesh.normal, &mesh.index, &library, &mesh.paths[3])) return false;
+		if(!TObjParser::ComputeBoundingBox(&mesh.vertex, &mesh.center, &mesh.size)) return false;
+
+		// Las texturas del mtl son relativas al mtl, las pasamos a relativas al fichero cocinado
+		mesh.hasMaterial = TObjParser::ParseMaterial(materialLibrary, &mesh.paths[3], &mesh.material, textures);
+		fs::path materialDir = fs::path(materialLibrary).parent_path();
+		for(int i=0; i<3; i++){
+			if(!textures[i].empty()) mesh.paths[i] = fs::relative(materialDir / textures[i], outputDir).generic_string();
+		}
+	}
+	else{
+		// Binario antiguo: ya viene indexado, solo falta resolver el material
+		if(!TMeshFile::LoadLegacy((const unsigned char*)content.data(), content.size(), job->source, &mesh)) return false;
+		mesh.hasMaterial = TObjParser::ParseMaterial(materialLibrary, &mesh.paths[3], &mesh.material, textures);
+
+		// Sus texturas eran relativas a la carpeta desde la que se ejecuta, solo se pueden pasar si existen desde aqui
+		for(int i=0; i<3; i++){
+			if(mesh.paths[i].empty()) continue;
+			if(fs::exists(mesh.paths[i])) mesh.paths[i] = fs::relative(mesh.paths[i], outputDir).generic_string();
+			else Log("Aviso: no se encuentra " + mesh.paths[i] + ", se guarda sin cambiar en " + job->relative);
+		}
+	}
+
+	// Orden de triangulos para la cache de vertices y de vertices para la lectura, tambien en los binarios antiguos
+	TObjParser::OptimizeMesh(&mesh.vertex, &mesh.uv, &mesh.normal, &mesh.index, job->relative);
+
+	// Se escribe en un temporal y se renombra, un cocinado a medias nunca deja un fichero roto
+	std::string temporal = job->output + ".tmp";
+	if(!TMeshFile::Save(temporal, &mesh)) return false;
+
+	std::vector<char> written;
+	TMeshFileHeader header;
+	if(!ReadFile(temporal, &written) || !TMeshFile::Validate((const unsigned char*)written.data(), written.size(), temporal, &header)){
+		fs::remove(temporal);
+		return false;
+	}
+
+	std::error_code error;
+	fs::rename(temporal, job->output, error);
+	return !error;
+}
+
+bool TAssetCooker::CookTexture(TCookJob* job){
+	// Siempre en RGBA, el formato final lo decide el compresor
+	int width = 0, height = 0, channels = 0;
+	unsigned char* image = stbi_load(job->source.c_str(), &width, &height, &channels, 4);
+	if(image == nullptr){
+		Log("Error al leer la imagen: " + job->relative + " (" + stbi_failure_reason() + ")");
+		return false;
+	}
+
+	// Se escribe en un temporal y se renombra, un cocinado a medias nunca deja un fichero roto
+	std::string temporal = job->output + ".tmp";
+	bool saved = TTextureFile::Save(temporal, image, width, height, job->format);
+	stbi_image_free(image);
+	if(!saved) return false;
+
+	std::vector<char> written;
+	std::vector<TTextureFileLevel> levels;
+	int format = 0;
+	if(!ReadFile(temporal, &written) || !TTextureFile::Validate((const unsigned char*)written.data(), written.size(), temporal, &format, &levels)){
+		fs::remove(temporal);
+		return false;
+	}
+
+	std::error_code error;
+	fs::rename(temporal, job->output, error);
+	return !error;
+}
+
+bool TAssetCooker::Pack(std::string packPath, bool lz4){
+	std::vector<TPackSource> sources;
+	std::error_code error;
+	fs::path pack = fs::absolute(packPath, error);
+
+	fs::recursive_directory_iterator it(m_assetsPath, error), end;
+	for(; !error && it != end; it.increment(error)){
+		if(!it->is_regular_file()) continue;
+		std::string source = it->path().string();
+		if(source == m_manifestPath || source == m_formatsPath || it->path().extension() == ".tmp") continue;
+		std::error_code same;
+		if(fs::equivalent(it->path(), pack, same)) continue;
+
+		// Dentro del pack las rutas son relativas a la carpeta de assets, como las busca el TFileSystem
+		TPackSource entry;
+		entry.name = fs::relative(it->path(), m_assetsPath).generic_string();
+		entry.path = source;
+		sources.push_back(entry);
+	}
+	if(error){
+		std::cout<<"Error al recorrer la carpeta: "<<m_assetsPath<<" ("<<error.message()<<")"<<std::endl;
+		return false;
+	}
+
+	// Se escribe en un temporal y se renombra, el motor nunca monta un pack a medias
+	std::string temporal = packPath + ".tmp";
+	if(!TPackFile::Save(temporal, sources, lz4)) return false;
+
+	std::vector<char> written;
+	if(!ReadFile(temporal, &written) || !TPackFile::Validate((const unsigned char*)written.data(), written.size(), temporal)){
+		fs::remove(temporal);
+		return false;
+	}
+
+	// Las entradas comprimidas se descomprimen para comprobarlas
+	const unsigned char* data = (const unsigned char*)written.data();
+	const TPackHeader* header = (const TPackHeader*)data;
+	const TPackEntry* entries = (const TPackEntry*)(data + header->entryOffset);
+	unsigned long long rawSize = 0, storedSize = 0;
+	std::vector<unsigned char> check;
+	for(unsigned int i=0; i<header->entryCount; i++){
+		rawSize += entries[i].rawSize;
+		storedSize += entries[i].size;
+		if(entries[i].compression != TPackFile::PACK_LZ4) continue;
+		check.resize(entries[i].rawSize);
+		if(!TPackFile::DecompressLZ4(data + entries[i].offset, entries[i].size, check.data(), check.size())){
+			std::cout<<"Error al comprimir: "<<std::string(TPackFile::GetName(data, &entries[i]), entries[i].nameLength)<<std::endl;
+			fs::remove(temporal);
+			return false;
+		}
+	}
+
+	fs::rename(temporal, packPath, error);
+	if(error) return false;
+
+	std::cout<<"Pack "<<packPath<<": "<<header->entryCount<<" ficheros, "<<rawSize<<" bytes ("<<storedSize<<" guardados)"<<std::endl;
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,157 @@
+#ifndef TASSETCOOKER_H
+#define TASSETCOOKER_H
+
+/**
+ * @brief Offline cooker that converts the OBJ/MTL meshes of an asset folder into cooked TOEM files and its images into compressed DDS textures.
+ * 		  It can also pack the whole folder into a single TOEP archive.
+ *
+ * @file TAssetCooker.h
+ */
+
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+
+/**
+ * @brief 	- Trabajo de cocinado de un mesh o una textura
+ */
+struct TCookJob{
+	std::string			source;		// source - Ruta del obj o de la imagen
+	std::string			output;		// output - Ruta del fichero cocinado
+	std::string			relative;	// relative - Ruta del fuente relativa a la carpeta de assets, clave del manifiesto
+	unsigned long long	hash;		// hash - Hash del contenido del fuente (y su mtl en los obj)
+	int					type;		// type - COOK_MESH o COOK_TEXTURE
+	int					format;		// format - Formato de compresion de las texturas (TTextureFile::TEXTURE_*)
+	int					state;		// state - COOK_SKIPPED, COOK_DONE o COOK_FAILED
+};
+
+class TAssetCooker{
+public:
+	/**
+	 * @brief	- Constructor del cocinador
+	 *
+	 * @param 	- assetsPath - Carpeta de assets, los ficheros cocinados se escriben al lado de cada obj
+	 * @param 	- threads - Numero de hilos (0 para usar todos los del procesador)
+	 */
+	TAssetCooker(std::string assetsPath, int threads = 0);
+
+	/**
+	 * @brief	- Destructor del cocinador
+	 */
+	~TAssetCooker();
+
+	/**
+	 * @brief	- Cocina todos los obj e imagenes de la carpeta cuyo contenido ha cambiado desde el ultimo cocinado
+	 *
+	 * @param 	- force - Cocina todos aunque no hayan cambiado
+	 * @return 	- int - Numero de ficheros que no se han podido cocinar
+	 */
+	int Cook(bool force = false);
+
+	/**
+	 * @brief	- Guarda todos los ficheros de la carpeta (fuentes y cocinados) en un pack TOEP
+	 * 				No se guardan el manifiesto, cook_textures.txt ni los temporales
+	 *
+	 * @param 	- packPath - Ruta del pack a escribir
+	 * @param 	- lz4 - Comprime con LZ4 las entradas en las que compensa
+	 * @return 	- bool - Se ha escrito y validado el pack
+	 */
+	bool Pack(std::string packPath, bool lz4);
+
+	/**
+	 * @brief	- Hash FNV-1a de 64 bits de un bloque de memoria, continuando desde otro hash
+	 */
+	static unsigned long long Hash(const void* data, unsigned long long size, unsigned long long hash = m_hashSeed);
+
+	static const int COOK_SKIPPED = 0;	// COOK_SKIPPED - No ha cambiado, se deja el fichero que habia
+	static const int COOK_DONE = 1;		// COOK_DONE - Se ha cocinado
+	static const int COOK_FAILED = 2;	// COOK_FAILED - No se ha podido cocinar
+
+	static const int COOK_MESH = 0;		// COOK_MESH - Obj a TOEM
+	static const int COOK_TEXTURE = 1;	// COOK_TEXTURE - Imagen a DDS
+
+private:
+	/**
+	 * @brief	- Busca todos los obj e imagenes de la carpeta de assets y les calcula el hash
+	 * 				Las imagenes con formato none no se cocinan
+	 */
+	void CollectJobs();
+
+	/**
+	 * @brief	- Cocina los trabajos pendientes, cada hilo coge el siguiente libre
+	 */
+	void Worker();
+
+	/**
+	 * @brief	- Convierte un obj (de texto o binario antiguo) y su mtl en un fichero TOEM
+	 *
+	 * @return 	- bool - Se ha escrito y validado el fichero
+	 */
+	bool CookMesh(TCookJob* job);
+
+	/**
+	 * @brief	- Genera los mipmaps de una imagen y los guarda comprimidos en un DDS
+	 *
+	 * @return 	- bool - Se ha escrito y validado el fichero
+	 */
+	bool CookTexture(TCookJob* job);
+
+	/**
+	 * @brief	- Lee el formato de cada textura de cook_textures.txt
+	 * 				Cada linea: <ruta relativa a assets o carpeta acabada en /> <none|auto|dxt1|dxt5>
+	 */
+	void LoadTextureFormats();
+
+	/**
+	 * @brief	- Devuelve el formato de una textura, el de la regla mas larga que coincide (auto si no hay ninguna)
+	 */
+	int GetTextureFormat(std::string relative);
+
+	/**
+	 * @brief	- Devuelve la ruta del fichero cocinado de un fuente segun su tipo
+	 */
+	static std::string GetCookedPath(std::string source);
+
+	/**
+	 * @brief	- Lee y escribe el manifiesto con el hash de cada obj cocinado
+	 */
+	void LoadManifest();
+	bool SaveManifest();
+
+	/**
+	 * @brief	- Devuelve el mtl que usa el obj: el de mtllib en los obj de texto o el que tiene su mismo nombre
+	 */
+	static std::string FindMaterialLibrary(std::string source, const std::vector<char>* content);
+
+	/**
+	 * @brief	- Comprueba si el contenido es un obj de texto y no un binario
+	 */
+	static bool IsTextObj(const std::vector<char>* content);
+
+	/**
+	 * @brief	- Lee un fichero entero, devuelve false si no existe
+	 */
+	static bool ReadFile(std::string path, std::vector<char>* content);
+
+	/**
+	 * @brief	- Escribe un mensaje por consola sin mezclarlo con el de otros hilos
+	 */
+	void Log(std::string message);
+
+	std::string								m_assetsPath;		// m_assetsPath - Carpeta de assets
+	std::string								m_manifestPath;		// m_manifestPath - Ruta del manifiesto
+	int										m_threads;			// m_threads - Numero de hilos
+	bool									m_force;			// m_force - Cocinar aunque no haya cambiado
+	std::vector<TCookJob>					m_jobs;				// m_jobs - Meshes encontrados
+	std::map<std::string, std::string>		m_manifest;			// m_manifest - Hash del ultimo cocinado de cada fuente
+	std::map<std::string, int>				m_textureFormats;	// m_textureFormats - Formato por ruta o carpeta de cook_textures.txt
+	std::string								m_formatsPath;		// m_formatsPath - Ruta de cook_textures.txt
+	int										m_nextJob;			// m_nextJob - Siguiente trabajo sin coger
+	std::mutex								m_mutex;			// m_mutex - Protege m_nextJob y la consola
+
+	static const unsigned long long			m_hashSeed = 14695981039346656037ull;	// m_hashSeed - Base del FNV-1a
+	static const unsigned int				m_cookerVersion = 3;					// m_cookerVersion - Cambiarlo recocina todo
+};
+
+#endif
@@ -0,0 +1,40 @@
+#include "TAssetCooker.h"
+
+#include <iostream>
+#include <string>
+#include <cstring>
+#include <cstdlib>
+
+/*
+	AssetCooker <carpeta de assets> [--force] [--jobs N] [--pack <fichero> [--lz4]]
+	Convierte cada obj de la carpeta (y sus subcarpetas) en un .toem a su lado, con el material ya resuelto
+	y cada imagen (png, jpg, tga, bmp) en un .dds comprimido con sus mipmaps (formato por textura en cook_textures.txt)
+	Solo se vuelven a cocinar los ficheros cuyo contenido (o el de su mtl) ha cambiado desde el ultimo cocinado
+	Con --pack despues de cocinar guarda toda la carpeta en un pack TOEP (con --lz4 comprime las entradas en las que compensa)
+*/
+
+int main(int argc, char* argv[]){
+	std::string assetsPath = "";
+	bool force = false;
+	int threads = 0;
+	std::string packPath = "";
+	bool lz4 = false;
+
+	for(int i=1; i<argc; i++){
+		if(strcmp(argv[i], "--force") == 0) force = true;
+		else if(strcmp(argv[i], "--jobs") == 0 && i + 1 < argc) threads = atoi(argv[++i]);
+		else if(strcmp(argv[i], "--pack") == 0 && i + 1 < argc) packPath = argv[++i];
+		else if(strcmp(argv[i], "--lz4") == 0) lz4 = true;
+		else assetsPath = argv[i];
+	}
+
+	if(assetsPath.empty()){
+		std::cout<<"Uso: AssetCooker <carpeta de assets> [--force] [--jobs N] [--pack <fichero> [--lz4]]"<<std::endl;
+		return 1;
+	}
+
+	TAssetCooker cooker(assetsPath, threads);
+	int failed = cooker.Cook(force);
+	if(!packPath.empty() && !cooker.Pack(packPath, lz4)) failed++;
+	return failed == 0 ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,152 @@
+#include "./../../src/EngineUtilities/TFrustum.h"
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cstdlib>
+#include <cmath>
+
+/*
+	CullBench [cajas] [repeticiones]
+	Compara el tiempo de TFrustum::CullBoxes (AVX o SSE segun como se compile), CullBoxesScalar
+	y el test antiguo de TMesh::CheckClipping (8 esquinas multiplicadas por la MVP) sobre las mismas cajas
+	Las cajas estan siempre delante del plano cercano, donde los dos tests tienen que dar la misma visibilidad
+	Las que tocan un plano (a menos de EDGE_DISTANCE) no se comparan con las 8 esquinas, dividir por w redondea distinto
+	Devuelve 1 si alguna caja no coincide
+*/
+
+#if defined(__AVX__)
+	#define CULLBENCH_PATH "AVX"
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define CULLBENCH_PATH "SSE"
+#else
+	#define CULLBENCH_PATH "Escalar"
+#endif
+
+static const float CLIPPING_LIMITS[4] = {+1.0f, -1.0f, +1.0f, -1.0f};	// Limites de la pantalla entera (+X, -X, +Y, -Y)
+static const float EDGE_DISTANCE = 0.01f;	// Distancia a un plano (en unidades del mundo) a partir de la que los dos tests tienen que coincidir
+
+// Copia de TEntity::CheckClippingAreas
+static void CheckClippingAreas(glm::vec4 point, int* upDown, int* leftRight, int* nearFar){
+	float valueX = point.x / std::abs(point.w);
+	float valueY = point.y / std::abs(point.w);
+	float valueZ = point.z / std::abs(point.w);
+
+	if(valueX > CLIPPING_LIMITS[0]) (*leftRight)++;
+	else if(valueX < CLIPPING_LIMITS[1]) (*leftRight)--;
+
+	if(valueY > CLIPPING_LIMITS[2]) (*upDown)++;
+	else if(valueY < CLIPPING_LIMITS[3]) (*upDown)--;
+
+	if(valueZ > 1.0f) (*nearFar)++;
+	else if(valueZ < 0.0f) (*nearFar)--;
+}
+
+// Test antiguo de TMesh::CheckClipping, la caja ya esta en coordenadas de mundo
+static bool CheckClippingCorners(const glm::mat4& mvpMatrix, glm::vec3 center, glm::vec3 size){
+	int upDown = 0, leftRight = 0, nearFar = 0;
+	for(int i=-1; i<=1; i+=2){
+		for(int j=-1; j<=1; j+=2){
+			for(int k=-1; k<=1; k+=2){
+				glm::vec3 point = center + glm::vec3(size.x/2.0f * i, size.y/2.0f * j, size.z/2.0f * k);
+				glm::vec4 mvpPoint = mvpMatrix * glm::vec4(point.x, point.y, point.z, 1.0f);
+				CheckClippingAreas(mvpPoint, &upDown, &leftRight, &nearFar);
+			}
+		}
+	}
+
+	int sides = 8;
+	return !(upDown == sides || upDown == -sides || leftRight == sides || leftRight == -sides || nearFar == sides);
+}
+
+// Indica si la caja esta a menos de EDGE_DISTANCE de salir por algun plano
+static bool OnEdge(const glm::vec4* planes, glm::vec3 center, glm::vec3 size){
+	for(int p=0; p<6; p++){
+		glm::vec3 normal(planes[p]);
+		float distance = glm::dot(normal, center) + planes[p].w;
+		float radius = glm::dot(glm::abs(normal), size * 0.5f);
+		if(std::abs(distance + radius) < EDGE_DISTANCE * glm::length(normal)) return true;
+	}
+	return false;
+}
+
+// Milisegundos desde start
+static double Elapsed(std::chrono::high_resolution_clock::time_point start){
+	return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[]){
+	int count = argc > 1 ? atoi(argv[1]) : 100000;
+	int iterations = argc > 2 ? atoi(argv[2]) : 200;
+	if(count <= 0 || iterations <= 0){
+		std::cout<<"Uso: CullBench [cajas] [repeticiones]"<<std::endl;
+		return 1;
+	}
+
+	// Camara fija mirando a -Z, las cajas siempre por delante del plano cercano (z de vista <= -0.5)
+	glm::vec3 eye(10.0f, 5.0f, 20.0f);
+	glm::mat4 viewProj = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 100.0f) * glm::lookAt(eye, eye + glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+
+	std::mt19937 random(1234);
+	std::uniform_real_distribution<float> randomX(-150.0f, 150.0f), randomY(-100.0f, 100.0f), randomZ(-160.0f, -1.5f), randomExtent(0.05f, 1.0f);
+
+	TBoundsArray boxes;
+	std::vector<glm::vec3> centers, sizes;
+	for(int i=0; i<count; i++){
+		glm::vec3 center = eye + glm::vec3(randomX(random), randomY(random), randomZ(random));
+		glm::vec3 extent(randomExtent(random), randomExtent(random), randomExtent(random));
+		boxes.Add(center - extent, center + extent);
+		centers.push_back(center);
+		sizes.push_back(extent * 2.0f);
+	}
+
+	TFrustum frustum;
+	frustum.Update(viewProj, CLIPPING_LIMITS);
+	std::vector<unsigned int> simdMask, scalarMask;
+	std::vector<char> corners(count);
+	unsigned long long visible = 0;	// Se suma para que no se quite ninguna pasada al optimizar
+
+	std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+	for(int it=0; it<iterations; it++){
+		frustum.CullBoxes(&boxes, &simdMask);
+		visible += simdMask[0];
+	}
+	double simdTime = Elapsed(start);
+
+	start = std::chrono::high_resolution_clock::now();
+	for(int it=0; it<iterations; it++){
+		scalarMask.assign((count + 31) / 32, 0u);
+		frustum.CullBoxesScalar(&boxes, 0, &scalarMask);
+		visible += scalarMask[0];
+	}
+	double scalarTime = Elapsed(start);
+
+	start = std::chrono::high_resolution_clock::now();
+	for(int it=0; it<iterations; it++){
+		for(int i=0; i<count; i++) corners[i] = CheckClippingCorners(viewProj, centers[i], sizes[i]);
+		visible += corners[0];
+	}
+	double cornersTime = Elapsed(start);
+
+	// Las tres versiones tienen que dar la misma visibilidad
+	int visibleBoxes = 0, edgeBoxes = 0, scalarMismatches = 0, cornerMismatches = 0;
+	for(int i=0; i<count; i++){
+		bool simd = TFrustum::IsVisible(simdMask, i);
+		if(simd) visibleBoxes++;
+		if(simd != TFrustum::IsVisible(scalarMask, i)) scalarMismatches++;
+
+		if(OnEdge(frustum.GetPlanes(), centers[i], sizes[i])) edgeBoxes++;
+		else if(simd != (corners[i] != 0)) cornerMismatches++;
+	}
+
+	double boxesTested = (double)count * iterations;
+	std::cout<<count<<" cajas, "<<iterations<<" repeticiones, "<<visibleBoxes<<" visibles ("<<visible<<")"<<std::endl;
+	std::cout<<"CullBoxes ("<<CULLBENCH_PATH<<"):\t"<<simdTime * 1000000.0 / boxesTested<<" ns/caja"<<std::endl;
+	std::cout<<"CullBoxesScalar:\t"<<scalarTime * 1000000.0 / boxesTested<<" ns/caja"<<std::endl;
+	std::cout<<"8 esquinas (MVP):\t"<<cornersTime * 1000000.0 / boxesTested<<" ns/caja"<<std::endl;
+	std::cout<<"Distintas: "<<scalarMismatches<<" escalar, "<<cornerMismatches<<" 8 esquinas ("<<edgeBoxes<<" en el borde sin comparar)"<<std::endl;
+
+	return scalarMismatches == 0 && cornerMismatches == 0 ? 0 : 1;
+}